@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/AllocationTracking.h"
+#include "AT/BitOperations.h"
+#include "AT/Log.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+// The tag names are only modified while holding the mutex. The tags are never removed, so the number of tags is
+// published with release semantics after the name is written.
+struct AllocationTagRegistry
+{
+    std::mutex mutex;
+    StringView names[AllocationTag::MaxCount] = { "Untagged"sv };
+    std::atomic<u32> count = 1;
+};
+
+static AllocationTagRegistry& get_allocation_tag_registry()
+{
+    static AllocationTagRegistry registry;
+    return registry;
+}
+
+static thread_local AllocationTag s_current_allocation_tag = AllocationTag::untagged();
+
+AllocationTag exchange_current_allocation_tag(AllocationTag tag)
+{
+    const AllocationTag previous_tag = s_current_allocation_tag;
+    s_current_allocation_tag = tag;
+    return previous_tag;
+}
+
+#if AT_ENABLE_ALLOCATION_TRACKING
+
+//
+// Tracking an allocation costs two atomic additions (and, rarely, a compare-exchange loop when the peak grows),
+// while tracking a release costs one. The allocation count is not stored, being the sum of the histogram buckets.
+// The counters of different tags are stored in different cache lines, so that the threads that work in different
+// subsystems don't contend.
+//
+struct alignas(64) AllocationTagCounters
+{
+    std::atomic<u64> live_byte_count = 0;
+    std::atomic<u64> peak_live_byte_count = 0;
+    std::atomic<u64> allocation_size_histogram[AllocationTagStatistics::HistogramBucketCount] = {};
+};
+
+static AllocationTagCounters s_allocation_tag_counters[AllocationTag::MaxCount];
+
+NODISCARD ALWAYS_INLINE static inline u32 get_histogram_bucket_index(usize byte_count)
+{
+    // The allocations of at most 16 bytes are counted in the first bucket.
+    if (byte_count <= 16)
+        return 0;
+    const u32 bucket_index = 64 - count_leading_zeroes(static_cast<u64>(byte_count - 1)) - 4;
+    return bucket_index < AllocationTagStatistics::HistogramBucketCount
+               ? bucket_index
+               : AllocationTagStatistics::HistogramBucketCount - 1;
+}
+
+AllocationTag get_current_allocation_tag()
+{
+    return s_current_allocation_tag;
+}
+
+void track_allocation(AllocationTag tag, usize byte_count)
+{
+    AllocationTagCounters& counters = s_allocation_tag_counters[tag.index()];
+    const u64 live_byte_count = counters.live_byte_count.fetch_add(byte_count, std::memory_order_relaxed) + byte_count;
+    counters.allocation_size_histogram[get_histogram_bucket_index(byte_count)].fetch_add(1, std::memory_order_relaxed);
+
+    u64 peak_live_byte_count = counters.peak_live_byte_count.load(std::memory_order_relaxed);
+    while (live_byte_count > peak_live_byte_count)
+    {
+        if (counters.peak_live_byte_count.compare_exchange_weak(
+                peak_live_byte_count, live_byte_count, std::memory_order_relaxed
+            ))
+            break;
+    }
+}
+
+void track_release(AllocationTag tag, usize byte_count)
+{
+    AllocationTagCounters& counters = s_allocation_tag_counters[tag.index()];
+    counters.live_byte_count.fetch_sub(byte_count, std::memory_order_relaxed);
+}
+
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+
+} // namespace Detail
+
+AllocationTag AllocationTag::get_or_create(StringView name)
+{
+    Detail::AllocationTagRegistry& registry = Detail::get_allocation_tag_registry();
+    std::scoped_lock lock(registry.mutex);
+
+    const u32 count = registry.count.load(std::memory_order_relaxed);
+    for (u32 index = 0; index < count; ++index)
+    {
+        if (registry.names[index] == name)
+            return AllocationTag(index);
+    }
+
+    VERIFY_ALWAYS(count < MaxCount);
+    registry.names[count] = name;
+    registry.count.store(count + 1, std::memory_order_release);
+    return AllocationTag(count);
+}
+
+u32 AllocationTag::get_count()
+{
+    return Detail::get_allocation_tag_registry().count.load(std::memory_order_acquire);
+}
+
+StringView AllocationTag::name() const
+{
+    return Detail::get_allocation_tag_registry().names[m_index];
+}
+
+AllocationTagStatistics get_allocation_tag_statistics(AllocationTag tag)
+{
+    AllocationTagStatistics statistics;
+    statistics.name = tag.name();
+
+#if AT_ENABLE_ALLOCATION_TRACKING
+    const Detail::AllocationTagCounters& counters = Detail::s_allocation_tag_counters[tag.index()];
+    statistics.live_byte_count = counters.live_byte_count.load(std::memory_order_relaxed);
+    statistics.peak_live_byte_count = counters.peak_live_byte_count.load(std::memory_order_relaxed);
+    for (u32 bucket_index = 0; bucket_index < AllocationTagStatistics::HistogramBucketCount; ++bucket_index)
+    {
+        statistics.allocation_size_histogram[bucket_index] =
+            counters.allocation_size_histogram[bucket_index].load(std::memory_order_relaxed);
+        statistics.allocation_count += statistics.allocation_size_histogram[bucket_index];
+    }
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+
+    return statistics;
+}
+
+void dump_allocation_report()
+{
+#if AT_ENABLE_ALLOCATION_TRACKING
+    dbgln("{:<24} {:>14} {:>14} {:>14}"sv, "Allocation tag"sv, "Live bytes"sv, "Peak bytes"sv, "Allocations"sv);
+
+    const u32 tag_count = AllocationTag::get_count();
+    for (u32 tag_index = 0; tag_index < tag_count; ++tag_index)
+    {
+        const AllocationTag tag = AllocationTag::from_index(tag_index);
+        const AllocationTagStatistics statistics = get_allocation_tag_statistics(tag);
+        if (statistics.allocation_count == 0)
+            continue;
+
+        dbgln(
+            "{:<24} {:>14} {:>14} {:>14}"sv, statistics.name, statistics.live_byte_count,
+            statistics.peak_live_byte_count, statistics.allocation_count
+        );
+
+        // The histogram only lists the buckets that counted any allocation.
+        StringBuilder histogram;
+        for (u32 bucket_index = 0; bucket_index < AllocationTagStatistics::HistogramBucketCount; ++bucket_index)
+        {
+            const u64 allocation_count = statistics.allocation_size_histogram[bucket_index];
+            if (allocation_count == 0)
+                continue;
+            if (bucket_index == AllocationTagStatistics::HistogramBucketCount - 1)
+                format_to(histogram, " >{}: {}"sv, static_cast<u64>(1) << (bucket_index + 3), allocation_count);
+            else
+                format_to(histogram, " <={}: {}"sv, static_cast<u64>(1) << (bucket_index + 4), allocation_count);
+        }
+        dbgln("    Sizes:{}"sv, histogram.to_view());
+    }
+#else
+    dbgln("The allocation tracking is not compiled (see the ENABLE_ALLOCATION_TRACKING CMake option)."sv);
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+}
+
+} // namespace AT
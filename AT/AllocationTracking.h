@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Assertions.h"
+#include "AT/CoreTypes.h"
+#include "AT/StringView.h"
+
+//
+// The allocation tracking is only compiled when AT_ENABLE_ALLOCATION_TRACKING is set (by the
+// ENABLE_ALLOCATION_TRACKING CMake option). Otherwise, the heap allocations are not accounted and the tag scope
+// macro expands to nothing.
+//
+#ifndef AT_ENABLE_ALLOCATION_TRACKING
+    #define AT_ENABLE_ALLOCATION_TRACKING 0
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+
+namespace AT
+{
+
+///
+/// Identifies the subsystem that owns a heap allocation. Each thread has a current tag (initially the untagged one),
+/// which is assigned to all the heap allocations it performs. The memory is accounted to the tag it was allocated
+/// with, even if it is released by another thread or while another tag is current.
+///
+class AllocationTag
+{
+public:
+    static constexpr u32 MaxCount = 64;
+
+    // Returns the tag with the given name, creating it if no such tag exists. The name must live for the whole program
+    // (such as a string literal).
+    NODISCARD AT_API static AllocationTag get_or_create(StringView name);
+
+    NODISCARD ALWAYS_INLINE static constexpr AllocationTag untagged() { return AllocationTag(0); }
+
+    // The tags are indexed in the order they were created, starting with the untagged one.
+    NODISCARD AT_API static u32 get_count();
+    NODISCARD ALWAYS_INLINE static AllocationTag from_index(u32 index)
+    {
+        VERIFY_ALWAYS(index < MaxCount);
+        return AllocationTag(index);
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE u32 index() const { return m_index; }
+    NODISCARD AT_API StringView name() const;
+
+    NODISCARD ALWAYS_INLINE bool operator==(const AllocationTag& other) const { return m_index == other.m_index; }
+
+private:
+    ALWAYS_INLINE constexpr explicit AllocationTag(u32 index)
+        : m_index(index)
+    {
+    }
+
+private:
+    u32 m_index;
+};
+
+struct AllocationTagStatistics
+{
+    // The bucket N counts the allocations of at most 2^(N + 4) bytes, except for the last bucket, which counts all
+    // the larger allocations.
+    static constexpr u32 HistogramBucketCount = 16;
+
+    StringView name;
+    u64 live_byte_count = 0;
+    u64 peak_live_byte_count = 0;
+    u64 allocation_count = 0;
+    u64 allocation_size_histogram[HistogramBucketCount] = {};
+};
+
+// Both functions report zero counters if the allocation tracking is not compiled.
+NODISCARD AT_API AllocationTagStatistics get_allocation_tag_statistics(AllocationTag tag);
+// Logs the counters of all tags that were used.
+AT_API void dump_allocation_report();
+
+namespace Detail
+{
+
+// Returns the previously current tag.
+AT_API AllocationTag exchange_current_allocation_tag(AllocationTag tag);
+
+#if AT_ENABLE_ALLOCATION_TRACKING
+// Called by the heap allocator. The memory is always released with the tag that was current when it was allocated.
+NODISCARD AllocationTag get_current_allocation_tag();
+void track_allocation(AllocationTag tag, usize byte_count);
+void track_release(AllocationTag tag, usize byte_count);
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+
+} // namespace Detail
+
+///
+/// Makes the tag current for the calling thread until the guard goes out of scope.
+/// Use the AT_ALLOCATION_TAG_SCOPE macro, which can be disabled at compile time.
+///
+class ScopedAllocationTag
+{
+    AT_MAKE_NONCOPYABLE(ScopedAllocationTag);
+    AT_MAKE_NONMOVABLE(ScopedAllocationTag);
+
+public:
+    ALWAYS_INLINE explicit ScopedAllocationTag(AllocationTag tag)
+        : m_previous_tag(Detail::exchange_current_allocation_tag(tag))
+    {
+    }
+
+    ALWAYS_INLINE ~ScopedAllocationTag() { Detail::exchange_current_allocation_tag(m_previous_tag); }
+
+private:
+    AllocationTag m_previous_tag;
+};
+
+} // namespace AT
+
+#if AT_ENABLE_ALLOCATION_TRACKING
+    #define AT_ALLOCATION_TAG_SCOPE(tag) \
+        const ::AT::ScopedAllocationTag CONCATENATE(at_allocation_tag_scope_, __LINE__)(tag)
+#else
+    #define AT_ALLOCATION_TAG_SCOPE(tag)
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+
+#if AT_INCLUDE_GLOBALLY
+using AT::AllocationTag;
+using AT::AllocationTagStatistics;
+using AT::dump_allocation_report;
+using AT::get_allocation_tag_statistics;
+using AT::ScopedAllocationTag;
+#endif // AT_INCLUDE_GLOBALLY
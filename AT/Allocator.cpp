@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Allocator.h"
+#include "AT/AllocationTracking.h"
+#include "AT/Platform.h"
+
+namespace AT
+{
+
+NODISCARD ALWAYS_INLINE static constexpr usize align_up(usize value, usize alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+//=============================================================================
+// Heap allocator.
+//=============================================================================
+
+NODISCARD static void* allocate_heap_block(usize byte_count, usize alignment)
+{
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return ::operator new(byte_count, static_cast<std::align_val_t>(alignment), std::nothrow);
+    return ::operator new(byte_count, std::nothrow);
+}
+
+static void release_heap_block(void* memory, usize byte_count, usize alignment)
+{
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(memory, byte_count, static_cast<std::align_val_t>(alignment));
+    else
+        ::operator delete(memory, byte_count);
+}
+
+#if AT_ENABLE_ALLOCATION_TRACKING
+
+//
+// When the allocations are tracked, each heap block is prefixed by a header that stores the tag the block was
+// allocated with, right before the memory returned to the caller. The header size is a multiple of the alignment,
+// so the returned memory keeps the requested alignment.
+//
+NODISCARD ALWAYS_INLINE static inline usize get_tracking_header_size(usize alignment)
+{
+    return alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? alignment : __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+ErrorOr<void*> HeapAllocator::try_allocate_from_heap(usize byte_count, usize alignment)
+{
+    const usize header_size = get_tracking_header_size(alignment);
+    u8* block = static_cast<u8*>(allocate_heap_block(header_size + byte_count, alignment));
+    if (!block)
+        return Error::Code::OutOfMemory;
+
+    const AllocationTag tag = Detail::get_current_allocation_tag();
+    Detail::track_allocation(tag, byte_count);
+    u8* memory = block + header_size;
+    reinterpret_cast<AllocationTag*>(memory)[-1] = tag;
+    return memory;
+}
+
+void HeapAllocator::release_to_heap(void* memory, usize byte_count, usize alignment)
+{
+    // Like the global operator delete, releasing a null pointer does nothing.
+    if (!memory)
+        return;
+
+    const usize header_size = get_tracking_header_size(alignment);
+    Detail::track_release(static_cast<AllocationTag*>(memory)[-1], byte_count);
+    release_heap_block(static_cast<u8*>(memory) - header_size, header_size + byte_count, alignment);
+}
+
+#else
+
+ErrorOr<void*> HeapAllocator::try_allocate_from_heap(usize byte_count, usize alignment)
+{
+    void* memory = allocate_heap_block(byte_count, alignment);
+    if (!memory)
+        return Error::Code::OutOfMemory;
+    return memory;
+}
+
+void HeapAllocator::release_to_heap(void* memory, usize byte_count, usize alignment)
+{
+    release_heap_block(memory, byte_count, alignment);
+}
+
+#endif // AT_ENABLE_ALLOCATION_TRACKING
+
+ErrorOr<void*> HeapAllocator::try_allocate(usize byte_count, usize alignment)
+{
+    return try_allocate_from_heap(byte_count, alignment);
+}
+
+void HeapAllocator::release(void* memory, usize byte_count, usize alignment)
+{
+    release_to_heap(memory, byte_count, alignment);
+}
+
+//=============================================================================
+// Arena allocator.
+//=============================================================================
+
+struct ArenaAllocator::Block
+{
+    Block* previous;
+    usize capacity;
+
+    NODISCARD ALWAYS_INLINE u8* data() { return reinterpret_cast<u8*>(this) + HeaderSize; }
+
+    // Returns the first offset, greater than or equal to the given one, whose address satisfies the alignment.
+    NODISCARD ALWAYS_INLINE usize get_aligned_offset(usize offset, usize alignment)
+    {
+        const uintptr data_address = reinterpret_cast<uintptr>(data());
+        return align_up(data_address + offset, alignment) - data_address;
+    }
+
+    // The size of the header is rounded up, so that the data is aligned to the default heap alignment.
+    static constexpr usize HeaderSize = align_up(sizeof(Block*) + sizeof(usize), __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+};
+
+ArenaAllocator::ArenaAllocator(usize block_size)
+    : m_block_size(block_size)
+{
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+    // Move all blocks to the free list, and then release them back to the heap.
+    reset();
+
+    while (m_free_blocks)
+    {
+        Block* block = m_free_blocks;
+        m_free_blocks = block->previous;
+        HeapAllocator::release_to_heap(block, Block::HeaderSize + block->capacity, alignof(Block));
+    }
+}
+
+ErrorOr<void*> ArenaAllocator::try_allocate(usize byte_count, usize alignment)
+{
+    if (m_current_block)
+    {
+        const usize offset = m_current_block->get_aligned_offset(m_current_offset, alignment);
+        if (offset + byte_count <= m_current_block->capacity)
+        {
+            m_current_offset = offset + byte_count;
+            return m_current_block->data() + offset;
+        }
+    }
+
+    // The padding is only required when the alignment exceeds the alignment of the block data.
+    const usize padding = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? alignment : 0;
+    TRY(try_acquire_block(byte_count + padding));
+
+    const usize offset = m_current_block->get_aligned_offset(0, alignment);
+    m_current_offset = offset + byte_count;
+    return m_current_block->data() + offset;
+}
+
+void ArenaAllocator::release(void* memory, usize byte_count, usize)
+{
+    // Only the most recent allocation can be rolled back. This is the common case for containers
+    // that grow, as they release their previous memory block right after allocating the new one.
+    if (m_current_block && static_cast<u8*>(memory) + byte_count == m_current_block->data() + m_current_offset)
+        m_current_offset = static_cast<usize>(static_cast<u8*>(memory) - m_current_block->data());
+}
+
+void ArenaAllocator::reset_to_marker(ArenaMarker marker)
+{
+    while (m_current_block != marker.block)
+    {
+        // The marker must have been created by this arena, before the current position.
+        VERIFY_ALWAYS(m_current_block);
+
+        Block* block = m_current_block;
+        m_current_block = block->previous;
+        block->previous = m_free_blocks;
+        m_free_blocks = block;
+    }
+
+    m_current_offset = marker.offset;
+}
+
+ErrorOr<void> ArenaAllocator::try_acquire_block(usize minimum_byte_count)
+{
+    // Try to reuse a cached block first.
+    Block** link = &m_free_blocks;
+    while (*link)
+    {
+        Block* block = *link;
+        if (block->capacity >= minimum_byte_count)
+        {
+            *link = block->previous;
+            block->previous = m_current_block;
+            m_current_block = block;
+            m_current_offset = 0;
+            return {};
+        }
+        link = &block->previous;
+    }
+
+    const usize capacity = minimum_byte_count > m_block_size ? minimum_byte_count : m_block_size;
+    TRY_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(Block::HeaderSize + capacity, alignof(Block)));
+
+    Block* block = static_cast<Block*>(memory);
+    block->previous = m_current_block;
+    block->capacity = capacity;
+    m_current_block = block;
+    m_current_offset = 0;
+    return {};
+}
+
+ArenaAllocator& get_thread_scratch_arena()
+{
+    static thread_local ArenaAllocator scratch_arena;
+    return scratch_arena;
+}
+
+//=============================================================================
+// Pool allocator.
+//=============================================================================
+
+struct PoolAllocator::FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct PoolAllocator::Chunk
+{
+    Chunk* next;
+};
+
+PoolAllocator::PoolAllocator(usize block_size, usize block_alignment, usize blocks_per_chunk)
+    : m_block_alignment(block_alignment > alignof(FreeBlock) ? block_alignment : alignof(FreeBlock))
+    , m_blocks_per_chunk(blocks_per_chunk)
+{
+    VERIFY_ALWAYS(blocks_per_chunk > 0);
+
+    // Each block must be able to store the free list link when it is not in use.
+    const usize minimum_block_size = block_size > sizeof(FreeBlock) ? block_size : sizeof(FreeBlock);
+    m_block_size = align_up(minimum_block_size, m_block_alignment);
+}
+
+PoolAllocator::~PoolAllocator()
+{
+    const usize chunk_header_size = align_up(sizeof(Chunk), m_block_alignment);
+    const usize chunk_byte_count = chunk_header_size + m_block_size * m_blocks_per_chunk;
+
+    while (m_chunks)
+    {
+        Chunk* chunk = m_chunks;
+        m_chunks = chunk->next;
+        HeapAllocator::release_to_heap(chunk, chunk_byte_count, m_block_alignment);
+    }
+}
+
+ErrorOr<void*> PoolAllocator::try_allocate(usize byte_count, usize alignment)
+{
+    VERIFY(byte_count <= m_block_size);
+    VERIFY(alignment <= m_block_alignment);
+
+    if (!m_free_blocks)
+        TRY(try_acquire_chunk());
+
+    FreeBlock* block = m_free_blocks;
+    m_free_blocks = block->next;
+    return block;
+}
+
+void PoolAllocator::release(void* memory, usize, usize)
+{
+    if (!memory)
+        return;
+
+    FreeBlock* block = static_cast<FreeBlock*>(memory);
+    block->next = m_free_blocks;
+    m_free_blocks = block;
+}
+
+ErrorOr<void> PoolAllocator::try_acquire_chunk()
+{
+    const usize chunk_header_size = align_up(sizeof(Chunk), m_block_alignment);
+    const usize chunk_byte_count = chunk_header_size + m_block_size * m_blocks_per_chunk;
+    TRY_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(chunk_byte_count, m_block_alignment));
+
+    Chunk* chunk = static_cast<Chunk*>(memory);
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+
+    // Push the blocks in reverse order, so that they are handed out in increasing address order.
+    u8* blocks = static_cast<u8*>(memory) + chunk_header_size;
+    for (usize index = m_blocks_per_chunk; index > 0; --index)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + (index - 1) * m_block_size);
+        block->next = m_free_blocks;
+        m_free_blocks = block;
+    }
+
+    return {};
+}
+
+//=============================================================================
+// Virtual memory allocator.
+//=============================================================================
+
+VirtualMemoryAllocator::VirtualMemoryAllocator(usize reserved_byte_count, bool use_huge_pages)
+    : m_reserved_byte_count(reserved_byte_count)
+    , m_use_huge_pages(use_huge_pages)
+{
+}
+
+VirtualMemoryAllocator::~VirtualMemoryAllocator()
+{
+    if (m_reservation)
+        release_virtual_memory(m_reservation, m_reservation_byte_count);
+}
+
+ErrorOr<void*> VirtualMemoryAllocator::try_allocate(usize byte_count, usize alignment)
+{
+    if (!m_base)
+        TRY(try_reserve());
+
+    const usize offset = align_up(m_used_byte_count, alignment);
+    if (offset > m_reserved_byte_count || byte_count > m_reserved_byte_count - offset)
+        return Error::Code::OutOfMemory;
+
+    TRY(try_commit(offset + byte_count));
+    m_used_byte_count = offset + byte_count;
+    m_last_block_offset = offset;
+    ++m_live_block_count;
+    return m_base + offset;
+}
+
+void VirtualMemoryAllocator::release(void* memory, usize byte_count, usize)
+{
+    if (!memory)
+        return;
+
+    // Only the most recent block can be rolled back. The memory of the other blocks is reclaimed when all blocks
+    // have been released.
+    const usize offset = static_cast<usize>(static_cast<u8*>(memory) - m_base);
+    if (offset == m_last_block_offset && offset + byte_count == m_used_byte_count)
+    {
+        m_used_byte_count = offset;
+        m_last_block_offset = InvalidSize;
+    }
+
+    if (--m_live_block_count == 0)
+    {
+        decommit_virtual_memory(m_base, m_committed_byte_count);
+        m_committed_byte_count = 0;
+        m_used_byte_count = 0;
+        m_last_block_offset = InvalidSize;
+    }
+}
+
+bool VirtualMemoryAllocator::try_resize_in_place(void* memory, usize byte_count, usize new_byte_count, usize)
+{
+    if (!memory)
+        return false;
+
+    const usize offset = static_cast<usize>(static_cast<u8*>(memory) - m_base);
+    if (offset != m_last_block_offset || offset + byte_count != m_used_byte_count)
+        return false;
+    if (new_byte_count > m_reserved_byte_count - offset)
+        return false;
+
+    if (try_commit(offset + new_byte_count).is_error())
+        return false;
+    m_used_byte_count = offset + new_byte_count;
+    return true;
+}
+
+ErrorOr<void> VirtualMemoryAllocator::try_reserve()
+{
+    // The pages are committed in large steps, as each commit is a system call.
+    static constexpr usize MinimumCommitGranularity = 64 * 1024;
+
+    const usize page_size = get_page_size();
+    const usize huge_page_size = get_huge_page_size();
+    m_commit_granularity = page_size > MinimumCommitGranularity ? page_size : MinimumCommitGranularity;
+    if (m_use_huge_pages && huge_page_size > m_commit_granularity)
+        m_commit_granularity = huge_page_size;
+
+    m_reserved_byte_count = align_up(m_reserved_byte_count, m_commit_granularity);
+    m_reservation_byte_count = m_reserved_byte_count;
+    if (m_use_huge_pages)
+        m_reservation_byte_count += huge_page_size;
+
+    TRY_ASSIGN(m_reservation, try_reserve_virtual_memory(m_reservation_byte_count));
+
+    const usize base_alignment = m_use_huge_pages ? huge_page_size : page_size;
+    m_base = reinterpret_cast<u8*>(align_up(reinterpret_cast<usize>(m_reservation), base_alignment));
+    if (m_use_huge_pages)
+        advise_huge_pages(m_base, m_reserved_byte_count);
+    return {};
+}
+
+ErrorOr<void> VirtualMemoryAllocator::try_commit(usize required_byte_count)
+{
+    if (required_byte_count <= m_committed_byte_count)
+        return {};
+
+    const usize new_committed_byte_count = align_up(required_byte_count, m_commit_granularity);
+    TRY(try_commit_virtual_memory(m_base + m_committed_byte_count, new_committed_byte_count - m_committed_byte_count));
+    m_committed_byte_count = new_committed_byte_count;
+    return {};
+}
+
+} // namespace AT
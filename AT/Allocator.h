@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Assertions.h"
+#include "AT/CoreTypes.h"
+#include "AT/Error.h"
+
+namespace AT
+{
+
+//
+// Interface that containers use to acquire and release memory.
+// Containers that store a null allocator pointer use the global heap (see HeapAllocator),
+// without going through a virtual call.
+//
+class Allocator
+{
+public:
+    virtual ~Allocator() = default;
+
+    // The alignment must be a power of two.
+    NODISCARD virtual ErrorOr<void*> try_allocate(usize byte_count, usize alignment) = 0;
+
+    // The byte count and alignment must be the same values that were used when allocating the memory block.
+    virtual void release(void* memory, usize byte_count, usize alignment) = 0;
+
+    // Tries to resize the memory block without moving it. The allocators that can't do that return false, in which
+    // case the container allocates a new block and moves its elements.
+    NODISCARD virtual bool try_resize_in_place(void*, usize, usize, usize) { return false; }
+};
+
+//
+// Allocator that uses the global heap (the global operator new and operator delete).
+//
+class HeapAllocator final : public Allocator
+{
+public:
+    NODISCARD AT_API static ErrorOr<void*> try_allocate_from_heap(usize byte_count, usize alignment);
+    AT_API static void release_to_heap(void* memory, usize byte_count, usize alignment);
+
+public:
+    NODISCARD AT_API virtual ErrorOr<void*> try_allocate(usize byte_count, usize alignment) override;
+    AT_API virtual void release(void* memory, usize byte_count, usize alignment) override;
+};
+
+// Wrappers that implement the null allocator convention used by the containers.
+NODISCARD ALWAYS_INLINE inline ErrorOr<void*> try_allocate_from(Allocator* allocator, usize byte_count, usize alignment)
+{
+    if (allocator)
+        return allocator->try_allocate(byte_count, alignment);
+    return HeapAllocator::try_allocate_from_heap(byte_count, alignment);
+}
+
+ALWAYS_INLINE inline void release_to(Allocator* allocator, void* memory, usize byte_count, usize alignment)
+{
+    if (allocator)
+        allocator->release(memory, byte_count, alignment);
+    else
+        HeapAllocator::release_to_heap(memory, byte_count, alignment);
+}
+
+//
+// Opaque position in an arena allocator. Resetting the arena to a marker releases, in O(1), all memory
+// allocated after the marker was created.
+//
+struct ArenaMarker
+{
+    void* block = nullptr;
+    usize offset = 0;
+};
+
+//
+// Linear (bump) allocator. Memory is carved out of large blocks, acquired from the heap, by incrementing
+// an offset. Individual allocations are not released (except for the most recent one, which is rolled back),
+// the memory being reclaimed in bulk by resetting the arena to a marker.
+// The blocks that are no longer used after a reset are cached and reused, so an arena that is reset every frame
+// doesn't cause any heap traffic after the first frames.
+//
+class ArenaAllocator final : public Allocator
+{
+    AT_MAKE_NONCOPYABLE(ArenaAllocator);
+    AT_MAKE_NONMOVABLE(ArenaAllocator);
+
+public:
+    static constexpr usize DefaultBlockSize = 64 * 1024;
+
+public:
+    AT_API explicit ArenaAllocator(usize block_size = DefaultBlockSize);
+    AT_API virtual ~ArenaAllocator() override;
+
+    NODISCARD AT_API virtual ErrorOr<void*> try_allocate(usize byte_count, usize alignment) override;
+    AT_API virtual void release(void* memory, usize byte_count, usize alignment) override;
+
+public:
+    NODISCARD ALWAYS_INLINE ArenaMarker get_marker() const { return { m_current_block, m_current_offset }; }
+
+    AT_API void reset_to_marker(ArenaMarker marker);
+    ALWAYS_INLINE void reset() { reset_to_marker({}); }
+
+private:
+    struct Block;
+
+    ErrorOr<void> try_acquire_block(usize minimum_byte_count);
+
+private:
+    usize m_block_size;
+    Block* m_current_block = nullptr;
+    usize m_current_offset = 0;
+
+    // Blocks that were acquired from the heap but are not used after a reset.
+    Block* m_free_blocks = nullptr;
+};
+
+//
+// Guard that resets the arena, when going out of scope, to the position it had when the guard was created.
+//
+class ScopedArenaMarker
+{
+    AT_MAKE_NONCOPYABLE(ScopedArenaMarker);
+    AT_MAKE_NONMOVABLE(ScopedArenaMarker);
+
+public:
+    ALWAYS_INLINE explicit ScopedArenaMarker(ArenaAllocator& arena)
+        : m_arena(arena)
+        , m_marker(arena.get_marker())
+    {
+    }
+
+    ALWAYS_INLINE ~ScopedArenaMarker() { m_arena.reset_to_marker(m_marker); }
+
+private:
+    ArenaAllocator& m_arena;
+    ArenaMarker m_marker;
+};
+
+//
+// Allocator that serves memory blocks of a fixed size, from chunks acquired from the heap. Released blocks are
+// stored in a free list and reused by the following allocations, so both operations are O(1).
+//
+class PoolAllocator final : public Allocator
+{
+    AT_MAKE_NONCOPYABLE(PoolAllocator);
+    AT_MAKE_NONMOVABLE(PoolAllocator);
+
+public:
+    static constexpr usize DefaultBlocksPerChunk = 64;
+
+public:
+    AT_API PoolAllocator(usize block_size, usize block_alignment, usize blocks_per_chunk = DefaultBlocksPerChunk);
+    AT_API virtual ~PoolAllocator() override;
+
+    // The byte count and the alignment must not exceed the values the pool was created with.
+    NODISCARD AT_API virtual ErrorOr<void*> try_allocate(usize byte_count, usize alignment) override;
+    AT_API virtual void release(void* memory, usize byte_count, usize alignment) override;
+
+public:
+    NODISCARD ALWAYS_INLINE usize block_size() const { return m_block_size; }
+    NODISCARD ALWAYS_INLINE usize block_alignment() const { return m_block_alignment; }
+
+private:
+    struct FreeBlock;
+    struct Chunk;
+
+    ErrorOr<void> try_acquire_chunk();
+
+private:
+    usize m_block_size;
+    usize m_block_alignment;
+    usize m_blocks_per_chunk;
+
+    FreeBlock* m_free_blocks = nullptr;
+    Chunk* m_chunks = nullptr;
+};
+
+//
+// Allocator that carves its blocks out of a single range of reserved address space, committing the pages only when
+// they are first used. The most recent block can be resized in place, so a vector that has its own virtual memory
+// allocator never moves its elements, no matter how much it grows. Releasing the most recent block rolls the
+// allocator back, and the pages are decommitted once no block is alive.
+//
+class VirtualMemoryAllocator final : public Allocator
+{
+    AT_MAKE_NONCOPYABLE(VirtualMemoryAllocator);
+    AT_MAKE_NONMOVABLE(VirtualMemoryAllocator);
+
+public:
+    // The reserved byte count bounds the total size of the blocks. The address space is only reserved by the first
+    // allocation, and reserving it is cheap, as no physical memory is used until the pages are committed.
+    AT_API explicit VirtualMemoryAllocator(usize reserved_byte_count, bool use_huge_pages = false);
+    AT_API virtual ~VirtualMemoryAllocator() override;
+
+    NODISCARD AT_API virtual ErrorOr<void*> try_allocate(usize byte_count, usize alignment) override;
+    AT_API virtual void release(void* memory, usize byte_count, usize alignment) override;
+    NODISCARD AT_API virtual bool
+    try_resize_in_place(void* memory, usize byte_count, usize new_byte_count, usize alignment) override;
+
+public:
+    NODISCARD ALWAYS_INLINE usize reserved_byte_count() const { return m_reserved_byte_count; }
+    NODISCARD ALWAYS_INLINE usize committed_byte_count() const { return m_committed_byte_count; }
+
+private:
+    ErrorOr<void> try_reserve();
+    ErrorOr<void> try_commit(usize required_byte_count);
+
+private:
+    usize m_reserved_byte_count;
+    bool m_use_huge_pages;
+
+    // The range returned by the platform, which is larger than the usable one when using huge pages (as the usable
+    // range must be aligned to the huge page size).
+    void* m_reservation = nullptr;
+    usize m_reservation_byte_count = 0;
+
+    u8* m_base = nullptr;
+    usize m_commit_granularity = 0;
+    usize m_committed_byte_count = 0;
+    usize m_used_byte_count = 0;
+    usize m_last_block_offset = InvalidSize;
+    usize m_live_block_count = 0;
+};
+
+// Arena that is local to the calling thread, intended for temporary allocations. The users should always
+// restore the arena to its previous position once they no longer need the memory (see ScopedArenaMarker).
+NODISCARD AT_API ArenaAllocator& get_thread_scratch_arena();
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::Allocator;
+using AT::ArenaAllocator;
+using AT::ArenaMarker;
+using AT::get_thread_scratch_arena;
+using AT::HeapAllocator;
+using AT::PoolAllocator;
+using AT::ScopedArenaMarker;
+using AT::VirtualMemoryAllocator;
+#endif // AT_INCLUDE_GLOBALLY
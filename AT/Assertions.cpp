@@ -18,6 +18,9 @@ void verification_failed(
     dbgln("    IN FUNCTION:     {}"sv, StringView::from_null_terminated_utf8(function));
     dbgln("    ON LINE:         {}"sv, line);
 
+    // The log is written asynchronously, so the messages must be written before the program terminates.
+    Detail::flush_log_after_failure();
+
     // TODO: Call the platform API in order to open a popup window that will display the error
     // message. This feature requires extensive access to the platform layer.
 }
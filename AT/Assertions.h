@@ -7,13 +7,43 @@
 
 #include "AT/CoreTypes.h"
 
-#define VERIFY(expression)                                                 \
+//
+// The checking level decides what VERIFY compiles to, and is set by the CHECKING_LEVEL CMake option:
+//   - Full:   VERIFY checks the expression, exactly like VERIFY_ALWAYS.
+//   - Cold:   VERIFY compiles to nothing. Only VERIFY_ALWAYS checks its expression.
+//   - Assume: VERIFY compiles to an optimizer assumption, which is undefined behaviour if the expression is false.
+//
+// VERIFY is meant for the hot paths (such as the bounds checks of the containers), while VERIFY_ALWAYS is meant for
+// the cold paths (such as the API misuse checks or the checks performed when a container grows), which must never be
+// disabled.
+//
+#define AT_CHECKING_LEVEL_ASSUME 0
+#define AT_CHECKING_LEVEL_COLD   1
+#define AT_CHECKING_LEVEL_FULL   2
+
+#ifndef AT_CHECKING_LEVEL
+    #define AT_CHECKING_LEVEL AT_CHECKING_LEVEL_FULL
+#endif // AT_CHECKING_LEVEL
+
+#define VERIFY_ALWAYS(expression)                                          \
     if (!(expression))                                                     \
     {                                                                      \
         verification_failed(#expression, __FILE__, AT_FUNCTION, __LINE__); \
         AT_DEBUGBREAK;                                                     \
     }
 
+#if AT_CHECKING_LEVEL == AT_CHECKING_LEVEL_FULL
+    #define VERIFY(expression) VERIFY_ALWAYS(expression)
+#elif AT_CHECKING_LEVEL == AT_CHECKING_LEVEL_COLD
+    // The expression is not evaluated, but it is still compiled, so that the variables it uses are not reported
+    // as unused.
+    #define VERIFY(expression) static_cast<void>(sizeof(!(expression)))
+#elif AT_CHECKING_LEVEL == AT_CHECKING_LEVEL_ASSUME
+    #define VERIFY(expression) AT_ASSUME(expression)
+#else
+    #error Unknown checking level!
+#endif // AT_CHECKING_LEVEL
+
 #define INVALID_CODEPATH                                                               \
     verification_failed("Invalid codepath reached!", __FILE__, AT_FUNCTION, __LINE__); \
     AT_DEBUGBREAK;
@@ -21,7 +51,7 @@
 namespace AT
 {
 
-AT_API void
+AT_API AT_COLD void
 verification_failed(const char* expression, const char* file, const char* function, u32 line);
 
 } // namespace AT
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Atom.h"
+#include "AT/Allocator.h"
+#include "AT/MemoryOperations.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace AT
+{
+
+// The atom hashes are only used to index the table, so they are never exposed.
+NODISCARD static u32 hash_atom_string(StringView view)
+{
+    return static_cast<u32>(hash_bytes(view.characters(), view.byte_count()));
+}
+
+//
+// The table has two parts:
+//   - The entries, that store the view of each interned string. They are indexed by the atom id and stored in
+//     fixed-size chunks, that are never moved or released, so resolving an atom is two loads.
+//   - The index, an open-addressing hash table of atom ids, used to find the atom of a string.
+//     When the index grows, the previous index is kept alive (but no longer updated), since readers might still
+//     probe it. A reader that doesn't find a string in a stale index retries under the lock.
+//
+// Writers are serialized by a mutex. An entry is always fully written before its atom id is published
+// (with release semantics) in the index, so the readers that observe the id also observe the entry.
+//
+class AtomTable
+{
+    AT_MAKE_NONCOPYABLE(AtomTable);
+    AT_MAKE_NONMOVABLE(AtomTable);
+
+public:
+    static constexpr u32 EntriesPerChunkShift = 12;
+    static constexpr u32 EntriesPerChunk = 1 << EntriesPerChunkShift;
+    static constexpr u32 MaxChunkCount = 4096;
+    static constexpr u32 InitialIndexCapacity = 1024;
+
+public:
+    AtomTable();
+    ~AtomTable();
+
+    NODISCARD ErrorOr<u32> try_intern(StringView view);
+
+    NODISCARD ALWAYS_INLINE StringView get_view(u32 id) const
+    {
+        const Entry* chunk = m_chunks[id >> EntriesPerChunkShift].load(std::memory_order_acquire);
+        const Entry& entry = chunk[id & (EntriesPerChunk - 1)];
+        return StringView::from_utf8(entry.characters, entry.byte_count);
+    }
+
+private:
+    struct Entry
+    {
+        const char* characters;
+        usize byte_count;
+        u32 hash;
+    };
+
+    struct Index
+    {
+        Index* previous;
+        // Always a power of two.
+        u32 capacity;
+        // Zero represents an empty slot, as the empty string (atom id zero) is never stored in the index.
+        std::atomic<u32>* slots;
+    };
+
+    NODISCARD bool try_find(const Index* index, StringView view, u32 hash, u32& out_id) const;
+    NODISCARD ErrorOr<Index*> try_allocate_index(u32 capacity);
+    NODISCARD ErrorOr<void> try_grow_index();
+    NODISCARD ALWAYS_INLINE const Entry& get_entry(u32 id) const
+    {
+        return m_chunks[id >> EntriesPerChunkShift].load(std::memory_order_relaxed)[id & (EntriesPerChunk - 1)];
+    }
+
+private:
+    std::atomic<Entry*> m_chunks[MaxChunkCount] = {};
+    std::atomic<Index*> m_index = nullptr;
+
+    // The following members are only accessed while holding the write mutex.
+    std::mutex m_write_mutex;
+    u32 m_atom_count = 0;
+    ArenaAllocator m_string_arena;
+};
+
+AtomTable::AtomTable()
+{
+    // The first chunk is always allocated, as it stores the empty string entry (atom id zero).
+    MUST_ASSIGN(void* chunk, HeapAllocator::try_allocate_from_heap(EntriesPerChunk * sizeof(Entry), alignof(Entry)));
+    Entry* entries = static_cast<Entry*>(chunk);
+    entries[0] = { "", 0, hash_atom_string({}) };
+    m_chunks[0].store(entries, std::memory_order_relaxed);
+    m_atom_count = 1;
+
+    MUST_ASSIGN(Index * index, try_allocate_index(InitialIndexCapacity));
+    m_index.store(index, std::memory_order_release);
+}
+
+AtomTable::~AtomTable()
+{
+    for (u32 chunk_index = 0; chunk_index < MaxChunkCount; ++chunk_index)
+    {
+        Entry* chunk = m_chunks[chunk_index].load(std::memory_order_relaxed);
+        if (chunk)
+            HeapAllocator::release_to_heap(chunk, EntriesPerChunk * sizeof(Entry), alignof(Entry));
+    }
+
+    Index* index = m_index.load(std::memory_order_relaxed);
+    while (index)
+    {
+        Index* previous = index->previous;
+        const usize byte_count = sizeof(Index) + index->capacity * sizeof(std::atomic<u32>);
+        HeapAllocator::release_to_heap(index, byte_count, alignof(Index));
+        index = previous;
+    }
+}
+
+ErrorOr<u32> AtomTable::try_intern(StringView view)
+{
+    if (view.is_empty())
+        return 0;
+
+    const u32 hash = hash_atom_string(view);
+
+    // Fast path, that doesn't acquire the lock.
+    u32 id;
+    if (try_find(m_index.load(std::memory_order_acquire), view, hash, id))
+        return id;
+
+    std::scoped_lock lock(m_write_mutex);
+
+    // The string might have been interned by another thread since the lookup was performed.
+    if (try_find(m_index.load(std::memory_order_relaxed), view, hash, id))
+        return id;
+
+    // Keep the load factor of the index below 3/4.
+    const Index* current_index = m_index.load(std::memory_order_relaxed);
+    if (4 * static_cast<u64>(m_atom_count) >= 3 * static_cast<u64>(current_index->capacity))
+        TRY(try_grow_index());
+
+    id = m_atom_count;
+    const u32 chunk_index = id >> EntriesPerChunkShift;
+    if (chunk_index >= MaxChunkCount)
+        return Error::Code::OutOfMemory;
+
+    Entry* chunk = m_chunks[chunk_index].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+        const usize byte_count = EntriesPerChunk * sizeof(Entry);
+        TRY_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(byte_count, alignof(Entry)));
+        chunk = static_cast<Entry*>(memory);
+        m_chunks[chunk_index].store(chunk, std::memory_order_release);
+    }
+
+    // The interned strings are null-terminated, so that they can be passed to APIs that expect C strings.
+    TRY_ASSIGN(void* characters, m_string_arena.try_allocate(view.byte_count() + 1, 1));
+    copy_memory(characters, view.characters(), view.byte_count());
+    static_cast<char*>(characters)[view.byte_count()] = 0;
+
+    chunk[id & (EntriesPerChunk - 1)] = { static_cast<const char*>(characters), view.byte_count(), hash };
+    ++m_atom_count;
+
+    const Index* index = m_index.load(std::memory_order_relaxed);
+    const u32 mask = index->capacity - 1;
+    for (u32 slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        if (index->slots[slot].load(std::memory_order_relaxed) == 0)
+        {
+            index->slots[slot].store(id, std::memory_order_release);
+            break;
+        }
+    }
+
+    return id;
+}
+
+bool AtomTable::try_find(const Index* index, StringView view, u32 hash, u32& out_id) const
+{
+    const u32 mask = index->capacity - 1;
+    for (u32 slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        const u32 id = index->slots[slot].load(std::memory_order_acquire);
+        if (id == 0)
+            return false;
+
+        const Entry& entry = get_entry(id);
+        if (entry.hash == hash && entry.byte_count == view.byte_count() &&
+            std::memcmp(entry.characters, view.characters(), view.byte_count()) == 0)
+        {
+            out_id = id;
+            return true;
+        }
+    }
+}
+
+ErrorOr<AtomTable::Index*> AtomTable::try_allocate_index(u32 capacity)
+{
+    const usize byte_count = sizeof(Index) + capacity * sizeof(std::atomic<u32>);
+    TRY_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(byte_count, alignof(Index)));
+
+    Index* index = static_cast<Index*>(memory);
+    index->previous = nullptr;
+    index->capacity = capacity;
+    index->slots = reinterpret_cast<std::atomic<u32>*>(index + 1);
+    for (u32 slot = 0; slot < capacity; ++slot)
+        new (&index->slots[slot]) std::atomic<u32>(0);
+    return index;
+}
+
+ErrorOr<void> AtomTable::try_grow_index()
+{
+    Index* current_index = m_index.load(std::memory_order_relaxed);
+    TRY_ASSIGN(Index * new_index, try_allocate_index(2 * current_index->capacity));
+    new_index->previous = current_index;
+
+    const u32 mask = new_index->capacity - 1;
+    for (u32 id = 1; id < m_atom_count; ++id)
+    {
+        u32 slot = get_entry(id).hash & mask;
+        while (new_index->slots[slot].load(std::memory_order_relaxed) != 0)
+            slot = (slot + 1) & mask;
+        new_index->slots[slot].store(id, std::memory_order_relaxed);
+    }
+
+    m_index.store(new_index, std::memory_order_release);
+    return {};
+}
+
+static AtomTable& get_atom_table()
+{
+    static AtomTable atom_table;
+    return atom_table;
+}
+
+ErrorOr<Atom> Atom::try_create(StringView view)
+{
+    TRY_ASSIGN(const u32 id, get_atom_table().try_intern(view));
+    return Atom(id);
+}
+
+Atom Atom::create(StringView view)
+{
+    MUST_ASSIGN(const u32 id, get_atom_table().try_intern(view));
+    return Atom(id);
+}
+
+StringView Atom::to_view() const
+{
+    return get_atom_table().get_view(m_id);
+}
+
+} // namespace AT
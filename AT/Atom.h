@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Error.h"
+#include "AT/StringView.h"
+#include "AT/TypeTraits.h"
+
+namespace AT
+{
+
+//
+// Compact (32-bit) handle to an interned string.
+// All atoms are stored in a global table, that contains a single copy of each distinct string.
+// Thus, two atoms are equal if and only if the strings they were created from are equal, and
+// comparing them is a single integer comparison. The interned strings live until the application
+// exits, so the views returned by an atom never dangle.
+//
+// Atoms can be created from and resolved to views on multiple threads simultaneously. Looking up
+// a string that is already interned and resolving an atom never acquire a lock.
+//
+class Atom
+{
+public:
+    // The default atom represents the empty string.
+    ALWAYS_INLINE constexpr Atom()
+        : m_id(0)
+    {
+    }
+
+    // Returns the atom of the given string, interning a copy of the string if it is not already interned.
+    NODISCARD AT_API static ErrorOr<Atom> try_create(StringView view);
+    NODISCARD AT_API static Atom create(StringView view);
+
+public:
+    // The returned view is null-terminated (the byte after the view is always zero).
+    NODISCARD AT_API StringView to_view() const;
+
+    NODISCARD ALWAYS_INLINE u32 id() const { return m_id; }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_id == 0); }
+
+    NODISCARD ALWAYS_INLINE bool operator==(Atom other) const { return (m_id == other.m_id); }
+    NODISCARD ALWAYS_INLINE bool operator!=(Atom other) const { return (m_id != other.m_id); }
+
+private:
+    ALWAYS_INLINE explicit Atom(u32 id)
+        : m_id(id)
+    {
+    }
+
+private:
+    u32 m_id;
+};
+
+template<>
+struct TypeTraits<Atom>
+{
+    NODISCARD ALWAYS_INLINE static u64 get_hash(const Atom& atom) { return hash_integer(atom.id()); }
+};
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::Atom;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Allocator.h"
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/String.h"
+#include "AT/Vector.h"
+
+#include <cstdio>
+
+//
+// Measures the allocation throughput of the heap, the arena and the pool allocators. Each batch allocates a number of
+// blocks and then frees all of them: one by one for the heap and the pool, and with a single reset to a marker for
+// the arena. The frame scratch case builds the containers of a UI frame (small vectors and strings that spill to the
+// heap), either from the default heap path or from the thread scratch arena.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize BatchAllocationCount = 1024;
+constexpr usize BlockAlignment = 16;
+
+// The block sizes cycle through these values, so that the mixed sizes case doesn't use a single size class.
+constexpr usize MixedBlockSizes[] = { 16, 48, 24, 128, 64, 256, 32, 96 };
+constexpr usize MixedBlockSizeCount = sizeof(MixedBlockSizes) / sizeof(MixedBlockSizes[0]);
+
+NODISCARD ALWAYS_INLINE static inline usize get_block_size(usize allocation_index, bool use_mixed_sizes)
+{
+    return use_mixed_sizes ? MixedBlockSizes[allocation_index % MixedBlockSizeCount] : 64;
+}
+
+NODISCARD static f64 measure_heap_batch(bool use_mixed_sizes)
+{
+    void* blocks[BatchAllocationCount];
+    return measure_nanoseconds_per_call(
+        [&blocks, use_mixed_sizes]
+        {
+            for (usize index = 0; index < BatchAllocationCount; ++index)
+            {
+                const usize block_size = get_block_size(index, use_mixed_sizes);
+                MUST_ASSIGN(blocks[index], HeapAllocator::try_allocate_from_heap(block_size, BlockAlignment));
+                do_not_optimize(blocks[index]);
+            }
+            for (usize index = 0; index < BatchAllocationCount; ++index)
+            {
+                const usize block_size = get_block_size(index, use_mixed_sizes);
+                HeapAllocator::release_to_heap(blocks[index], block_size, BlockAlignment);
+            }
+        }
+    );
+}
+
+NODISCARD static f64 measure_arena_batch(bool use_mixed_sizes)
+{
+    ArenaAllocator arena;
+    return measure_nanoseconds_per_call(
+        [&arena, use_mixed_sizes]
+        {
+            ScopedArenaMarker marker(arena);
+            for (usize index = 0; index < BatchAllocationCount; ++index)
+            {
+                const usize block_size = get_block_size(index, use_mixed_sizes);
+                MUST_ASSIGN(void* block, arena.try_allocate(block_size, BlockAlignment));
+                do_not_optimize(block);
+            }
+        }
+    );
+}
+
+NODISCARD static f64 measure_pool_batch()
+{
+    PoolAllocator pool(64, BlockAlignment);
+    void* blocks[BatchAllocationCount];
+    return measure_nanoseconds_per_call(
+        [&pool, &blocks]
+        {
+            for (usize index = 0; index < BatchAllocationCount; ++index)
+            {
+                MUST_ASSIGN(blocks[index], pool.try_allocate(64, BlockAlignment));
+                do_not_optimize(blocks[index]);
+            }
+            for (usize index = 0; index < BatchAllocationCount; ++index)
+                pool.release(blocks[index], 64, BlockAlignment);
+        }
+    );
+}
+
+// Builds the scratch containers of a frame: a small vector of indices and a string for each of the widgets.
+static void build_frame(Allocator* allocator)
+{
+    constexpr usize WidgetCount = 256;
+    constexpr StringView WidgetName = "Settings.Appearance.ThemeSelector.Dropdown"sv;
+
+    for (usize widget_index = 0; widget_index < WidgetCount; ++widget_index)
+    {
+        Vector<u32> child_indices(allocator);
+        for (u32 child_index = 0; child_index < 12; ++child_index)
+            MUST(child_indices.try_push_back(child_index));
+
+        String name(WidgetName, allocator);
+        do_not_optimize(child_indices);
+        do_not_optimize(name);
+    }
+}
+
+static void run()
+{
+    std::printf("%-40s %12s\n", "Case (1024 allocations per batch)", "ns/alloc");
+    std::printf("%-40s %12.2f\n", "heap, 64 bytes", measure_heap_batch(false) / BatchAllocationCount);
+    std::printf("%-40s %12.2f\n", "arena, 64 bytes", measure_arena_batch(false) / BatchAllocationCount);
+    std::printf("%-40s %12.2f\n", "pool, 64 bytes", measure_pool_batch() / BatchAllocationCount);
+    std::printf("%-40s %12.2f\n", "heap, mixed sizes", measure_heap_batch(true) / BatchAllocationCount);
+    std::printf("%-40s %12.2f\n", "arena, mixed sizes", measure_arena_batch(true) / BatchAllocationCount);
+
+    ArenaAllocator& scratch_arena = get_thread_scratch_arena();
+    const f64 heap_frame_time = measure_nanoseconds_per_call([] { build_frame(nullptr); });
+    const f64 arena_frame_time = measure_nanoseconds_per_call(
+        [&scratch_arena]
+        {
+            ScopedArenaMarker marker(scratch_arena);
+            build_frame(&scratch_arena);
+        }
+    );
+
+    std::printf("\n%-40s %12s\n", "Case (256 widgets per frame)", "us/frame");
+    std::printf("%-40s %12.2f\n", "frame scratch, heap", heap_frame_time / 1000);
+    std::printf("%-40s %12.2f\n", "frame scratch, thread scratch arena", arena_frame_time / 1000);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Platform.h"
+
+#if AT_COMPILER_MSVC
+    #include <intrin.h>
+#endif // AT_COMPILER_MSVC
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+// Each measurement round runs the callable for at least this long, so that the cost of reading the clock is
+// negligible.
+constexpr u64 MinimumRoundNanoseconds = 20'000'000;
+// The fastest of the rounds is reported, as the slower ones were disturbed by the rest of the system.
+constexpr u32 RoundCount = 3;
+
+//
+// Makes the compiler assume that the object is read and written through an unknown pointer, so the computation of its
+// value (or the writes to the memory it points to) is not optimized away.
+//
+template<typename T>
+ALWAYS_INLINE inline void do_not_optimize(T& value)
+{
+#if AT_COMPILER_MSVC
+    static volatile void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r"(&value) : "memory");
+#endif // AT_COMPILER_MSVC
+}
+
+//
+// Returns the time a call to the callable takes, in nanoseconds. The calls are batched, doubling the batch size until
+// a batch takes long enough to be measured accurately.
+//
+template<typename Callable>
+NODISCARD f64 measure_nanoseconds_per_call(Callable&& callable)
+{
+    u64 call_count = 1;
+    f64 fastest_nanoseconds_per_call = 0;
+    for (u32 round_index = 0; round_index < RoundCount;)
+    {
+        const u64 begin_time = get_monotonic_time_in_nanoseconds();
+        for (u64 call_index = 0; call_index < call_count; ++call_index)
+            callable();
+        const u64 elapsed_time = get_monotonic_time_in_nanoseconds() - begin_time;
+
+        if (elapsed_time < MinimumRoundNanoseconds)
+        {
+            call_count *= 2;
+            continue;
+        }
+
+        const f64 nanoseconds_per_call = static_cast<f64>(elapsed_time) / static_cast<f64>(call_count);
+        if (round_index == 0 || nanoseconds_per_call < fastest_nanoseconds_per_call)
+            fastest_nanoseconds_per_call = nanoseconds_per_call;
+        ++round_index;
+    }
+    return fastest_nanoseconds_per_call;
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
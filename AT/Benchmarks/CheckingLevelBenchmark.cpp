@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/StringView.h"
+#include "AT/Vector.h"
+
+#include <cstdio>
+
+//
+// Measures the loops that index a container in its hot path: the dot product of two Vector<u16> and the count of the
+// equal bytes of two string views. Each loop uses the bounds-checked accessors and the unchecked ones, so comparing
+// the builds with the Full, Cold and Assume checking levels (the CHECKING_LEVEL CMake option) shows what the checks
+// cost, and whether the loops are vectorized when the checks are off. The times are per element.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize ElementCount = 64 * 1024;
+
+NODISCARD static const char* get_checking_level_name()
+{
+#if AT_CHECKING_LEVEL == AT_CHECKING_LEVEL_FULL
+    return "Full";
+#elif AT_CHECKING_LEVEL == AT_CHECKING_LEVEL_COLD
+    return "Cold";
+#else
+    return "Assume";
+#endif // AT_CHECKING_LEVEL
+}
+
+NODISCARD static Vector<u16> generate_elements(u16 seed)
+{
+    Vector<u16> elements;
+    MUST(elements.try_ensure_capacity(ElementCount));
+    for (usize index = 0; index < ElementCount; ++index)
+        MUST(elements.try_push_back(static_cast<u16>(index * 7 + seed)));
+    return elements;
+}
+
+NODISCARD static Vector<char> generate_bytes(usize period)
+{
+    Vector<char> bytes;
+    MUST(bytes.try_ensure_capacity(ElementCount));
+    for (usize index = 0; index < ElementCount; ++index)
+        MUST(bytes.try_push_back(static_cast<char>('a' + index % period)));
+    return bytes;
+}
+
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_element(Callable&& callable)
+{
+    return measure_nanoseconds_per_call(callable) / static_cast<f64>(ElementCount);
+}
+
+static void run()
+{
+    const Vector<u16> lhs = generate_elements(1);
+    const Vector<u16> rhs = generate_elements(3);
+
+    const f64 dot_product_checked = measure_nanoseconds_per_element(
+        [&]
+        {
+            u64 sum = 0;
+            for (usize index = 0; index < lhs.count(); ++index)
+                sum += static_cast<u32>(lhs[index]) * rhs[index];
+            do_not_optimize(sum);
+        }
+    );
+    const f64 dot_product_unchecked = measure_nanoseconds_per_element(
+        [&]
+        {
+            u64 sum = 0;
+            for (usize index = 0; index < lhs.count(); ++index)
+                sum += static_cast<u32>(lhs.unchecked_at(index)) * rhs.unchecked_at(index);
+            do_not_optimize(sum);
+        }
+    );
+
+    const Vector<char> lhs_bytes = generate_bytes(26);
+    const Vector<char> rhs_bytes = generate_bytes(13);
+    const StringView lhs_view = StringView::from_utf8(lhs_bytes.elements(), lhs_bytes.count());
+    const StringView rhs_view = StringView::from_utf8(rhs_bytes.elements(), rhs_bytes.count());
+
+    const f64 byte_compare_checked = measure_nanoseconds_per_element(
+        [&]
+        {
+            usize equal_count = 0;
+            for (usize offset = 0; offset < lhs_view.byte_count(); ++offset)
+                equal_count += (lhs_view.at_offset_in_bytes(offset) == rhs_view.at_offset_in_bytes(offset)) ? 1 : 0;
+            do_not_optimize(equal_count);
+        }
+    );
+    const f64 byte_compare_unchecked = measure_nanoseconds_per_element(
+        [&]
+        {
+            usize equal_count = 0;
+            for (usize offset = 0; offset < lhs_view.byte_count(); ++offset)
+            {
+                const bool is_equal =
+                    lhs_view.unchecked_at_offset_in_bytes(offset) == rhs_view.unchecked_at_offset_in_bytes(offset);
+                equal_count += is_equal ? 1 : 0;
+            }
+            do_not_optimize(equal_count);
+        }
+    );
+
+    std::printf("Checking level: %s\n", get_checking_level_name());
+    std::printf("%-26s %10s %10s\n", "Loop", "checked", "unchecked");
+    std::printf("%-26s %10.3f %10.3f\n", "Vector<u16> dot product", dot_product_checked, dot_product_unchecked);
+    std::printf("%-26s %10.3f %10.3f\n", "StringView byte compare", byte_compare_checked, byte_compare_unchecked);
+    std::printf("(ns/element)\n");
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/Format.h"
+#include "AT/Vector.h"
+
+#include <charconv>
+#include <cstdio>
+
+//
+// Measures the formatting of an f64 into a stack buffer with format_to(), against std::to_chars() and snprintf(). The
+// shortest round-trip representation ("{}") is compared with the shortest std::to_chars() and with "%.17g", which is
+// what snprintf() needs to round-trip. The fixed notation ("{:.2f}") is compared with the same notation of both. The
+// values are uniformly distributed in [0, 1000). The times are per value.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize ValueCount = 4096;
+
+// SplitMix64, with a fixed seed so that every run uses the same values.
+NODISCARD static u64 get_next_random(u64& state)
+{
+    u64 value = (state += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+NODISCARD static Vector<f64> generate_values()
+{
+    u64 state = 1;
+    Vector<f64> values;
+    MUST(values.try_ensure_capacity(ValueCount));
+    for (usize index = 0; index < ValueCount; ++index)
+    {
+        // The top 53 bits give a uniformly distributed value in [0, 1), with all the mantissa bits used.
+        const f64 unit_value = static_cast<f64>(get_next_random(state) >> 11) * 0x1.0p-53;
+        MUST(values.try_push_back(unit_value * 1000.0));
+    }
+    return values;
+}
+
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_value(const Vector<f64>& values, Callable&& format_value)
+{
+    const f64 time = measure_nanoseconds_per_call(
+        [&values, &format_value]
+        {
+            char buffer[64];
+            usize byte_count = 0;
+            for (const f64 value : values)
+            {
+                byte_count += format_value(buffer, sizeof(buffer), value);
+                do_not_optimize(buffer);
+            }
+            do_not_optimize(byte_count);
+        }
+    );
+    return time / static_cast<f64>(values.count());
+}
+
+static void run()
+{
+    const Vector<f64> values = generate_values();
+
+    const f64 shortest_format_to = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, f64 value)
+        { return format_to(Span<char>(buffer, buffer_size), "{}"sv, value).written_byte_count; }
+    );
+    const f64 shortest_to_chars = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, f64 value)
+        { return static_cast<usize>(std::to_chars(buffer, buffer + buffer_size, value).ptr - buffer); }
+    );
+    const f64 shortest_snprintf = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, f64 value)
+        { return static_cast<usize>(std::snprintf(buffer, buffer_size, "%.17g", value)); }
+    );
+
+    const f64 fixed_format_to = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, f64 value)
+        { return format_to(Span<char>(buffer, buffer_size), "{:.2f}"sv, value).written_byte_count; }
+    );
+    const f64 fixed_to_chars = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, f64 value)
+        {
+            const std::to_chars_result result =
+                std::to_chars(buffer, buffer + buffer_size, value, std::chars_format::fixed, 2);
+            return static_cast<usize>(result.ptr - buffer);
+        }
+    );
+    const f64 fixed_snprintf = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, f64 value)
+        { return static_cast<usize>(std::snprintf(buffer, buffer_size, "%.2f", value)); }
+    );
+
+    std::printf("%-10s %12s %12s %12s\n", "Specifier", "format_to", "to_chars", "snprintf");
+    std::printf("%-10s %12.1f %12.1f %12.1f\n", "{}", shortest_format_to, shortest_to_chars, shortest_snprintf);
+    std::printf("%-10s %12.1f %12.1f %12.1f\n", "{:.2f}", fixed_format_to, fixed_to_chars, fixed_snprintf);
+    std::printf("(ns/value)\n");
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
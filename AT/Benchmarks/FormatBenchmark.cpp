@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/Format.h"
+
+#include <cstdio>
+
+//
+// Measures dbgln-style calls: a format string with four parameters (integers and a string view) and a result of about
+// 60 bytes, formatted into a new String. The same message is formatted with snprintf into a stack buffer (then copied
+// into a String) as a reference. Only format() is used, so this file also builds against the runtime-parsed format
+// strings that preceded the compile-time parsed ones.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize MessageCount = 4;
+constexpr StringView WidgetNames[MessageCount] = { "toolbar"sv, "properties_panel"sv, "viewport"sv, "console"sv };
+
+static void run()
+{
+    u64 frame_index = 1'000'000;
+    u32 message_index = 0;
+
+    const f64 format_time = measure_nanoseconds_per_call(
+        [&]
+        {
+            const StringView widget_name = WidgetNames[message_index++ % MessageCount];
+            String message = format("[frame {}] layout of '{}' took {} us, {} children\n"sv, frame_index++,
+                                    widget_name, static_cast<u32>(frame_index % 977), static_cast<i32>(message_index));
+            do_not_optimize(message);
+        }
+    );
+
+    const f64 snprintf_time = measure_nanoseconds_per_call(
+        [&]
+        {
+            const StringView widget_name = WidgetNames[message_index++ % MessageCount];
+            char buffer[256];
+            const int byte_count =
+                std::snprintf(buffer, sizeof(buffer), "[frame %llu] layout of '%.*s' took %u us, %d children\n",
+                              static_cast<unsigned long long>(frame_index++),
+                              static_cast<int>(widget_name.byte_count()), widget_name.characters(),
+                              static_cast<u32>(frame_index % 977), static_cast<i32>(message_index));
+            String message = String(StringView::from_utf8(buffer, static_cast<usize>(byte_count)));
+            do_not_optimize(message);
+        }
+    );
+
+    const String sample = format("[frame {}] layout of '{}' took {} us, {} children\n"sv, u64(1'000'000),
+                                 WidgetNames[1], u32(512), i32(12));
+    std::printf("Message: %.*s", static_cast<int>(sample.byte_count() - 1), sample.characters());
+    std::printf("%-28s %10s\n", "Call", "ns/call");
+    std::printf("%-28s %10.1f\n", "format()", format_time);
+    std::printf("%-28s %10.1f\n", "snprintf() + String", snprintf_time);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
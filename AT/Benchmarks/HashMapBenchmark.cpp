@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/HashMap.h"
+#include "AT/Vector.h"
+
+#include <cstdio>
+#include <unordered_map>
+
+//
+// Measures HashMap<u64, u64> against std::unordered_map, for 1K to 10M entries: inserting all keys into an empty map,
+// looking up all present keys (hits) and looking up the same number of absent keys (misses). The keys are random, so
+// the lookups visit the table in random order. The times are per key.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize EntryCounts[] = { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 };
+
+// SplitMix64, with fixed seeds so that every run uses the same keys.
+NODISCARD static u64 get_next_random(u64& state)
+{
+    u64 value = (state += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+NODISCARD static Vector<u64> generate_keys(usize count, u64 seed)
+{
+    Vector<u64> keys;
+    MUST(keys.try_ensure_capacity(count));
+    for (usize index = 0; index < count; ++index)
+        MUST(keys.try_push_back(get_next_random(seed)));
+    return keys;
+}
+
+struct MapMeasurement
+{
+    f64 insert_time;
+    f64 hit_time;
+    f64 miss_time;
+};
+
+NODISCARD static MapMeasurement measure_hash_map(const Vector<u64>& keys, const Vector<u64>& absent_keys)
+{
+    MapMeasurement measurement;
+    measurement.insert_time = measure_nanoseconds_per_call(
+        [&keys]
+        {
+            HashMap<u64, u64> map;
+            for (const u64 key : keys)
+                MUST(map.try_set(key, key));
+            do_not_optimize(map);
+        }
+    );
+
+    HashMap<u64, u64> map;
+    for (const u64 key : keys)
+        MUST(map.try_set(key, key));
+
+    measurement.hit_time = measure_nanoseconds_per_call(
+        [&map, &keys]
+        {
+            u64 sum = 0;
+            for (const u64 key : keys)
+                sum += *map.find(key);
+            do_not_optimize(sum);
+        }
+    );
+    measurement.miss_time = measure_nanoseconds_per_call(
+        [&map, &absent_keys]
+        {
+            usize found_count = 0;
+            for (const u64 key : absent_keys)
+                found_count += map.contains(key) ? 1 : 0;
+            do_not_optimize(found_count);
+        }
+    );
+    return measurement;
+}
+
+NODISCARD static MapMeasurement measure_std_unordered_map(const Vector<u64>& keys, const Vector<u64>& absent_keys)
+{
+    MapMeasurement measurement;
+    measurement.insert_time = measure_nanoseconds_per_call(
+        [&keys]
+        {
+            std::unordered_map<u64, u64> map;
+            for (const u64 key : keys)
+                map[key] = key;
+            do_not_optimize(map);
+        }
+    );
+
+    std::unordered_map<u64, u64> map;
+    for (const u64 key : keys)
+        map[key] = key;
+
+    measurement.hit_time = measure_nanoseconds_per_call(
+        [&map, &keys]
+        {
+            u64 sum = 0;
+            for (const u64 key : keys)
+                sum += map.find(key)->second;
+            do_not_optimize(sum);
+        }
+    );
+    measurement.miss_time = measure_nanoseconds_per_call(
+        [&map, &absent_keys]
+        {
+            usize found_count = 0;
+            for (const u64 key : absent_keys)
+                found_count += map.count(key);
+            do_not_optimize(found_count);
+        }
+    );
+    return measurement;
+}
+
+static void run()
+{
+    std::printf("%10s  %28s  %28s\n", "", "HashMap (ns/key)", "std::unordered_map (ns/key)");
+    std::printf("%10s  %8s %9s %9s  %8s %9s %9s\n", "Entries", "insert", "hit", "miss", "insert", "hit", "miss");
+
+    for (const usize entry_count : EntryCounts)
+    {
+        const Vector<u64> keys = generate_keys(entry_count, 1);
+        const Vector<u64> absent_keys = generate_keys(entry_count, 2);
+        const f64 key_count = static_cast<f64>(entry_count);
+
+        const MapMeasurement map = measure_hash_map(keys, absent_keys);
+        const MapMeasurement std_map = measure_std_unordered_map(keys, absent_keys);
+        std::printf("%10zu  %8.1f %9.1f %9.1f  %8.1f %9.1f %9.1f\n", entry_count, map.insert_time / key_count,
+                    map.hit_time / key_count, map.miss_time / key_count, std_map.insert_time / key_count,
+                    std_map.hit_time / key_count, std_map.miss_time / key_count);
+    }
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/Format.h"
+#include "AT/Vector.h"
+
+#include <charconv>
+#include <cstdio>
+
+//
+// Measures the formatting of a u64 into a stack buffer with format_to(), against snprintf() and std::to_chars(), for
+// the "{}", "{:#x}" and "{:20}" specifiers. The values are random, with a random bit length, so that every digit count
+// of the full u64 range is formatted. The times are per value.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize ValueCount = 4096;
+
+// SplitMix64, with a fixed seed so that every run uses the same values.
+NODISCARD static u64 get_next_random(u64& state)
+{
+    u64 value = (state += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+NODISCARD static Vector<u64> generate_values()
+{
+    u64 state = 1;
+    Vector<u64> values;
+    MUST(values.try_ensure_capacity(ValueCount));
+    for (usize index = 0; index < ValueCount; ++index)
+    {
+        // Shifting by a random amount gives every bit length (and thus every digit count) the same probability.
+        const u64 value = get_next_random(state);
+        MUST(values.try_push_back(value >> (get_next_random(state) % 64)));
+    }
+    return values;
+}
+
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_value(const Vector<u64>& values, Callable&& format_value)
+{
+    const f64 time = measure_nanoseconds_per_call(
+        [&values, &format_value]
+        {
+            char buffer[32];
+            usize byte_count = 0;
+            for (const u64 value : values)
+            {
+                byte_count += format_value(buffer, sizeof(buffer), value);
+                do_not_optimize(buffer);
+            }
+            do_not_optimize(byte_count);
+        }
+    );
+    return time / static_cast<f64>(values.count());
+}
+
+static void print_row(const char* specifier, f64 format_to_time, f64 snprintf_time, f64 to_chars_time)
+{
+    std::printf("%-10s %12.1f %12.1f", specifier, format_to_time, snprintf_time);
+    if (to_chars_time > 0)
+        std::printf(" %12.1f\n", to_chars_time);
+    else
+        std::printf(" %12s\n", "-");
+}
+
+static void run()
+{
+    const Vector<u64> values = generate_values();
+
+    const f64 decimal_format_to = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        { return format_to(Span<char>(buffer, buffer_size), "{}"sv, value).written_byte_count; }
+    );
+    const f64 decimal_snprintf = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        {
+            const int byte_count = std::snprintf(buffer, buffer_size, "%llu", static_cast<unsigned long long>(value));
+            return static_cast<usize>(byte_count);
+        }
+    );
+    const f64 decimal_to_chars = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        { return static_cast<usize>(std::to_chars(buffer, buffer + buffer_size, value).ptr - buffer); }
+    );
+
+    const f64 hexadecimal_format_to = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        { return format_to(Span<char>(buffer, buffer_size), "{:#x}"sv, value).written_byte_count; }
+    );
+    const f64 hexadecimal_snprintf = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        {
+            const int byte_count = std::snprintf(buffer, buffer_size, "%#llx", static_cast<unsigned long long>(value));
+            return static_cast<usize>(byte_count);
+        }
+    );
+    // std::to_chars() has no prefix option, so the "0x" prefix is written separately.
+    const f64 hexadecimal_to_chars = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        {
+            buffer[0] = '0';
+            buffer[1] = 'x';
+            return static_cast<usize>(std::to_chars(buffer + 2, buffer + buffer_size, value, 16).ptr - buffer);
+        }
+    );
+
+    const f64 width_format_to = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        { return format_to(Span<char>(buffer, buffer_size), "{:20}"sv, value).written_byte_count; }
+    );
+    const f64 width_snprintf = measure_nanoseconds_per_value(
+        values,
+        [](char* buffer, usize buffer_size, u64 value)
+        {
+            const int byte_count = std::snprintf(buffer, buffer_size, "%20llu", static_cast<unsigned long long>(value));
+            return static_cast<usize>(byte_count);
+        }
+    );
+
+    std::printf("%-10s %12s %12s %12s\n", "Specifier", "format_to", "snprintf", "to_chars");
+    print_row("{}", decimal_format_to, decimal_snprintf, decimal_to_chars);
+    print_row("{:#x}", hexadecimal_format_to, hexadecimal_snprintf, hexadecimal_to_chars);
+    // std::to_chars() does not pad, so it has no equivalent for the width specifier.
+    print_row("{:20}", width_format_to, width_snprintf, 0);
+    std::printf("(ns/value)\n");
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
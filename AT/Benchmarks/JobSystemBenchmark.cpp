@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/JobSystem.h"
+
+#include <cstdio>
+
+//
+// Measures the job system for 1 to 64 workers. The workers beyond the number of logical cores are not pinned, so they
+// share the cores with the other workers. The scheduling overhead is the time it takes to schedule a batch of empty
+// jobs from a worker and to wait until they all completed, per job. The fork-join workload computes fib(25)
+// recursively, with a job for every call above the serial cutoff, and is compared with the serial computation.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr u32 WorkerCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+constexpr u32 EmptyJobCount = 1024;
+
+constexpr u32 FibonacciIndex = 25;
+// The calls for smaller indices are computed serially, so that the jobs are not much smaller than the overhead.
+constexpr u32 FibonacciSerialCutoff = 12;
+
+NODISCARD static u64 compute_fibonacci_serially(u32 index)
+{
+    if (index < 2)
+        return index;
+    return compute_fibonacci_serially(index - 1) + compute_fibonacci_serially(index - 2);
+}
+
+static void compute_fibonacci(u32 index, u64* result)
+{
+    if (index <= FibonacciSerialCutoff)
+    {
+        *result = compute_fibonacci_serially(index);
+        return;
+    }
+
+    u64 first_result;
+    u64 second_result;
+    JobCounter counter;
+    schedule_job([index, &first_result] { compute_fibonacci(index - 1, &first_result); }, &counter);
+    compute_fibonacci(index - 2, &second_result);
+    wait_for_counter(counter);
+    *result = first_result + second_result;
+}
+
+NODISCARD static f64 measure_empty_job_nanoseconds()
+{
+    const f64 batch_time = measure_nanoseconds_per_call(
+        []
+        {
+            JobCounter counter;
+            for (u32 job_index = 0; job_index < EmptyJobCount; ++job_index)
+                schedule_job([] {}, &counter);
+            wait_for_counter(counter);
+        }
+    );
+    return batch_time / static_cast<f64>(EmptyJobCount);
+}
+
+NODISCARD static f64 measure_fibonacci_milliseconds()
+{
+    const f64 time = measure_nanoseconds_per_call(
+        []
+        {
+            u64 result;
+            compute_fibonacci(FibonacciIndex, &result);
+            do_not_optimize(result);
+        }
+    );
+    return time / 1'000'000.0;
+}
+
+static void measure_with_worker_count(u32 worker_count, f64 serial_milliseconds)
+{
+    initialize_job_system(worker_count);
+    const f64 empty_job_time = measure_empty_job_nanoseconds();
+    const f64 fibonacci_time = measure_fibonacci_milliseconds();
+    shutdown_job_system();
+
+    std::printf("%8u %16.1f %14.3f %10.2fx\n", worker_count, empty_job_time, fibonacci_time,
+                serial_milliseconds / fibonacci_time);
+}
+
+static void run()
+{
+    const u32 core_count = get_logical_core_count();
+    const f64 serial_time = measure_nanoseconds_per_call(
+        []
+        {
+            u64 result = compute_fibonacci_serially(FibonacciIndex);
+            do_not_optimize(result);
+        }
+    );
+    const f64 serial_milliseconds = serial_time / 1'000'000.0;
+
+    std::printf("Logical cores: %u, serial fib(%u): %.3f ms\n", core_count, FibonacciIndex, serial_milliseconds);
+    std::printf("%8s %16s %14s %11s\n", "Workers", "empty job (ns)", "fib(25) (ms)", "speedup");
+
+    for (const u32 worker_count : WorkerCounts)
+        measure_with_worker_count(worker_count, serial_milliseconds);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
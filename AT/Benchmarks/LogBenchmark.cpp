@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/Log.h"
+
+#include <cstdio>
+
+//
+// Measures the time a dbgln() call takes on the logging thread, for a message with an integer, a floating-point or a
+// string view parameter. In bursts, 256 messages are logged and only the calls are timed, while the background thread
+// writes them between the bursts. When sustained, the messages are logged back to back, so the ring buffer fills up
+// and the logging thread eventually writes the pending messages itself. As a reference, the same messages are
+// formatted and written synchronously, like the logger did before it was asynchronous.
+//
+// The log is written to the null device, so that the terminal doesn't limit the throughput. The results are printed
+// to the standard error stream.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize BurstMessageCount = 256;
+
+#if AT_PLATFORM_WINDOWS
+constexpr const char* NullDevicePath = "NUL";
+#else
+constexpr const char* NullDevicePath = "/dev/null";
+#endif // AT_PLATFORM_WINDOWS
+
+//
+// Returns the time a call to the callable takes, when it is called in bursts. Only the calls are timed, not the time
+// it takes to write the log between the bursts.
+//
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_burst_call(Callable&& callable)
+{
+    f64 fastest_nanoseconds_per_call = 0;
+    for (u32 round_index = 0; round_index < RoundCount; ++round_index)
+    {
+        u64 elapsed_time = 0;
+        u64 call_count = 0;
+        while (elapsed_time < MinimumRoundNanoseconds)
+        {
+            const u64 begin_time = get_monotonic_time_in_nanoseconds();
+            for (usize call_index = 0; call_index < BurstMessageCount; ++call_index)
+                callable();
+            elapsed_time += get_monotonic_time_in_nanoseconds() - begin_time;
+            call_count += BurstMessageCount;
+            flush_log();
+        }
+
+        const f64 nanoseconds_per_call = static_cast<f64>(elapsed_time) / static_cast<f64>(call_count);
+        if (round_index == 0 || nanoseconds_per_call < fastest_nanoseconds_per_call)
+            fastest_nanoseconds_per_call = nanoseconds_per_call;
+    }
+    return fastest_nanoseconds_per_call;
+}
+
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_sustained_call(Callable&& callable)
+{
+    const f64 nanoseconds_per_call = measure_nanoseconds_per_call(callable);
+    flush_log();
+    return nanoseconds_per_call;
+}
+
+template<typename... Parameters>
+static void write_synchronously(CheckedFormatString<Parameters...> format_string, const Parameters&... parameters)
+{
+    char buffer[256];
+    const FormatToResult result = format_to(Span<char>(buffer, sizeof(buffer)), format_string, parameters...);
+    std::fwrite(buffer, 1, result.written_byte_count, stdout);
+    std::fflush(stdout);
+}
+
+static void print_row(const char* parameter, f64 burst_time, f64 sustained_time, f64 synchronous_time)
+{
+    std::fprintf(stderr, "%-12s %12.1f %12.1f %14.1f\n", parameter, burst_time, sustained_time, synchronous_time);
+}
+
+static void run()
+{
+    if (std::freopen(NullDevicePath, "w", stdout) == nullptr)
+    {
+        std::fprintf(stderr, "Failed to redirect the standard output to '%s'.\n", NullDevicePath);
+        return;
+    }
+
+    i32 integer_value = 0;
+    f64 floating_point_value = 0.5;
+    const StringView string_value = "properties_panel"sv;
+
+    const auto log_integer = [&] { dbgln("frame {} finished"sv, integer_value++); };
+    const auto log_floating_point = [&] { dbgln("frame took {} ms"sv, floating_point_value += 0.25); };
+    const auto log_string = [&] { dbgln("layout of '{}' finished"sv, string_value); };
+
+    const f64 integer_burst = measure_nanoseconds_per_burst_call(log_integer);
+    const f64 integer_sustained = measure_nanoseconds_per_sustained_call(log_integer);
+    const f64 integer_synchronous =
+        measure_nanoseconds_per_call([&] { write_synchronously("frame {} finished\n"sv, integer_value++); });
+
+    const f64 floating_point_burst = measure_nanoseconds_per_burst_call(log_floating_point);
+    const f64 floating_point_sustained = measure_nanoseconds_per_sustained_call(log_floating_point);
+    const f64 floating_point_synchronous = measure_nanoseconds_per_call(
+        [&] { write_synchronously("frame took {} ms\n"sv, floating_point_value += 0.25); }
+    );
+
+    const f64 string_burst = measure_nanoseconds_per_burst_call(log_string);
+    const f64 string_sustained = measure_nanoseconds_per_sustained_call(log_string);
+    const f64 string_synchronous =
+        measure_nanoseconds_per_call([&] { write_synchronously("layout of '{}' finished\n"sv, string_value); });
+
+    std::fprintf(stderr, "%-12s %12s %12s %14s\n", "Parameter", "burst", "sustained", "synchronous");
+    print_row("i32", integer_burst, integer_sustained, integer_synchronous);
+    print_row("f64", floating_point_burst, floating_point_sustained, floating_point_synchronous);
+    print_row("StringView", string_burst, string_sustained, string_synchronous);
+    std::fprintf(stderr, "(ns/call)\n");
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
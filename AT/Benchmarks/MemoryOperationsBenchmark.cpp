@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Allocator.h"
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/MemoryOperations.h"
+
+#include <cstdio>
+#include <cstring>
+
+//
+// Measures the throughput of copy_memory, move_memory and set_memory against the corresponding libc functions, for
+// every power of two size from 1 byte to 64 MiB. The copies go between two distinct buffers. The moves shift a range
+// by 64 bytes towards the end of the same buffer, which forces a backward copy of overlapping ranges.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize MaximumByteCount = 64 * 1024 * 1024;
+constexpr usize MoveDistance = 64;
+constexpr usize BufferAlignment = 4096;
+
+NODISCARD static f64 get_gigabytes_per_second(usize byte_count, f64 nanoseconds_per_call)
+{
+    return static_cast<f64>(byte_count) / nanoseconds_per_call;
+}
+
+static void run()
+{
+    const usize buffer_byte_count = MaximumByteCount + MoveDistance;
+    MUST_ASSIGN(void* source_memory, HeapAllocator::try_allocate_from_heap(buffer_byte_count, BufferAlignment));
+    MUST_ASSIGN(void* destination_memory, HeapAllocator::try_allocate_from_heap(buffer_byte_count, BufferAlignment));
+    u8* source = static_cast<u8*>(source_memory);
+    u8* destination = static_cast<u8*>(destination_memory);
+
+    // Touch all pages up front, so that no page fault is measured.
+    std::memset(source, 0x5A, buffer_byte_count);
+    std::memset(destination, 0xA5, buffer_byte_count);
+
+    std::printf("%10s  %10s %10s  %10s %10s  %10s %10s\n", "Bytes", "copy", "memcpy", "move", "memmove", "set",
+                "memset");
+    for (usize byte_count = 1; byte_count <= MaximumByteCount; byte_count *= 2)
+    {
+        const f64 copy_time = measure_nanoseconds_per_call(
+            [&]
+            {
+                copy_memory(destination, source, byte_count);
+                do_not_optimize(destination);
+            }
+        );
+        const f64 memcpy_time = measure_nanoseconds_per_call(
+            [&]
+            {
+                std::memcpy(destination, source, byte_count);
+                do_not_optimize(destination);
+            }
+        );
+        const f64 move_time = measure_nanoseconds_per_call(
+            [&]
+            {
+                move_memory(destination + MoveDistance, destination, byte_count);
+                do_not_optimize(destination);
+            }
+        );
+        const f64 memmove_time = measure_nanoseconds_per_call(
+            [&]
+            {
+                std::memmove(destination + MoveDistance, destination, byte_count);
+                do_not_optimize(destination);
+            }
+        );
+        const f64 set_time = measure_nanoseconds_per_call(
+            [&]
+            {
+                set_memory(destination, 0x3C, byte_count);
+                do_not_optimize(destination);
+            }
+        );
+        const f64 memset_time = measure_nanoseconds_per_call(
+            [&]
+            {
+                std::memset(destination, 0x3C, byte_count);
+                do_not_optimize(destination);
+            }
+        );
+
+        std::printf("%10zu  %10.2f %10.2f  %10.2f %10.2f  %10.2f %10.2f\n", byte_count,
+                    get_gigabytes_per_second(byte_count, copy_time), get_gigabytes_per_second(byte_count, memcpy_time),
+                    get_gigabytes_per_second(byte_count, move_time),
+                    get_gigabytes_per_second(byte_count, memmove_time),
+                    get_gigabytes_per_second(byte_count, set_time), get_gigabytes_per_second(byte_count, memset_time));
+    }
+
+    HeapAllocator::release_to_heap(source, buffer_byte_count, BufferAlignment);
+    HeapAllocator::release_to_heap(destination, buffer_byte_count, BufferAlignment);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    std::printf("Throughput in GB/s.\n");
+    AT::Benchmarks::run();
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/ParallelAlgorithms.h"
+
+#include <cmath>
+#include <cstdio>
+
+//
+// Measures the parallel algorithms over 4M elements (parallel_for, parallel_transform, parallel_reduce and
+// parallel_sort), and parallel_for over 64 expensive items, first without the job system (so everything runs
+// serially) and then with 1, 2, 4, 8 and 16 workers. The sort copies the unsorted elements before every call, which
+// is included in its time. The times are in milliseconds per call.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr u32 WorkerCounts[] = { 1, 2, 4, 8, 16 };
+constexpr usize ElementCount = 4 * 1024 * 1024;
+constexpr usize HeavyItemCount = 64;
+constexpr u32 HeavyItemIterationCount = 100'000;
+
+// SplitMix64, with a fixed seed so that every run uses the same elements.
+NODISCARD static u64 get_next_random(u64& state)
+{
+    u64 value = (state += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+// A dependent chain of multiplications, so that the item takes about the same time on every call.
+NODISCARD static u64 compute_heavy_item(u64 seed)
+{
+    u64 value = seed;
+    for (u32 iteration_index = 0; iteration_index < HeavyItemIterationCount; ++iteration_index)
+        value = value * 0x5851F42D4C957F2D + 0x14057B7EF767814F;
+    return value;
+}
+
+struct BenchmarkData
+{
+    Vector<u64> random_elements;
+    Vector<u64> elements;
+    Vector<f32> input_values;
+    Vector<f32> output_values;
+    Vector<u64> heavy_results;
+};
+
+struct AlgorithmTimes
+{
+    f64 for_time;
+    f64 transform_time;
+    f64 reduce_time;
+    f64 sort_time;
+    f64 heavy_time;
+};
+
+template<typename Callable>
+NODISCARD static f64 measure_milliseconds(Callable&& callable)
+{
+    return measure_nanoseconds_per_call(callable) / 1'000'000.0;
+}
+
+NODISCARD static AlgorithmTimes measure_algorithms(BenchmarkData& data)
+{
+    AlgorithmTimes times;
+    times.for_time = measure_milliseconds(
+        [&data] { parallel_for(data.elements, [](u64& element) { element = element * 3 + 1; }); }
+    );
+    times.transform_time = measure_milliseconds(
+        [&data]
+        {
+            parallel_transform(data.input_values, data.output_values, [](f32 value) { return std::sqrt(value); });
+        }
+    );
+    times.reduce_time = measure_milliseconds(
+        [&data]
+        {
+            u64 sum = parallel_reduce(
+                data.elements, u64(0), [](u64 value, u64 element) { return value + element; },
+                [](u64 value, u64 other_value) { return value + other_value; }
+            );
+            do_not_optimize(sum);
+        }
+    );
+    times.sort_time = measure_milliseconds(
+        [&data]
+        {
+            copy_memory(data.elements.elements(), data.random_elements.elements(), ElementCount * sizeof(u64));
+            parallel_sort(data.elements);
+        }
+    );
+    times.heavy_time = measure_milliseconds(
+        [&data]
+        {
+            u64* results = data.heavy_results.elements();
+            parallel_for(HeavyItemCount, [results](usize index) { results[index] = compute_heavy_item(index); });
+            do_not_optimize(results);
+        }
+    );
+
+    return times;
+}
+
+static void print_row(const char* configuration, const AlgorithmTimes& times)
+{
+    std::printf("%-10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", configuration, times.for_time, times.transform_time,
+                times.reduce_time, times.sort_time, times.heavy_time);
+}
+
+static void run()
+{
+    BenchmarkData data;
+    u64 state = 1;
+    MUST(data.random_elements.try_ensure_capacity(ElementCount));
+    MUST(data.elements.try_ensure_capacity(ElementCount));
+    MUST(data.input_values.try_ensure_capacity(ElementCount));
+    for (usize index = 0; index < ElementCount; ++index)
+    {
+        const u64 value = get_next_random(state);
+        MUST(data.random_elements.try_push_back(value));
+        MUST(data.elements.try_push_back(value));
+        MUST(data.input_values.try_push_back(static_cast<f32>(value >> 40)));
+    }
+    MUST(data.output_values.try_resize(ElementCount));
+    MUST(data.heavy_results.try_resize(HeavyItemCount));
+
+    std::printf("Logical cores: %u\n", get_logical_core_count());
+    std::printf("%-10s %10s %10s %10s %10s %10s\n", "Workers", "for", "transform", "reduce", "sort", "64 heavy");
+    // The first measurements are slower (the memory of the elements is not in the TLB and the caches yet, and the
+    // core might not have reached its highest frequency), so they are repeated.
+    static_cast<void>(measure_algorithms(data));
+    print_row("serial", measure_algorithms(data));
+
+    for (const u32 worker_count : WorkerCounts)
+    {
+        char configuration[16];
+        std::snprintf(configuration, sizeof(configuration), "%u", worker_count);
+
+        initialize_job_system(worker_count);
+        const AlgorithmTimes times = measure_algorithms(data);
+        shutdown_job_system();
+        print_row(configuration, times);
+    }
+    std::printf("(ms/call)\n");
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
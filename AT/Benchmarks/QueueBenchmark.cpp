@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/BlockingQueue.h"
+#include "AT/MPMCQueue.h"
+#include "AT/SPSCQueue.h"
+
+#include <cstdio>
+#include <thread>
+
+//
+// Measures the bounded queues of u64 elements:
+//   - The round trip latency of a ping-pong between two threads, through a pair of blocking queues.
+//   - The throughput of one producer and one consumer, pushing and popping one element or a batch of 64 elements at
+//     a time, and of four producers and four consumers sharing a MPMC queue.
+//   - The cost of a push followed by a pop on a single thread, when the queue is never contended.
+// The threads are not pinned, so the operating system decides on which core pairs they run.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize QueueCapacity = 1024;
+constexpr usize BatchElementCount = 64;
+constexpr u64 RoundTripCount = 100'000;
+constexpr u64 ThroughputElementCount = 4 * 1024 * 1024;
+constexpr u32 ContendedThreadCount = 4;
+
+using SPSCQueueType = SPSCQueue<u64, QueueCapacity>;
+using MPMCQueueType = MPMCQueue<u64, QueueCapacity>;
+
+//
+// Returns the time the callable takes per operation, for callables that start their own threads (so they can't be
+// called repeatedly in a batch). The fastest of the rounds is reported.
+//
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_operation(u64 operation_count, Callable&& callable)
+{
+    f64 fastest_nanoseconds_per_operation = 0;
+    for (u32 round_index = 0; round_index < RoundCount; ++round_index)
+    {
+        const u64 begin_time = get_monotonic_time_in_nanoseconds();
+        callable();
+        const u64 elapsed_time = get_monotonic_time_in_nanoseconds() - begin_time;
+
+        const f64 nanoseconds_per_operation = static_cast<f64>(elapsed_time) / static_cast<f64>(operation_count);
+        if (round_index == 0 || nanoseconds_per_operation < fastest_nanoseconds_per_operation)
+            fastest_nanoseconds_per_operation = nanoseconds_per_operation;
+    }
+    return fastest_nanoseconds_per_operation;
+}
+
+template<typename Queue>
+NODISCARD static f64 measure_round_trip()
+{
+    return measure_nanoseconds_per_operation(
+        RoundTripCount,
+        []
+        {
+            BlockingQueue<Queue> requests;
+            BlockingQueue<Queue> responses;
+            std::thread responder = std::thread(
+                [&requests, &responses]
+                {
+                    for (u64 index = 0; index < RoundTripCount; ++index)
+                    {
+                        u64 value;
+                        requests.pop(value);
+                        responses.push(value + 1);
+                    }
+                }
+            );
+
+            for (u64 index = 0; index < RoundTripCount; ++index)
+            {
+                u64 value;
+                requests.push(index);
+                responses.pop(value);
+            }
+            responder.join();
+        }
+    );
+}
+
+template<typename Queue>
+NODISCARD static f64 measure_single_element_throughput()
+{
+    return measure_nanoseconds_per_operation(
+        ThroughputElementCount,
+        []
+        {
+            BlockingQueue<Queue> queue;
+            std::thread producer = std::thread(
+                [&queue]
+                {
+                    for (u64 index = 0; index < ThroughputElementCount; ++index)
+                        queue.push(index);
+                }
+            );
+
+            u64 sum = 0;
+            for (u64 index = 0; index < ThroughputElementCount; ++index)
+            {
+                u64 value;
+                queue.pop(value);
+                sum += value;
+            }
+            do_not_optimize(sum);
+            producer.join();
+        }
+    );
+}
+
+template<typename Queue>
+NODISCARD static f64 measure_batch_throughput()
+{
+    return measure_nanoseconds_per_operation(
+        ThroughputElementCount,
+        []
+        {
+            BlockingQueue<Queue> queue;
+            std::thread producer = std::thread(
+                [&queue]
+                {
+                    u64 batch[BatchElementCount];
+                    for (u64 index = 0; index < ThroughputElementCount; index += BatchElementCount)
+                    {
+                        for (usize batch_index = 0; batch_index < BatchElementCount; ++batch_index)
+                            batch[batch_index] = index + batch_index;
+                        queue.push_batch(Span<u64>(batch, BatchElementCount));
+                    }
+                }
+            );
+
+            u64 sum = 0;
+            u64 batch[BatchElementCount];
+            for (u64 popped_count = 0; popped_count < ThroughputElementCount;)
+            {
+                const usize batch_count = queue.pop_batch(Span<u64>(batch, BatchElementCount));
+                for (usize batch_index = 0; batch_index < batch_count; ++batch_index)
+                    sum += batch[batch_index];
+                popped_count += batch_count;
+            }
+            do_not_optimize(sum);
+            producer.join();
+        }
+    );
+}
+
+NODISCARD static f64 measure_contended_throughput()
+{
+    return measure_nanoseconds_per_operation(
+        ThroughputElementCount,
+        []
+        {
+            constexpr u64 ElementCountPerThread = ThroughputElementCount / ContendedThreadCount;
+
+            BlockingQueue<MPMCQueueType> queue;
+            std::thread threads[2 * ContendedThreadCount];
+            for (u32 thread_index = 0; thread_index < ContendedThreadCount; ++thread_index)
+            {
+                threads[thread_index] = std::thread(
+                    [&queue]
+                    {
+                        for (u64 index = 0; index < ElementCountPerThread; ++index)
+                            queue.push(index);
+                    }
+                );
+                threads[ContendedThreadCount + thread_index] = std::thread(
+                    [&queue]
+                    {
+                        u64 sum = 0;
+                        for (u64 index = 0; index < ElementCountPerThread; ++index)
+                        {
+                            u64 value;
+                            queue.pop(value);
+                            sum += value;
+                        }
+                        do_not_optimize(sum);
+                    }
+                );
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+    );
+}
+
+template<typename Queue>
+NODISCARD static f64 measure_uncontended_push_and_pop()
+{
+    Queue queue;
+    u64 value = 0;
+    return measure_nanoseconds_per_call(
+        [&queue, &value]
+        {
+            const bool was_pushed = queue.try_push(value + 1);
+            const bool was_popped = queue.try_pop(value);
+            do_not_optimize(value);
+            VERIFY_ALWAYS(was_pushed && was_popped);
+        }
+    );
+}
+
+static void run()
+{
+    const f64 spsc_round_trip = measure_round_trip<SPSCQueueType>();
+    const f64 mpmc_round_trip = measure_round_trip<MPMCQueueType>();
+    const f64 spsc_single = measure_single_element_throughput<SPSCQueueType>();
+    const f64 mpmc_single = measure_single_element_throughput<MPMCQueueType>();
+    const f64 spsc_batch = measure_batch_throughput<SPSCQueueType>();
+    const f64 mpmc_batch = measure_batch_throughput<MPMCQueueType>();
+    const f64 mpmc_contended = measure_contended_throughput();
+    const f64 spsc_uncontended = measure_uncontended_push_and_pop<SPSCQueueType>();
+    const f64 mpmc_uncontended = measure_uncontended_push_and_pop<MPMCQueueType>();
+
+    std::printf("Logical cores: %u\n", get_logical_core_count());
+    std::printf("%-36s %10s %10s\n", "Measurement", "SPSC", "MPMC");
+    std::printf("%-36s %10.1f %10.1f\n", "Ping-pong round trip (ns)", spsc_round_trip, mpmc_round_trip);
+    std::printf("%-36s %10.1f %10.1f\n", "1P/1C, single element (ns/element)", spsc_single, mpmc_single);
+    std::printf("%-36s %10.1f %10.1f\n", "1P/1C, batch of 64 (ns/element)", spsc_batch, mpmc_batch);
+    std::printf("%-36s %10s %10.1f\n", "4P/4C, single element (ns/element)", "-", mpmc_contended);
+    std::printf("%-36s %10.1f %10.1f\n", "Uncontended push and pop (ns)", spsc_uncontended, mpmc_uncontended);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
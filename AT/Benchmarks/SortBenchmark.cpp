@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/Sort.h"
+#include "AT/Vector.h"
+
+#include <algorithm>
+#include <cstdio>
+
+//
+// Measures the sorts of u64 keys against std::sort and std::stable_sort, for 1K to 10M keys that are random, already
+// sorted, or random with only 16 unique values. The radix sort is measured both with only keys and with a u32 payload
+// for each key. Every call first copies the unsorted keys (and resets the payloads), and the time of the copy is
+// subtracted. The times are per key.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize KeyCounts[] = { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 };
+constexpr u64 FewUniqueKeyCount = 16;
+
+enum class KeyDistribution : u8
+{
+    Random,
+    Sorted,
+    FewUnique,
+};
+
+// SplitMix64, with a fixed seed so that every run uses the same keys.
+NODISCARD static u64 get_next_random(u64& state)
+{
+    u64 value = (state += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+NODISCARD static Vector<u64> generate_keys(usize count, KeyDistribution distribution)
+{
+    u64 state = 1;
+    Vector<u64> keys;
+    MUST(keys.try_ensure_capacity(count));
+    for (usize index = 0; index < count; ++index)
+    {
+        switch (distribution)
+        {
+            case KeyDistribution::Random:
+                MUST(keys.try_push_back(get_next_random(state)));
+                break;
+            case KeyDistribution::Sorted:
+                MUST(keys.try_push_back(index * 3));
+                break;
+            case KeyDistribution::FewUnique:
+                MUST(keys.try_push_back(get_next_random(state) % FewUniqueKeyCount * 0x9E3779B97F4A7C15));
+                break;
+        }
+    }
+    return keys;
+}
+
+struct SortData
+{
+    Vector<u64> source_keys;
+    Vector<u64> keys;
+    Vector<u32> payloads;
+
+    // Restores the unsorted keys, and the payloads that match them.
+    void reset()
+    {
+        copy_memory(keys.elements(), source_keys.elements(), keys.count() * sizeof(u64));
+        for (usize index = 0; index < payloads.count(); ++index)
+            payloads.unchecked_at(index) = static_cast<u32>(index);
+    }
+};
+
+template<typename Callable>
+NODISCARD static f64 measure_nanoseconds_per_key(SortData& data, f64 reset_time, Callable&& sort_keys)
+{
+    const f64 time = measure_nanoseconds_per_call(
+        [&data, &sort_keys]
+        {
+            data.reset();
+            sort_keys(data);
+            do_not_optimize(data);
+        }
+    );
+    return (time - reset_time) / static_cast<f64>(data.keys.count());
+}
+
+static void measure_distribution(const char* distribution_name, KeyDistribution distribution)
+{
+    std::printf("%s keys (ns/key):\n", distribution_name);
+    std::printf("%10s %10s %10s %12s %12s %10s %10s\n", "Keys", "std::sort", "sort", "std::stable", "stable_sort",
+                "radix", "radix+u32");
+
+    for (const usize key_count : KeyCounts)
+    {
+        SortData data;
+        data.source_keys = generate_keys(key_count, distribution);
+        MUST(data.keys.try_resize(key_count));
+        MUST(data.payloads.try_resize(key_count));
+        const f64 reset_time = measure_nanoseconds_per_call(
+            [&data]
+            {
+                data.reset();
+                do_not_optimize(data);
+            }
+        );
+
+        const f64 std_sort_time = measure_nanoseconds_per_key(
+            data, reset_time,
+            [](SortData& sort_data)
+            {
+                u64* keys = sort_data.keys.elements();
+                std::sort(keys, keys + sort_data.keys.count());
+            }
+        );
+        const f64 sort_time =
+            measure_nanoseconds_per_key(data, reset_time, [](SortData& sort_data) { sort(sort_data.keys); });
+        const f64 std_stable_sort_time = measure_nanoseconds_per_key(
+            data, reset_time,
+            [](SortData& sort_data)
+            {
+                u64* keys = sort_data.keys.elements();
+                std::stable_sort(keys, keys + sort_data.keys.count());
+            }
+        );
+        const f64 stable_sort_time =
+            measure_nanoseconds_per_key(data, reset_time, [](SortData& sort_data) { stable_sort(sort_data.keys); });
+        const f64 radix_sort_time = measure_nanoseconds_per_key(
+            data, reset_time, [](SortData& sort_data) { radix_sort(sort_data.keys.span()); }
+        );
+        const f64 radix_sort_with_payloads_time = measure_nanoseconds_per_key(
+            data, reset_time,
+            [](SortData& sort_data) { radix_sort(sort_data.keys.span(), sort_data.payloads.span()); }
+        );
+
+        std::printf("%10zu %10.1f %10.1f %12.1f %12.1f %10.1f %10.1f\n", key_count, std_sort_time, sort_time,
+                    std_stable_sort_time, stable_sort_time, radix_sort_time, radix_sort_with_payloads_time);
+    }
+}
+
+static void run()
+{
+    measure_distribution("Random", KeyDistribution::Random);
+    measure_distribution("Sorted", KeyDistribution::Sorted);
+    measure_distribution("Few unique", KeyDistribution::FewUnique);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Allocator.h"
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/String.h"
+#include "AT/Vector.h"
+
+#include <cstdio>
+
+//
+// Counts the heap allocations made by creating strings from a corpus of UI identifiers (widget names, style keys,
+// action names and log fragments), and measures the time it takes. The allocations are counted by an allocator that
+// forwards to the heap. The previous layout stored up to 7 characters inline, so its allocation count is the number
+// of identifiers that are longer than that.
+//
+// The copy case keeps 1024 copies of a heap string alive, and compares the deep copies with the copies of shared
+// strings (with non-atomic and atomic reference counts): the time to create and destroy a copy, and the bytes
+// allocated for the original string and all of its copies.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize PreviousInlineCharacterCount = sizeof(char*) - 1;
+
+constexpr StringView Identifiers[] = {
+    // Widget names.
+    "Button"sv, "Label"sv, "Slider"sv, "CheckBox"sv, "ComboBox"sv, "TextInput"sv, "ScrollView"sv, "Splitter"sv,
+    "MainWindow"sv, "Toolbar"sv, "StatusBar"sv, "MenuBar"sv, "TabView"sv, "TreeView"sv, "ListView"sv, "Dialog"sv,
+    "ok_button"sv, "cancel_button"sv, "apply_button"sv, "close_button"sv, "search_field"sv, "file_tree"sv,
+    "properties_panel"sv, "color_picker"sv, "layer_list"sv, "zoom_slider"sv, "brush_size"sv, "opacity"sv,
+    "viewport"sv, "minimap"sv, "console"sv, "timeline"sv, "outliner"sv, "inspector"sv, "asset_browser"sv,
+    "scene_hierarchy"sv, "preview_canvas"sv, "notification_area"sv, "progress_bar"sv, "tooltip"sv,
+
+    // Style keys.
+    "color"sv, "background-color"sv, "border-color"sv, "border-width"sv, "border-radius"sv, "padding"sv,
+    "padding-left"sv, "padding-right"sv, "padding-top"sv, "padding-bottom"sv, "margin"sv, "margin-left"sv,
+    "margin-top"sv, "font-family"sv, "font-size"sv, "font-weight"sv, "line-height"sv, "text-align"sv, "opacity"sv,
+    "min-width"sv, "max-width"sv, "min-height"sv, "max-height"sv, "gap"sv, "flex-grow"sv, "flex-shrink"sv,
+    "cursor"sv, "z-index"sv, "box-shadow"sv, "transition"sv, "hover:background-color"sv, "focus:border-color"sv,
+    "pressed:opacity"sv, "disabled:color"sv,
+
+    // Action and command names.
+    "file.new"sv, "file.open"sv, "file.save"sv, "file.save_as"sv, "file.close"sv, "edit.undo"sv, "edit.redo"sv,
+    "edit.cut"sv, "edit.copy"sv, "edit.paste"sv, "edit.select_all"sv, "view.zoom_in"sv, "view.zoom_out"sv,
+    "view.toggle_fullscreen"sv, "view.reset_layout"sv, "help.about"sv, "tools.preferences"sv,
+    "Settings.Appearance.Theme"sv, "Settings.Editor.TabSize"sv, "Settings.Keyboard.Shortcuts"sv,
+
+    // Log fragments.
+    "frame"sv, "layout"sv, "paint"sv, "upload"sv, "swapchain"sv, "resize"sv, "dpi"sv, "vsync"sv, "gpu"sv,
+    "widget created"sv, "widget destroyed"sv, "layout pass"sv, "paint pass"sv, "texture upload"sv,
+    "swapchain recreated"sv, "surface lost"sv, "font atlas rebuilt"sv, "input focus changed"sv, "ms"sv, "px"sv,
+};
+constexpr usize IdentifierCount = sizeof(Identifiers) / sizeof(Identifiers[0]);
+
+class CountingAllocator final : public Allocator
+{
+public:
+    NODISCARD virtual ErrorOr<void*> try_allocate(usize byte_count, usize alignment) override
+    {
+        ++m_allocation_count;
+        m_allocated_byte_count += byte_count;
+        return HeapAllocator::try_allocate_from_heap(byte_count, alignment);
+    }
+
+    virtual void release(void* memory, usize byte_count, usize alignment) override
+    {
+        HeapAllocator::release_to_heap(memory, byte_count, alignment);
+    }
+
+    NODISCARD ALWAYS_INLINE usize allocation_count() const { return m_allocation_count; }
+    NODISCARD ALWAYS_INLINE usize allocated_byte_count() const { return m_allocated_byte_count; }
+
+private:
+    usize m_allocation_count = 0;
+    usize m_allocated_byte_count = 0;
+};
+
+constexpr usize CopyCount = 1024;
+constexpr StringView CopiedString = "Settings.Appearance.Theme.Colors.Background.Hovered.Pressed"sv;
+
+struct CopyMeasurement
+{
+    f64 nanoseconds_per_copy;
+    usize allocated_byte_count;
+};
+
+// Keeps all copies alive at the same time, as the copies of a shared string reference the same buffer.
+NODISCARD static CopyMeasurement measure_copies(StringSharing sharing)
+{
+    CountingAllocator counting_allocator;
+    const String original = (sharing == StringSharing::None)
+                                ? String(CopiedString, &counting_allocator)
+                                : String::create_shared(CopiedString, sharing, &counting_allocator);
+
+    Vector<String> copies;
+    MUST(copies.try_ensure_capacity(CopyCount));
+    for (usize index = 0; index < CopyCount; ++index)
+        MUST(copies.try_push_back(original));
+    const usize allocated_byte_count = counting_allocator.allocated_byte_count();
+    copies.clear();
+
+    const f64 batch_time = measure_nanoseconds_per_call(
+        [&original, &copies]
+        {
+            for (usize index = 0; index < CopyCount; ++index)
+                MUST(copies.try_push_back(original));
+            do_not_optimize(copies);
+            copies.clear();
+        }
+    );
+
+    return { batch_time / CopyCount, allocated_byte_count };
+}
+
+static void run_copies()
+{
+    std::printf("\nCopies of a %zu character string (%zu copies alive at once):\n", CopiedString.byte_count(),
+                CopyCount);
+    std::printf("%-24s %18s %16s\n", "Copy", "ns/copy+destroy", "bytes allocated");
+
+    const struct
+    {
+        const char* name;
+        StringSharing sharing;
+    } cases[] = {
+        { "deep", StringSharing::None },
+        { "shared, non-atomic", StringSharing::NonAtomic },
+        { "shared, atomic", StringSharing::Atomic },
+    };
+    for (const auto& copy_case : cases)
+    {
+        const CopyMeasurement measurement = measure_copies(copy_case.sharing);
+        std::printf("%-24s %18.2f %16zu\n", copy_case.name, measurement.nanoseconds_per_copy,
+                    measurement.allocated_byte_count);
+    }
+}
+
+static void run()
+{
+    usize previous_allocation_count = 0;
+    usize character_count = 0;
+    for (const StringView identifier : Identifiers)
+    {
+        if (identifier.byte_count() > PreviousInlineCharacterCount)
+            ++previous_allocation_count;
+        character_count += identifier.byte_count();
+    }
+
+    CountingAllocator counting_allocator;
+    for (const StringView identifier : Identifiers)
+    {
+        String string(identifier, &counting_allocator);
+        do_not_optimize(string);
+    }
+
+    const f64 creation_time = measure_nanoseconds_per_call(
+        []
+        {
+            for (const StringView identifier : Identifiers)
+            {
+                String string(identifier);
+                do_not_optimize(string);
+            }
+        }
+    );
+
+    std::printf("Corpus: %zu identifiers, %.1f characters on average.\n", IdentifierCount,
+                static_cast<f64>(character_count) / static_cast<f64>(IdentifierCount));
+    std::printf("Allocations with %2zu inline characters: %zu\n", PreviousInlineCharacterCount,
+                previous_allocation_count);
+    std::printf("Allocations with %2zu inline characters: %zu\n", String::InlineCapacity - 1,
+                counting_allocator.allocation_count());
+    std::printf("Creating and destroying a string: %.1f ns\n", creation_time / IdentifierCount);
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    AT::Benchmarks::run_copies();
+    return 0;
+}
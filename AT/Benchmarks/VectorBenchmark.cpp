@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Benchmarks/Benchmark.h"
+#include "AT/Vector.h"
+
+#include <cstdio>
+#include <vector>
+
+//
+// Measures the insertion at the front and the growth by appending of vectors with one million elements. The u32
+// elements take the trivially relocatable paths, which move the elements with bulk memory operations. The wrapped u32
+// elements have user-provided copy and move operations, so they take the per-element paths (the only paths before
+// the trivially relocatable ones were added). std::vector is measured as a reference.
+//
+
+namespace AT
+{
+
+namespace Benchmarks
+{
+
+constexpr usize ElementCount = 1'000'000;
+
+struct NonRelocatableU32
+{
+    NonRelocatableU32(u32 in_value)
+        : value(in_value)
+    {}
+
+    NonRelocatableU32(const NonRelocatableU32& other)
+        : value(other.value)
+    {}
+
+    NonRelocatableU32(NonRelocatableU32&& other)
+        : value(other.value)
+    {}
+
+    NonRelocatableU32& operator=(const NonRelocatableU32& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    NonRelocatableU32& operator=(NonRelocatableU32&& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    u32 value;
+};
+
+static_assert(IsTriviallyRelocatable<u32>);
+static_assert(!IsTriviallyRelocatable<NonRelocatableU32>);
+
+// Inserts an element at the front of a vector that holds one million elements, then removes it.
+template<typename T>
+NODISCARD static f64 measure_insert_at_front()
+{
+    Vector<T> vector;
+    MUST(vector.try_ensure_capacity(ElementCount + 1));
+    for (usize index = 0; index < ElementCount; ++index)
+        MUST(vector.try_push_back(T(static_cast<u32>(index))));
+
+    return measure_nanoseconds_per_call(
+        [&vector]
+        {
+            MUST(vector.try_insert(0, T(7)));
+            vector.remove(0);
+            do_not_optimize(vector);
+        }
+    );
+}
+
+// Appends one million elements, one at a time, to an empty vector.
+template<typename T>
+NODISCARD static f64 measure_grow_by_append()
+{
+    return measure_nanoseconds_per_call(
+        []
+        {
+            Vector<T> vector;
+            for (usize index = 0; index < ElementCount; ++index)
+                MUST(vector.try_push_back(T(static_cast<u32>(index))));
+            do_not_optimize(vector);
+        }
+    );
+}
+
+// Appends one million elements, as a single span, to an empty vector.
+template<typename T>
+NODISCARD static f64 measure_bulk_append(const Vector<T>& elements)
+{
+    return measure_nanoseconds_per_call(
+        [&elements]
+        {
+            Vector<T> vector;
+            MUST(vector.try_append(elements.span()));
+            do_not_optimize(vector);
+        }
+    );
+}
+
+static void run()
+{
+    Vector<u32> elements;
+    Vector<NonRelocatableU32> non_relocatable_elements;
+    for (usize index = 0; index < ElementCount; ++index)
+    {
+        MUST(elements.try_push_back(static_cast<u32>(index)));
+        MUST(non_relocatable_elements.try_push_back(NonRelocatableU32(static_cast<u32>(index))));
+    }
+
+    std::vector<u32> std_vector(ElementCount);
+    const f64 std_insert_at_front_time = measure_nanoseconds_per_call(
+        [&std_vector]
+        {
+            std_vector.insert(std_vector.begin(), 7);
+            std_vector.erase(std_vector.begin());
+            do_not_optimize(std_vector);
+        }
+    );
+    const f64 std_grow_by_append_time = measure_nanoseconds_per_call(
+        []
+        {
+            std::vector<u32> vector;
+            for (usize index = 0; index < ElementCount; ++index)
+                vector.push_back(static_cast<u32>(index));
+            do_not_optimize(vector);
+        }
+    );
+
+    std::printf("%-36s %14s %14s %14s\n", "Operation (1M elements)", "per-element", "relocatable", "std::vector");
+    std::printf("%-36s %11.1f us %11.1f us %11.1f us\n", "insert and remove at the front",
+                measure_insert_at_front<NonRelocatableU32>() / 1000, measure_insert_at_front<u32>() / 1000,
+                std_insert_at_front_time / 1000);
+    std::printf("%-36s %11.2f ms %11.2f ms %11.2f ms\n", "grow by appending one at a time",
+                measure_grow_by_append<NonRelocatableU32>() / 1'000'000, measure_grow_by_append<u32>() / 1'000'000,
+                std_grow_by_append_time / 1'000'000);
+    std::printf("%-36s %11.2f ms %11.2f ms %14s\n", "append a span",
+                measure_bulk_append(non_relocatable_elements) / 1'000'000,
+                measure_bulk_append(elements) / 1'000'000, "-");
+}
+
+} // namespace Benchmarks
+
+} // namespace AT
+
+int main()
+{
+    AT::Benchmarks::run();
+    return 0;
+}
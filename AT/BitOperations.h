@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Assertions.h"
+#include "AT/CoreTypes.h"
+
+#if AT_COMPILER_MSVC
+    #include <intrin.h>
+#endif // AT_COMPILER_MSVC
+
+namespace AT
+{
+
+// The value must not be zero.
+NODISCARD ALWAYS_INLINE inline u32 count_trailing_zeroes(u32 value)
+{
+#if AT_COMPILER_MSVC
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<u32>(index);
+#else
+    return static_cast<u32>(__builtin_ctz(value));
+#endif // AT_COMPILER_MSVC
+}
+
+// The value must not be zero.
+NODISCARD ALWAYS_INLINE inline u32 count_trailing_zeroes(u64 value)
+{
+#if AT_COMPILER_MSVC
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<u32>(index);
+#else
+    return static_cast<u32>(__builtin_ctzll(value));
+#endif // AT_COMPILER_MSVC
+}
+
+// The value must not be zero.
+NODISCARD ALWAYS_INLINE inline u32 count_leading_zeroes(u64 value)
+{
+#if AT_COMPILER_MSVC
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<u32>(index);
+#else
+    return static_cast<u32>(__builtin_clzll(value));
+#endif // AT_COMPILER_MSVC
+}
+
+NODISCARD ALWAYS_INLINE constexpr bool is_power_of_two(usize value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Returns the smallest power of two that is greater than or equal to the given value.
+NODISCARD ALWAYS_INLINE inline usize round_up_to_power_of_two(usize value)
+{
+    if (value <= 1)
+        return 1;
+    return static_cast<usize>(1) << (64 - count_leading_zeroes(static_cast<u64>(value - 1)));
+}
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::count_leading_zeroes;
+using AT::count_trailing_zeroes;
+using AT::is_power_of_two;
+using AT::round_up_to_power_of_two;
+#endif // AT_INCLUDE_GLOBALLY
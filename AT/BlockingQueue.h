@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Platform.h"
+#include "AT/Span.h"
+
+#include <atomic>
+
+namespace AT
+{
+
+///
+/// Wraps a bounded queue (SPSCQueue or MPMCQueue) with operations that block the calling thread while the queue is
+/// full (or empty), instead of failing. The blocked threads sleep on a futex, so they don't consume any CPU time.
+/// The threads that use the queue must still respect the rules of the wrapped queue (such as having a single producer
+/// and a single consumer for a SPSCQueue).
+///
+/// Each side counts its operations in a futex word, on which the other side waits. A thread that is about to wait
+/// first announces itself by incrementing the waiter count of the word, and the other side only issues the (expensive)
+/// wake-up system call when it sees an announcement. Both sides use sequentially consistent operations for the word
+/// and the waiter count, so either the waiting thread observes the change of the word, or the other side observes the
+/// announcement. The thread that issues the wake-up clears all announcements, so a burst of operations doesn't issue
+/// a system call for each of them while the woken threads are not running yet.
+///
+template<typename Queue>
+class BlockingQueue
+{
+    AT_MAKE_NONCOPYABLE(BlockingQueue);
+    AT_MAKE_NONMOVABLE(BlockingQueue);
+
+public:
+    using ElementType = typename Queue::ElementType;
+
+public:
+    BlockingQueue() = default;
+
+public:
+    void push(ElementType&& element)
+    {
+        wait_until([this, &element] { return m_queue.try_push(move(element)); }, m_pop_sequence, m_pop_waiter_count);
+        notify(m_push_sequence, m_push_waiter_count);
+    }
+
+    void push(const ElementType& element)
+    {
+        wait_until([this, &element] { return m_queue.try_push(element); }, m_pop_sequence, m_pop_waiter_count);
+        notify(m_push_sequence, m_push_waiter_count);
+    }
+
+    void pop(ElementType& out_element)
+    {
+        wait_until([this, &out_element] { return m_queue.try_pop(out_element); }, m_push_sequence, m_push_waiter_count);
+        notify(m_pop_sequence, m_pop_waiter_count);
+    }
+
+    // Blocks until all elements have been pushed.
+    void push_batch(Span<ElementType> elements)
+    {
+        usize pushed_count = 0;
+        while (pushed_count < elements.count())
+        {
+            usize batch_count = 0;
+            wait_until(
+                [this, &elements, pushed_count, &batch_count]
+                {
+                    const Span<ElementType> remaining_elements =
+                        Span<ElementType>(elements.elements() + pushed_count, elements.count() - pushed_count);
+                    batch_count = m_queue.try_push_batch(remaining_elements);
+                    return batch_count > 0;
+                },
+                m_pop_sequence, m_pop_waiter_count
+            );
+            pushed_count += batch_count;
+            notify(m_push_sequence, m_push_waiter_count);
+        }
+    }
+
+    // Blocks until at least one element is available, then pops as many as are available (up to the count of the
+    // destination span) and returns their count.
+    NODISCARD usize pop_batch(Span<ElementType> out_elements)
+    {
+        if (out_elements.is_empty())
+            return 0;
+
+        usize popped_count = 0;
+        wait_until(
+            [this, &out_elements, &popped_count]
+            {
+                popped_count = m_queue.try_pop_batch(out_elements);
+                return popped_count > 0;
+            },
+            m_push_sequence, m_push_waiter_count
+        );
+        notify(m_pop_sequence, m_pop_waiter_count);
+        return popped_count;
+    }
+
+    NODISCARD ALWAYS_INLINE bool try_push(ElementType&& element)
+    {
+        if (!m_queue.try_push(move(element)))
+            return false;
+        notify(m_push_sequence, m_push_waiter_count);
+        return true;
+    }
+
+    NODISCARD ALWAYS_INLINE bool try_pop(ElementType& out_element)
+    {
+        if (!m_queue.try_pop(out_element))
+            return false;
+        notify(m_pop_sequence, m_pop_waiter_count);
+        return true;
+    }
+
+    NODISCARD ALWAYS_INLINE usize approximate_count() const { return m_queue.approximate_count(); }
+
+private:
+    // The blocked threads retry the operation a few times before sleeping, as the wait is often very short.
+    static constexpr u32 SpinCount = 128;
+
+    template<typename Operation>
+    ALWAYS_INLINE void wait_until(Operation operation, std::atomic<u32>& sequence, std::atomic<u32>& waiter_count)
+    {
+        u32 spin_count = 0;
+        while (true)
+        {
+            // The sequence is read before trying the operation, so a change that happens after the failed attempt
+            // makes the futex wait return immediately.
+            const u32 observed_sequence = sequence.load(std::memory_order_seq_cst);
+            if (operation())
+                return;
+            if (spin_count++ < SpinCount)
+                continue;
+
+            waiter_count.fetch_add(1, std::memory_order_seq_cst);
+            wait_on_address(sequence, observed_sequence);
+        }
+    }
+
+    //
+    // All announced waiters are woken, because a waiter whose announcement was cleared but that was not woken would
+    // sleep until the next operation. If a thread returns from the wait without being woken, its announcement stays
+    // set, which only costs one unnecessary system call.
+    //
+    ALWAYS_INLINE static void notify(std::atomic<u32>& sequence, std::atomic<u32>& waiter_count)
+    {
+        sequence.fetch_add(1, std::memory_order_seq_cst);
+        if (waiter_count.load(std::memory_order_seq_cst) == 0)
+            return;
+        if (waiter_count.exchange(0, std::memory_order_seq_cst) > 0)
+            wake_all_waiters_on_address(sequence);
+    }
+
+private:
+    Queue m_queue;
+
+    // Incremented after each push (or pop), and waited on by the consumers (or producers). The waiter counts are
+    // the number of announcements since the last wake-up.
+    alignas(64) std::atomic<u32> m_push_sequence = 0;
+    std::atomic<u32> m_push_waiter_count = 0;
+
+    alignas(64) std::atomic<u32> m_pop_sequence = 0;
+    std::atomic<u32> m_pop_waiter_count = 0;
+};
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::BlockingQueue;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/CPUFeatures.h"
+
+#if AT_ARCHITECTURE_X86_64
+    #if AT_COMPILER_MSVC
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif // AT_COMPILER_MSVC
+#endif // AT_ARCHITECTURE_X86_64
+
+namespace AT
+{
+
+#if AT_ARCHITECTURE_X86_64
+
+struct CPUIDRegisters
+{
+    u32 eax;
+    u32 ebx;
+    u32 ecx;
+    u32 edx;
+};
+
+static CPUIDRegisters query_cpuid(u32 leaf, u32 subleaf)
+{
+    CPUIDRegisters registers = {};
+    #if AT_COMPILER_MSVC
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers.eax = static_cast<u32>(values[0]);
+    registers.ebx = static_cast<u32>(values[1]);
+    registers.ecx = static_cast<u32>(values[2]);
+    registers.edx = static_cast<u32>(values[3]);
+    #else
+    __cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+    #endif // AT_COMPILER_MSVC
+    return registers;
+}
+
+// Reads the XCR0 register, which describes the register states that the OS saves on context switches.
+static u64 query_extended_control_register()
+{
+    #if AT_COMPILER_MSVC
+    return _xgetbv(0);
+    #else
+    u32 low;
+    u32 high;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<u64>(high) << 32) | low;
+    #endif // AT_COMPILER_MSVC
+}
+
+static bool is_bit_set(u32 value, u32 bit)
+{
+    return (value >> bit) & 1;
+}
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+
+    const u32 max_leaf = query_cpuid(0, 0).eax;
+    if (max_leaf < 1)
+        return features;
+
+    const CPUIDRegisters leaf_1 = query_cpuid(1, 0);
+    features.has_sse2 = is_bit_set(leaf_1.edx, 26);
+    features.has_sse3 = is_bit_set(leaf_1.ecx, 0);
+    features.has_ssse3 = is_bit_set(leaf_1.ecx, 9);
+    features.has_sse4_1 = is_bit_set(leaf_1.ecx, 19);
+    features.has_sse4_2 = is_bit_set(leaf_1.ecx, 20);
+    features.has_popcnt = is_bit_set(leaf_1.ecx, 23);
+
+    // The AVX register state can only be used if the OS has enabled the XSAVE mechanism and saves
+    // the SSE and AVX state (XCR0 bits 1 and 2). AVX-512 additionally requires the opmask and
+    // the upper ZMM register states (XCR0 bits 5, 6 and 7).
+    const bool has_os_xsave = is_bit_set(leaf_1.ecx, 27);
+    const u64 xcr0 = has_os_xsave ? query_extended_control_register() : 0;
+    const bool has_os_avx_support = (xcr0 & 0x06) == 0x06;
+    const bool has_os_avx512_support = (xcr0 & 0xE6) == 0xE6;
+
+    features.has_avx = has_os_avx_support && is_bit_set(leaf_1.ecx, 28);
+
+    if (max_leaf >= 7)
+    {
+        const CPUIDRegisters leaf_7 = query_cpuid(7, 0);
+        features.has_bmi1 = is_bit_set(leaf_7.ebx, 3);
+        features.has_avx2 = features.has_avx && is_bit_set(leaf_7.ebx, 5);
+        features.has_bmi2 = is_bit_set(leaf_7.ebx, 8);
+        features.has_erms = is_bit_set(leaf_7.ebx, 9);
+        features.has_avx512f = has_os_avx512_support && is_bit_set(leaf_7.ebx, 16);
+        features.has_avx512bw = features.has_avx512f && is_bit_set(leaf_7.ebx, 30);
+        features.has_avx512vl = features.has_avx512f && is_bit_set(leaf_7.ebx, 31);
+    }
+
+    const u32 max_extended_leaf = query_cpuid(0x80000000, 0).eax;
+    if (max_extended_leaf >= 0x80000007)
+        features.has_invariant_tsc = is_bit_set(query_cpuid(0x80000007, 0).edx, 8);
+
+    return features;
+}
+
+#else
+
+static CPUFeatures detect_cpu_features()
+{
+    // No instruction set extensions are detected on architectures other than x86-64.
+    return {};
+}
+
+#endif // AT_ARCHITECTURE_X86_64
+
+const CPUFeatures& get_cpu_features()
+{
+    static const CPUFeatures features = detect_cpu_features();
+    return features;
+}
+
+} // namespace AT
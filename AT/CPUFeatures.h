@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+
+namespace AT
+{
+
+//
+// The instruction set extensions supported by the CPU that runs the application.
+// A feature is only reported as available when both the CPU and the operating system
+// support it (for example, the AVX register state must be saved by the OS on context switches).
+//
+struct CPUFeatures
+{
+    bool has_sse2 = false;
+    bool has_sse3 = false;
+    bool has_ssse3 = false;
+    bool has_sse4_1 = false;
+    bool has_sse4_2 = false;
+    bool has_popcnt = false;
+    bool has_avx = false;
+    bool has_avx2 = false;
+    bool has_bmi1 = false;
+    bool has_bmi2 = false;
+    bool has_avx512f = false;
+    bool has_avx512bw = false;
+    bool has_avx512vl = false;
+    bool has_erms = false;
+    // The time stamp counter ticks at a constant rate, regardless of the frequency and power state of the core.
+    bool has_invariant_tsc = false;
+};
+
+// The features are detected only once, the first time this function is called.
+NODISCARD AT_API const CPUFeatures& get_cpu_features();
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::CPUFeatures;
+using AT::get_cpu_features;
+#endif // AT_INCLUDE_GLOBALLY
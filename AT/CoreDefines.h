@@ -5,9 +5,10 @@
 
 #pragma once
 
-// Check if the platform is Windows.
+// Check if the platform is Windows or Linux.
 #ifdef _WIN32
     #define AT_PLATFORM_WINDOWS 1
+    #define AT_PLATFORM_LINUX   0
 
     #ifdef _WIN64
         #define AT_ARCHITECTURE_32_BIT 0
@@ -16,14 +17,33 @@
         #define AT_ARCHITECTURE_32_BIT 1
         #define AT_ARCHITECTURE_64_BIT 0
     #endif // _WIN64
+#elif defined(__linux__)
+    #define AT_PLATFORM_WINDOWS 0
+    #define AT_PLATFORM_LINUX   1
+
+    #ifdef __LP64__
+        #define AT_ARCHITECTURE_32_BIT 0
+        #define AT_ARCHITECTURE_64_BIT 1
+    #else
+        #define AT_ARCHITECTURE_32_BIT 1
+        #define AT_ARCHITECTURE_64_BIT 0
+    #endif // __LP64__
 #else
     #define AT_PLATFORM_WINDOWS    0
+    #define AT_PLATFORM_LINUX      0
     #define AT_ARCHITECTURE_32_BIT 0
     #define AT_ARCHITECTURE_64_BIT 0
-#endif // _WIN32
+#endif // Platforms.
+
+// Check if the instruction set architecture is x86-64.
+#if defined(_M_X64) || defined(__x86_64__)
+    #define AT_ARCHITECTURE_X86_64 1
+#else
+    #define AT_ARCHITECTURE_X86_64 0
+#endif // defined(_M_X64) || defined(__x86_64__)
 
 // If none of the supported platforms are detected don't bother trying to build.
-#if !AT_PLATFORM_WINDOWS
+#if !AT_PLATFORM_WINDOWS && !AT_PLATFORM_LINUX
     #error Unsupported/Unknown platform!
 #endif // Any platform.
 
@@ -83,6 +103,33 @@
     #define AT_DEBUGBREAK __builtin_trap()
 #endif // Compilers.
 
+// Marks a function that is rarely called, such that the compiler moves it (and the branches that lead to it) away
+// from the hot code. AT_ASSUME lets the optimizer rely on the expression being true, without checking it. The
+// expression must not have side effects, as it might not be evaluated.
+#if AT_COMPILER_MSVC
+    #define AT_COLD
+    #define AT_ASSUME(expression) __assume(expression)
+#elif AT_COMPILER_CLANG
+    #define AT_COLD               __attribute__((cold))
+    #define AT_ASSUME(expression) __builtin_assume(expression)
+#else
+    #define AT_COLD __attribute__((cold))
+    #define AT_ASSUME(expression)        \
+        do                               \
+        {                                \
+            if (!(expression))           \
+                __builtin_unreachable(); \
+        } while (0)
+#endif // Compilers.
+
+// Disables the address sanitizer instrumentation of a function. Only used by the kernels that intentionally read
+// past the end of a buffer, without ever crossing a page boundary.
+#if AT_COMPILER_MSVC
+    #define AT_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#else
+    #define AT_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif // Compilers.
+
 #define NODISCARD    [[nodiscard]]
 #define MAYBE_UNUSED [[maybe_unused]]
 #define AT_DEPRECATED
@@ -57,7 +57,7 @@ using ReadonlyBytes = ReadonlyByte*;
 using WriteonlyBytes = WriteonlyByte*;
 using ReadWriteBytes = ReadWriteByte*;
 
-using NullptrType = nullptr_t;
+using NullptrType = decltype(nullptr);
 
 constexpr usize InvalidSize = static_cast<usize>(-1);
 
@@ -193,9 +193,9 @@ static constexpr bool IsConst<const T> = true;
 template<typename T>
 static constexpr bool IsFloatingPoint = false;
 template<>
-static constexpr bool IsFloatingPoint<f32> = true;
+constexpr bool IsFloatingPoint<f32> = true;
 template<>
-static constexpr bool IsFloatingPoint<f64> = true;
+constexpr bool IsFloatingPoint<f64> = true;
 
 template<typename T>
 static constexpr bool IsPointer = false;
@@ -216,29 +216,29 @@ static constexpr bool IsReference<const T&&> = true;
 template<typename T>
 static constexpr bool IsSigned = false;
 template<>
-static constexpr bool IsSigned<i8> = true;
+constexpr bool IsSigned<i8> = true;
 template<>
-static constexpr bool IsSigned<i16> = true;
+constexpr bool IsSigned<i16> = true;
 template<>
-static constexpr bool IsSigned<i32> = true;
+constexpr bool IsSigned<i32> = true;
 template<>
-static constexpr bool IsSigned<i64> = true;
+constexpr bool IsSigned<i64> = true;
 
 template<typename T>
 static constexpr bool IsUnsigned = false;
 template<>
-static constexpr bool IsUnsigned<u8> = true;
+constexpr bool IsUnsigned<u8> = true;
 template<>
-static constexpr bool IsUnsigned<u16> = true;
+constexpr bool IsUnsigned<u16> = true;
 template<>
-static constexpr bool IsUnsigned<u32> = true;
+constexpr bool IsUnsigned<u32> = true;
 template<>
-static constexpr bool IsUnsigned<u64> = true;
+constexpr bool IsUnsigned<u64> = true;
 
 template<typename T>
 static constexpr bool IsVoid = false;
 template<>
-static constexpr bool IsVoid<void> = true;
+constexpr bool IsVoid<void> = true;
 
 template<typename T>
 static constexpr bool IsVolatile = false;
@@ -272,21 +272,21 @@ static constexpr bool IsSame = std::is_same_v<T, Q>;
 template<typename Base, typename Derived>
 static constexpr bool IsBaseOf = std::is_base_of_v<Base, Derived>;
 
-//=============================================================================
-// Type traits.
-//=============================================================================
-
 template<typename T>
-struct TypeTraits
-{
-    NODISCARD ALWAYS_INLINE static u64 get_hash(const T&) { return 0; }
-};
+static constexpr bool IsTriviallyCopyable = std::is_trivially_copyable_v<T>;
+template<typename T>
+static constexpr bool IsTriviallyDestructible = std::is_trivially_destructible_v<T>;
+template<typename T>
+static constexpr bool IsTriviallyDefaultConstructible = std::is_trivially_default_constructible_v<T>;
 
-template<>
-struct TypeTraits<i32>
-{
-    NODISCARD ALWAYS_INLINE static u64 get_hash(const u32& value) { return value; }
-};
+///
+/// A type is trivially relocatable if moving an instance to a new memory location and destroying the old one
+/// is equivalent to copying its bytes. Containers use this to move elements in bulk, with a single memory copy.
+/// Trivially copyable types are detected automatically. Any other type that doesn't store pointers into itself
+/// can opt in by specializing this variable (which is why it is declared inline instead of static).
+///
+template<typename T>
+inline constexpr bool IsTriviallyRelocatable = IsTriviallyCopyable<T>;
 
 } // namespace AT
 
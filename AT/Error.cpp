@@ -8,50 +8,27 @@
 namespace AT
 {
 
-Error Error::from_code(Code code)
+StringView Error::message() const
 {
-    Error error = {};
-    error.m_kind = Kind::Code;
-    error.m_error_code = code;
-    return error;
-}
-
-Error Error::from_string(StringView string)
-{
-    Error error;
-    error.m_kind = Kind::String;
-    error.m_error_string = string;
-    return error;
-}
-
-Error Error::from_undefined_data(AT::u64 undefined_data)
-{
-    Error error;
-    error.m_kind = Kind::UndefinedData;
-    error.m_error_undefined_data = undefined_data;
-    return error;
-}
+    if (has_descriptor())
+        return descriptor().message;
 
-Error::Error(Error&& other) noexcept
-    : m_kind(other.m_kind)
-{
-    switch (m_kind)
+    switch (code())
     {
-        case Kind::Code:
-            m_error_code = other.m_error_code;
-            other.m_error_code = Code::Unknown;
-            break;
-
-        case Kind::String:
-            m_error_string = move(other.m_error_string);
-            other.m_error_string = {};
-            break;
-
-        case Kind::UndefinedData:
-            m_error_undefined_data = other.m_error_undefined_data;
-            other.m_error_undefined_data = 0;
-            break;
+        case Code::Unknown:
+            return "Unknown"sv;
+        case Code::OutOfMemory:
+            return "OutOfMemory"sv;
+        case Code::IndexOutOfRange:
+            return "IndexOutOfRange"sv;
+        case Code::InvalidEncoding:
+            return "InvalidEncoding"sv;
+        case Code::BufferTooSmall:
+            return "BufferTooSmall"sv;
+        case Code::FileOperationFailed:
+            return "FileOperationFailed"sv;
     }
+    return "Unknown"sv;
 }
 
 } // namespace AT
@@ -12,6 +12,13 @@
 namespace AT
 {
 
+struct ErrorDescriptor;
+
+//
+// An error is a single pointer-sized word, so that it can be returned in a register. The word either stores an error
+// code (tagged by its lowest bit) or points to a static error descriptor (whose alignment keeps the lowest bit clear).
+// The word is never zero, which lets ErrorOr<void> use zero as the success value.
+//
 class Error
 {
     AT_MAKE_NONCOPYABLE(Error);
@@ -25,66 +32,115 @@ public:
         Unknown = 0,
         OutOfMemory,
         IndexOutOfRange,
+        InvalidEncoding,
+        BufferTooSmall,
+        FileOperationFailed,
     };
 
-    enum class Kind : u16
+    NODISCARD ALWAYS_INLINE static constexpr Error from_code(Code code)
     {
-        Code,
-        String,
-        UndefinedData,
-    };
+        return Error((static_cast<usize>(code) << 1) | CodeTag);
+    }
 
-    NODISCARD AT_API static Error from_code(Code code);
-    NODISCARD AT_API static Error from_string(StringView string);
-    NODISCARD AT_API static Error from_undefined_data(u64 undefined_data);
+    // The descriptor must live for the whole program (such as a static constant).
+    NODISCARD ALWAYS_INLINE static Error from_descriptor(const ErrorDescriptor& descriptor)
+    {
+        return Error(reinterpret_cast<usize>(&descriptor));
+    }
 
-private:
-    Error() = default;
-    AT_API Error(Error&& other) noexcept;
+public:
+    ALWAYS_INLINE Error(Error&& other) noexcept = default;
     Error& operator=(Error&& other) noexcept = delete;
 
+public:
+    NODISCARD ALWAYS_INLINE bool has_descriptor() const { return (m_encoded_value & CodeTag) == 0; }
+    NODISCARD ALWAYS_INLINE const ErrorDescriptor& descriptor() const
+    {
+        VERIFY(has_descriptor());
+        return *reinterpret_cast<const ErrorDescriptor*>(m_encoded_value);
+    }
+
+    NODISCARD ALWAYS_INLINE Code code() const;
+    // Returns the message of the descriptor, or the name of the code if the error doesn't have a descriptor.
+    NODISCARD AT_API StringView message() const;
+
 private:
-    Kind m_kind = Kind::Code;
+    static constexpr usize CodeTag = 1;
 
-    union
+    ALWAYS_INLINE constexpr explicit Error(usize encoded_value)
+        : m_encoded_value(encoded_value)
     {
-        Code m_error_code = Code::Unknown;
-        StringView m_error_string;
-        u64 m_error_undefined_data;
-    };
+    }
+
+private:
+    usize m_encoded_value;
+};
+
+struct ErrorDescriptor
+{
+    Error::Code code;
+    StringView message;
 };
 
+ALWAYS_INLINE inline Error::Code Error::code() const
+{
+    if (has_descriptor())
+        return descriptor().code;
+    return static_cast<Code>(m_encoded_value >> 1);
+}
+
+//
+// The ErrorOr types are movable, and they are trivially movable and destructible when the value type is, which lets
+// the compiler return them in registers. ErrorOr<void> is a single word (zero meaning success), while ErrorOr<T&> uses
+// a null pointer to mark an error.
+//
 template<typename T>
 class NODISCARD ErrorOr
 {
     AT_MAKE_NONCOPYABLE(ErrorOr);
-    AT_MAKE_NONMOVABLE(ErrorOr);
 
 public:
     ALWAYS_INLINE ErrorOr(T value)
-        : m_is_error(false)
-        , m_value(move(value))
+        : m_value(move(value))
+        , m_is_error(false)
     {
     }
 
     ALWAYS_INLINE ErrorOr(Error&& error)
-        : m_is_error(true)
-        , m_error(move(error))
+        : m_error(move(error))
+        , m_is_error(true)
     {
     }
 
     ALWAYS_INLINE ErrorOr(Error::Code code)
-        : m_is_error(true)
-        , m_error(Error::from_code(code))
+        : m_error(Error::from_code(code))
+        , m_is_error(true)
     {
     }
 
+    ALWAYS_INLINE ErrorOr(ErrorOr&& other) noexcept
+        requires(IsTriviallyCopyable<T>)
+    = default;
+
+    ALWAYS_INLINE ErrorOr(ErrorOr&& other) noexcept
+        : m_is_error(other.m_is_error)
+    {
+        if (m_is_error)
+            new (&m_error) Error(move(other.m_error));
+        else
+            new (&m_value) T(move(other.m_value));
+    }
+
+    ErrorOr& operator=(ErrorOr&& other) noexcept = delete;
+
+    ALWAYS_INLINE ~ErrorOr()
+        requires(IsTriviallyDestructible<T>)
+    = default;
+
     ALWAYS_INLINE ~ErrorOr()
     {
         if (!m_is_error)
             m_value.~T();
-        else
-            m_error.~Error();
     }
 
 public:
@@ -107,88 +163,72 @@ template<>
 class NODISCARD ErrorOr<void>
 {
     AT_MAKE_NONCOPYABLE(ErrorOr);
-    AT_MAKE_NONMOVABLE(ErrorOr);
 
 public:
     ALWAYS_INLINE ErrorOr()
-        : m_is_error(false)
+        : m_error(0)
     {
     }
 
     ALWAYS_INLINE ErrorOr(Error&& error)
-        : m_is_error(true)
+        : m_error(move(error))
     {
-        new (m_error_storage) Error(move(error));
     }
 
     ALWAYS_INLINE ErrorOr(Error::Code code)
-        : m_is_error(true)
+        : m_error(Error::from_code(code))
     {
-        new (m_error_storage) Error(move(Error::from_code(code)));
     }
 
-    ALWAYS_INLINE ~ErrorOr()
-    {
-        if (m_is_error)
-            reinterpret_cast<Error*>(m_error_storage)->~Error();
-    }
+    ALWAYS_INLINE ErrorOr(ErrorOr&& other) noexcept = default;
+    ErrorOr& operator=(ErrorOr&& other) noexcept = delete;
 
 public:
-    NODISCARD ALWAYS_INLINE bool is_error() const { return m_is_error; }
+    NODISCARD ALWAYS_INLINE bool is_error() const { return (m_error.m_encoded_value != 0); }
 
     ALWAYS_INLINE void release_value() {}
-    NODISCARD ALWAYS_INLINE Error&& release_error() { return move(*reinterpret_cast<Error*>(m_error_storage)); }
+    NODISCARD ALWAYS_INLINE Error&& release_error() { return move(m_error); }
 
 private:
-    alignas(Error) u8 m_error_storage[sizeof(Error)];
-    bool m_is_error;
+    Error m_error;
 };
 
 template<typename T>
 class NODISCARD ErrorOr<T&>
 {
     AT_MAKE_NONCOPYABLE(ErrorOr);
-    AT_MAKE_NONMOVABLE(ErrorOr);
 
 public:
     ALWAYS_INLINE ErrorOr(T& reference)
-        : m_is_error(false)
+        : m_pointer(&reference)
+        , m_error(0)
     {
-        m_pointer = &reference;
     }
 
     ALWAYS_INLINE ErrorOr(Error&& error)
-        : m_is_error(true)
+        : m_pointer(nullptr)
         , m_error(move(error))
     {
     }
 
     ALWAYS_INLINE ErrorOr(Error::Code code)
-        : m_is_error(true)
+        : m_pointer(nullptr)
         , m_error(Error::from_code(code))
     {
     }
 
-    ALWAYS_INLINE ~ErrorOr()
-    {
-        if (m_is_error)
-            m_error.~Error();
-    }
+    ALWAYS_INLINE ErrorOr(ErrorOr&& other) noexcept = default;
+    ErrorOr& operator=(ErrorOr&& other) noexcept = delete;
 
 public:
-    NODISCARD ALWAYS_INLINE bool is_error() const { return m_is_error; }
+    NODISCARD ALWAYS_INLINE bool is_error() const { return (m_pointer == nullptr); }
 
     ALWAYS_INLINE T& release_value() { return *m_pointer; }
     NODISCARD ALWAYS_INLINE Error&& release_error() { return move(m_error); }
 
 private:
-    union
-    {
-        Error m_error;
-        T* m_pointer;
-    };
-
-    bool m_is_error;
+    T* m_pointer;
+    Error m_error;
 };
 
 } // namespace AT
@@ -256,5 +296,6 @@ private:
 
 #if AT_INCLUDE_GLOBALLY
 using AT::Error;
+using AT::ErrorDescriptor;
 using AT::ErrorOr;
 #endif // AT_INCLUDE_GLOBALLY
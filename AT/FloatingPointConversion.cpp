@@ -0,0 +1,1172 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/FloatingPointConversion.h"
+#include "AT/Assertions.h"
+#include "AT/BitOperations.h"
+#include "AT/MemoryOperations.h"
+
+#if AT_COMPILER_MSVC
+    #include <intrin.h>
+#endif // AT_COMPILER_MSVC
+
+namespace AT
+{
+
+namespace Detail
+{
+
+//
+// The Schubfach algorithm, as described in "The Schubfach way to render doubles" by Raffaello Giulietti. The
+// implementation follows the reference implementation (which is part of OpenJDK), with the same names. The only
+// difference is that the reference implementation never produces fewer than two digits, as required by Java.
+// Here, the one digit decimals are also considered, so the tiny subnormal numbers don't need special handling.
+//
+
+// floor(e * log10(2)), for e in the [-5456721, 5456721] range.
+NODISCARD ALWAYS_INLINE static inline i32 flog10pow2(i32 e)
+{
+    return static_cast<i32>((static_cast<i64>(e) * 661971961083ll) >> 41);
+}
+
+// floor(log10(3/4 * 2^e)), for e in the [-2985325, 2936293] range.
+NODISCARD ALWAYS_INLINE static inline i32 flog10_three_quarters_pow2(i32 e)
+{
+    return static_cast<i32>((static_cast<i64>(e) * 661971961083ll - 274743187321ll) >> 41);
+}
+
+// floor(e * log2(10)), for e in the [-1838394, 1838394] range.
+NODISCARD ALWAYS_INLINE static inline i32 flog2pow10(i32 e)
+{
+    return static_cast<i32>((static_cast<i64>(e) * 913124641741ll) >> 38);
+}
+
+NODISCARD ALWAYS_INLINE static inline u64 multiply_high(u64 lhs, u64 rhs)
+{
+#if AT_COMPILER_MSVC
+    return __umulh(lhs, rhs);
+#else
+    return static_cast<u64>((static_cast<unsigned __int128>(lhs) * rhs) >> 64);
+#endif // AT_COMPILER_MSVC
+}
+
+static constexpr i32 GTableMinK = -324;
+static constexpr i32 GTableMaxK = 292;
+
+//
+// For each k in the [GTableMinK, GTableMaxK] range, g = floor(10^(-k) * 2^(125 - flog2pow10(-k))) + 1, which
+// is a 126-bit number, split into its upper and lower 63 bits. Generated using arbitrary-precision arithmetic.
+//
+static constexpr u64 GTable[GTableMaxK - GTableMinK + 1][2] = {
+    { 0x4F0CEDC95A718DD4ull, 0x5B01E8B09AA0D1B5ull }, // 10^324
+    { 0x7E7B160EF71C1621ull, 0x119CA780F767B5EEull }, // 10^323
+    { 0x652F44D8C5B011B4ull, 0x0E16EC672C52F7F2ull }, // 10^322
+    { 0x50F29D7A37C00E29ull, 0x581256B8F0425FF5ull }, // 10^321
+    { 0x40C21794F96671BAull, 0x79A84560C0351991ull }, // 10^320
+    { 0x679CF287F570B5F7ull, 0x75DA089ACD21C281ull }, // 10^319
+    { 0x52E3F5399126F7F9ull, 0x44AE6D48A41B0201ull }, // 10^318
+    { 0x424FF76140EBF994ull, 0x36F1F106E9AF34CDull }, // 10^317
+    { 0x6A198BCECE465C20ull, 0x57E981A4A918547Bull }, // 10^316
+    { 0x54E13CA571D1E34Dull, 0x2CBACE1D541376C9ull }, // 10^315
+    { 0x43E763B78E4182A4ull, 0x23C8A4E44342C56Eull }, // 10^314
+    { 0x6CA56C58E39C043Aull, 0x060DD4A06B9E08B0ull }, // 10^313
+    { 0x56EABD13E9499CFBull, 0x1E7176E6BC7E6D59ull }, // 10^312
+    { 0x458897432107B0C8ull, 0x7EC12BEBC9FEBDE1ull }, // 10^311
+    { 0x6F40F20501A5E7A7ull, 0x7E01DFDFA9979635ull }, // 10^310
+    { 0x5900C19D9AEB1FB9ull, 0x4B34B319547944F7ull }, // 10^309
+    { 0x4733CE17AF227FC7ull, 0x55C3C27AA9FA9D93ull }, // 10^308
+    { 0x71EC7CF2B1D0CC72ull, 0x560603F7765DC8EAull }, // 10^307
+    { 0x5B2397288E40A38Eull, 0x7804CFF92B7E3A55ull }, // 10^306
+    { 0x48E945BA0B66E93Full, 0x13370CC755FE9511ull }, // 10^305
+    { 0x74A86F90123E41FEull, 0x51F1AE0BBCCA881Bull }, // 10^304
+    { 0x5D538C7341CB67FEull, 0x74C1580963D539AFull }, // 10^303
+    { 0x4AA93D29016F8665ull, 0x43CDE0078310FAF3ull }, // 10^302
+    { 0x77752EA8024C0A3Cull, 0x0616333F381B2B1Eull }, // 10^301
+    { 0x5F90F22001D66E96ull, 0x3811C298F9AF55B1ull }, // 10^300
+    { 0x4C73F4E667DEBEDEull, 0x600E35472E25DE28ull }, // 10^299
+    { 0x7A532170A6313164ull, 0x3349EED849D6303Full }, // 10^298
+    { 0x61DC1AC084F42783ull, 0x42A18BE03B11C033ull }, // 10^297
+    { 0x4E49AF006A5CEC69ull, 0x1BB46FE695A7CCF5ull }, // 10^296
+    { 0x7D42B19A43C7E0A8ull, 0x2C53E63DBC3FAE55ull }, // 10^295
+    { 0x64355AE1CFD31A20ull, 0x237651CAFCFFBEAAull }, // 10^294
+    { 0x502AAF1B0CA8E1B3ull, 0x35F8416F30CC9888ull }, // 10^293
+    { 0x402225AF3D53E7C2ull, 0x5E603458F3D6E06Dull }, // 10^292
+    { 0x669D0918621FD937ull, 0x4A3386F4B957CD7Bull }, // 10^291
+    { 0x52173A79E8197A92ull, 0x6E8F9F2A2DDFD796ull }, // 10^290
+    { 0x41AC2EC7ECE12EDBull, 0x720C7F54F17FDFABull }, // 10^289
+    { 0x69137E0CAE3517C6ull, 0x1CE0CBBB1BFFCC45ull }, // 10^288
+    { 0x540F980A24F74638ull, 0x171A3C95AFFFD69Eull }, // 10^287
+    { 0x433FACD4EA5F6B60ull, 0x127B63AAF3331218ull }, // 10^286
+    { 0x6B991487DD657899ull, 0x6A5F05DE51EB5026ull }, // 10^285
+    { 0x5614106CB11DFA14ull, 0x5518D17EA7EF7352ull }, // 10^284
+    { 0x44DCD9F08DB194DDull, 0x2A7A41321FF2C2A8ull }, // 10^283
+    { 0x6E2E2980E2B5BAFBull, 0x5D906850331E043Full }, // 10^282
+    { 0x5824EE00B55E2F2Full, 0x647386A68F4B3699ull }, // 10^281
+    { 0x4683F19A2AB1BF59ull, 0x36C2D21ED908F87Bull }, // 10^280
+    { 0x70D31C29DDE93228ull, 0x579E1CFE280E5A5Dull }, // 10^279
+    { 0x5A427CEE4B20F4EDull, 0x2C7E7D98200B7B7Eull }, // 10^278
+    { 0x483530BEA280C3F1ull, 0x09FECAE019A2C932ull }, // 10^277
+    { 0x73884DFDD0CE064Eull, 0x43314499C29E0EB6ull }, // 10^276
+    { 0x5C6D0B3173D8050Bull, 0x4F5A9D47CEE4D891ull }, // 10^275
+    { 0x49F0D5C129799DA2ull, 0x72AEE4397250AD41ull }, // 10^274
+    { 0x764E22CEA8C295D1ull, 0x377E39F583B44868ull }, // 10^273
+    { 0x5EA4E8A553CEDE41ull, 0x12CB61913629D387ull }, // 10^272
+    { 0x4BB72084430BE500ull, 0x756F8140F8217605ull }, // 10^271
+    { 0x792500D39E796E67ull, 0x6F18CECE59CF233Cull }, // 10^270
+    { 0x60EA670FB1FABEB9ull, 0x3F470BD847D8E8FDull }, // 10^269
+    { 0x4D885272F4C89894ull, 0x329F3CAD064720CAull }, // 10^268
+    { 0x7C0D50B7EE0DC0EDull, 0x37652DE1A3A50143ull }, // 10^267
+    { 0x633DDA2CBE716724ull, 0x2C50F1814FB73436ull }, // 10^266
+    { 0x4F64AE8A31F45283ull, 0x3D0D8E010C92902Bull }, // 10^265
+    { 0x7F077DA9E986EA6Bull, 0x7B48E334E0EA8045ull }, // 10^264
+    { 0x659F97BB2138BB89ull, 0x49071C2A4D88669Dull }, // 10^263
+    { 0x514C796280FA2FA1ull, 0x20D27CEEA46D1EE4ull }, // 10^262
+    { 0x4109FAB533FB594Dull, 0x670ECA58838A7F1Dull }, // 10^261
+    { 0x680FF788532BC216ull, 0x0B4ADD5A6C10CB62ull }, // 10^260
+    { 0x533FF939DC2301ABull, 0x22A24AAEBCDA3C4Eull }, // 10^259
+    { 0x4299942E49B59AEFull, 0x354EA22563E1C9D8ull }, // 10^258
+    { 0x6A8F537D42BC2B18ull, 0x554A9D089FCFA95Aull }, // 10^257
+    { 0x553F75FDCEFCEF46ull, 0x776EE406E63FBAAEull }, // 10^256
+    { 0x4432C4CB0BFD8C38ull, 0x5F8BE99F1E996225ull }, // 10^255
+    { 0x6D1E07AB466279F4ull, 0x327975CB64289D08ull }, // 10^254
+    { 0x574B3955D1E86190ull, 0x28612B091CED4A6Dull }, // 10^253
+    { 0x45D5C777DB204E0Dull, 0x06B4226DB0BDD524ull }, // 10^252
+    { 0x6FBC72595E9A167Bull, 0x24536A491AC95506ull }, // 10^251
+    { 0x59638EADE54811FCull, 0x1D0F883A7BD44405ull }, // 10^250
+    { 0x4782D88B1DD34196ull, 0x4A72D361FCA9D004ull }, // 10^249
+    { 0x726AF411C952028Aull, 0x43EAEBCFFAA94CD3ull }, // 10^248
+    { 0x5B88C3416DDB353Bull, 0x4FEF230CC88770A9ull }, // 10^247
+    { 0x493A35CDF17C2A96ull, 0x0CBF4F3D6D3926EEull }, // 10^246
+    { 0x7529EFAFE8C6AA89ull, 0x61321862485B717Cull }, // 10^245
+    { 0x5DBB262653D22207ull, 0x675B46B506AF8DFDull }, // 10^244
+    { 0x4AFC1E850FDB4E6Cull, 0x52AF6BC405593E64ull }, // 10^243
+    { 0x77F9CA6E7FC54A47ull, 0x377F12D33BC1FD6Dull }, // 10^242
+    { 0x5FFB085866376E9Full, 0x45FF42429634CABDull }, // 10^241
+    { 0x4CC8D379EB5F8BB2ull, 0x6B329B68782A3BCBull }, // 10^240
+    { 0x7ADAEBF64565AC51ull, 0x2B842BDA59DD2C77ull }, // 10^239
+    { 0x6248BCC5045156A7ull, 0x3C69BCAEAE4A89F9ull }, // 10^238
+    { 0x4EA0970403744552ull, 0x6387CA25583BA194ull }, // 10^237
+    { 0x7DCDBE6CD253A21Eull, 0x05A6103BC05F68EDull }, // 10^236
+    { 0x64A498570EA94E7Eull, 0x37B80CFC99E5ED8Aull }, // 10^235
+    { 0x5083AD1272210B98ull, 0x2C933D96E184BE08ull }, // 10^234
+    { 0x40695741F4E73C79ull, 0x7075CADF1AD09807ull }, // 10^233
+    { 0x670EF2032171FA5Cull, 0x4D8944982AE759A4ull }, // 10^232
+    { 0x52725B35B45B2EB0ull, 0x3E076A135585E150ull }, // 10^231
+    { 0x41F515C49048F226ull, 0x64D2BB42AAD1810Dull }, // 10^230
+    { 0x698822D41A0E503Eull, 0x07B7920444826815ull }, // 10^229
+    { 0x546CE8A9AE71D9CBull, 0x1FC60E69D0685344ull }, // 10^228
+    { 0x438A53BAF1F4AE3Cull, 0x196B3EBB0D20429Dull }, // 10^227
+    { 0x6C1085F7E9877D2Dull, 0x0F11FDF815006A94ull }, // 10^226
+    { 0x56739E5FEE05FDBDull, 0x58DB319344005543ull }, // 10^225
+    { 0x45294B7FF19E6497ull, 0x60AF5ADC3666AA9Cull }, // 10^224
+    { 0x6EA878CCB5CA3A8Cull, 0x344BC4938A3DDDC7ull }, // 10^223
+    { 0x5886C70A2B082ED6ull, 0x5D096A0FA1CB17D2ull }, // 10^222
+    { 0x46D238D4EF39BF12ull, 0x173ABB3FB4A27975ull }, // 10^221
+    { 0x71505AEE4B8F981Dull, 0x0B912B992103F588ull }, // 10^220
+    { 0x5AA6AF25093FACE4ull, 0x0940EFADB4032AD3ull }, // 10^219
+    { 0x488558EA6DCC8A50ull, 0x07672624900288A9ull }, // 10^218
+    { 0x74088E43E2E0DD4Cull, 0x723EA36DB337410Eull }, // 10^217
+    { 0x5CD3A5031BE71770ull, 0x5B654F8AF5C5CDA5ull }, // 10^216
+    { 0x4A42EA68E31F45F3ull, 0x62B772D5916B0AEBull }, // 10^215
+    { 0x76D1770E38320986ull, 0x0458B7BC1BDE77DDull }, // 10^214
+    { 0x5F0DF8D82CF4D46Bull, 0x1D13C630164B9318ull }, // 10^213
+    { 0x4C0B2D79BD90A9EFull, 0x30DC9E8CDEA2DC13ull }, // 10^212
+    { 0x79AB7BF5FC1AA97Full, 0x0160FDAE31049351ull }, // 10^211
+    { 0x6155FCC4C9AEEDFFull, 0x1AB3FE24F403A90Eull }, // 10^210
+    { 0x4DDE63D0A158BE65ull, 0x6229981D9002EDA5ull }, // 10^209
+    { 0x7C97061A9BC130A2ull, 0x69DC2695B337E2A1ull }, // 10^208
+    { 0x63AC04E2163426E8ull, 0x54B01EDE28F9821Bull }, // 10^207
+    { 0x4FBCD0B4DE901F20ull, 0x43C018B1BA6134E2ull }, // 10^206
+    { 0x7F9481216419CB67ull, 0x1F99C11C5D68549Dull }, // 10^205
+    { 0x6610674DE9AE3C52ull, 0x4C7B00E37DED107Eull }, // 10^204
+    { 0x51A6B90B21583042ull, 0x09FC00B5FE574065ull }, // 10^203
+    { 0x41522DA2811359CEull, 0x3B3000919845CD1Dull }, // 10^202
+    { 0x68837C3734EBC2E3ull, 0x784CCDB5C06FAE95ull }, // 10^201
+    { 0x539C635F5D8968B6ull, 0x2D0A3E2B00595877ull }, // 10^200
+    { 0x42E382B2B13ABA2Bull, 0x3DA1CB5599E11393ull }, // 10^199
+    { 0x6B059DEAB52AC378ull, 0x629C7888F634EC1Eull }, // 10^198
+    { 0x559E17EEF755692Dull, 0x3549FA072B5D89B1ull }, // 10^197
+    { 0x447E798BF91120F1ull, 0x1107FB38EF7E07C1ull }, // 10^196
+    { 0x6D9728DFF4E834B5ull, 0x01A65EC17F300C68ull }, // 10^195
+    { 0x57AC20B32A535D5Dull, 0x4E1EB23465C009EDull }, // 10^194
+    { 0x46234D5C21DC4AB1ull, 0x24E55B5D1E333B24ull }, // 10^193
+    { 0x70387BC69C93AAB5ull, 0x216EF894FD1EC506ull }, // 10^192
+    { 0x59C6C96BB076222Aull, 0x4DF2607730E56A6Cull }, // 10^191
+    { 0x47D23ABC8D2B4E88ull, 0x3E5B805F5A5121F0ull }, // 10^190
+    { 0x72E9F79415121740ull, 0x63C59A322A1B697Full }, // 10^189
+    { 0x5BEE5FA9AA74DF67ull, 0x03047B5B54E2BACCull }, // 10^188
+    { 0x498B7FBAEEC3E5ECull, 0x0269FC4910B5623Dull }, // 10^187
+    { 0x75ABFF917E063CACull, 0x6A432D41B45569FBull }, // 10^186
+    { 0x5E2332DACB38308Aull, 0x21CF5767C37787FCull }, // 10^185
+    { 0x4B4F5BE23C2CF3A1ull, 0x67D912B9692C6CCAull }, // 10^184
+    { 0x787EF969F9E185CFull, 0x595B5128A8471476ull }, // 10^183
+    { 0x60659454C7E79E3Full, 0x6115DA86ED05A9F8ull }, // 10^182
+    { 0x4D1E1043D31FB1CCull, 0x4DAB1538BD9E2193ull }, // 10^181
+    { 0x7B634D3951CC4FADull, 0x62AB552795C9CF52ull }, // 10^180
+    { 0x62B5D7610E3D0C8Bull, 0x0222AA86116E3F75ull }, // 10^179
+    { 0x4EF7DF80D830D6D5ull, 0x4E822204DABE992Aull }, // 10^178
+    { 0x7E59659AF38157BCull, 0x17369CD49130F510ull }, // 10^177
+    { 0x65145148C2CDDFC9ull, 0x5F5EE3DD40F3F740ull }, // 10^176
+    { 0x50DD0DD3CF0B196Eull, 0x1918B64A9A5CC5CDull }, // 10^175
+    { 0x40B0D7DCA5A27ABEull, 0x4746F83BAEB09E3Eull }, // 10^174
+    { 0x678159610903F797ull, 0x253E59F91780FD2Full }, // 10^173
+    { 0x52CDE11A6D9CC612ull, 0x50FEAE60DF9A6426ull }, // 10^172
+    { 0x423E4DAEBE1704DBull, 0x5A65584D7FAEB685ull }, // 10^171
+    { 0x69FD4917968B3AF9ull, 0x10A226E265E4573Bull }, // 10^170
+    { 0x54CAA0DFABA29594ull, 0x0D4E8581EB1D1295ull }, // 10^169
+    { 0x43D54D7FBC821143ull, 0x243ED134BC174211ull }, // 10^168
+    { 0x6C887BFF94034ED2ull, 0x06CAE85460253682ull }, // 10^167
+    { 0x56D396661002A574ull, 0x6BD586A9E6842B9Bull }, // 10^166
+    { 0x457611EB40021DF7ull, 0x09779EEE52035616ull }, // 10^165
+    { 0x6F234FDECCD02FF1ull, 0x5BF297E3B66BBCEFull }, // 10^164
+    { 0x58E90CB23D73598Eull, 0x165BACB62B8963F3ull }, // 10^163
+    { 0x4720D6F4FDF5E13Eull, 0x451623C4EFA11CC2ull }, // 10^162
+    { 0x71CE24BB2FEFCECAull, 0x3B569FA17F682E03ull }, // 10^161
+    { 0x5B0B5095BFF30BD5ull, 0x15DEE61ACC535803ull }, // 10^160
+    { 0x48D5DA11665C0977ull, 0x2B18B8157042ACCFull }, // 10^159
+    { 0x74895CE8A3C6758Bull, 0x5E8DF355806AAE18ull }, // 10^158
+    { 0x5D3AB0BA1C9EC46Full, 0x653E5C4466BBBE7Aull }, // 10^157
+    { 0x4A955A2E7D4BD059ull, 0x3765169D1EFC9861ull }, // 10^156
+    { 0x77555D172EDFB3C2ull, 0x256E8A94FE60F3CFull }, // 10^155
+    { 0x5F777DAC257FC301ull, 0x6ABED543FEB3F63Full }, // 10^154
+    { 0x4C5F97BCEACC9C01ull, 0x3BCBDDCFFEF65E99ull }, // 10^153
+    { 0x7A328C6177ADC668ull, 0x5FAC961997F0975Bull }, // 10^152
+    { 0x61C209E792F16B86ull, 0x7FBD44E1465A12AFull }, // 10^151
+    { 0x4E34D4B9425ABC6Bull, 0x7FCA9D810514DBBFull }, // 10^150
+    { 0x7D21545B9D5DFA46ull, 0x32DDC8CE6E87C5FFull }, // 10^149
+    { 0x641AA9E2E44B2E9Eull, 0x5BE4A0A525396B32ull }, // 10^148
+    { 0x501554B5836F587Eull, 0x7CB6E6EA842DEF5Cull }, // 10^147
+    { 0x4011109135F2AD32ull, 0x30925255368B25E3ull }, // 10^146
+    { 0x6681B41B89844850ull, 0x4DB6EA21F0DEA304ull }, // 10^145
+    { 0x52015CE2D469D373ull, 0x57C5881B2718826Aull }, // 10^144
+    { 0x419AB0B576BB0F8Full, 0x5FD139AF527A01EFull }, // 10^143
+    { 0x68F781225791B27Full, 0x4C81F5E550C3364Aull }, // 10^142
+    { 0x53F9341B79415B99ull, 0x239B2B1DDA35C508ull }, // 10^141
+    { 0x432DC3492DCDE2E1ull, 0x02E288E4AE916A6Dull }, // 10^140
+    { 0x6B7C6BA849496B01ull, 0x516A74A1174F10AEull }, // 10^139
+    { 0x55FD22ED076DEF34ull, 0x4121F6E745D8DA25ull }, // 10^138
+    { 0x44CA82573924BF5Dull, 0x1A8192529E4714EBull }, // 10^137
+    { 0x6E10D08B8EA1322Eull, 0x5D9C1D50FD3E87DDull }, // 10^136
+    { 0x580D73A2D880F4F2ull, 0x17B01773FDCB9FE4ull }, // 10^135
+    { 0x4671294F139A5D8Eull, 0x4626792997D61984ull }, // 10^134
+    { 0x70B50EE4EC2A2F4Aull, 0x3D0A5B75BFBCF59Full }, // 10^133
+    { 0x5A2A7250BCEE8C3Bull, 0x4A6EAF916630C47Full }, // 10^132
+    { 0x4821F50D63F209C9ull, 0x21F2260DEB5A36CCull }, // 10^131
+    { 0x736988156CB6760Eull, 0x69837016455D247Aull }, // 10^130
+    { 0x5C546CDDF091F80Bull, 0x6E02C011D1175062ull }, // 10^129
+    { 0x49DD23E4C074C66Full, 0x719BCCDB0DAC404Eull }, // 10^128
+    { 0x762E9FD467213D7Full, 0x68F947C4E2AD33B0ull }, // 10^127
+    { 0x5E8BB3105280FDFFull, 0x6D94396A4EF0F627ull }, // 10^126
+    { 0x4BA2F5A6A8673199ull, 0x3E102DEEA58D91B9ull }, // 10^125
+    { 0x7904BC3DDA3EB5C2ull, 0x3019E3176F48E927ull }, // 10^124
+    { 0x60D09697E1CBC49Bull, 0x4014B5AC590720ECull }, // 10^123
+    { 0x4D73ABACB4A303AFull, 0x4CDD5E237A6C1A57ull }, // 10^122
+    { 0x7BEC45E12104D2B2ull, 0x47C8969F2A46908Aull }, // 10^121
+    { 0x63236B1A80D0A88Eull, 0x6CA0787F5505406Full }, // 10^120
+    { 0x4F4F88E200A6ED3Full, 0x0A19F9FF773766BFull }, // 10^119
+    { 0x7EE5A7D0010B1531ull, 0x5CF65CCBF1F23DFEull }, // 10^118
+    { 0x6584864000D5AA8Eull, 0x172B7D6FF4C1CB32ull }, // 10^117
+    { 0x5136D1CCCD77BBA4ull, 0x78EF978CC3CE3C28ull }, // 10^116
+    { 0x40F8A7D70AC62FB7ull, 0x13F2DFA3CFD83020ull }, // 10^115
+    { 0x67F43FBE77A37F8Bull, 0x398499061959E699ull }, // 10^114
+    { 0x5329CC985FB5FFA2ull, 0x6136E0D1ADE18548ull }, // 10^113
+    { 0x4287D6E04C91994Full, 0x00F8B3DAF181376Dull }, // 10^112
+    { 0x6A72F166E0E8F54Bull, 0x1B27862B1C01F247ull }, // 10^111
+    { 0x5528C11F1A53F76Full, 0x2F52D1BC1667F506ull }, // 10^110
+    { 0x44209A7F48432C59ull, 0x0C424163451FF738ull }, // 10^109
+    { 0x6D00F7320D3846F4ull, 0x7A039BD208332526ull }, // 10^108
+    { 0x5733F8F4D76038C3ull, 0x7B361641A028EA85ull }, // 10^107
+    { 0x45C32D90AC4CFA36ull, 0x2F5E78348020BB9Eull }, // 10^106
+    { 0x6F9EAF4DE07B29F0ull, 0x4BCA59ED99CDF8FCull }, // 10^105
+    { 0x594BBF71806287F3ull, 0x563B7B247B0B2D96ull }, // 10^104
+    { 0x476FCC5ACD1B9FF6ull, 0x11C92F50626F57ACull }, // 10^103
+    { 0x724C7A2AE1C5CCBDull, 0x02DB7EE703E55912ull }, // 10^102
+    { 0x5B7061BBE7D17097ull, 0x1BE2CBEC031DE0DCull }, // 10^101
+    { 0x4926B496530DF3ACull, 0x164F09899C17E716ull }, // 10^100
+    { 0x750ABA8A1E7CB913ull, 0x3D4B4275C68CA4F0ull }, // 10^99
+    { 0x5DA22ED4E530940Full, 0x4AA29B916BA3B726ull }, // 10^98
+    { 0x4AE825771DC07672ull, 0x6EE87C74561C9285ull }, // 10^97
+    { 0x77D9D58B62CD8A51ull, 0x3173FA53BCFA8408ull }, // 10^96
+    { 0x5FE177A2B5713B74ull, 0x278FFB7630C869A0ull }, // 10^95
+    { 0x4CB45FB55DF42F90ull, 0x1FA662C4F3D387B3ull }, // 10^94
+    { 0x7ABA32BBC986B280ull, 0x32A3D13B1FB8D91Full }, // 10^93
+    { 0x622E8EFCA1388ECDull, 0x0EE9742F4C93E0E6ull }, // 10^92
+    { 0x4E8BA596E760723Dull, 0x58BAC3590A0FE71Eull }, // 10^91
+    { 0x7DAC3C24A5671D2Full, 0x412AD228101971C9ull }, // 10^90
+    { 0x6489C9B6EAB8E426ull, 0x00EF0E8673478E3Bull }, // 10^89
+    { 0x506E3AF8BBC71CEBull, 0x1A58D86B8F6C71C9ull }, // 10^88
+    { 0x40582F2D6305B0BCull, 0x1513E0560C56C16Eull }, // 10^87
+    { 0x66F37EAF04D5E793ull, 0x3B530089AD579BE2ull }, // 10^86
+    { 0x525C6558D0AB1FA9ull, 0x15DC006E2446164Full }, // 10^85
+    { 0x41E384470D55B2EDull, 0x5E4999F1B69E783Full }, // 10^84
+    { 0x696C06D81555EB15ull, 0x7D428FE92430C065ull }, // 10^83
+    { 0x54566BE0111188DEull, 0x31020CBA835A3384ull }, // 10^82
+    { 0x4378564CDA746D7Eull, 0x5A680A2ECF7B5C69ull }, // 10^81
+    { 0x6BF3BD47C3ED7BFDull, 0x770CDD17B25EFA42ull }, // 10^80
+    { 0x565C976C9CBDFCCBull, 0x1270B0DFC1E59502ull }, // 10^79
+    { 0x4516DF8A16FE63D5ull, 0x5B8D5A4C9B1E10CEull }, // 10^78
+    { 0x6E8AFF4357FD6C89ull, 0x127BC3ADC4FCE7B0ull }, // 10^77
+    { 0x586F329C466456D4ull, 0x0EC96957D0CA52F3ull }, // 10^76
+    { 0x46BF5BB038504576ull, 0x3F07877973D50F29ull }, // 10^75
+    { 0x71322C4D26E6D58Aull, 0x31A5A58F1FBB4B75ull }, // 10^74
+    { 0x5A8E89D75252446Eull, 0x5AEAEAD8E62F6F91ull }, // 10^73
+    { 0x487207DF750E9D25ull, 0x2F22557A51BF8C74ull }, // 10^72
+    { 0x73E9A63254E42EA2ull, 0x1836EF2A1C65AD86ull }, // 10^71
+    { 0x5CBAEB5B771CF21Bull, 0x2CF8BF54E3848AD2ull }, // 10^70
+    { 0x4A2F22AF927D8E7Cull, 0x23FA32AA4F9D3BDBull }, // 10^69
+    { 0x76B1D118EA627D93ull, 0x5329EAAA18FB92F8ull }, // 10^68
+    { 0x5EF4A74721E86476ull, 0x0F54BBBB472FA8C6ull }, // 10^67
+    { 0x4BF6EC38E7ED1D2Bull, 0x25DD62FC38F2ED6Cull }, // 10^66
+    { 0x798B138E3FE1C845ull, 0x22FBD1938E517BDFull }, // 10^65
+    { 0x613C0FA4FFE7D36Aull, 0x4F2FDADC71DAC97Full }, // 10^64
+    { 0x4DC9A61D998642BBull, 0x58F3157D27E23ACCull }, // 10^63
+    { 0x7C75D695C2706AC5ull, 0x74B82261D969F7ADull }, // 10^62
+    { 0x63917877CEC0556Bull, 0x10934EB4ADEE5FBEull }, // 10^61
+    { 0x4FA793930BCD1122ull, 0x4075D8908B251965ull }, // 10^60
+    { 0x7F7285B812E1B504ull, 0x00BC8DB411D4F56Eull }, // 10^59
+    { 0x65F537C675815D9Cull, 0x66FD3E29A7DD9125ull }, // 10^58
+    { 0x5190F96B91344AE3ull, 0x6BFDCB54864ADA84ull }, // 10^57
+    { 0x4140C78940F6A24Full, 0x6FFE3C439EA2486Aull }, // 10^56
+    { 0x6867A5A867F103B2ull, 0x7FFD2D38FDD073DCull }, // 10^55
+    { 0x53861E2053273628ull, 0x6664242D97D9F64Aull }, // 10^54
+    { 0x42D1B1B375B8F820ull, 0x51E9B68ADFE191D5ull }, // 10^53
+    { 0x6AE91C5255F4C034ull, 0x1CA924116635B621ull }, // 10^52
+    { 0x558749DB77F70029ull, 0x63BA83411E915E81ull }, // 10^51
+    { 0x446C3B15F9926687ull, 0x6962029A7EDAB201ull }, // 10^50
+    { 0x6D79F82328EA3DA6ull, 0x0F03375D97C45001ull }, // 10^49
+    { 0x5794C6828721CAEBull, 0x259C2C4ADFD04001ull }, // 10^48
+    { 0x46109ECED2816F22ull, 0x5149BD08B30D0001ull }, // 10^47
+    { 0x701A97B150CF1837ull, 0x3542C80DEB480001ull }, // 10^46
+    { 0x59AEDFC10D7279C5ull, 0x7768A00B22A00001ull }, // 10^45
+    { 0x47BF19673DF52E37ull, 0x79208008E8800001ull }, // 10^44
+    { 0x72CB5BD86321E38Cull, 0x5B67334174000001ull }, // 10^43
+    { 0x5BD5E313828182D6ull, 0x7C528F6790000001ull }, // 10^42
+    { 0x4977E8DC68679BDFull, 0x16A872B940000001ull }, // 10^41
+    { 0x758CA7C70D7292FEull, 0x5773EAC200000001ull }, // 10^40
+    { 0x5E0A1FD271287598ull, 0x45F6556800000001ull }, // 10^39
+    { 0x4B3B4CA85A86C47Aull, 0x04C5112000000001ull }, // 10^38
+    { 0x785EE10D5DA46D90ull, 0x07A1B50000000001ull }, // 10^37
+    { 0x604BE73DE4838AD9ull, 0x52E7C40000000001ull }, // 10^36
+    { 0x4D0985CB1D3608AEull, 0x0F1FD00000000001ull }, // 10^35
+    { 0x7B426FAB61F00DE3ull, 0x31CC800000000001ull }, // 10^34
+    { 0x629B8C891B267182ull, 0x5B0A000000000001ull }, // 10^33
+    { 0x4EE2D6D415B85ACEull, 0x7C08000000000001ull }, // 10^32
+    { 0x7E37BE2022C0914Bull, 0x1340000000000001ull }, // 10^31
+    { 0x64F964E68233A76Full, 0x2900000000000001ull }, // 10^30
+    { 0x50C783EB9B5C85F2ull, 0x5400000000000001ull }, // 10^29
+    { 0x409F9CBC7C4A04C2ull, 0x1000000000000001ull }, // 10^28
+    { 0x6765C793FA10079Dull, 0x0000000000000001ull }, // 10^27
+    { 0x52B7D2DCC80CD2E4ull, 0x0000000000000001ull }, // 10^26
+    { 0x422CA8B0A00A4250ull, 0x0000000000000001ull }, // 10^25
+    { 0x69E10DE76676D080ull, 0x0000000000000001ull }, // 10^24
+    { 0x54B40B1F852BDA00ull, 0x0000000000000001ull }, // 10^23
+    { 0x43C33C1937564800ull, 0x0000000000000001ull }, // 10^22
+    { 0x6C6B935B8BBD4000ull, 0x0000000000000001ull }, // 10^21
+    { 0x56BC75E2D6310000ull, 0x0000000000000001ull }, // 10^20
+    { 0x4563918244F40000ull, 0x0000000000000001ull }, // 10^19
+    { 0x6F05B59D3B200000ull, 0x0000000000000001ull }, // 10^18
+    { 0x58D15E1762800000ull, 0x0000000000000001ull }, // 10^17
+    { 0x470DE4DF82000000ull, 0x0000000000000001ull }, // 10^16
+    { 0x71AFD498D0000000ull, 0x0000000000000001ull }, // 10^15
+    { 0x5AF3107A40000000ull, 0x0000000000000001ull }, // 10^14
+    { 0x48C2739500000000ull, 0x0000000000000001ull }, // 10^13
+    { 0x746A528800000000ull, 0x0000000000000001ull }, // 10^12
+    { 0x5D21DBA000000000ull, 0x0000000000000001ull }, // 10^11
+    { 0x4A817C8000000000ull, 0x0000000000000001ull }, // 10^10
+    { 0x7735940000000000ull, 0x0000000000000001ull }, // 10^9
+    { 0x5F5E100000000000ull, 0x0000000000000001ull }, // 10^8
+    { 0x4C4B400000000000ull, 0x0000000000000001ull }, // 10^7
+    { 0x7A12000000000000ull, 0x0000000000000001ull }, // 10^6
+    { 0x61A8000000000000ull, 0x0000000000000001ull }, // 10^5
+    { 0x4E20000000000000ull, 0x0000000000000001ull }, // 10^4
+    { 0x7D00000000000000ull, 0x0000000000000001ull }, // 10^3
+    { 0x6400000000000000ull, 0x0000000000000001ull }, // 10^2
+    { 0x5000000000000000ull, 0x0000000000000001ull }, // 10^1
+    { 0x4000000000000000ull, 0x0000000000000001ull }, // 10^0
+    { 0x6666666666666666ull, 0x3333333333333334ull }, // 10^-1
+    { 0x51EB851EB851EB85ull, 0x0F5C28F5C28F5C29ull }, // 10^-2
+    { 0x4189374BC6A7EF9Dull, 0x5916872B020C49BBull }, // 10^-3
+    { 0x68DB8BAC710CB295ull, 0x74F0D844D013A92Bull }, // 10^-4
+    { 0x53E2D6238DA3C211ull, 0x43F3E0370CDC8755ull }, // 10^-5
+    { 0x431BDE82D7B634DAull, 0x698FE69270B06C44ull }, // 10^-6
+    { 0x6B5FCA6AF2BD215Eull, 0x0F4CA41D811A46D4ull }, // 10^-7
+    { 0x55E63B88C230E77Eull, 0x3F70834ACDAE9F10ull }, // 10^-8
+    { 0x44B82FA09B5A52CBull, 0x4C5A02A23E254C0Dull }, // 10^-9
+    { 0x6DF37F675EF6EADFull, 0x2D5CD10396A21347ull }, // 10^-10
+    { 0x57F5FF85E592557Full, 0x3DE3DA69454E75D3ull }, // 10^-11
+    { 0x465E6604B7A84465ull, 0x7E4FE1EDD10B9175ull }, // 10^-12
+    { 0x709709A125DA0709ull, 0x4A19697C81AC1BEFull }, // 10^-13
+    { 0x5A126E1A84AE6C07ull, 0x54E1213067BCE326ull }, // 10^-14
+    { 0x480EBE7B9D58566Cull, 0x43E74DC052FD8285ull }, // 10^-15
+    { 0x734ACA5F6226F0ADull, 0x530BAF9A1E626A6Dull }, // 10^-16
+    { 0x5C3BD5191B525A24ull, 0x426FBFAE7EB521F1ull }, // 10^-17
+    { 0x49C97747490EAE83ull, 0x4EBFCC8B9890E7F4ull }, // 10^-18
+    { 0x760F253EDB4AB0D2ull, 0x4ACC7A78F41B0CBAull }, // 10^-19
+    { 0x5E72843249088D75ull, 0x223D2EC729AF3D62ull }, // 10^-20
+    { 0x4B8ED0283A6D3DF7ull, 0x34FDBF05BAF29781ull }, // 10^-21
+    { 0x78E480405D7B9658ull, 0x54C931A2C4B758CFull }, // 10^-22
+    { 0x60B6CD004AC94513ull, 0x5D6DC14F03C5E0A5ull }, // 10^-23
+    { 0x4D5F0A66A23A9DA9ull, 0x31249AA59C9E4D51ull }, // 10^-24
+    { 0x7BCB43D769F762A8ull, 0x4EA0F76F60FD4882ull }, // 10^-25
+    { 0x63090312BB2C4EEDull, 0x254D92BF80CAA068ull }, // 10^-26
+    { 0x4F3A68DBC8F03F24ull, 0x1DD7A89933D54D20ull }, // 10^-27
+    { 0x7EC3DAF941806506ull, 0x62F2A75B86221500ull }, // 10^-28
+    { 0x65697BFA9ACD1D9Full, 0x025BB91604E810CDull }, // 10^-29
+    { 0x51212FFBAF0A7E18ull, 0x684960DE6A5340A4ull }, // 10^-30
+    { 0x40E7599625A1FE7Aull, 0x203AB3E521DC33B6ull }, // 10^-31
+    { 0x67D88F56A29CCA5Dull, 0x19F7863B696052BDull }, // 10^-32
+    { 0x5313A5DEE87D6EB0ull, 0x7B2C6B62BAB37564ull }, // 10^-33
+    { 0x42761E4BED31255Aull, 0x2F56BC4EFBC2C450ull }, // 10^-34
+    { 0x6A5696DFE1E83BC3ull, 0x655793B192D13A1Aull }, // 10^-35
+    { 0x5512124CB4B9C969ull, 0x377942F475742E7Bull }, // 10^-36
+    { 0x440E750A2A2E3ABAull, 0x5F9435905DF68B96ull }, // 10^-37
+    { 0x6CE3EE76A9E3912Aull, 0x65B9EF4D63241289ull }, // 10^-38
+    { 0x571CBEC554B60DBBull, 0x6AFB25D782834207ull }, // 10^-39
+    { 0x45B0989DDD5E7163ull, 0x08C8EB12CECF6806ull }, // 10^-40
+    { 0x6F80F42FC8971BD1ull, 0x5ADB11B7B14BD9A3ull }, // 10^-41
+    { 0x5933F68CA078E30Eull, 0x157C0E2C8DD647B5ull }, // 10^-42
+    { 0x475CC53D4D2D8271ull, 0x5DFCD823A4AB6C91ull }, // 10^-43
+    { 0x722E086215159D82ull, 0x632E269F6DDF141Bull }, // 10^-44
+    { 0x5B5806B4DDAAE468ull, 0x4F581EE5F17F4349ull }, // 10^-45
+    { 0x49133890B1558386ull, 0x72ACE584C1329C3Bull }, // 10^-46
+    { 0x74EB8DB44EEF38D7ull, 0x6AAE3C079B842D2Aull }, // 10^-47
+    { 0x5D893E29D8BF60ACull, 0x5558300616035755ull }, // 10^-48
+    { 0x4AD431BB13CC4D56ull, 0x7779C004DE6912ABull }, // 10^-49
+    { 0x77B9E92B52E07BBEull, 0x258F99A163DB5111ull }, // 10^-50
+    { 0x5FC7EDBC424D2FCBull, 0x37A614811CAF740Dull }, // 10^-51
+    { 0x4C9FF163683DBFD5ull, 0x7951AA00E3BF900Bull }, // 10^-52
+    { 0x7A998238A6C932EFull, 0x754F7667D2CC19ABull }, // 10^-53
+    { 0x6214682D523A8F26ull, 0x2AA5F8530F09AE22ull }, // 10^-54
+    { 0x4E76B9BDDB620C1Eull, 0x55519375A5A1581Bull }, // 10^-55
+    { 0x7D8AC2C95F034697ull, 0x3BB5B8BC3C3559C5ull }, // 10^-56
+    { 0x646F023AB2690545ull, 0x7C9160969691149Eull }, // 10^-57
+    { 0x5058CE955B87376Bull, 0x16DAB3ABABA743B2ull }, // 10^-58
+    { 0x40470BAAAF9F5F88ull, 0x78AEF622EFB902F5ull }, // 10^-59
+    { 0x66D812AAB29898DBull, 0x0DE4BD04B2C19E54ull }, // 10^-60
+    { 0x524675555BAD4715ull, 0x57EA30D08F014B76ull }, // 10^-61
+    { 0x41D1F7777C8A9F44ull, 0x4654F3DA0C01092Cull }, // 10^-62
+    { 0x694FF258C7443207ull, 0x23BB1FC346680EACull }, // 10^-63
+    { 0x543FF513D29CF4D2ull, 0x4FC8E635D1ECD88Aull }, // 10^-64
+    { 0x43665DA9754A5D75ull, 0x263A51C4A7F0AD3Bull }, // 10^-65
+    { 0x6BD6FC425543C8BBull, 0x56C3B607731AAEC4ull }, // 10^-66
+    { 0x5645969B77696D62ull, 0x789C919F8F488BD0ull }, // 10^-67
+    { 0x4504787C5F878AB5ull, 0x46E3A7B2D906D640ull }, // 10^-68
+    { 0x6E6D8D93CC0C1122ull, 0x3E390C515B3E239Aull }, // 10^-69
+    { 0x5857A4763CD6741Bull, 0x4B60D6A77C31B615ull }, // 10^-70
+    { 0x46AC8391CA4529AFull, 0x55E7121F968E2B44ull }, // 10^-71
+    { 0x711405B6106EA919ull, 0x0971B698F0E3786Dull }, // 10^-72
+    { 0x5A766AF80D255414ull, 0x078E2BAD8D82C6BDull }, // 10^-73
+    { 0x485EBBF9A41DDCDCull, 0x6C71BC8AD79BD231ull }, // 10^-74
+    { 0x73CAC65C39C96161ull, 0x2D82C7448C2C8382ull }, // 10^-75
+    { 0x5CA23849C7D44DE7ull, 0x3E023903A356CF9Bull }, // 10^-76
+    { 0x4A1B603B06437185ull, 0x7E682D9C82ABD949ull }, // 10^-77
+    { 0x76923391A39F1C09ull, 0x4A4048FA6AAC8EDBull }, // 10^-78
+    { 0x5EDB5C7482E5B007ull, 0x55003A61EEF07249ull }, // 10^-79
+    { 0x4BE2B05D35848CD2ull, 0x773361E7F259F507ull }, // 10^-80
+    { 0x796AB3C855A0E151ull, 0x3EB89CA6508FEE71ull }, // 10^-81
+    { 0x6122296D114D810Dull, 0x7EFA16EB73A6585Bull }, // 10^-82
+    { 0x4DB4EDF0DAA4673Eull, 0x3261ABEF8FB846AFull }, // 10^-83
+    { 0x7C54AFE7C43A3ECAull, 0x1D691318E5F3A44Bull }, // 10^-84
+    { 0x6376F31FD02E98A1ull, 0x64540F471E5C836Full }, // 10^-85
+    { 0x4F925C1973587A1Bull, 0x0376729F4B7D35F3ull }, // 10^-86
+    { 0x7F50935BEBC0C35Eull, 0x38BD84321261EFEBull }, // 10^-87
+    { 0x65DA0F7CBC9A35E5ull, 0x13CAD0280EB4BFEFull }, // 10^-88
+    { 0x517B3F96FD482B1Dull, 0x5CA240200BC3CCBFull }, // 10^-89
+    { 0x412F66126439BC17ull, 0x63B50019A3030A33ull }, // 10^-90
+    { 0x684BD683D38F9359ull, 0x1F88002904D1A9EAull }, // 10^-91
+    { 0x536FDECFDC72DC47ull, 0x32D3335403DAEE55ull }, // 10^-92
+    { 0x42BFE57316C249D2ull, 0x5BDC291003158B77ull }, // 10^-93
+    { 0x6ACCA251BE03A951ull, 0x12F9DB4CD1BC1258ull }, // 10^-94
+    { 0x557081DAFE695440ull, 0x7594AF70A7C9A847ull }, // 10^-95
+    { 0x445A017BFEBAA9CDull, 0x4476F2C0863AED06ull }, // 10^-96
+    { 0x6D5CCF2CCAC442E2ull, 0x3A57EACDA3917B3Cull }, // 10^-97
+    { 0x577D728A3BD03581ull, 0x7B7988A482DAC8FDull }, // 10^-98
+    { 0x45FDF53B630CF79Bull, 0x15FAD3B6CF156D97ull }, // 10^-99
+    { 0x6FFCBB923814BF5Eull, 0x565E1F8AE4EF15BEull }, // 10^-100
+    { 0x5996FC74F9AA32B2ull, 0x11E4E608B725AAFFull }, // 10^-101
+    { 0x47ABFD2A6154F55Bull, 0x27EA51A0928488CCull }, // 10^-102
+    { 0x72ACC843CEEE555Eull, 0x7310829A84074146ull }, // 10^-103
+    { 0x5BBD6D030BF1DDE5ull, 0x42739BAED005CDD2ull }, // 10^-104
+    { 0x49645735A327E4B7ull, 0x4EC2E2F24004A4A8ull }, // 10^-105
+    { 0x756D5855D1D96DF2ull, 0x4AD16B1D333AA10Cull }, // 10^-106
+    { 0x5DF11377DB1457F5ull, 0x2241227DC2954DA3ull }, // 10^-107
+    { 0x4B2742C648DD132Aull, 0x4E9A81FE35443E1Cull }, // 10^-108
+    { 0x783ED13D4161B844ull, 0x175D9CC9EED39694ull }, // 10^-109
+    { 0x603240FDCDE7C69Cull, 0x7917B0A18BDC7876ull }, // 10^-110
+    { 0x4CF500CB0B1FD217ull, 0x1412F3B46FE39392ull }, // 10^-111
+    { 0x7B219ADE7832E9BEull, 0x535185ED7FD285B6ull }, // 10^-112
+    { 0x628148B1F9C25498ull, 0x42A79E57997537C5ull }, // 10^-113
+    { 0x4ECDD3C1949B76E0ull, 0x3552E512E12A9304ull }, // 10^-114
+    { 0x7E161F9C20F8BE33ull, 0x6EEB081E3510EB39ull }, // 10^-115
+    { 0x64DE7FB01A609829ull, 0x3F226CE4F740BC2Eull }, // 10^-116
+    { 0x50B1FFC0151A1354ull, 0x3281F0B72C33C9BEull }, // 10^-117
+    { 0x408E66334414DC43ull, 0x42018D5F568FD498ull }, // 10^-118
+    { 0x674A3D1ED354939Full, 0x1CCF48988A7FBA8Dull }, // 10^-119
+    { 0x52A1CA7F0F76DC7Full, 0x30A5D3AD3B99620Bull }, // 10^-120
+    { 0x421B0865A5F8B065ull, 0x73B7DC8A96144E6Full }, // 10^-121
+    { 0x69C4DA3C3CC11A3Cull, 0x52BFC7442353B0B1ull }, // 10^-122
+    { 0x549D7B6363CDAE96ull, 0x756639034F7626F4ull }, // 10^-123
+    { 0x43B12F82B63E2545ull, 0x4451C735D92B525Dull }, // 10^-124
+    { 0x6C4EB26ABD303BA2ull, 0x3A1C71EFC1DEEA2Eull }, // 10^-125
+    { 0x56A55B889759C94Eull, 0x61B05B2634B254F2ull }, // 10^-126
+    { 0x45511606DF7B0772ull, 0x1AF37C1E908EAA5Bull }, // 10^-127
+    { 0x6EE8233E325E7250ull, 0x2B1F2CFDB41776F8ull }, // 10^-128
+    { 0x58B9B5CB5B7EC1D9ull, 0x6F4C23FE29AC5F2Dull }, // 10^-129
+    { 0x46FAF7D5E2CBCE47ull, 0x72A34FFE87BD18F1ull }, // 10^-130
+    { 0x71918C896ADFB073ull, 0x04387FFDA5FB5B1Bull }, // 10^-131
+    { 0x5ADAD6D4557FC05Cull, 0x0360666484C915AFull }, // 10^-132
+    { 0x48AF1243779966B0ull, 0x02B3851D3707448Cull }, // 10^-133
+    { 0x744B506BF28F0AB3ull, 0x1DEC082EBE720746ull }, // 10^-134
+    { 0x5D090D2328726EF5ull, 0x64BCD358985B3905ull }, // 10^-135
+    { 0x4A6DA41C205B8BF7ull, 0x6A30A913AD15C738ull }, // 10^-136
+    { 0x7715D36033C5ACBFull, 0x5D1AA81F7B560B8Cull }, // 10^-137
+    { 0x5F44A919C3048A32ull, 0x7DAEECE5FC44D609ull }, // 10^-138
+    { 0x4C36EDAE359D3B5Bull, 0x7E258A51969D7808ull }, // 10^-139
+    { 0x79F17C49EF61F893ull, 0x16A276E8F0FBF33Full }, // 10^-140
+    { 0x618DFD07F2B4C6DCull, 0x121B9253F3FCC299ull }, // 10^-141
+    { 0x4E0B30D328909F16ull, 0x41AFA84329970214ull }, // 10^-142
+    { 0x7CDEB4850DB431BDull, 0x4F7F739EA8F19CEDull }, // 10^-143
+    { 0x63E55D373E29C164ull, 0x3F99294BBA5AE3F1ull }, // 10^-144
+    { 0x4FEAB0F8FE87CDE9ull, 0x7FADBAA2FB7BE98Dull }, // 10^-145
+    { 0x7FDDE7F4CA72E30Full, 0x7F7C5DD1925FDC15ull }, // 10^-146
+    { 0x664B1FF7085BE8D9ull, 0x4C637E4141E649ABull }, // 10^-147
+    { 0x51D5B32C06AFED7Aull, 0x704F983434B83AEFull }, // 10^-148
+    { 0x4177C2899EF32462ull, 0x26A6135CF6F9C8BFull }, // 10^-149
+    { 0x68BF9DA8FE51D3D0ull, 0x3DD685618B294132ull }, // 10^-150
+    { 0x53CC7E20CB74A973ull, 0x4B12044E08EDCDC2ull }, // 10^-151
+    { 0x4309FE80A2C3BAC2ull, 0x6F419D0B3A57D7CEull }, // 10^-152
+    { 0x6B4330CDD1392AD1ull, 0x320294DEC3BFBFB0ull }, // 10^-153
+    { 0x55CF5A3E40FA88A7ull, 0x419BAA4BCFCC995Aull }, // 10^-154
+    { 0x44A5E1CB672ED3B9ull, 0x1AE2EEA30CA3ADE1ull }, // 10^-155
+    { 0x6DD636123EB152C1ull, 0x77D17DD1ADD2AFCFull }, // 10^-156
+    { 0x57DE91A832277567ull, 0x797464A7BE42263Full }, // 10^-157
+    { 0x464BA7B9C1B92AB9ull, 0x4790508631CE84FFull }, // 10^-158
+    { 0x70790C5C6928445Cull, 0x0C1A1A704FB0D4CCull }, // 10^-159
+    { 0x59FA7049EDB9D049ull, 0x567B4859D95A43D6ull }, // 10^-160
+    { 0x47FB8D07F161736Eull, 0x11FC39E17AAE9CABull }, // 10^-161
+    { 0x732C14D98235857Dull, 0x032D2968C44A9445ull }, // 10^-162
+    { 0x5C2343E134F79DFDull, 0x4F575453D03BA9D1ull }, // 10^-163
+    { 0x49B5CFE75D92E4CAull, 0x72AC4376402FBB0Eull }, // 10^-164
+    { 0x75EFB30BC8EB07ABull, 0x0446D256CD192B49ull }, // 10^-165
+    { 0x5E595C096D88D2EFull, 0x1D0575123DADBC3Aull }, // 10^-166
+    { 0x4B7AB0078AD3DBF2ull, 0x4A6AC40E97BE302Full }, // 10^-167
+    { 0x78C44CD8DE1FC650ull, 0x771139B0F2C9E6B1ull }, // 10^-168
+    { 0x609D0A4718196B73ull, 0x78DA948D8F07EBC1ull }, // 10^-169
+    { 0x4D4A6E9F467ABC5Cull, 0x60AEDD3E0C065634ull }, // 10^-170
+    { 0x7BAA4A9870C46094ull, 0x344AFB9679A3BD20ull }, // 10^-171
+    { 0x62EEA2138D69E6DDull, 0x103BFC78614FCA80ull }, // 10^-172
+    { 0x4F254E760ABB1F17ull, 0x26966393810CA200ull }, // 10^-173
+    { 0x7EA21723445E9825ull, 0x2423D2859B476999ull }, // 10^-174
+    { 0x654E78E9037EE01Dull, 0x69B642047C392148ull }, // 10^-175
+    { 0x510B93ED9C658017ull, 0x6E2B680396941AA0ull }, // 10^-176
+    { 0x40D60FF149EACCDFull, 0x71BC53361210154Dull }, // 10^-177
+    { 0x67BCE64EDCAAE166ull, 0x1C6085235019BBAEull }, // 10^-178
+    { 0x52FD850BE3BBE784ull, 0x7D1A041C40149625ull }, // 10^-179
+    { 0x42646A6FE9631F9Dull, 0x4A7B367D0010781Dull }, // 10^-180
+    { 0x6A3A43E642383295ull, 0x5D91F0C8001A59C8ull }, // 10^-181
+    { 0x54FB698501C68EDEull, 0x17A7F3D3334847D4ull }, // 10^-182
+    { 0x43FC546A67D20BE4ull, 0x79532975C2A03976ull }, // 10^-183
+    { 0x6CC6ED770C83463Bull, 0x0EEB75893766C256ull }, // 10^-184
+    { 0x57058AC5A39C382Full, 0x25892AD42C523512ull }, // 10^-185
+    { 0x459E089E1C7CF9BFull, 0x37A0EF102374F742ull }, // 10^-186
+    { 0x6F6340FCFA618F98ull, 0x59017E8038BB2536ull }, // 10^-187
+    { 0x591C33FD951AD946ull, 0x7A67986693C8EA91ull }, // 10^-188
+    { 0x4749C33144157A9Full, 0x151FAD1EDCA0BBA8ull }, // 10^-189
+    { 0x720F9EB539BBF765ull, 0x0832AE97C76792A5ull }, // 10^-190
+    { 0x5B3FB22A94965F84ull, 0x068EF21305EC7551ull }, // 10^-191
+    { 0x48FFC1BBAA11E603ull, 0x1ED8C1A8D189F774ull }, // 10^-192
+    { 0x74CC692C434FD66Bull, 0x4AF4690E1C0FF253ull }, // 10^-193
+    { 0x5D705423690CAB89ull, 0x225D20D816732843ull }, // 10^-194
+    { 0x4AC0434F873D5607ull, 0x35174D79AB8F5369ull }, // 10^-195
+    { 0x779A054C0B955672ull, 0x21BEE25C45B21F0Eull }, // 10^-196
+    { 0x5FAE6AA33C77785Bull, 0x3498B5169E2818D8ull }, // 10^-197
+    { 0x4C8B888296C5F9E2ull, 0x5D46F7454B534713ull }, // 10^-198
+    { 0x7A78DA6A8AD65C9Dull, 0x7BA4BED545520B52ull }, // 10^-199
+    { 0x61FA48553BDEB07Eull, 0x2FB6FF110441A2A8ull }, // 10^-200
+    { 0x4E61D37763188D31ull, 0x72F8CC0D9D014EEDull }, // 10^-201
+    { 0x7D6952589E8DAEB6ull, 0x1E5AE015C80217E1ull }, // 10^-202
+    { 0x645441E07ED7BEF8ull, 0x1848B344A001ACB4ull }, // 10^-203
+    { 0x504367E6CBDFCBF9ull, 0x603A2903B3348A2Aull }, // 10^-204
+    { 0x4035ECB8A3196FFBull, 0x002E873628F6D4EEull }, // 10^-205
+    { 0x66BCADF43828B32Bull, 0x19E40B89DB2487E3ull }, // 10^-206
+    { 0x52308B29C686F5BCull, 0x14B66FA17C1D3983ull }, // 10^-207
+    { 0x41C06F549ED25E30ull, 0x1091F2E7967DC79Cull }, // 10^-208
+    { 0x6933E554315096B3ull, 0x341CB7D8F0C93F5Full }, // 10^-209
+    { 0x542984435AA6DEF5ull, 0x767D5FE0C0A0FF80ull }, // 10^-210
+    { 0x435469CF7BB8B25Eull, 0x2B977FE70080CC66ull }, // 10^-211
+    { 0x6BBA42E592C11D63ull, 0x5F58CCA4CD9AE0A3ull }, // 10^-212
+    { 0x562E9BEADBCDB11Cull, 0x4C470A1D7148B3B6ull }, // 10^-213
+    { 0x44F216557CA48DB0ull, 0x3D05A1B1276D5C92ull }, // 10^-214
+    { 0x6E5023BBFAA0E2B3ull, 0x7B3C35E83F1560E9ull }, // 10^-215
+    { 0x58401C96621A4EF6ull, 0x2F635E5365AAB3EDull }, // 10^-216
+    { 0x4699B0784E7B725Eull, 0x591C4B75EAEEF658ull }, // 10^-217
+    { 0x70F5E726E3F8B6FDull, 0x74FA125644B18A26ull }, // 10^-218
+    { 0x5A5E5285832D5F31ull, 0x43FB41DE9D5AD4EBull }, // 10^-219
+    { 0x484B75379C244C27ull, 0x4FFC34B2177BDD89ull }, // 10^-220
+    { 0x73ABEEBF603A1372ull, 0x4CC6BAB68BF96274ull }, // 10^-221
+    { 0x5C898BCC4CFB42C2ull, 0x0A38955ED6611B90ull }, // 10^-222
+    { 0x4A07A309D72F689Bull, 0x21C6DDE5784DAFA7ull }, // 10^-223
+    { 0x76729E762518A75Eull, 0x693E2FD58D49190Bull }, // 10^-224
+    { 0x5EC2185E8413B918ull, 0x5431BFDE0AA0E0D5ull }, // 10^-225
+    { 0x4BCE79E536762DADull, 0x29C1664B3BB3E711ull }, // 10^-226
+    { 0x794A5CA1F0BD15E2ull, 0x0F9BD6DEC5ECA4E8ull }, // 10^-227
+    { 0x61084A1B26FDAB1Bull, 0x2616457F04BD50BAull }, // 10^-228
+    { 0x4DA03B48EBFE227Cull, 0x1E783798D09773C8ull }, // 10^-229
+    { 0x7C33920E46636A60ull, 0x30C058F480F252D9ull }, // 10^-230
+    { 0x635C74D8384F884Dull, 0x0D66AD9067284247ull }, // 10^-231
+    { 0x4F7D2A469372D370ull, 0x711EF14052869B6Cull }, // 10^-232
+    { 0x7F2EAA0A85848581ull, 0x34FE4ECD50D75F14ull }, // 10^-233
+    { 0x65BEEE6ED136D134ull, 0x2A650BD773DF7F43ull }, // 10^-234
+    { 0x51658B8BDA9240F6ull, 0x551DA312C319329Cull }, // 10^-235
+    { 0x411E093CAEDB672Bull, 0x5DB14F4235ADC217ull }, // 10^-236
+    { 0x68300EC77E2BD845ull, 0x7C4EE536BC49368Aull }, // 10^-237
+    { 0x5359A56C64EFE037ull, 0x7D0BEA92303A9208ull }, // 10^-238
+    { 0x42AE1DF050BFE693ull, 0x173CBBA8269541A0ull }, // 10^-239
+    { 0x6AB02FE6E79970EBull, 0x3EC792A6A422029Aull }, // 10^-240
+    { 0x5559BFEBEC7AC0BCull, 0x3239421EE9B4CEE1ull }, // 10^-241
+    { 0x4447CCBCBD2F0096ull, 0x5B6101B25490A581ull }, // 10^-242
+    { 0x6D3FADFAC84B3424ull, 0x2BCE691D541AA268ull }, // 10^-243
+    { 0x576624C8A03C29B6ull, 0x563EBA7DDCE21B87ull }, // 10^-244
+    { 0x45EB50A08030215Eull, 0x78322ECB171B4939ull }, // 10^-245
+    { 0x6FDEE76733803564ull, 0x59E9E47824F87527ull }, // 10^-246
+    { 0x597F1F85C2CCF783ull, 0x6187E9F9B72D2A86ull }, // 10^-247
+    { 0x4798E6049BD72C69ull, 0x346CBB2E2C242205ull }, // 10^-248
+    { 0x728E3CD42C8B7A42ull, 0x20ADF849E039D007ull }, // 10^-249
+    { 0x5BA4FD768A092E9Bull, 0x33BE603B19C7D99Full }, // 10^-250
+    { 0x4950CAC53B3A8BAFull, 0x42FEB3627B0647B3ull }, // 10^-251
+    { 0x754E113B91F745E5ull, 0x5197856A5E7072B8ull }, // 10^-252
+    { 0x5DD80DC941929E51ull, 0x27AC6ABB7EC05BC6ull }, // 10^-253
+    { 0x4B133E3A9ADBB1DAull, 0x52F05562CBCD1638ull }, // 10^-254
+    { 0x781EC9F75E2C4FC4ull, 0x1E4D556ADFAE89F3ull }, // 10^-255
+    { 0x6018A192B1BD0C9Cull, 0x7EA444557FBED4C3ull }, // 10^-256
+    { 0x4CE0814227CA707Dull, 0x4BB69D1132FF109Cull }, // 10^-257
+    { 0x7B00CED03FAA4D95ull, 0x5F8A94E851981A93ull }, // 10^-258
+    { 0x62670BD9CC883E11ull, 0x32D543ED0E134875ull }, // 10^-259
+    { 0x4EB8D647D6D364DAull, 0x5BDDCFF0D80F6D2Bull }, // 10^-260
+    { 0x7DF48A0C8AEBD491ull, 0x12FC7FE7C018AEABull }, // 10^-261
+    { 0x64C3A1A3A25643A7ull, 0x28C9FFEC99AD5889ull }, // 10^-262
+    { 0x509C814FB511CFB9ull, 0x0707FFF07AF113A1ull }, // 10^-263
+    { 0x407D343FC40E3FC7ull, 0x1F39998D2F2742E7ull }, // 10^-264
+    { 0x672EB9FFA016CC71ull, 0x7EC28F484B7204A4ull }, // 10^-265
+    { 0x528BC7FFB345705Bull, 0x189BA5D36F8E6A1Dull }, // 10^-266
+    { 0x42096CCC8F6AC048ull, 0x7A161E42BFA521B1ull }, // 10^-267
+    { 0x69A8AE1418AACD41ull, 0x435696D132A1CF81ull }, // 10^-268
+    { 0x5486F1A9AD557101ull, 0x1C454574288172CEull }, // 10^-269
+    { 0x439F27BAF1112734ull, 0x169DD129BA0128A5ull }, // 10^-270
+    { 0x6C31D92B1B4EA520ull, 0x242FB50F9001DAA1ull }, // 10^-271
+    { 0x568E4755AF721DB3ull, 0x368C90D940017BB4ull }, // 10^-272
+    { 0x453E9F77BF8E7E29ull, 0x120A0D7A999AC95Dull }, // 10^-273
+    { 0x6ECA98BF98E3FD0Eull, 0x50101590F5C47561ull }, // 10^-274
+    { 0x58A213CC7A4FFDA5ull, 0x26734473F7D05DE8ull }, // 10^-275
+    { 0x46E80FD6C83FFE1Dull, 0x6B8F69F65FD9E4B9ull }, // 10^-276
+    { 0x71734C8AD9FFFCFCull, 0x45B24323CC8FD45Cull }, // 10^-277
+    { 0x5AC2A3A247FFFD96ull, 0x6AF502830A0CA9E3ull }, // 10^-278
+    { 0x489BB61B6CCCCADFull, 0x08C402026E7087E9ull }, // 10^-279
+    { 0x742C569247AE1164ull, 0x746CD003E3E73FDBull }, // 10^-280
+    { 0x5CF04541D2F1A783ull, 0x76BD73364FEC3315ull }, // 10^-281
+    { 0x4A59D101758E1F9Cull, 0x5EFDF5C50CBCF5ABull }, // 10^-282
+    { 0x76F61B3588E365C7ull, 0x4B2FEFA1ADFB22ABull }, // 10^-283
+    { 0x5F2B48F7A0B5EB06ull, 0x08F3261AF195B555ull }, // 10^-284
+    { 0x4C22A0C61A2B226Bull, 0x20C284E25ADE2AABull }, // 10^-285
+    { 0x79D1013CF6AB6A45ull, 0x1AD0D49D5E304444ull }, // 10^-286
+    { 0x617400FD9222BB6Aull, 0x48A7107DE4F369D0ull }, // 10^-287
+    { 0x4DF6673141B562BBull, 0x53B8D9FE50C2BB0Dull }, // 10^-288
+    { 0x7CBD71E869223792ull, 0x52C15CCA1AD12B48ull }, // 10^-289
+    { 0x63CAC186BA81C60Eull, 0x75677D6E7BDA8906ull }, // 10^-290
+    { 0x4FD5679EFB9B04D8ull, 0x5DEC645863153A6Cull }, // 10^-291
+    { 0x7FBBD8FE5F5E6E27ull, 0x497A3A2704EEC3DFull }, // 10^-292
+};
+
+NODISCARD ALWAYS_INLINE static inline u64 g1(i32 k)
+{
+    return GTable[k - GTableMinK][0];
+}
+
+NODISCARD ALWAYS_INLINE static inline u64 g0(i32 k)
+{
+    return GTable[k - GTableMinK][1];
+}
+
+NODISCARD ALWAYS_INLINE static inline DecimalFloatingPoint remove_trailing_zeroes(u64 significand, i32 exponent)
+{
+    if (significand == 0)
+        return { 0, 0 };
+    while (significand % 10 == 0)
+    {
+        significand /= 10;
+        ++exponent;
+    }
+    return { significand, exponent };
+}
+
+//
+// Conversion of binary64 numbers.
+//
+
+static constexpr i32 F64Precision = 53;
+static constexpr i32 F64MinQ = -1074;
+static constexpr u64 F64MinC = static_cast<u64>(1) << (F64Precision - 1);
+static constexpr u64 Mask63 = (static_cast<u64>(1) << 63) - 1;
+
+// Rounds to odd the product of g and cp, shifted to the right by 127 bits.
+NODISCARD ALWAYS_INLINE static inline u64 round_to_odd(u64 g1, u64 g0, u64 cp)
+{
+    const u64 x1 = multiply_high(g0, cp);
+    const u64 y0 = g1 * cp;
+    const u64 y1 = multiply_high(g1, cp);
+    const u64 z = (y0 >> 1) + x1;
+    const u64 vbp = y1 + (z >> 63);
+    return vbp | (((z & Mask63) + Mask63) >> 63);
+}
+
+static DecimalFloatingPoint to_decimal(i32 q, u64 c)
+{
+    const u64 out = c & 1;
+    const u64 cb = c << 2;
+    const u64 cbr = cb + 2;
+    u64 cbl;
+    i32 k;
+    if (c != F64MinC || q == F64MinQ)
+    {
+        cbl = cb - 2;
+        k = flog10pow2(q);
+    }
+    else
+    {
+        // The value is a power of two, so the rounding interval is asymmetric.
+        cbl = cb - 1;
+        k = flog10_three_quarters_pow2(q);
+    }
+    const i32 h = q + flog2pow10(-k) + 2;
+
+    const u64 g1_k = g1(k);
+    const u64 g0_k = g0(k);
+    const u64 vb = round_to_odd(g1_k, g0_k, cb << h);
+    const u64 vbl = round_to_odd(g1_k, g0_k, cbl << h);
+    const u64 vbr = round_to_odd(g1_k, g0_k, cbr << h);
+
+    const u64 s = vb >> 2;
+    if (s >= 10)
+    {
+        // Try the decimals that are one digit shorter first.
+        const u64 sp10 = 10 * (s / 10);
+        const u64 tp10 = sp10 + 10;
+        const bool upin = vbl + out <= (sp10 << 2);
+        const bool wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin)
+            return remove_trailing_zeroes(upin ? sp10 : tp10, k);
+    }
+
+    const u64 t = s + 1;
+    const bool uin = vbl + out <= (s << 2);
+    const bool win = (t << 2) + out <= vbr;
+    if (uin != win)
+        return remove_trailing_zeroes(uin ? s : t, k);
+
+    // Both decimals are in the rounding interval, so the closest one is selected (or the even one, on a tie).
+    const i64 cmp = static_cast<i64>(vb - ((s + t) << 1));
+    return remove_trailing_zeroes((cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t, k);
+}
+
+//
+// Conversion of binary32 numbers. The g table is shared with the binary64 conversion, but only its upper
+// 63 bits are used.
+//
+
+static constexpr i32 F32Precision = 24;
+static constexpr i32 F32MinQ = -149;
+static constexpr u32 F32MinC = static_cast<u32>(1) << (F32Precision - 1);
+static constexpr u64 Mask32 = (static_cast<u64>(1) << 32) - 1;
+
+NODISCARD ALWAYS_INLINE static inline u32 round_to_odd(u64 g, u64 cp)
+{
+    const u64 x1 = multiply_high(g, cp);
+    const u64 vbp = x1 >> 31;
+    return static_cast<u32>(vbp | (((x1 & Mask32) + Mask32) >> 32));
+}
+
+static DecimalFloatingPoint to_decimal_f32(i32 q, u32 c)
+{
+    const u32 out = c & 1;
+    const u64 cb = static_cast<u64>(c) << 2;
+    const u64 cbr = cb + 2;
+    u64 cbl;
+    i32 k;
+    if (c != F32MinC || q == F32MinQ)
+    {
+        cbl = cb - 2;
+        k = flog10pow2(q);
+    }
+    else
+    {
+        cbl = cb - 1;
+        k = flog10_three_quarters_pow2(q);
+    }
+    const i32 h = q + flog2pow10(-k) + 33;
+
+    const u64 g = g1(k) + 1;
+    const u32 vb = round_to_odd(g, cb << h);
+    const u32 vbl = round_to_odd(g, cbl << h);
+    const u32 vbr = round_to_odd(g, cbr << h);
+
+    const u32 s = vb >> 2;
+    if (s >= 10)
+    {
+        const u32 sp10 = 10 * (s / 10);
+        const u32 tp10 = sp10 + 10;
+        const bool upin = vbl + out <= (sp10 << 2);
+        const bool wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin)
+            return remove_trailing_zeroes(upin ? sp10 : tp10, k);
+    }
+
+    const u32 t = s + 1;
+    const bool uin = vbl + out <= (s << 2);
+    const bool win = (t << 2) + out <= vbr;
+    if (uin != win)
+        return remove_trailing_zeroes(uin ? s : t, k);
+
+    const i32 cmp = static_cast<i32>(vb - ((s + t) << 1));
+    return remove_trailing_zeroes((cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t, k);
+}
+
+//
+// An unsigned integer with a fixed maximum size, large enough to store the exact value of any finite f64
+// scaled by the powers of ten required to compute all its significant digits.
+//
+class BigInteger
+{
+public:
+    static constexpr usize MaxWordCount = 128;
+
+public:
+    explicit BigInteger(u64 value)
+    {
+        m_words[0] = static_cast<u32>(value);
+        m_words[1] = static_cast<u32>(value >> 32);
+        m_word_count = (m_words[1] != 0) ? 2 : (m_words[0] != 0 ? 1 : 0);
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE bool is_zero() const { return m_word_count == 0; }
+    NODISCARD ALWAYS_INLINE bool is_odd() const { return m_word_count > 0 && (m_words[0] & 1) != 0; }
+
+    void multiply(u32 factor)
+    {
+        u64 carry = 0;
+        for (usize index = 0; index < m_word_count; ++index)
+        {
+            const u64 product = static_cast<u64>(m_words[index]) * factor + carry;
+            m_words[index] = static_cast<u32>(product);
+            carry = product >> 32;
+        }
+        if (carry != 0)
+            push_word(static_cast<u32>(carry));
+    }
+
+    void multiply_by_power_of_ten(u32 exponent)
+    {
+        for (; exponent >= 9; exponent -= 9)
+            multiply(1000000000);
+        if (exponent > 0)
+            multiply(s_small_powers_of_ten[exponent]);
+    }
+
+    void add_one()
+    {
+        for (usize index = 0; index < m_word_count; ++index)
+        {
+            if (++m_words[index] != 0)
+                return;
+        }
+        push_word(1);
+    }
+
+    void shift_left(u32 bit_count)
+    {
+        if (m_word_count == 0)
+            return;
+
+        const usize word_shift = bit_count / 32;
+        const u32 inner_shift = bit_count % 32;
+        VERIFY(m_word_count + word_shift + 1 <= MaxWordCount);
+
+        m_words[m_word_count] = 0;
+        for (usize index = m_word_count + 1; index-- > 0;)
+        {
+            u32 word = m_words[index] << inner_shift;
+            if (inner_shift != 0 && index > 0)
+                word |= m_words[index - 1] >> (32 - inner_shift);
+            m_words[index + word_shift] = word;
+        }
+        zero_memory(m_words, word_shift * sizeof(u32));
+        m_word_count += word_shift + 1;
+        trim();
+    }
+
+    // Returns true if any of the bits that are shifted out is set.
+    bool shift_right(u32 bit_count)
+    {
+        const usize word_shift = bit_count / 32;
+        const u32 inner_shift = bit_count % 32;
+        if (word_shift >= m_word_count)
+        {
+            const bool had_bits = !is_zero();
+            m_word_count = 0;
+            return had_bits;
+        }
+
+        const u32 discarded_bits_mask = (static_cast<u32>(1) << inner_shift) - 1;
+        bool has_discarded_bits = (m_words[word_shift] & discarded_bits_mask) != 0;
+        for (usize index = 0; index < word_shift; ++index)
+            has_discarded_bits |= (m_words[index] != 0);
+
+        const usize new_word_count = m_word_count - word_shift;
+        for (usize index = 0; index < new_word_count; ++index)
+        {
+            u32 word = m_words[index + word_shift] >> inner_shift;
+            if (inner_shift != 0 && index + word_shift + 1 < m_word_count)
+                word |= m_words[index + word_shift + 1] << (32 - inner_shift);
+            m_words[index] = word;
+        }
+        m_word_count = new_word_count;
+        trim();
+        return has_discarded_bits;
+    }
+
+    // Returns the remainder of the division.
+    u32 divide(u32 divisor)
+    {
+        u64 remainder = 0;
+        for (usize index = m_word_count; index-- > 0;)
+        {
+            const u64 dividend = (remainder << 32) | m_words[index];
+            m_words[index] = static_cast<u32>(dividend / divisor);
+            remainder = dividend % divisor;
+        }
+        trim();
+        return static_cast<u32>(remainder);
+    }
+
+    // Returns true if the remainder of the division is not zero.
+    bool divide_by_power_of_ten(u32 exponent)
+    {
+        bool has_remainder = false;
+        for (; exponent >= 9; exponent -= 9)
+            has_remainder |= (divide(1000000000) != 0);
+        if (exponent > 0)
+            has_remainder |= (divide(s_small_powers_of_ten[exponent]) != 0);
+        return has_remainder;
+    }
+
+    // Writes the decimal digits without leading zeroes ("0" for zero) and returns their count. The value is
+    // consumed in the process.
+    usize consume_decimal_digits(char* digits)
+    {
+        // Groups of nine digits are extracted with a single (multi-word) division each, from the least
+        // significant to the most significant one.
+        u32 groups[MaxWordCount * 32 / 29 + 1];
+        usize group_count = 0;
+        do
+        {
+            groups[group_count++] = divide(1000000000);
+        } while (!is_zero());
+
+        usize digit_count = 0;
+        const auto write_group = [&](u32 group, bool is_first)
+        {
+            char group_digits[9];
+            usize group_digit_count = 0;
+            do
+            {
+                group_digits[group_digit_count++] = static_cast<char>('0' + group % 10);
+                group /= 10;
+            } while ((is_first && group > 0) || (!is_first && group_digit_count < 9));
+            while (group_digit_count > 0)
+                digits[digit_count++] = group_digits[--group_digit_count];
+        };
+
+        write_group(groups[group_count - 1], true);
+        for (usize index = group_count - 1; index-- > 0;)
+            write_group(groups[index], false);
+        return digit_count;
+    }
+
+private:
+    void push_word(u32 word)
+    {
+        VERIFY(m_word_count < MaxWordCount);
+        m_words[m_word_count++] = word;
+    }
+
+    void trim()
+    {
+        while (m_word_count > 0 && m_words[m_word_count - 1] == 0)
+            --m_word_count;
+    }
+
+private:
+    static constexpr u32 s_small_powers_of_ten[9] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    };
+
+    u32 m_words[MaxWordCount];
+    usize m_word_count;
+};
+
+// The value is significand * 2^exponent, where the significand is an integer.
+struct BinaryFloatingPoint
+{
+    u64 significand;
+    i32 exponent;
+};
+
+NODISCARD static BinaryFloatingPoint decompose(f64 value)
+{
+    u64 bits;
+    copy_memory(&bits, &value, sizeof(bits));
+    const u64 fraction = bits & (F64MinC - 1);
+    const i32 biased_exponent = static_cast<i32>((bits >> (F64Precision - 1)) & 0x7FF);
+    if (biased_exponent == 0)
+        return { fraction, F64MinQ };
+    return { F64MinC | fraction, biased_exponent - 1075 };
+}
+
+// Writes the digits of round(value * 10^scale), with the ties rounded to even. Returns the number of digits.
+static usize write_scaled_digits(f64 value, i32 scale, char* digits)
+{
+    const BinaryFloatingPoint binary = decompose(value);
+
+    // An extra digit is computed, which is then used (together with the discarded bits or the remainders)
+    // to round the result.
+    const i32 extended_scale = scale + 1;
+    BigInteger integer = BigInteger(binary.significand);
+    bool is_inexact = false;
+
+    // All multiplications are performed before the divisions, so that the divisions truncate only once.
+    if (extended_scale > 0)
+        integer.multiply_by_power_of_ten(static_cast<u32>(extended_scale));
+    if (binary.exponent > 0)
+        integer.shift_left(static_cast<u32>(binary.exponent));
+    if (binary.exponent < 0)
+        is_inexact |= integer.shift_right(static_cast<u32>(-binary.exponent));
+    if (extended_scale < 0)
+        is_inexact |= integer.divide_by_power_of_ten(static_cast<u32>(-extended_scale));
+
+    const u32 rounding_digit = integer.divide(10);
+    if (rounding_digit > 5 || (rounding_digit == 5 && (is_inexact || integer.is_odd())))
+        integer.add_one();
+
+    return integer.consume_decimal_digits(digits);
+}
+
+} // namespace Detail
+
+DecimalFloatingPoint to_shortest_decimal(f64 value)
+{
+    u64 bits;
+    copy_memory(&bits, &value, sizeof(bits));
+    const u64 fraction = bits & (Detail::F64MinC - 1);
+    const i32 biased_exponent = static_cast<i32>((bits >> (Detail::F64Precision - 1)) & 0x7FF);
+
+    if (biased_exponent != 0)
+    {
+        const i32 mq = -Detail::F64MinQ + 1 - biased_exponent;
+        const u64 c = Detail::F64MinC | fraction;
+
+        // Integers are converted directly.
+        if (0 < mq && mq < Detail::F64Precision)
+        {
+            const u64 f = c >> mq;
+            if ((f << mq) == c)
+                return Detail::remove_trailing_zeroes(f, 0);
+        }
+        return Detail::to_decimal(-mq, c);
+    }
+
+    // Subnormal numbers.
+    if (fraction != 0)
+        return Detail::to_decimal(Detail::F64MinQ, fraction);
+
+    return { 0, 0 };
+}
+
+DecimalFloatingPoint to_shortest_decimal(f32 value)
+{
+    u32 bits;
+    copy_memory(&bits, &value, sizeof(bits));
+    const u32 fraction = bits & (Detail::F32MinC - 1);
+    const i32 biased_exponent = static_cast<i32>((bits >> (Detail::F32Precision - 1)) & 0xFF);
+
+    if (biased_exponent != 0)
+    {
+        const i32 mq = -Detail::F32MinQ + 1 - biased_exponent;
+        const u32 c = Detail::F32MinC | fraction;
+
+        if (0 < mq && mq < Detail::F32Precision)
+        {
+            const u32 f = c >> mq;
+            if ((f << mq) == c)
+                return Detail::remove_trailing_zeroes(f, 0);
+        }
+        return Detail::to_decimal_f32(-mq, c);
+    }
+
+    if (fraction != 0)
+        return Detail::to_decimal_f32(Detail::F32MinQ, fraction);
+
+    return { 0, 0 };
+}
+
+usize write_fixed_digits(f64 value, u32 fraction_digit_count, char* digits)
+{
+    VERIFY_ALWAYS(fraction_digit_count <= MaxFloatingPointFractionDigitCount);
+
+    // A value with a binary exponent e has at most -e fraction digits that are not zero. Not computing the
+    // other ones keeps the size of the intermediate integer bounded.
+    const Detail::BinaryFloatingPoint binary = Detail::decompose(value);
+    const u32 maximum_exact_digit_count = (binary.exponent < 0) ? static_cast<u32>(-binary.exponent) : 0;
+    const u32 exact_digit_count =
+        (fraction_digit_count < maximum_exact_digit_count) ? fraction_digit_count : maximum_exact_digit_count;
+
+    usize digit_count = Detail::write_scaled_digits(value, static_cast<i32>(exact_digit_count), digits);
+    if (digit_count == 1 && digits[0] == '0')
+        return digit_count;
+
+    set_memory(digits + digit_count, '0', fraction_digit_count - exact_digit_count);
+    digit_count += fraction_digit_count - exact_digit_count;
+    return digit_count;
+}
+
+i32 write_significant_digits(f64 value, u32 digit_count, char* digits)
+{
+    VERIFY_ALWAYS(digit_count >= 1 && digit_count <= MaxFloatingPointSignificantDigitCount);
+
+    if (value == 0)
+    {
+        set_memory(digits, '0', digit_count);
+        return 0;
+    }
+
+    // The estimated exponent of the first digit is either exact or one too small. In the latter case, one
+    // digit too many is computed, so the digits are computed again with the next exponent.
+    const Detail::BinaryFloatingPoint binary = Detail::decompose(value);
+    const i32 bit_count = 64 - static_cast<i32>(count_leading_zeroes(binary.significand));
+    i32 exponent = Detail::flog10pow2(binary.exponent + bit_count - 1);
+
+    char scaled_digits[MaxFloatingPointSignificantDigitCount + 1];
+    while (true)
+    {
+        const i32 scale = static_cast<i32>(digit_count) - 1 - exponent;
+        if (Detail::write_scaled_digits(value, scale, scaled_digits) == digit_count)
+        {
+            copy_memory(digits, scaled_digits, digit_count);
+            return exponent;
+        }
+        ++exponent;
+    }
+}
+
+} // namespace AT
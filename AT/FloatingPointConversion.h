@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+
+namespace AT
+{
+
+// A decimal floating-point number, which has the value significand * 10^exponent.
+struct DecimalFloatingPoint
+{
+    u64 significand;
+    i32 exponent;
+};
+
+//
+// Converts a binary floating-point number to the shortest decimal that converts back to exactly the same number,
+// using the Schubfach algorithm by Raffaello Giulietti. If there are multiple shortest decimals, the one that is
+// closest to the binary number is selected. The value must be finite and not negative. The significand of the
+// result has no trailing zeroes (the zero value is converted to a zero significand).
+//
+NODISCARD AT_API DecimalFloatingPoint to_shortest_decimal(f64 value);
+NODISCARD AT_API DecimalFloatingPoint to_shortest_decimal(f32 value);
+
+// A finite f64 has at most 1074 digits after the decimal point and at most 767 significant digits. All digits
+// past these limits are zeroes, so they don't have to be computed.
+static constexpr u32 MaxFloatingPointFractionDigitCount = 1074;
+static constexpr u32 MaxFloatingPointSignificantDigitCount = 767;
+
+//
+// The following functions compute the exact decimal digits of a finite and not negative value, rounded to the
+// given number of digits (ties are rounded to even), using arbitrary-precision arithmetic. They are slower
+// than the shortest conversion, so they are intended for formatting with an explicit precision.
+//
+
+// Writes the digits of the value rounded to the given number of fraction digits, without the decimal point and
+// without leading zeroes (if the rounded value is zero, a single zero digit is written). For example, 0.125
+// rounded to two fraction digits is written as "12". Returns the number of written digits, which is at most
+// 309 + fraction_digit_count.
+AT_API usize write_fixed_digits(f64 value, u32 fraction_digit_count, char* digits);
+
+// Writes exactly digit_count digits, which must be in the [1, MaxFloatingPointSignificantDigitCount] range,
+// of the value rounded to that many significant digits. Returns the decimal exponent of the first digit.
+AT_API i32 write_significant_digits(f64 value, u32 digit_count, char* digits);
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::DecimalFloatingPoint;
+using AT::to_shortest_decimal;
+using AT::write_fixed_digits;
+using AT::write_significant_digits;
+#endif // AT_INCLUDE_GLOBALLY
@@ -4,134 +4,547 @@
  */
 
 #include "AT/Format.h"
-#include "AT/MemoryOperations.h"
+#include "AT/BitOperations.h"
+#include "AT/FloatingPointConversion.h"
+#include "AT/UTF8.h"
 
-#define AT_FORMAT_SPECIFIER_BEGIN_TOKEN '{'
-#define AT_FORMAT_SPECIFIER_END_TOKEN   '}'
+#include <cmath>
 
 namespace AT
 {
 
-void FormatBuilder::push_string(StringView string)
+namespace Detail
 {
-    MUST_ASSIGN(auto& offset, m_formatted.try_push_uninitialized(string.byte_count()));
-    copy_memory(static_cast<void*>(&offset), string.bytes(), string.byte_count());
+
+// The decimal representation of all numbers between 0 and 99, using two characters for each number.
+// Generating two digits at a time halves the number of (relatively slow) divisions.
+static constexpr char DecimalDigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static constexpr u64 PowersOfTen[] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+static constexpr char LowercaseDigits[] = "0123456789abcdef";
+static constexpr char UppercaseDigits[] = "0123456789ABCDEF";
+
+// The largest formatted integer is a 64-bit binary number, with the sign and the base prefix.
+static constexpr usize MaxFormattedIntegerByteCount = 1 + 2 + 64;
+
+static usize count_decimal_digits(u64 value)
+{
+    // The number of decimal digits is approximated from the number of bits, as log10(2) ~= 1233 / 4096. The
+    // approximation is either exact or one too large, which is corrected by a comparison with a power of ten.
+    // Zero is treated as one, as it also has a single digit.
+    value |= 1;
+    const u32 bit_count = 64 - count_leading_zeroes(value);
+    const u32 estimate = (bit_count * 1233) >> 12;
+    return estimate + 1 - (value < PowersOfTen[estimate] ? 1 : 0);
+}
+
+NODISCARD ALWAYS_INLINE static inline char* write_digit_pair(char* end, u32 pair)
+{
+    end -= 2;
+    end[0] = DecimalDigitPairs[pair * 2];
+    end[1] = DecimalDigitPairs[pair * 2 + 1];
+    return end;
 }
 
-void FormatBuilder::push_integer(AT::u64 integer, IsNegative is_negative)
+// Writes the digits backwards, ending at the given pointer. Returns a pointer to the first digit.
+static char* write_decimal_digits(char* end, u64 value)
 {
-    if (integer == 0)
+    // Large values are split into blocks of eight digits, so that most of the divisions operate on 32-bit
+    // integers, and the digits of a block don't depend on the digits of the other blocks.
+    while (value >= 100000000)
     {
-        MUST(m_formatted.try_push_back('0'));
+        u32 block = static_cast<u32>(value % 100000000);
+        value /= 100000000;
+        for (u32 pair_index = 0; pair_index < 4; ++pair_index)
+        {
+            end = write_digit_pair(end, block % 100);
+            block /= 100;
+        }
+    }
+
+    u32 remaining = static_cast<u32>(value);
+    while (remaining >= 100)
+    {
+        end = write_digit_pair(end, remaining % 100);
+        remaining /= 100;
+    }
+
+    if (remaining >= 10)
+        return write_digit_pair(end, remaining);
+
+    *--end = static_cast<char>('0' + remaining);
+    return end;
+}
+
+// Writes the digits in a base that is a power of two (binary, octal or hexadecimal) backwards, ending at the
+// given pointer. Returns a pointer to the first digit.
+static char* write_digits_in_power_of_two_base(char* end, u64 value, u32 bits_per_digit, const char* digits)
+{
+    const u64 digit_mask = (static_cast<u64>(1) << bits_per_digit) - 1;
+    do
+    {
+        *--end = digits[value & digit_mask];
+        value >>= bits_per_digit;
+    } while (value > 0);
+    return end;
+}
+
+// Returns the number of fill characters that are placed before the aligned content.
+static usize get_leading_padding_count(FormatBuilder::Specifier::Alignment alignment, usize padding_count)
+{
+    using Alignment = FormatBuilder::Specifier::Alignment;
+
+    // When centering, the extra fill character (if any) is placed after the content.
+    if (alignment == Alignment::Right)
+        return padding_count;
+    if (alignment == Alignment::Center)
+        return padding_count / 2;
+    return 0;
+}
+
+static void push_aligned(
+    FormatBuilder& builder,
+    StringView string,
+    usize padding_count,
+    FormatBuilder::Specifier::Alignment alignment,
+    char fill
+)
+{
+    const usize leading_padding_count = get_leading_padding_count(alignment, padding_count);
+    builder.push_padding(fill, leading_padding_count);
+    builder.push_string(string);
+    builder.push_padding(fill, padding_count - leading_padding_count);
+}
+
+// Pushes a number, which is aligned to the right by default. The zero padding is placed between the sign (and
+// the base prefix) and the digits. As in the standard library, an explicit alignment takes precedence over the
+// zero padding.
+static void push_number(
+    FormatBuilder& builder,
+    StringView sign_and_prefix,
+    StringView digits,
+    const FormatBuilder::Specifier& specifier
+)
+{
+    using Alignment = FormatBuilder::Specifier::Alignment;
+
+    const usize byte_count = sign_and_prefix.byte_count() + digits.byte_count();
+    const usize padding_count = (specifier.width > byte_count) ? specifier.width - byte_count : 0;
+
+    // Most numbers are formatted without a width, so only the digits have to be pushed.
+    if (padding_count == 0)
+    {
+        if (!sign_and_prefix.is_empty())
+            builder.push_string(sign_and_prefix);
+        builder.push_string(digits);
         return;
     }
 
-    if (is_negative == IsNegative::Yes)
-        MUST(m_formatted.try_push_back('-'));
+    if (specifier.zero_padding && specifier.alignment == Alignment::Default)
+    {
+        builder.push_string(sign_and_prefix);
+        builder.push_padding('0', padding_count);
+        builder.push_string(digits);
+        return;
+    }
+
+    const Alignment alignment = (specifier.alignment == Alignment::Default) ? Alignment::Right : specifier.alignment;
+    const usize leading_padding_count = get_leading_padding_count(alignment, padding_count);
+    builder.push_padding(specifier.fill, leading_padding_count);
+    builder.push_string(sign_and_prefix);
+    builder.push_string(digits);
+    builder.push_padding(specifier.fill, padding_count - leading_padding_count);
+}
+
+//
+// Floating-point formatting. The largest formatted number (excluding the sign) is a number with 309 integer
+// digits, formatted using the fixed notation with the maximum precision.
+//
+
+static constexpr usize MaxFormattedFloatingPointByteCount = 309 + 1 + MaxFloatingPointFractionDigitCount;
+
+static usize write_exponent(char* characters, i32 exponent)
+{
+    // As in the C standard library, the exponent always has a sign and at least two digits.
+    usize byte_count = 0;
+    characters[byte_count++] = 'e';
+    characters[byte_count++] = (exponent < 0) ? '-' : '+';
+    const u32 magnitude = static_cast<u32>(exponent < 0 ? -exponent : exponent);
+    if (magnitude >= 100)
+        characters[byte_count++] = static_cast<char>('0' + magnitude / 100);
+    characters[byte_count++] = DecimalDigitPairs[(magnitude % 100) * 2];
+    characters[byte_count++] = DecimalDigitPairs[(magnitude % 100) * 2 + 1];
+    return byte_count;
+}
+
+// The value is digits * 10^exponent.
+static usize write_fixed_notation(char* characters, const char* digits, usize digit_count, i32 exponent)
+{
+    if (exponent >= 0)
+    {
+        copy_memory(characters, digits, digit_count);
+        set_memory(characters + digit_count, '0', static_cast<usize>(exponent));
+        return digit_count + static_cast<usize>(exponent);
+    }
 
-    u8 digit_count = 0;
-    u64 number = integer;
-    while (number > 0)
+    const usize fraction_digit_count = static_cast<usize>(-exponent);
+    if (digit_count > fraction_digit_count)
     {
-        ++digit_count;
-        number /= 10;
+        const usize integer_digit_count = digit_count - fraction_digit_count;
+        copy_memory(characters, digits, integer_digit_count);
+        characters[integer_digit_count] = '.';
+        copy_memory(characters + integer_digit_count + 1, digits + integer_digit_count, fraction_digit_count);
+        return digit_count + 1;
     }
 
-    MUST_ASSIGN(char& destination_ref, m_formatted.try_push_uninitialized(digit_count));
-    char* destination = &destination_ref;
+    const usize leading_zero_count = fraction_digit_count - digit_count;
+    characters[0] = '0';
+    characters[1] = '.';
+    set_memory(characters + 2, '0', leading_zero_count);
+    copy_memory(characters + 2 + leading_zero_count, digits, digit_count);
+    return 2 + fraction_digit_count;
+}
 
-    number = integer;
-    for (u8 digit_index = 1; digit_index <= digit_count; ++digit_index)
+// The value is d.ddd * 10^exponent, where the first digit is not zero (unless the value is zero).
+static usize write_scientific_notation(char* characters, const char* digits, usize digit_count, i32 exponent)
+{
+    usize byte_count = 0;
+    characters[byte_count++] = digits[0];
+    if (digit_count > 1)
     {
-        const u8 digit = '0' + number % 10;
-        destination[digit_count - digit_index] = static_cast<char>(digit);
-        number /= 10;
+        characters[byte_count++] = '.';
+        copy_memory(characters + byte_count, digits + 1, digit_count - 1);
+        byte_count += digit_count - 1;
     }
+    return byte_count + write_exponent(characters + byte_count, exponent);
 }
 
-bool FormatBuilder::consume_until_format_specifier()
+// The value is the magnitude of the number that was converted to the decimal.
+static usize
+write_shortest(char* characters, f64 value, DecimalFloatingPoint decimal, FormatBuilder::Specifier::Type type)
 {
-    if (m_format_offset >= m_format.byte_count())
-        return false;
+    using Type = FormatBuilder::Specifier::Type;
+
+    char digits[20];
+    char* const digits_end = digits + sizeof(digits);
+    const char* const digits_begin = write_decimal_digits(digits_end, decimal.significand);
+    const usize digit_count = static_cast<usize>(digits_end - digits_begin);
+    const i32 scientific_exponent = decimal.exponent + static_cast<i32>(digit_count) - 1;
+
+    if (type == Type::Default)
+    {
+        // Select the notation that produces fewer characters, as std::to_chars does.
+        const usize exponent_digit_count = (scientific_exponent <= -100 || scientific_exponent >= 100) ? 3 : 2;
+        const usize scientific_byte_count = digit_count + (digit_count > 1 ? 1 : 0) + 2 + exponent_digit_count;
+
+        usize fixed_byte_count;
+        if (decimal.exponent >= 0)
+            fixed_byte_count = digit_count + static_cast<usize>(decimal.exponent);
+        else if (scientific_exponent >= 0)
+            fixed_byte_count = digit_count + 1;
+        else
+            fixed_byte_count = 2 + static_cast<usize>(-decimal.exponent);
+
+        type = (fixed_byte_count <= scientific_byte_count) ? Type::Fixed : Type::Scientific;
+    }
 
-    const usize copy_begin_offset = m_format_offset;
+    if (type == Type::Scientific)
+        return write_scientific_notation(characters, digits_begin, digit_count, scientific_exponent);
 
-    bool has_reached_end = false;
-    while (m_format.at_offset_in_bytes(m_format_offset) != AT_FORMAT_SPECIFIER_BEGIN_TOKEN)
+    if (decimal.exponent > 0)
     {
-        if (++m_format_offset == m_format.byte_count())
+        // The shortest digits would be followed by zeroes, but the exact integer has the same length and is closer to
+        // the value, so it is written instead (as std::to_chars does). Below 2^64 the integer fits in a u64.
+        if (value < 18446744073709551616.0)
         {
-            has_reached_end = true;
-            break;
+            const u64 integer = static_cast<u64>(value);
+            const usize byte_count = count_decimal_digits(integer);
+            write_decimal_digits(characters + byte_count, integer);
+            return byte_count;
         }
+        return write_fixed_digits(value, 0, characters);
+    }
+    return write_fixed_notation(characters, digits_begin, digit_count, decimal.exponent);
+}
+
+static usize write_fixed_with_precision(char* characters, f64 value, u32 precision)
+{
+    // The digits are written to the start of the buffer, and then moved to make room for the decimal point.
+    const usize digit_count = write_fixed_digits(value, precision, characters);
+    if (precision == 0)
+        return digit_count;
+
+    if (digit_count > precision)
+    {
+        const usize integer_digit_count = digit_count - precision;
+        move_memory(characters + integer_digit_count + 1, characters + integer_digit_count, precision);
+        characters[integer_digit_count] = '.';
+        return digit_count + 1;
+    }
+
+    const usize leading_byte_count = 2 + precision - digit_count;
+    move_memory(characters + leading_byte_count, characters, digit_count);
+    characters[0] = '0';
+    characters[1] = '.';
+    set_memory(characters + 2, '0', leading_byte_count - 2);
+    return 2 + precision;
+}
+
+static usize write_scientific_with_precision(char* characters, f64 value, u32 precision)
+{
+    // The significant digits past the maximum are always zeroes.
+    const u32 digit_count = (precision + 1 < MaxFloatingPointSignificantDigitCount)
+                                ? precision + 1
+                                : MaxFloatingPointSignificantDigitCount;
+
+    // The digits are written after the first byte, and the first digit is then moved before the decimal point.
+    const i32 exponent = write_significant_digits(value, digit_count, characters + 1);
+    characters[0] = characters[1];
+    if (precision == 0)
+        return 1 + write_exponent(characters + 1, exponent);
+
+    characters[1] = '.';
+    set_memory(characters + 1 + digit_count, '0', precision + 1 - digit_count);
+    const usize byte_count = 2 + precision;
+    return byte_count + write_exponent(characters + byte_count, exponent);
+}
+
+template<typename T>
+static void push_floating_point(FormatBuilder& builder, T value, const FormatBuilder::Specifier& specifier)
+{
+    using Type = FormatBuilder::Specifier::Type;
+
+    const StringView sign = std::signbit(value) ? "-"sv : ""sv;
+    if (!std::isfinite(value))
+    {
+        // There are no digits to pad with zeroes, and the sign of NaN is meaningless.
+        FormatBuilder::Specifier non_finite_specifier = specifier;
+        non_finite_specifier.zero_padding = false;
+        if (std::isnan(value))
+            push_number(builder, {}, "nan"sv, non_finite_specifier);
+        else
+            push_number(builder, sign, "inf"sv, non_finite_specifier);
+        return;
     }
 
-    const StringView string_to_copy = m_format.substring(copy_begin_offset, m_format_offset - copy_begin_offset);
-    push_string(string_to_copy);
+    char characters[MaxFormattedFloatingPointByteCount];
+    usize byte_count;
+    const T magnitude = std::fabs(value);
 
-    if (has_reached_end)
-        return false;
+    if (specifier.precision == FormatBuilder::Specifier::NoPrecision)
+        byte_count =
+            write_shortest(characters, static_cast<f64>(magnitude), to_shortest_decimal(magnitude), specifier.type);
+    else if (specifier.type == Type::Scientific)
+        byte_count = write_scientific_with_precision(characters, static_cast<f64>(magnitude), specifier.precision);
+    else
+        byte_count = write_fixed_with_precision(characters, static_cast<f64>(magnitude), specifier.precision);
 
-    ++m_format_offset;
-    return true;
+    push_number(builder, sign, StringView::from_utf8(characters, byte_count), specifier);
 }
 
-bool FormatBuilder::consume_format_specifier(Specifier& specifier)
+} // namespace Detail
+
+void FormatBuilder::push_integer(u64 integer, IsNegative is_negative)
 {
-    if (m_format_offset == 0 || m_format.at_offset_in_bytes(m_format_offset - 1) != AT_FORMAT_SPECIFIER_BEGIN_TOKEN)
-        return false;
+    const usize sign_byte_count = (is_negative == IsNegative::Yes) ? 1 : 0;
+    const usize byte_count = sign_byte_count + Detail::count_decimal_digits(integer);
 
-    bool has_reached_end = false;
-    const usize begin_offset = m_format_offset;
+    // Most of the time the integer fits in the buffer, so the digits are written directly in place.
+    if (char* bytes = get_writable_bytes(byte_count))
+    {
+        if (is_negative == IsNegative::Yes)
+            bytes[0] = '-';
+        Detail::write_decimal_digits(bytes + byte_count, integer);
+        return;
+    }
 
-    while (m_format.at_offset_in_bytes(m_format_offset) != AT_FORMAT_SPECIFIER_END_TOKEN)
+    char characters[Detail::MaxFormattedIntegerByteCount];
+    char* const characters_end = characters + sizeof(characters);
+    char* current = Detail::write_decimal_digits(characters_end, integer);
+    if (is_negative == IsNegative::Yes)
+        *--current = '-';
+    push_string(StringView::from_utf8(current, static_cast<usize>(characters_end - current)));
+}
+
+void FormatBuilder::push_integer(u64 integer, IsNegative is_negative, const Specifier& specifier)
+{
+    using Type = Specifier::Type;
+
+    if (specifier.is_default())
     {
-        if (++m_format_offset == m_format.byte_count())
-        {
-            has_reached_end = true;
+        push_integer(integer, is_negative);
+        return;
+    }
+
+    // The sign, the base prefix and the digits are generated backwards, as a contiguous string.
+    char characters[Detail::MaxFormattedIntegerByteCount];
+    char* const characters_end = characters + sizeof(characters);
+    char* current;
+    const char* prefix = "";
+    usize prefix_byte_count = 0;
+
+    switch (specifier.type)
+    {
+        case Type::Hexadecimal:
+            current = Detail::write_digits_in_power_of_two_base(characters_end, integer, 4, Detail::LowercaseDigits);
+            prefix = "0x";
+            prefix_byte_count = 2;
+            break;
+        case Type::UppercaseHexadecimal:
+            current = Detail::write_digits_in_power_of_two_base(characters_end, integer, 4, Detail::UppercaseDigits);
+            prefix = "0X";
+            prefix_byte_count = 2;
+            break;
+        case Type::Binary:
+            current = Detail::write_digits_in_power_of_two_base(characters_end, integer, 1, Detail::LowercaseDigits);
+            prefix = "0b";
+            prefix_byte_count = 2;
+            break;
+        case Type::Octal:
+            current = Detail::write_digits_in_power_of_two_base(characters_end, integer, 3, Detail::LowercaseDigits);
+            // Zero already starts with a zero, so it doesn't need the octal prefix.
+            prefix = "0";
+            prefix_byte_count = (integer != 0) ? 1 : 0;
+            break;
+        default:
+            current = Detail::write_decimal_digits(characters_end, integer);
             break;
-        }
     }
 
-    if (has_reached_end)
-        return false;
+    char* const digits = current;
+    if (specifier.alternate_form)
+    {
+        current -= prefix_byte_count;
+        copy_memory(current, prefix, prefix_byte_count);
+    }
+    if (is_negative == IsNegative::Yes)
+        *--current = '-';
+
+    Detail::push_number(
+        *this,
+        StringView::from_utf8(current, static_cast<usize>(digits - current)),
+        StringView::from_utf8(digits, static_cast<usize>(characters_end - digits)),
+        specifier
+    );
+}
+
+void FormatBuilder::push_floating_point(f64 value, const Specifier& specifier)
+{
+    Detail::push_floating_point(*this, value, specifier);
+}
 
-    const StringView specifier_string = m_format.substring(begin_offset, m_format_offset - begin_offset);
-    ++m_format_offset;
-    return process_format_specifier(specifier_string, specifier);
+void FormatBuilder::push_floating_point(f32 value, const Specifier& specifier)
+{
+    Detail::push_floating_point(*this, value, specifier);
 }
 
-bool FormatBuilder::process_format_specifier(AT::StringView specifier_string, AT::FormatBuilder::Specifier& specifier)
+void FormatBuilder::push_string(StringView string, const Specifier& specifier)
 {
-    if (specifier_string.is_empty())
+    const char* characters = string.characters();
+    usize byte_count = string.byte_count();
+    usize code_point_count = 0;
+
+    if (specifier.precision != Specifier::NoPrecision)
+    {
+        // Keep at most 'precision' code points. Counting the lead bytes is enough to find the truncation point.
+        usize offset = 0;
+        for (; offset < byte_count; ++offset)
+        {
+            if ((characters[offset] & 0xC0) == 0x80)
+                continue;
+            if (code_point_count == specifier.precision)
+                break;
+            ++code_point_count;
+        }
+        byte_count = offset;
+    }
+    else if (specifier.width > 0)
+    {
+        code_point_count = count_utf8_code_points(characters, byte_count);
+    }
+
+    const StringView truncated_string = StringView::from_utf8(characters, byte_count);
+    if (code_point_count >= specifier.width)
     {
-        specifier = {};
-        return true;
+        push_string(truncated_string);
+        return;
     }
 
-    return false;
+    const Specifier::Alignment alignment =
+        (specifier.alignment == Specifier::Alignment::Default) ? Specifier::Alignment::Left : specifier.alignment;
+    Detail::push_aligned(*this, truncated_string, specifier.width - code_point_count, alignment, specifier.fill);
 }
 
-String FormatBuilder::release_as_string()
+void FormatBuilder::push_padding(char fill, usize count)
 {
-    MUST(m_formatted.try_push_back(0));
-    MUST(m_formatted.try_shrink_to_fit());
-    String formatted;
+    if (count == 0)
+        return;
+
+    if (char* bytes = get_writable_bytes(count))
+    {
+        set_memory(bytes, static_cast<u8>(fill), count);
+        return;
+    }
 
-    if (m_formatted.count() <= String::InlineCapacity)
+    char chunk[64];
+    set_memory(chunk, static_cast<u8>(fill), sizeof(chunk));
+    while (count > 0)
     {
-        formatted.set_internal_inline_buffer(
-            reinterpret_cast<const char*>(m_formatted.bytes()), m_formatted.byte_count()
-        );
-        m_formatted.clear_and_shrink();
+        const usize chunk_byte_count = (count < sizeof(chunk)) ? count : sizeof(chunk);
+        push_string(StringView::from_utf8(chunk, chunk_byte_count));
+        count -= chunk_byte_count;
     }
-    else
+}
+
+void FormatBuilder::push_string_that_doesnt_fit(StringView string)
+{
+    if (m_string_builder)
+    {
+        m_string_builder->append(string);
+        m_byte_count += string.byte_count();
+        return;
+    }
+
+    if (m_byte_count < m_capacity)
     {
-        const usize byte_count = m_formatted.count();
-        formatted.set_internal_heap_buffer(m_formatted.leak_elements(), byte_count);
+        // Write as many characters as fit, but without splitting a multi-byte sequence: if the first character
+        // that doesn't fit is a continuation byte, the sequence it belongs to is discarded entirely.
+        usize fitting_byte_count = m_capacity - m_byte_count;
+        while (fitting_byte_count > 0 && (string.characters()[fitting_byte_count] & 0xC0) == 0x80)
+            --fitting_byte_count;
+
+        copy_memory(m_buffer + m_byte_count, string.characters(), fitting_byte_count);
+        m_capacity = m_byte_count + fitting_byte_count;
     }
 
-    return formatted;
+    m_byte_count += string.byte_count();
 }
 
 } // namespace AT
@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include "AT/FloatingPointConversion.h"
+#include "AT/MemoryOperations.h"
+#include "AT/Span.h"
 #include "AT/String.h"
-#include "AT/Vector.h"
+#include "AT/StringBuilder.h"
 
 namespace AT
 {
@@ -17,39 +20,415 @@ enum class IsNegative : u8
     Yes = 1,
 };
 
+///
+/// The destination of the formatted characters. Depending on how the builder is created, the characters are:
+///   - Written to a fixed buffer. The characters that don't fit are discarded, but still counted, so the caller
+///     knows the size of the buffer that is required. Truncation never splits a UTF-8 encoded code point.
+///   - Appended to a string builder, which grows as required.
+///   - Only counted, without being written anywhere.
+///
 class FormatBuilder
 {
 public:
+    //
+    // The parsed form of a format specifier, which has the syntax (all parts being optional):
+    //     {:[[fill]alignment][#][0][width][.precision][type]}
+    // The alignment is '<' (left), '>' (right) or '^' (center) and the fill is any ASCII character except the
+    // braces. The type is 'd', 'x', 'X', 'b' or 'o' for integers, 'f' (fixed) or 'e' (scientific) for
+    // floating-point numbers and 's' for strings. The '#' flag prefixes integers with their base ("0x", "0X",
+    // "0b" or "0"), while the '0' flag pads numbers with zeroes between the sign (and the prefix) and the digits.
+    // The precision is the number of digits after the decimal point of a floating-point number (which implies
+    // the fixed notation if no type is given) or the maximum number of code points of a string.
+    //
+    // Without a precision, floating-point numbers are formatted using the shortest decimal that converts back
+    // to the same number, except that integers in the fixed notation are written exactly, as std::to_chars does.
+    // Without a type, the notation is the shortest one, preferring the fixed notation.
+    //
     struct Specifier
     {
+        enum class Alignment : u8
+        {
+            // Integers are aligned to the right, everything else to the left.
+            Default = 0,
+            Left,
+            Right,
+            Center,
+        };
+
+        enum class Type : u8
+        {
+            Default = 0,
+            Decimal,
+            Hexadecimal,
+            UppercaseHexadecimal,
+            Binary,
+            Octal,
+            Fixed,
+            Scientific,
+            String,
+        };
+
+        static constexpr u32 NoPrecision = static_cast<u32>(-1);
+
+        NODISCARD ALWAYS_INLINE constexpr bool is_default() const
+        {
+            return alignment == Alignment::Default && type == Type::Default && !alternate_form && !zero_padding &&
+                   width == 0 && precision == NoPrecision;
+        }
+
+        char fill = ' ';
+        Alignment alignment = Alignment::Default;
+        Type type = Type::Default;
+        bool alternate_form = false;
+        bool zero_padding = false;
+        u32 width = 0;
+        u32 precision = NoPrecision;
     };
 
 public:
-    FormatBuilder(StringView format)
-        : m_format(format)
+    // Creates a builder that only counts the formatted characters.
+    ALWAYS_INLINE FormatBuilder()
+        : m_buffer(nullptr)
+        , m_capacity(0)
+    {
+    }
+
+    ALWAYS_INLINE FormatBuilder(char* buffer, usize capacity)
+        : m_buffer(buffer)
+        , m_capacity(capacity)
+    {
+    }
+
+    ALWAYS_INLINE explicit FormatBuilder(StringBuilder& string_builder)
+        : m_buffer(nullptr)
+        , m_capacity(0)
+        , m_string_builder(&string_builder)
+    {
+    }
+
+public:
+    ALWAYS_INLINE void push_string(StringView string)
     {
+        if (m_byte_count + string.byte_count() <= m_capacity) [[likely]]
+        {
+            copy_memory(m_buffer + m_byte_count, string.characters(), string.byte_count());
+            m_byte_count += string.byte_count();
+            return;
+        }
+
+        push_string_that_doesnt_fit(string);
     }
 
-    AT_API void push_string(StringView string);
     AT_API void push_integer(u64 integer, IsNegative is_negative);
+    AT_API void push_integer(u64 integer, IsNegative is_negative, const Specifier& specifier);
+
+    AT_API void push_floating_point(f64 value, const Specifier& specifier);
+    AT_API void push_floating_point(f32 value, const Specifier& specifier);
+
+    // Applies the precision, the width and the alignment of the specifier.
+    AT_API void push_string(StringView string, const Specifier& specifier);
+
+    // Pushes the fill character the given number of times.
+    AT_API void push_padding(char fill, usize count);
+
+public:
+    // The number of formatted bytes, including the ones that didn't fit in the buffer.
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_byte_count; }
 
-    // Returns true if a format specifier was found.
-    AT_API bool consume_until_format_specifier();
-    // Returns true if the format specifier is valid.
-    AT_API bool consume_format_specifier(Specifier& specifier);
+    // The number of bytes written to the buffer. Only meaningful for builders that write to a fixed buffer.
+    NODISCARD ALWAYS_INLINE usize written_byte_count() const
+    {
+        return m_byte_count < m_capacity ? m_byte_count : m_capacity;
+    }
 
-    AT_API String release_as_string();
+    NODISCARD ALWAYS_INLINE bool is_truncated() const
+    {
+        return m_string_builder == nullptr && m_byte_count > m_capacity;
+    }
 
 private:
-    static bool process_format_specifier(StringView specifier_string, Specifier& specifier);
+    AT_API void push_string_that_doesnt_fit(StringView string);
+
+    // Returns a pointer where the given number of bytes can be written directly, or nullptr if they don't fit.
+    NODISCARD ALWAYS_INLINE char* get_writable_bytes(usize byte_count)
+    {
+        if (m_byte_count + byte_count > m_capacity)
+            return nullptr;
+        char* bytes = m_buffer + m_byte_count;
+        m_byte_count += byte_count;
+        return bytes;
+    }
 
 private:
-    StringView m_format;
-    usize m_format_offset = 0;
+    char* m_buffer;
+    // Once a string doesn't fit, the capacity is reduced to the number of written bytes, so that the shorter
+    // strings that follow are not written after the truncated one.
+    usize m_capacity;
+    usize m_byte_count = 0;
+    StringBuilder* m_string_builder = nullptr;
+};
+
+namespace Detail
+{
+
+// These functions are intentionally not constexpr and never defined. Calling one of them while parsing a format
+// string at compile time makes the program ill-formed, and the compiler diagnostic contains the function name.
+void format_string_has_unterminated_specifier();
+void format_string_has_invalid_specifier();
+void format_string_has_more_specifiers_than_parameters();
+void format_string_has_fewer_specifiers_than_parameters();
 
-    Vector<char> m_formatted;
+// The kinds of parameters, which determine the valid format specifiers.
+enum class FormatParameterKind : u8
+{
+    Integer,
+    FloatingPoint,
+    String,
+    Other,
 };
 
+template<typename T>
+NODISCARD consteval FormatParameterKind get_format_parameter_kind()
+{
+    if constexpr (IsInteger<T>)
+        return FormatParameterKind::Integer;
+    else if constexpr (IsFloatingPoint<T>)
+        return FormatParameterKind::FloatingPoint;
+    else if constexpr (IsSame<T, String> || IsSame<T, StringView>)
+        return FormatParameterKind::String;
+    else
+        return FormatParameterKind::Other;
+}
+
+} // namespace Detail
+
+///
+/// A format string that is parsed at compile time. The string is split into the literal segments and the
+/// format specifiers that separate them, so formatting only has to copy the segments and format the parameters.
+/// A format string that is malformed or that doesn't have exactly one specifier for each parameter is rejected
+/// at compile time. The parameter types are the decayed types of the values passed to the format function.
+///
+template<typename... Parameters>
+class FormatString
+{
+public:
+    static constexpr usize ParameterCount = sizeof...(Parameters);
+
+    template<usize N>
+    consteval FormatString(const char (&literal)[N])
+        : FormatString(StringView::from_utf8(literal, N - 1))
+    {
+    }
+
+    consteval FormatString(StringView string)
+        : m_string(string)
+    {
+        parse();
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE constexpr StringView string() const { return m_string; }
+
+    // The segment that precedes the specifier with the given index. The segment with index ParameterCount is
+    // the one that follows the last specifier.
+    NODISCARD ALWAYS_INLINE constexpr StringView literal(usize index) const { return m_literals[index]; }
+
+    NODISCARD ALWAYS_INLINE constexpr const FormatBuilder::Specifier& specifier(usize index) const
+    {
+        return m_specifiers[index];
+    }
+
+    // The number of bytes in all literal segments, which is a lower bound of the formatted string byte count.
+    NODISCARD ALWAYS_INLINE constexpr usize literal_byte_count() const { return m_literal_byte_count; }
+
+private:
+    consteval void parse()
+    {
+        const char* characters = m_string.characters();
+        const usize byte_count = m_string.byte_count();
+
+        usize specifier_count = 0;
+        usize literal_begin_offset = 0;
+        usize offset = 0;
+
+        while (offset < byte_count)
+        {
+            if (characters[offset] != '{')
+            {
+                ++offset;
+                continue;
+            }
+
+            if (specifier_count == ParameterCount)
+                Detail::format_string_has_more_specifiers_than_parameters();
+            push_literal(specifier_count, characters + literal_begin_offset, offset - literal_begin_offset);
+
+            const usize specifier_begin_offset = ++offset;
+            while (offset < byte_count && characters[offset] != '}')
+                ++offset;
+            if (offset == byte_count)
+                Detail::format_string_has_unterminated_specifier();
+
+            const StringView specifier_string =
+                StringView::from_utf8(characters + specifier_begin_offset, offset - specifier_begin_offset);
+            if (!parse_specifier(specifier_string, s_parameter_kinds[specifier_count], m_specifiers[specifier_count]))
+                Detail::format_string_has_invalid_specifier();
+
+            ++specifier_count;
+            literal_begin_offset = ++offset;
+        }
+
+        if (specifier_count != ParameterCount)
+            Detail::format_string_has_fewer_specifiers_than_parameters();
+        push_literal(specifier_count, characters + literal_begin_offset, byte_count - literal_begin_offset);
+    }
+
+    consteval void push_literal(usize index, const char* characters, usize byte_count)
+    {
+        m_literals[index] = StringView::from_utf8(characters, byte_count);
+        m_literal_byte_count += byte_count;
+    }
+
+    // Returns true if the format specifier is valid for the kind of parameter it applies to.
+    NODISCARD static consteval bool
+    parse_specifier(StringView specifier_string, Detail::FormatParameterKind kind, FormatBuilder::Specifier& specifier)
+    {
+        using Alignment = FormatBuilder::Specifier::Alignment;
+        using Type = FormatBuilder::Specifier::Type;
+
+        specifier = {};
+        if (specifier_string.is_empty())
+            return true;
+
+        const char* characters = specifier_string.characters();
+        const usize byte_count = specifier_string.byte_count();
+        if (characters[0] != ':')
+            return false;
+        usize offset = 1;
+
+        const auto parse_alignment = [](char character) -> Alignment
+        {
+            switch (character)
+            {
+                case '<': return Alignment::Left;
+                case '>': return Alignment::Right;
+                case '^': return Alignment::Center;
+                default: return Alignment::Default;
+            }
+        };
+
+        // The fill character can only be specified together with the alignment.
+        if (offset + 1 < byte_count && parse_alignment(characters[offset + 1]) != Alignment::Default)
+        {
+            if (characters[offset] == '{' || static_cast<u8>(characters[offset]) >= 0x80)
+                return false;
+            specifier.fill = characters[offset];
+            specifier.alignment = parse_alignment(characters[offset + 1]);
+            offset += 2;
+        }
+        else if (offset < byte_count && parse_alignment(characters[offset]) != Alignment::Default)
+        {
+            specifier.alignment = parse_alignment(characters[offset]);
+            offset += 1;
+        }
+
+        if (offset < byte_count && characters[offset] == '#')
+        {
+            specifier.alternate_form = true;
+            ++offset;
+        }
+
+        if (offset < byte_count && characters[offset] == '0')
+        {
+            specifier.zero_padding = true;
+            ++offset;
+        }
+
+        // Returns false if the number doesn't fit in 16 bits, which is plenty for any sensible width or precision.
+        const auto parse_number = [&](u32& number) -> bool
+        {
+            number = 0;
+            while (offset < byte_count && characters[offset] >= '0' && characters[offset] <= '9')
+            {
+                number = number * 10 + static_cast<u32>(characters[offset++] - '0');
+                if (number > 0xFFFF)
+                    return false;
+            }
+            return true;
+        };
+
+        if (!parse_number(specifier.width))
+            return false;
+
+        if (offset < byte_count && characters[offset] == '.')
+        {
+            ++offset;
+            if (offset == byte_count || characters[offset] < '0' || characters[offset] > '9')
+                return false;
+            if (!parse_number(specifier.precision))
+                return false;
+        }
+
+        if (offset < byte_count)
+        {
+            switch (characters[offset++])
+            {
+                case 'd': specifier.type = Type::Decimal; break;
+                case 'x': specifier.type = Type::Hexadecimal; break;
+                case 'X': specifier.type = Type::UppercaseHexadecimal; break;
+                case 'b': specifier.type = Type::Binary; break;
+                case 'o': specifier.type = Type::Octal; break;
+                case 'f': specifier.type = Type::Fixed; break;
+                case 'e': specifier.type = Type::Scientific; break;
+                case 's': specifier.type = Type::String; break;
+                default: return false;
+            }
+        }
+
+        if (offset != byte_count)
+            return false;
+
+        // Check that the specifier makes sense for the kind of parameter.
+        switch (kind)
+        {
+            case Detail::FormatParameterKind::Integer:
+                return specifier.precision == FormatBuilder::Specifier::NoPrecision && specifier.type != Type::Fixed &&
+                       specifier.type != Type::Scientific && specifier.type != Type::String;
+            case Detail::FormatParameterKind::FloatingPoint:
+                return !specifier.alternate_form &&
+                       (specifier.precision == FormatBuilder::Specifier::NoPrecision ||
+                        specifier.precision <= MaxFloatingPointFractionDigitCount) &&
+                       (specifier.type == Type::Default || specifier.type == Type::Fixed ||
+                        specifier.type == Type::Scientific);
+            case Detail::FormatParameterKind::String:
+                return !specifier.alternate_form && !specifier.zero_padding &&
+                       (specifier.type == Type::Default || specifier.type == Type::String);
+            case Detail::FormatParameterKind::Other:
+                return !specifier.alternate_form && !specifier.zero_padding &&
+                       specifier.precision == FormatBuilder::Specifier::NoPrecision && specifier.type == Type::Default;
+        }
+        return false;
+    }
+
+private:
+    // An array can't have zero elements, so the kinds array always has an extra element.
+    static constexpr Detail::FormatParameterKind s_parameter_kinds[] = {
+        Detail::get_format_parameter_kind<Parameters>()...,
+        Detail::FormatParameterKind::Other,
+    };
+
+    StringView m_string;
+    StringView m_literals[ParameterCount + 1];
+    // An array can't have zero elements, so there is always at least one specifier.
+    FormatBuilder::Specifier m_specifiers[ParameterCount > 0 ? ParameterCount : 1] = {};
+    usize m_literal_byte_count = 0;
+};
+
+// The format string type that matches the values passed to a format function. The parameter types are
+// not deduced from the format string, only from the values.
+template<typename... Parameters>
+using CheckedFormatString = FormatString<RemoveCVR<Parameters>...>;
+
 template<typename T>
 struct Formatter
 {
@@ -59,150 +438,218 @@ struct Formatter
 template<>
 struct Formatter<u8>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const u8& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const u8& value)
     {
-        builder.push_integer(static_cast<u64>(value), IsNegative::No);
+        builder.push_integer(static_cast<u64>(value), IsNegative::No, specifier);
     }
 };
 template<>
 struct Formatter<u16>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const u16& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const u16& value)
     {
-        builder.push_integer(static_cast<u64>(value), IsNegative::No);
+        builder.push_integer(static_cast<u64>(value), IsNegative::No, specifier);
     }
 };
 template<>
 struct Formatter<u32>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const u32& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const u32& value)
     {
-        builder.push_integer(static_cast<u64>(value), IsNegative::No);
+        builder.push_integer(static_cast<u64>(value), IsNegative::No, specifier);
     }
 };
 template<>
 struct Formatter<u64>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const u64& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const u64& value)
     {
-        builder.push_integer(static_cast<u64>(value), IsNegative::No);
+        builder.push_integer(static_cast<u64>(value), IsNegative::No, specifier);
     }
 };
 
 template<>
 struct Formatter<i8>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const i8& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const i8& value)
     {
+        // The magnitude is computed using unsigned arithmetic, as negating the minimum value would overflow.
         const bool is_negative = value < 0;
-        builder.push_integer(
-            static_cast<u64>(is_negative ? -value : value), is_negative ? IsNegative::Yes : IsNegative::No
-        );
+        const u64 magnitude = is_negative ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
+        builder.push_integer(magnitude, is_negative ? IsNegative::Yes : IsNegative::No, specifier);
     }
 };
 template<>
 struct Formatter<i16>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const i16& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const i16& value)
     {
+        // The magnitude is computed using unsigned arithmetic, as negating the minimum value would overflow.
         const bool is_negative = value < 0;
-        builder.push_integer(
-            static_cast<u64>(is_negative ? -value : value), is_negative ? IsNegative::Yes : IsNegative::No
-        );
+        const u64 magnitude = is_negative ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
+        builder.push_integer(magnitude, is_negative ? IsNegative::Yes : IsNegative::No, specifier);
     }
 };
 template<>
 struct Formatter<i32>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const i32& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const i32& value)
     {
+        // The magnitude is computed using unsigned arithmetic, as negating the minimum value would overflow.
         const bool is_negative = value < 0;
-        builder.push_integer(
-            static_cast<u64>(is_negative ? -value : value), is_negative ? IsNegative::Yes : IsNegative::No
-        );
+        const u64 magnitude = is_negative ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
+        builder.push_integer(magnitude, is_negative ? IsNegative::Yes : IsNegative::No, specifier);
     }
 };
 template<>
 struct Formatter<i64>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const i64& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const i64& value)
     {
+        // The magnitude is computed using unsigned arithmetic, as negating the minimum value would overflow.
         const bool is_negative = value < 0;
-        builder.push_integer(
-            static_cast<u64>(is_negative ? -value : value), is_negative ? IsNegative::Yes : IsNegative::No
-        );
+        const u64 magnitude = is_negative ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
+        builder.push_integer(magnitude, is_negative ? IsNegative::Yes : IsNegative::No, specifier);
+    }
+};
+
+template<>
+struct Formatter<f32>
+{
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const f32& value)
+    {
+        builder.push_floating_point(value, specifier);
+    }
+};
+
+template<>
+struct Formatter<f64>
+{
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const f64& value)
+    {
+        builder.push_floating_point(value, specifier);
     }
 };
 
 template<>
 struct Formatter<String>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const String& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const String& value)
     {
-        builder.push_string(value.to_view());
+        builder.push_string(value.to_view(), specifier);
     }
 };
 template<>
 struct Formatter<StringView>
 {
-    static void format(FormatBuilder& builder, const FormatBuilder::Specifier&, const StringView& value)
+    static void format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const StringView& value)
     {
-        builder.push_string(value);
+        builder.push_string(value, specifier);
     }
 };
 
 namespace Detail
 {
 
-inline bool format(FormatBuilder& builder)
+template<typename... FormatParameters, typename... Parameters>
+ALWAYS_INLINE inline void format_parameters(
+    FormatBuilder& builder, const FormatString<FormatParameters...>& format_string, const Parameters&... parameters
+)
 {
-    if (builder.consume_until_format_specifier())
+    // Format strings often start or end with a specifier, or have adjacent specifiers, so the empty literals
+    // are skipped instead of being copied.
+    const auto push_literal = [&builder](StringView literal)
     {
-        // The string contains more format specifiers than the number of parameters passed.
-        return false;
-    }
+        if (!literal.is_empty())
+            builder.push_string(literal);
+    };
 
-    return true;
+    usize index = 0;
+    (
+        (push_literal(format_string.literal(index)),
+         Formatter<Parameters>::format(builder, format_string.specifier(index), parameters),
+         ++index),
+        ...
+    );
+    push_literal(format_string.literal(index));
 }
 
-template<typename T, typename... Parameters>
-inline bool format(FormatBuilder& builder, T parameter, Parameters&&... parameters)
+} // namespace Detail
+
+struct FormatToResult
 {
-    if (builder.consume_until_format_specifier())
-    {
-        FormatBuilder::Specifier specifier;
-        if (!builder.consume_format_specifier(specifier))
-        {
-            // The format specifier is invalid.
-            return false;
-        }
+    usize written_byte_count;
+    // If the formatted string is larger than the buffer, the output was truncated.
+    usize formatted_byte_count;
 
-        Formatter<T>::format(builder, specifier, parameter);
-        return format(builder, forward<Parameters>(parameters)...);
-    }
+    NODISCARD ALWAYS_INLINE bool is_truncated() const { return written_byte_count < formatted_byte_count; }
+};
 
-    // NOTE: If the number of parameters passed to the format function is greater than the
-    // number of format specifiers in the string the function will still succeed.
-    return true;
+// Writes the formatted string to the buffer, without a null-termination character and without allocating any memory.
+template<typename... Parameters>
+inline FormatToResult
+format_to(Span<char> buffer, CheckedFormatString<Parameters...> format_string, Parameters&&... parameters)
+{
+    FormatBuilder builder = FormatBuilder(buffer.elements(), buffer.count());
+    Detail::format_parameters(builder, format_string, parameters...);
+    return { builder.written_byte_count(), builder.byte_count() };
 }
 
+// Appends the formatted string to the string builder.
+template<typename... Parameters>
+inline void
+format_to(StringBuilder& string_builder, CheckedFormatString<Parameters...> format_string, Parameters&&... parameters)
+{
+    MUST(string_builder.try_ensure_available(format_string.literal_byte_count()));
+    FormatBuilder builder = FormatBuilder(string_builder);
+    Detail::format_parameters(builder, format_string, parameters...);
+}
+
+// Returns the byte count of the formatted string (excluding the null-termination character), without formatting it.
+template<typename... Parameters>
+inline usize formatted_size(CheckedFormatString<Parameters...> format_string, Parameters&&... parameters)
+{
+    FormatBuilder builder;
+    Detail::format_parameters(builder, format_string, parameters...);
+    return builder.byte_count();
+}
+
+namespace Detail
+{
+
+// The formatted strings that fit in this many bytes are formatted on the stack first.
+constexpr usize FormatStackBufferSize = 256;
+
 } // namespace Detail
 
+// The string buffer is allocated only once, with the exact required size.
 template<typename... Parameters>
-inline String format(StringView fmt, Parameters&&... parameters)
+inline String format(CheckedFormatString<Parameters...> format_string, Parameters&&... parameters)
 {
-    FormatBuilder builder = FormatBuilder(fmt);
-    if (Detail::format(builder, forward<Parameters>(parameters)...))
-        return builder.release_as_string();
+    // Most formatted strings fit in the stack buffer, so they are formatted only once.
+    char stack_buffer[Detail::FormatStackBufferSize];
+    FormatBuilder builder = FormatBuilder(stack_buffer, sizeof(stack_buffer));
+    Detail::format_parameters(builder, format_string, parameters...);
+    if (!builder.is_truncated())
+        return String(StringView::from_utf8(stack_buffer, builder.byte_count()));
 
-    // The string formatting process has failed, so an empty string is returned.
-    return {};
+    // The exact byte count is known now, so the string is formatted again, directly into its own buffer.
+    String formatted;
+    char* characters = formatted.replace_with_uninitialized(builder.byte_count());
+    FormatBuilder exact_builder = FormatBuilder(characters, builder.byte_count());
+    Detail::format_parameters(exact_builder, format_string, parameters...);
+    return formatted;
 }
 
 } // namespace AT
 
 #if AT_INCLUDE_GLOBALLY
+using AT::CheckedFormatString;
 using AT::format;
+using AT::format_to;
+using AT::formatted_size;
+using AT::FormatToResult;
 using AT::FormatBuilder;
 using AT::Formatter;
+using AT::FormatString;
 #endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Hash.h"
+
+#include <cstring>
+
+#if AT_ARCHITECTURE_X86_64
+    #include <emmintrin.h>
+#endif // AT_ARCHITECTURE_X86_64
+
+namespace AT
+{
+
+NODISCARD ALWAYS_INLINE static inline u64 read_u64(const u8* bytes)
+{
+    u64 value;
+    std::memcpy(&value, bytes, sizeof(u64));
+    return value;
+}
+
+NODISCARD ALWAYS_INLINE static inline u64 read_u32(const u8* bytes)
+{
+    u32 value;
+    std::memcpy(&value, bytes, sizeof(u32));
+    return value;
+}
+
+//=============================================================================
+// Short and medium inputs.
+//=============================================================================
+
+// Based on wyhash (final version 4). The ranges of up to 16 bytes are hashed without any loop, by reading
+// (possibly overlapping) words from the start and the end of the range.
+NODISCARD static u64 hash_short_bytes(const u8* bytes, usize byte_count, u64 seed)
+{
+    using namespace Detail;
+    seed ^= multiply_and_fold(seed ^ HashSecret0, HashSecret1);
+
+    u64 a;
+    u64 b;
+    if (byte_count <= 16)
+    {
+        if (byte_count >= 4)
+        {
+            const usize middle_offset = (byte_count >> 3) << 2;
+            a = (read_u32(bytes) << 32) | read_u32(bytes + middle_offset);
+            b = (read_u32(bytes + byte_count - 4) << 32) | read_u32(bytes + byte_count - 4 - middle_offset);
+        }
+        else if (byte_count > 0)
+        {
+            a = (static_cast<u64>(bytes[0]) << 16) | (static_cast<u64>(bytes[byte_count >> 1]) << 8) |
+                bytes[byte_count - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        usize remaining_byte_count = byte_count;
+        if (remaining_byte_count > 48)
+        {
+            // Three independent lanes, so that the multiplications can execute in parallel.
+            u64 seed_1 = seed;
+            u64 seed_2 = seed;
+            do
+            {
+                seed = multiply_and_fold(read_u64(bytes) ^ HashSecret1, read_u64(bytes + 8) ^ seed);
+                seed_1 = multiply_and_fold(read_u64(bytes + 16) ^ HashSecret2, read_u64(bytes + 24) ^ seed_1);
+                seed_2 = multiply_and_fold(read_u64(bytes + 32) ^ HashSecret3, read_u64(bytes + 40) ^ seed_2);
+                bytes += 48;
+                remaining_byte_count -= 48;
+            } while (remaining_byte_count > 48);
+            seed ^= seed_1 ^ seed_2;
+        }
+
+        while (remaining_byte_count > 16)
+        {
+            seed = multiply_and_fold(read_u64(bytes) ^ HashSecret1, read_u64(bytes + 8) ^ seed);
+            bytes += 16;
+            remaining_byte_count -= 16;
+        }
+
+        a = read_u64(bytes + remaining_byte_count - 16);
+        b = read_u64(bytes + remaining_byte_count - 8);
+    }
+
+    a ^= HashSecret1;
+    b ^= seed;
+
+    // Multiply without folding, so that the final mix operates on both halves of the product.
+#if AT_COMPILER_MSVC
+    u64 high;
+    const u64 low = _umul128(a, b, &high);
+#else
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    const u64 low = static_cast<u64>(product);
+    const u64 high = static_cast<u64>(product >> 64);
+#endif // AT_COMPILER_MSVC
+
+    return multiply_and_fold(low ^ HashSecret0 ^ byte_count, high ^ HashSecret1);
+}
+
+//=============================================================================
+// Long inputs.
+//=============================================================================
+
+//
+// Based on the long input path of XXH3. The input is split in stripes of 64 bytes, each one being accumulated into
+// eight 64-bit lanes that don't depend on each other, which maps naturally to vector registers. Each stripe is
+// combined with a different window of the secret. After each block of stripes the accumulators are scrambled,
+// so that the bits of the lanes don't degrade.
+//
+
+static constexpr usize LongInputThreshold = 256;
+static constexpr usize StripeSize = 64;
+static constexpr usize SecretSize = 192;
+static constexpr usize SecretWindowStride = 8;
+static constexpr usize StripesPerBlock = (SecretSize - StripeSize) / SecretWindowStride;
+static constexpr usize BlockSize = StripesPerBlock * StripeSize;
+static constexpr usize AccumulatorCount = StripeSize / sizeof(u64);
+static constexpr u32 ScrambleMultiplier = 0x9E3779B1u;
+
+alignas(16) static constexpr u64 s_long_input_secret[SecretSize / sizeof(u64)] = {
+    0x9ddb0205f7b13feaull, 0xdd33035fe1c0c42eull, 0x2023d613d839f9b0ull, 0x4993cff87efa954bull,
+    0x8b5f2b5e7fb07281ull, 0x1729b379a1d093fdull, 0x500af5f8e9b11736ull, 0xf51335b1bc092229ull,
+    0xe239f893e587b3feull, 0x1119a75ede461bffull, 0x6639c880b730a45cull, 0xa48f0288dc7c934bull,
+    0x655cbd93b9636a53ull, 0xd24954647f4903ffull, 0x1977b42ce3a5fbd0ull, 0x94f7b34f8c2272c7ull,
+    0x10a5871c99d3bff4ull, 0xdb023d9fd9337d9dull, 0x1569be1bfd05b415ull, 0xd2e9530781c717d1ull,
+    0x5a44aef55474ba35ull, 0x704bcd549472f91bull, 0xdf8af0e375b715c9ull, 0x9bbf22a2bb69b9b8ull,
+};
+
+#if AT_ARCHITECTURE_X86_64
+
+// SSE2 is part of the x86-64 baseline, so the vectorized accumulation is always available.
+ALWAYS_INLINE static inline void accumulate_stripe(u64* accumulators, const u8* stripe, const u8* secret)
+{
+    __m128i* lanes = reinterpret_cast<__m128i*>(accumulators);
+    for (usize index = 0; index < AccumulatorCount / 2; ++index)
+    {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe) + index);
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + index);
+        const __m128i data_key = _mm_xor_si128(data, key);
+
+        // Multiply the low and the high 32-bit halves of each 64-bit lane.
+        const __m128i data_key_high = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product = _mm_mul_epu32(data_key, data_key_high);
+
+        // The data is also added to the adjacent lane, so that no input bits are lost by the multiplication.
+        const __m128i swapped_data = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m128i sum = _mm_add_epi64(_mm_load_si128(lanes + index), swapped_data);
+        _mm_store_si128(lanes + index, _mm_add_epi64(product, sum));
+    }
+}
+
+ALWAYS_INLINE static inline void scramble_accumulators(u64* accumulators, const u8* secret)
+{
+    __m128i* lanes = reinterpret_cast<__m128i*>(accumulators);
+    const __m128i multiplier = _mm_set1_epi32(static_cast<int>(ScrambleMultiplier));
+
+    for (usize index = 0; index < AccumulatorCount / 2; ++index)
+    {
+        __m128i lane = _mm_load_si128(lanes + index);
+        lane = _mm_xor_si128(lane, _mm_srli_epi64(lane, 47));
+        lane = _mm_xor_si128(lane, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + index));
+
+        // 64-bit by 32-bit multiplication, assembled from two 32-bit by 32-bit multiplications.
+        const __m128i product_low = _mm_mul_epu32(lane, multiplier);
+        const __m128i product_high = _mm_mul_epu32(_mm_shuffle_epi32(lane, _MM_SHUFFLE(0, 3, 0, 1)), multiplier);
+        _mm_store_si128(lanes + index, _mm_add_epi64(product_low, _mm_slli_epi64(product_high, 32)));
+    }
+}
+
+#else
+
+ALWAYS_INLINE static inline void accumulate_stripe(u64* accumulators, const u8* stripe, const u8* secret)
+{
+    for (usize index = 0; index < AccumulatorCount; ++index)
+    {
+        const u64 data = read_u64(stripe + index * sizeof(u64));
+        const u64 data_key = data ^ read_u64(secret + index * sizeof(u64));
+        accumulators[index ^ 1] += data;
+        accumulators[index] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+}
+
+ALWAYS_INLINE static inline void scramble_accumulators(u64* accumulators, const u8* secret)
+{
+    for (usize index = 0; index < AccumulatorCount; ++index)
+    {
+        u64 lane = accumulators[index];
+        lane ^= lane >> 47;
+        lane ^= read_u64(secret + index * sizeof(u64));
+        accumulators[index] = lane * ScrambleMultiplier;
+    }
+}
+
+#endif // AT_ARCHITECTURE_X86_64
+
+NODISCARD static u64 hash_long_bytes(const u8* bytes, usize byte_count, u64 seed)
+{
+    const u8* secret = reinterpret_cast<const u8*>(s_long_input_secret);
+
+    alignas(16) u64 accumulators[AccumulatorCount];
+    for (usize index = 0; index < AccumulatorCount; ++index)
+        accumulators[index] = s_long_input_secret[index] ^ seed;
+
+    const usize block_count = (byte_count - 1) / BlockSize;
+    for (usize block_index = 0; block_index < block_count; ++block_index)
+    {
+        const u8* block = bytes + block_index * BlockSize;
+        for (usize stripe_index = 0; stripe_index < StripesPerBlock; ++stripe_index)
+        {
+            const usize secret_offset = stripe_index * SecretWindowStride;
+            accumulate_stripe(accumulators, block + stripe_index * StripeSize, secret + secret_offset);
+        }
+        scramble_accumulators(accumulators, secret + SecretSize - StripeSize);
+    }
+
+    // The last (partial) block. The final stripe always ends at the end of the input, possibly overlapping the
+    // previous stripe, and it uses a secret window that is not used by any other stripe.
+    const u8* last_block = bytes + block_count * BlockSize;
+    const usize last_stripe_count = (byte_count - 1 - block_count * BlockSize) / StripeSize;
+    for (usize stripe_index = 0; stripe_index < last_stripe_count; ++stripe_index)
+    {
+        const usize secret_offset = stripe_index * SecretWindowStride;
+        accumulate_stripe(accumulators, last_block + stripe_index * StripeSize, secret + secret_offset);
+    }
+    accumulate_stripe(accumulators, bytes + byte_count - StripeSize, secret + SecretSize - StripeSize - 7);
+
+    // Merge the accumulators.
+    u64 result = byte_count * 0x9E3779B185EBCA87ull;
+    for (usize index = 0; index < AccumulatorCount / 2; ++index)
+    {
+        const u64 lhs = accumulators[2 * index] ^ read_u64(secret + 11 + 16 * index);
+        const u64 rhs = accumulators[2 * index + 1] ^ read_u64(secret + 19 + 16 * index);
+        result += Detail::multiply_and_fold(lhs, rhs);
+    }
+
+    result ^= result >> 37;
+    result *= 0x165667919E3779F9ull;
+    result ^= result >> 32;
+    return result;
+}
+
+u64 hash_bytes(const void* bytes, usize byte_count, u64 seed)
+{
+    if (byte_count <= LongInputThreshold) [[likely]]
+        return hash_short_bytes(static_cast<const u8*>(bytes), byte_count, seed);
+    return hash_long_bytes(static_cast<const u8*>(bytes), byte_count, seed);
+}
+
+} // namespace AT
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+
+#if AT_COMPILER_MSVC
+    #include <intrin.h>
+#endif // AT_COMPILER_MSVC
+
+namespace AT
+{
+
+namespace Detail
+{
+
+// Constants used by the hash functions. They are random odd numbers with (roughly) half of the bits set.
+static constexpr u64 HashSecret0 = 0x2d358dccaa6c78a5ull;
+static constexpr u64 HashSecret1 = 0x8bb84b93962eacc9ull;
+static constexpr u64 HashSecret2 = 0x4b33a62ed433d4a3ull;
+static constexpr u64 HashSecret3 = 0x4d5a2da51de1aa47ull;
+
+// Computes the full 128-bit product of the operands, and folds it by XOR-ing its halves.
+// A single multiplication diffuses every input bit into (almost) every output bit.
+NODISCARD ALWAYS_INLINE inline u64 multiply_and_fold(u64 lhs, u64 rhs)
+{
+#if AT_COMPILER_MSVC
+    u64 high;
+    const u64 low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#else
+    const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#endif // AT_COMPILER_MSVC
+}
+
+} // namespace Detail
+
+//
+// The hash functions are intended for hash tables, so they are fast but NOT cryptographically secure, and
+// they are not stable between versions of the library (the hashes must never be persisted).
+//
+
+NODISCARD ALWAYS_INLINE inline u64 hash_integer(u64 value)
+{
+    return Detail::multiply_and_fold(value ^ Detail::HashSecret0, Detail::HashSecret1);
+}
+
+// Byte ranges up to a few hundred bytes are hashed by a scalar function from the wyhash family. Longer ranges are
+// accumulated in parallel lanes (as in XXH3), which are processed using vector instructions when available.
+NODISCARD AT_API u64 hash_bytes(const void* bytes, usize byte_count, u64 seed = 0);
+
+// Combines the hashes of the members of a composite key. The order of the hashes matters.
+NODISCARD ALWAYS_INLINE inline u64 hash_combine(u64 seed, u64 hash)
+{
+    return Detail::multiply_and_fold(seed ^ Detail::HashSecret2, hash ^ Detail::HashSecret3);
+}
+
+template<typename... Hashes>
+NODISCARD ALWAYS_INLINE inline u64 hash_combine(u64 seed, u64 hash, Hashes... hashes)
+{
+    return hash_combine(hash_combine(seed, hash), hashes...);
+}
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::hash_bytes;
+using AT::hash_combine;
+using AT::hash_integer;
+#endif // AT_INCLUDE_GLOBALLY
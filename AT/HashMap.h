@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/HashTable.h"
+
+namespace AT
+{
+
+template<typename K, typename V>
+struct HashMapEntry
+{
+    K key;
+    V value;
+};
+
+///
+/// Associative container that maps unique keys to values, implemented as an open-addressing hash table
+/// (see Detail::HashTable). The entries are stored inline in the table, so references to them are invalidated
+/// when the map grows or when another entry is removed.
+///
+/// The keys are hashed using KeyTraits::get_hash. The lookup functions accept any type that KeyTraits can hash
+/// and that can be compared with the key type (for example, a StringView can be used to find a String key),
+/// so no temporary key has to be constructed. The hash of such a type must match the hash of the equal key.
+///
+template<typename K, typename V, typename KeyTraits = TypeTraits<K>>
+class HashMap
+{
+public:
+    using Entry = HashMapEntry<K, V>;
+
+private:
+    struct EntryTraits
+    {
+        NODISCARD ALWAYS_INLINE static u64 get_hash(const Entry& entry) { return KeyTraits::get_hash(entry.key); }
+    };
+
+    using TableType = Detail::HashTable<Entry, EntryTraits>;
+
+public:
+    using Iterator = typename TableType::Iterator;
+    using ConstIterator = typename TableType::ConstIterator;
+
+public:
+    ALWAYS_INLINE static ErrorOr<HashMap> try_create_with_initial_capacity(usize initial_capacity,
+                                                                           Allocator* allocator = nullptr)
+    {
+        HashMap map = HashMap(allocator);
+        TRY(map.try_ensure_capacity(initial_capacity));
+        return map;
+    }
+
+public:
+    HashMap() = default;
+
+    ALWAYS_INLINE explicit HashMap(Allocator* allocator)
+        : m_table(allocator)
+    {
+    }
+
+public:
+    // Inserts the entry if the key is not already in the map, otherwise replaces the value of the existing entry.
+    template<typename KeyType>
+    ALWAYS_INLINE ErrorOr<void> try_set(KeyType&& key, V value)
+    {
+        const auto is_matching_entry = [&](const Entry& entry) { return entry.key == key; };
+        TRY_ASSIGN(auto result, m_table.try_find_or_reserve(KeyTraits::get_hash(key), is_matching_entry));
+
+        if (result.is_new_entry)
+            new (result.slot) Entry { K(forward<KeyType>(key)), move(value) };
+        else
+            result.slot->value = move(value);
+        return {};
+    }
+
+    // Returns the value associated with the key, inserting a default constructed value if the key is not in the map.
+    template<typename KeyType>
+    ALWAYS_INLINE ErrorOr<V&> try_ensure(KeyType&& key)
+    {
+        const auto is_matching_entry = [&](const Entry& entry) { return entry.key == key; };
+        TRY_ASSIGN(auto result, m_table.try_find_or_reserve(KeyTraits::get_hash(key), is_matching_entry));
+
+        if (result.is_new_entry)
+            new (result.slot) Entry { K(forward<KeyType>(key)), V() };
+        return result.slot->value;
+    }
+
+    template<typename KeyType>
+    NODISCARD ALWAYS_INLINE V* find(const KeyType& key)
+    {
+        Entry* entry = find_entry(key);
+        return entry ? &entry->value : nullptr;
+    }
+
+    template<typename KeyType>
+    NODISCARD ALWAYS_INLINE const V* find(const KeyType& key) const
+    {
+        const Entry* entry = find_entry(key);
+        return entry ? &entry->value : nullptr;
+    }
+
+    // IMPORTANT: The key of the returned entry must not be modified, as the entry would no longer be found.
+    template<typename KeyType>
+    NODISCARD ALWAYS_INLINE Entry* find_entry(const KeyType& key)
+    {
+        const u64 hash = KeyTraits::get_hash(key);
+        return m_table.find(hash, [&](const Entry& entry) { return entry.key == key; });
+    }
+
+    template<typename KeyType>
+    NODISCARD ALWAYS_INLINE const Entry* find_entry(const KeyType& key) const
+    {
+        const u64 hash = KeyTraits::get_hash(key);
+        return m_table.find(hash, [&](const Entry& entry) { return entry.key == key; });
+    }
+
+    template<typename KeyType>
+    NODISCARD ALWAYS_INLINE bool contains(const KeyType& key) const
+    {
+        return find_entry(key) != nullptr;
+    }
+
+    // Returns false if the key was not in the map.
+    template<typename KeyType>
+    ALWAYS_INLINE bool remove(const KeyType& key)
+    {
+        const u64 hash = KeyTraits::get_hash(key);
+        return m_table.remove(hash, [&](const Entry& entry) { return entry.key == key; });
+    }
+
+    ALWAYS_INLINE ErrorOr<void> try_ensure_capacity(usize required_count)
+    {
+        return m_table.try_ensure_capacity(required_count);
+    }
+
+    ALWAYS_INLINE void clear() { m_table.clear(); }
+    ALWAYS_INLINE void clear_and_shrink() { m_table.clear_and_shrink(); }
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_table.count(); }
+    NODISCARD ALWAYS_INLINE usize capacity() const { return m_table.capacity(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_table.is_empty(); }
+    NODISCARD ALWAYS_INLINE Allocator* allocator() const { return m_table.allocator(); }
+
+    NODISCARD ALWAYS_INLINE Iterator begin() { return m_table.begin(); }
+    NODISCARD ALWAYS_INLINE Iterator end() { return m_table.end(); }
+
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return m_table.begin(); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return m_table.end(); }
+
+private:
+    TableType m_table;
+};
+
+// The map only stores a pointer to its memory, so it can be relocated by copying its bytes.
+template<typename K, typename V, typename KeyTraits>
+inline constexpr bool IsTriviallyRelocatable<HashMap<K, V, KeyTraits>> = true;
+
+template<typename K, typename V>
+inline constexpr bool IsTriviallyRelocatable<HashMapEntry<K, V>> =
+    IsTriviallyRelocatable<K> && IsTriviallyRelocatable<V>;
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::HashMap;
+using AT::HashMapEntry;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/HashTable.h"
+
+namespace AT
+{
+
+///
+/// Collection of unique values, implemented as an open-addressing hash table (see Detail::HashTable).
+/// As for HashMap, the lookup functions accept any type that Traits can hash and that can be compared
+/// with the stored type.
+///
+template<typename T, typename Traits = TypeTraits<T>>
+class HashSet
+{
+private:
+    using TableType = Detail::HashTable<T, Traits>;
+
+public:
+    using Iterator = typename TableType::ConstIterator;
+    using ConstIterator = typename TableType::ConstIterator;
+
+public:
+    ALWAYS_INLINE static ErrorOr<HashSet> try_create_with_initial_capacity(usize initial_capacity,
+                                                                           Allocator* allocator = nullptr)
+    {
+        HashSet set = HashSet(allocator);
+        TRY(set.try_ensure_capacity(initial_capacity));
+        return set;
+    }
+
+public:
+    HashSet() = default;
+
+    ALWAYS_INLINE explicit HashSet(Allocator* allocator)
+        : m_table(allocator)
+    {
+    }
+
+public:
+    // Returns true if the value was inserted, or false if an equal value was already in the set.
+    template<typename ValueType>
+    ALWAYS_INLINE ErrorOr<bool> try_set(ValueType&& value)
+    {
+        const auto is_matching_element = [&](const T& element) { return element == value; };
+        TRY_ASSIGN(auto result, m_table.try_find_or_reserve(Traits::get_hash(value), is_matching_element));
+
+        if (result.is_new_entry)
+            new (result.slot) T(forward<ValueType>(value));
+        return result.is_new_entry;
+    }
+
+    template<typename ValueType>
+    NODISCARD ALWAYS_INLINE const T* find(const ValueType& value) const
+    {
+        const u64 hash = Traits::get_hash(value);
+        return m_table.find(hash, [&](const T& element) { return element == value; });
+    }
+
+    template<typename ValueType>
+    NODISCARD ALWAYS_INLINE bool contains(const ValueType& value) const
+    {
+        return find(value) != nullptr;
+    }
+
+    // Returns false if the value was not in the set.
+    template<typename ValueType>
+    ALWAYS_INLINE bool remove(const ValueType& value)
+    {
+        const u64 hash = Traits::get_hash(value);
+        return m_table.remove(hash, [&](const T& element) { return element == value; });
+    }
+
+    ALWAYS_INLINE ErrorOr<void> try_ensure_capacity(usize required_count)
+    {
+        return m_table.try_ensure_capacity(required_count);
+    }
+
+    ALWAYS_INLINE void clear() { m_table.clear(); }
+    ALWAYS_INLINE void clear_and_shrink() { m_table.clear_and_shrink(); }
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_table.count(); }
+    NODISCARD ALWAYS_INLINE usize capacity() const { return m_table.capacity(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_table.is_empty(); }
+    NODISCARD ALWAYS_INLINE Allocator* allocator() const { return m_table.allocator(); }
+
+    // The values can't be modified in place, as that might change their hash.
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return m_table.begin(); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return m_table.end(); }
+
+private:
+    TableType m_table;
+};
+
+// The set only stores a pointer to its memory, so it can be relocated by copying its bytes.
+template<typename T, typename Traits>
+inline constexpr bool IsTriviallyRelocatable<HashSet<T, Traits>> = true;
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::HashSet;
+#endif // AT_INCLUDE_GLOBALLY
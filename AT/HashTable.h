@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Allocator.h"
+#include "AT/Assertions.h"
+#include "AT/BitOperations.h"
+#include "AT/CoreTypes.h"
+#include "AT/Error.h"
+#include "AT/MemoryOperations.h"
+#include "AT/TypeTraits.h"
+
+#include <new>
+
+#if AT_ARCHITECTURE_X86_64
+    #include <emmintrin.h>
+#endif // AT_ARCHITECTURE_X86_64
+
+namespace AT
+{
+
+namespace Detail
+{
+
+//
+// The control bytes of consecutive slots, that are probed at once.
+// Each control byte is either HashTableEmptyControl (the high bit is set) or the top seven bits of
+// the hash of the entry stored in the slot (the high bit is clear). Comparing the control bytes
+// filters out almost all entries that don't match the searched key, without touching their memory.
+//
+static constexpr u8 HashTableEmptyControl = 0x80;
+
+#if AT_ARCHITECTURE_X86_64
+
+// SSE2 is part of the x86-64 baseline, so the groups are always probed using vector instructions.
+class HashTableGroup
+{
+public:
+    static constexpr usize Width = 16;
+
+public:
+    ALWAYS_INLINE explicit HashTableGroup(const u8* control)
+        : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+    {
+    }
+
+    // Each bit of the returned masks corresponds to a slot in the group.
+    NODISCARD ALWAYS_INLINE u32 match(u8 h2) const
+    {
+        const __m128i pattern = _mm_set1_epi8(static_cast<char>(h2));
+        return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_control, pattern)));
+    }
+
+    NODISCARD ALWAYS_INLINE u32 match_empty() const { return static_cast<u32>(_mm_movemask_epi8(m_control)); }
+
+private:
+    __m128i m_control;
+};
+
+#else
+
+class HashTableGroup
+{
+public:
+    static constexpr usize Width = 16;
+
+public:
+    ALWAYS_INLINE explicit HashTableGroup(const u8* control) { copy_memory(m_control, control, Width); }
+
+    NODISCARD ALWAYS_INLINE u32 match(u8 h2) const
+    {
+        u32 mask = 0;
+        for (usize index = 0; index < Width; ++index)
+            mask |= static_cast<u32>(m_control[index] == h2) << index;
+        return mask;
+    }
+
+    NODISCARD ALWAYS_INLINE u32 match_empty() const { return match(HashTableEmptyControl); }
+
+private:
+    u8 m_control[Width];
+};
+
+#endif // AT_ARCHITECTURE_X86_64
+
+//
+// Open-addressing hash table, in the style of the Swiss tables, that is the storage of HashMap and HashSet.
+//
+// The slots are probed linearly, one group of control bytes at a time, starting from the slot selected by the low
+// bits of the hash. A lookup stops at the first group that contains an empty slot. The first control bytes are cloned
+// after the last one, so that a group can start at any slot without wrapping around.
+//
+// Removing an entry doesn't leave a tombstone behind. Instead, the following entries of the probe sequence are
+// shifted backwards into the hole, so the table never degrades due to removals and never has to be cleaned up.
+//
+// The EntryTraits must provide 'static u64 get_hash(const T&)', which is used when entries are moved around.
+//
+template<typename T, typename EntryTraits>
+class HashTable
+{
+public:
+    static constexpr usize MinimumCapacity = HashTableGroup::Width;
+
+    struct FindOrReserveResult
+    {
+        T* slot;
+        // If true, the slot is not initialized and the caller must construct the entry in place.
+        bool is_new_entry;
+    };
+
+    template<typename TableType, typename EntryType>
+    class IteratorBase
+    {
+    public:
+        ALWAYS_INLINE IteratorBase(TableType* table, usize index)
+            : m_table(table)
+            , m_index(index)
+        {
+            skip_empty_slots();
+        }
+
+        NODISCARD ALWAYS_INLINE EntryType& operator*() const { return m_table->m_slots[m_index]; }
+        NODISCARD ALWAYS_INLINE EntryType* operator->() const { return &m_table->m_slots[m_index]; }
+
+        NODISCARD ALWAYS_INLINE bool operator==(const IteratorBase& other) const { return m_index == other.m_index; }
+        NODISCARD ALWAYS_INLINE bool operator!=(const IteratorBase& other) const { return m_index != other.m_index; }
+
+        ALWAYS_INLINE IteratorBase& operator++()
+        {
+            ++m_index;
+            skip_empty_slots();
+            return *this;
+        }
+
+    private:
+        ALWAYS_INLINE void skip_empty_slots()
+        {
+            while (m_index < m_table->m_capacity && m_table->m_control[m_index] == HashTableEmptyControl)
+                ++m_index;
+        }
+
+    private:
+        TableType* m_table;
+        usize m_index;
+    };
+
+    using Iterator = IteratorBase<HashTable, T>;
+    using ConstIterator = IteratorBase<const HashTable, const T>;
+
+public:
+    ALWAYS_INLINE HashTable()
+        : m_slots(nullptr)
+        , m_control(nullptr)
+        , m_capacity(0)
+        , m_count(0)
+        , m_allocator(nullptr)
+    {
+    }
+
+    ALWAYS_INLINE explicit HashTable(Allocator* allocator)
+        : m_slots(nullptr)
+        , m_control(nullptr)
+        , m_capacity(0)
+        , m_count(0)
+        , m_allocator(allocator)
+    {
+    }
+
+    ALWAYS_INLINE HashTable(const HashTable& other)
+        : m_slots(nullptr)
+        , m_control(nullptr)
+        , m_capacity(0)
+        , m_count(0)
+        , m_allocator(other.m_allocator)
+    {
+        copy_from(other);
+    }
+
+    ALWAYS_INLINE HashTable(HashTable&& other) noexcept
+        : m_slots(other.m_slots)
+        , m_control(other.m_control)
+        , m_capacity(other.m_capacity)
+        , m_count(other.m_count)
+        , m_allocator(other.m_allocator)
+    {
+        other.m_slots = nullptr;
+        other.m_control = nullptr;
+        other.m_capacity = 0;
+        other.m_count = 0;
+    }
+
+    ALWAYS_INLINE HashTable& operator=(const HashTable& other)
+    {
+        if (this == &other)
+            return *this;
+
+        clear_and_shrink();
+        copy_from(other);
+        return *this;
+    }
+
+    ALWAYS_INLINE HashTable& operator=(HashTable&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        clear_and_shrink();
+
+        m_slots = other.m_slots;
+        m_control = other.m_control;
+        m_capacity = other.m_capacity;
+        m_count = other.m_count;
+        m_allocator = other.m_allocator;
+
+        other.m_slots = nullptr;
+        other.m_control = nullptr;
+        other.m_capacity = 0;
+        other.m_count = 0;
+        return *this;
+    }
+
+    ALWAYS_INLINE ~HashTable() { clear_and_shrink(); }
+
+public:
+    template<typename Predicate>
+    NODISCARD ALWAYS_INLINE T* find(u64 hash, Predicate predicate)
+    {
+        const usize index = find_index(hash, predicate);
+        return index != InvalidIndex ? &m_slots[index] : nullptr;
+    }
+
+    template<typename Predicate>
+    NODISCARD ALWAYS_INLINE const T* find(u64 hash, Predicate predicate) const
+    {
+        const usize index = find_index(hash, predicate);
+        return index != InvalidIndex ? &m_slots[index] : nullptr;
+    }
+
+    template<typename Predicate>
+    NODISCARD ALWAYS_INLINE ErrorOr<FindOrReserveResult> try_find_or_reserve(u64 hash, Predicate predicate)
+    {
+        const usize existing_index = find_index(hash, predicate);
+        if (existing_index != InvalidIndex)
+            return FindOrReserveResult { &m_slots[existing_index], false };
+
+        if (m_count + 1 > get_maximum_count(m_capacity))
+            TRY(try_rehash(m_capacity > 0 ? 2 * m_capacity : MinimumCapacity));
+
+        const usize index = find_empty_index(hash);
+        set_control(index, get_h2(hash));
+        ++m_count;
+        return FindOrReserveResult { &m_slots[index], true };
+    }
+
+    template<typename Predicate>
+    ALWAYS_INLINE bool remove(u64 hash, Predicate predicate)
+    {
+        const usize index = find_index(hash, predicate);
+        if (index == InvalidIndex)
+            return false;
+
+        remove_at_index(index);
+        return true;
+    }
+
+    // Ensures that the given number of entries can be stored without rehashing the table.
+    ALWAYS_INLINE ErrorOr<void> try_ensure_capacity(usize required_count)
+    {
+        if (required_count <= get_maximum_count(m_capacity))
+            return {};
+
+        usize new_capacity = round_up_to_power_of_two(required_count);
+        if (new_capacity < MinimumCapacity)
+            new_capacity = MinimumCapacity;
+        if (required_count > get_maximum_count(new_capacity))
+            new_capacity *= 2;
+
+        TRY(try_rehash(new_capacity));
+        return {};
+    }
+
+    ALWAYS_INLINE void clear()
+    {
+        if (m_count == 0)
+            return;
+
+        destroy_entries();
+        set_memory(m_control, HashTableEmptyControl, get_control_byte_count(m_capacity));
+        m_count = 0;
+    }
+
+    ALWAYS_INLINE void clear_and_shrink()
+    {
+        destroy_entries();
+        release_memory(m_slots, m_capacity);
+
+        m_slots = nullptr;
+        m_control = nullptr;
+        m_capacity = 0;
+        m_count = 0;
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_count; }
+    NODISCARD ALWAYS_INLINE usize capacity() const { return m_capacity; }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_count == 0; }
+    NODISCARD ALWAYS_INLINE Allocator* allocator() const { return m_allocator; }
+
+    NODISCARD ALWAYS_INLINE Iterator begin() { return Iterator(this, 0); }
+    NODISCARD ALWAYS_INLINE Iterator end() { return Iterator(this, m_capacity); }
+
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return ConstIterator(this, 0); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return ConstIterator(this, m_capacity); }
+
+private:
+    static constexpr usize InvalidIndex = static_cast<usize>(-1);
+
+    // The low bits of the hash select the slot where the probing starts, while the top seven bits are stored
+    // in the control byte. Thus, the two values are (mostly) independent.
+    NODISCARD ALWAYS_INLINE static usize get_h1(u64 hash) { return static_cast<usize>(hash); }
+    NODISCARD ALWAYS_INLINE static u8 get_h2(u64 hash) { return static_cast<u8>(hash >> 57); }
+
+    // The maximum load factor is 7/8, which guarantees that every probe sequence reaches an empty slot.
+    NODISCARD ALWAYS_INLINE static constexpr usize get_maximum_count(usize capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    NODISCARD ALWAYS_INLINE static constexpr usize get_control_byte_count(usize capacity)
+    {
+        return capacity + HashTableGroup::Width - 1;
+    }
+
+    NODISCARD ALWAYS_INLINE static constexpr usize get_allocation_byte_count(usize capacity)
+    {
+        return capacity * sizeof(T) + get_control_byte_count(capacity);
+    }
+
+    template<typename Predicate>
+    NODISCARD ALWAYS_INLINE usize find_index(u64 hash, Predicate& predicate) const
+    {
+        if (m_count == 0)
+            return InvalidIndex;
+
+        const usize mask = m_capacity - 1;
+        const u8 h2 = get_h2(hash);
+
+        for (usize offset = get_h1(hash) & mask;; offset = (offset + HashTableGroup::Width) & mask)
+        {
+            const HashTableGroup group = HashTableGroup(m_control + offset);
+            for (u32 matches = group.match(h2); matches != 0; matches &= matches - 1)
+            {
+                const usize index = (offset + count_trailing_zeroes(matches)) & mask;
+                if (predicate(m_slots[index])) [[likely]]
+                    return index;
+            }
+
+            if (group.match_empty() != 0) [[likely]]
+                return InvalidIndex;
+        }
+    }
+
+    NODISCARD ALWAYS_INLINE usize find_empty_index(u64 hash) const
+    {
+        const usize mask = m_capacity - 1;
+        for (usize offset = get_h1(hash) & mask;; offset = (offset + HashTableGroup::Width) & mask)
+        {
+            const u32 empty_slots = HashTableGroup(m_control + offset).match_empty();
+            if (empty_slots != 0) [[likely]]
+                return (offset + count_trailing_zeroes(empty_slots)) & mask;
+        }
+    }
+
+    ALWAYS_INLINE void set_control(usize index, u8 control)
+    {
+        m_control[index] = control;
+        // Keep the cloned control bytes, that follow the last slot, in sync.
+        if (index < HashTableGroup::Width - 1)
+            m_control[m_capacity + index] = control;
+    }
+
+    ALWAYS_INLINE void remove_at_index(usize index)
+    {
+        m_slots[index].~T();
+
+        // Shift the following entries of the probe sequence backwards. An entry can fill the hole only if the hole
+        // is between its home slot and its current slot, otherwise it would become unreachable.
+        const usize mask = m_capacity - 1;
+        usize hole_index = index;
+
+        for (usize next_index = (index + 1) & mask; m_control[next_index] != HashTableEmptyControl;
+             next_index = (next_index + 1) & mask)
+        {
+            const usize home_index = get_h1(EntryTraits::get_hash(m_slots[next_index])) & mask;
+            if (((next_index - home_index) & mask) >= ((next_index - hole_index) & mask))
+            {
+                relocate_entry(&m_slots[hole_index], &m_slots[next_index]);
+                set_control(hole_index, m_control[next_index]);
+                hole_index = next_index;
+            }
+        }
+
+        set_control(hole_index, HashTableEmptyControl);
+        --m_count;
+    }
+
+    ALWAYS_INLINE static void relocate_entry(T* destination, T* source)
+    {
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            copy_memory(destination, source, sizeof(T));
+        }
+        else
+        {
+            new (destination) T(move(*source));
+            source->~T();
+        }
+    }
+
+    ALWAYS_INLINE void destroy_entries()
+    {
+        if constexpr (!IsTriviallyDestructible<T>)
+        {
+            for (usize index = 0; index < m_capacity && m_count > 0; ++index)
+            {
+                if (m_control[index] != HashTableEmptyControl)
+                    m_slots[index].~T();
+            }
+        }
+    }
+
+    ALWAYS_INLINE ErrorOr<void> try_allocate_memory(usize capacity)
+    {
+        TRY_ASSIGN(void* memory_block, try_allocate_from(m_allocator, get_allocation_byte_count(capacity), alignof(T)));
+
+        m_slots = static_cast<T*>(memory_block);
+        m_control = reinterpret_cast<u8*>(m_slots + capacity);
+        m_capacity = capacity;
+        set_memory(m_control, HashTableEmptyControl, get_control_byte_count(capacity));
+        return {};
+    }
+
+    ALWAYS_INLINE void release_memory(T* slots, usize capacity)
+    {
+        if (slots)
+            release_to(m_allocator, slots, get_allocation_byte_count(capacity), alignof(T));
+    }
+
+    ALWAYS_INLINE ErrorOr<void> try_rehash(usize new_capacity)
+    {
+        VERIFY_ALWAYS(is_power_of_two(new_capacity));
+        VERIFY_ALWAYS(get_maximum_count(new_capacity) >= m_count);
+
+        T* old_slots = m_slots;
+        u8* old_control = m_control;
+        const usize old_capacity = m_capacity;
+        TRY(try_allocate_memory(new_capacity));
+
+        for (usize old_index = 0; old_index < old_capacity; ++old_index)
+        {
+            if (old_control[old_index] == HashTableEmptyControl)
+                continue;
+
+            const u64 hash = EntryTraits::get_hash(old_slots[old_index]);
+            const usize index = find_empty_index(hash);
+            set_control(index, get_h2(hash));
+            relocate_entry(&m_slots[index], &old_slots[old_index]);
+        }
+
+        release_memory(old_slots, old_capacity);
+        return {};
+    }
+
+    // NOTE: The table must be empty and have no memory allocated.
+    ALWAYS_INLINE void copy_from(const HashTable& other)
+    {
+        if (other.m_count == 0)
+            return;
+
+        // The entries are copied to the same slots, so the control bytes can be copied in bulk.
+        MUST(try_allocate_memory(other.m_capacity));
+        copy_memory(m_control, other.m_control, get_control_byte_count(m_capacity));
+        for (usize index = 0; index < m_capacity; ++index)
+        {
+            if (m_control[index] != HashTableEmptyControl)
+                new (&m_slots[index]) T(other.m_slots[index]);
+        }
+        m_count = other.m_count;
+    }
+
+private:
+    T* m_slots;
+    u8* m_control;
+    usize m_capacity;
+    usize m_count;
+    Allocator* m_allocator;
+};
+
+} // namespace Detail
+
+} // namespace AT
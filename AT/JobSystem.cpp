@@ -0,0 +1,567 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/JobSystem.h"
+#include "AT/Allocator.h"
+#include "AT/Platform.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+struct alignas(64) Job
+{
+    JobFunction function;
+    JobCounter* counter;
+    // While the job is free, links it to the next free job of the same batch. While the job is queued globally,
+    // links it to the next queued job.
+    u32 next_in_batch;
+    // Only used by the first job of a batch, while the batch is in the global free stack.
+    std::atomic<u32> next_batch;
+    u32 batch_job_count;
+    alignas(JobDataAlignment) u8 data[JobDataByteCount];
+};
+
+static_assert(sizeof(Job) == 128);
+
+constexpr u32 InvalidJobIndex = static_cast<u32>(-1);
+constexpr u32 JobPoolCapacity = 32 * 1024;
+constexpr u32 JobBatchSize = 64;
+
+//
+// The free jobs are kept in batches. Each thread caches a chain of free jobs, so allocating and releasing a job
+// usually doesn't touch any shared memory. A thread takes a whole batch from the global stack when its chain is
+// empty, and gives a batch back when its chain grows too long (which happens to the threads that run more jobs than
+// they schedule). The jobs are never returned to the heap, so a job index stays valid forever, and reading the link
+// of a batch that was already popped by another thread is harmless: the tag of the stack head makes the CAS fail.
+//
+struct JobPool
+{
+    Job* jobs = nullptr;
+    // The tag (incremented by each operation) is stored in the high half, and the index of the first job of the
+    // batch at the top of the stack in the low half.
+    alignas(64) std::atomic<u64> free_batch_stack_head = InvalidJobIndex;
+};
+
+static JobPool s_job_pool;
+
+static void push_free_batch(u32 first_job_index, u32 job_count)
+{
+    Job& first_job = s_job_pool.jobs[first_job_index];
+    first_job.batch_job_count = job_count;
+
+    u64 head = s_job_pool.free_batch_stack_head.load(std::memory_order_relaxed);
+    u64 new_head;
+    do
+    {
+        first_job.next_batch.store(static_cast<u32>(head), std::memory_order_relaxed);
+        new_head = (((head >> 32) + 1) << 32) | first_job_index;
+    } while (!s_job_pool.free_batch_stack_head.compare_exchange_weak(
+        head, new_head, std::memory_order_release, std::memory_order_relaxed
+    ));
+}
+
+static u32 pop_free_batch()
+{
+    u64 head = s_job_pool.free_batch_stack_head.load(std::memory_order_acquire);
+    u64 new_head;
+    do
+    {
+        const u32 first_job_index = static_cast<u32>(head);
+        if (first_job_index == InvalidJobIndex)
+            return InvalidJobIndex;
+        const u32 next_batch = s_job_pool.jobs[first_job_index].next_batch.load(std::memory_order_relaxed);
+        new_head = (((head >> 32) + 1) << 32) | next_batch;
+    } while (!s_job_pool.free_batch_stack_head.compare_exchange_weak(
+        head, new_head, std::memory_order_acquire, std::memory_order_acquire
+    ));
+    return static_cast<u32>(head);
+}
+
+// The chain of free jobs cached by a thread. The chain is given back to the global stack when the thread exits.
+struct LocalJobCache
+{
+    ~LocalJobCache()
+    {
+        if (free_job_count > 0)
+            push_free_batch(first_free_job_index, free_job_count);
+    }
+
+    u32 first_free_job_index = InvalidJobIndex;
+    u32 free_job_count = 0;
+};
+
+static thread_local LocalJobCache s_local_job_cache;
+
+static void initialize_job_pool()
+{
+    if (s_job_pool.jobs != nullptr)
+        return;
+
+    MUST_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(JobPoolCapacity * sizeof(Job), alignof(Job)));
+    s_job_pool.jobs = static_cast<Job*>(memory);
+
+    for (u32 batch_index = JobPoolCapacity / JobBatchSize; batch_index > 0; --batch_index)
+    {
+        const u32 first_job_index = (batch_index - 1) * JobBatchSize;
+        for (u32 job_index = first_job_index; job_index < first_job_index + JobBatchSize; ++job_index)
+        {
+            Job* job = new (&s_job_pool.jobs[job_index]) Job();
+            job->next_in_batch = (job_index + 1 < first_job_index + JobBatchSize) ? job_index + 1 : InvalidJobIndex;
+        }
+        push_free_batch(first_job_index, JobBatchSize);
+    }
+}
+
+static void release_job(Job* job)
+{
+    LocalJobCache& cache = s_local_job_cache;
+    job->next_in_batch = cache.first_free_job_index;
+    cache.first_free_job_index = static_cast<u32>(job - s_job_pool.jobs);
+    ++cache.free_job_count;
+
+    if (cache.free_job_count < 2 * JobBatchSize) [[likely]]
+        return;
+
+    // Keep one batch cached and give the other one back.
+    const u32 batch_first_job_index = cache.first_free_job_index;
+    u32 batch_last_job_index = batch_first_job_index;
+    for (u32 index = 1; index < JobBatchSize; ++index)
+        batch_last_job_index = s_job_pool.jobs[batch_last_job_index].next_in_batch;
+
+    cache.first_free_job_index = s_job_pool.jobs[batch_last_job_index].next_in_batch;
+    cache.free_job_count -= JobBatchSize;
+    s_job_pool.jobs[batch_last_job_index].next_in_batch = InvalidJobIndex;
+    push_free_batch(batch_first_job_index, JobBatchSize);
+}
+
+//
+// The work-stealing deque described by Chase and Lev, with the memory orderings of Lê et al. (2013), "Correct and
+// Efficient Work-Stealing for Weak Memory Models". The owner worker pushes and pops at the bottom, while the other
+// threads steal from the top. The buffer has a fixed capacity. The jobs that don't fit are run by the owner instead.
+//
+// The job pointers are stored with release semantics and loaded by the thieves with acquire semantics (instead of
+// relying only on the fences), which costs nothing on x86-64 and lets the thread sanitizer understand the handoff.
+//
+class JobDeque
+{
+public:
+    static constexpr i64 Capacity = 4096;
+
+    NODISCARD bool try_push(Job* job)
+    {
+        const i64 bottom = m_bottom.load(std::memory_order_relaxed);
+        const i64 top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= Capacity)
+            return false;
+
+        m_buffer[bottom & (Capacity - 1)].store(job, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    NODISCARD Job* pop()
+    {
+        const i64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = m_buffer[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // This is the last job, which a thief might be stealing at the same time.
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Returns nullptr if the deque is empty or if another thread stole the top job first.
+    NODISCARD Job* steal()
+    {
+        i64 top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const i64 bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+
+        Job* job = m_buffer[top & (Capacity - 1)].load(std::memory_order_acquire);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+    NODISCARD bool is_empty() const
+    {
+        const i64 top = m_top.load(std::memory_order_seq_cst);
+        const i64 bottom = m_bottom.load(std::memory_order_seq_cst);
+        return top >= bottom;
+    }
+
+private:
+    alignas(64) std::atomic<i64> m_top = 0;
+    alignas(64) std::atomic<i64> m_bottom = 0;
+    alignas(64) std::atomic<Job*> m_buffer[Capacity] = {};
+};
+
+struct alignas(64) JobWorker
+{
+    JobDeque deque;
+    // Not joinable for the first worker, which is the thread that initialized the job system.
+    std::thread thread;
+};
+
+//
+// The idle workers spin for a while before going to sleep. A worker that goes to sleep announces it (by incrementing
+// the sleeping worker count) and then checks for jobs one last time, while the threads that queue a job check the
+// sleeping worker count after queueing it. Both sides use sequentially consistent operations, so at least one of
+// them observes the other, and a job can't be queued while all workers sleep.
+//
+struct JobSystem
+{
+    JobWorker* workers = nullptr;
+    u32 worker_count = 0;
+
+    // The jobs scheduled by the threads that are not workers, linked through Job::next_in_batch.
+    std::mutex injected_jobs_mutex;
+    u32 first_injected_job_index = InvalidJobIndex;
+    u32 last_injected_job_index = InvalidJobIndex;
+    std::atomic<u32> injected_job_count = 0;
+
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_condition;
+    std::atomic<u32> sleeping_worker_count = 0;
+    // Only incremented while holding the sleep mutex.
+    std::atomic<u64> wake_generation = 0;
+    std::atomic<bool> should_stop = false;
+};
+
+static JobSystem& get_job_system()
+{
+    static JobSystem job_system;
+    return job_system;
+}
+
+static thread_local u32 s_current_worker_index = InvalidJobWorkerIndex;
+static thread_local u32 s_steal_random_state = 0;
+
+constexpr u32 IdleSpinCount = 64;
+
+static void wake_one_worker(JobSystem& job_system)
+{
+    {
+        std::scoped_lock lock(job_system.sleep_mutex);
+        job_system.wake_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    job_system.sleep_condition.notify_one();
+}
+
+static void wake_worker_if_sleeping(JobSystem& job_system)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (job_system.sleeping_worker_count.load(std::memory_order_relaxed) > 0)
+        wake_one_worker(job_system);
+}
+
+static void inject_job(JobSystem& job_system, Job* job)
+{
+    const u32 job_index = static_cast<u32>(job - s_job_pool.jobs);
+    job->next_in_batch = InvalidJobIndex;
+
+    std::scoped_lock lock(job_system.injected_jobs_mutex);
+    if (job_system.last_injected_job_index == InvalidJobIndex)
+        job_system.first_injected_job_index = job_index;
+    else
+        s_job_pool.jobs[job_system.last_injected_job_index].next_in_batch = job_index;
+    job_system.last_injected_job_index = job_index;
+    job_system.injected_job_count.fetch_add(1, std::memory_order_seq_cst);
+}
+
+static Job* try_pop_injected_job(JobSystem& job_system)
+{
+    if (job_system.injected_job_count.load(std::memory_order_relaxed) == 0)
+        return nullptr;
+
+    std::scoped_lock lock(job_system.injected_jobs_mutex);
+    const u32 job_index = job_system.first_injected_job_index;
+    if (job_index == InvalidJobIndex)
+        return nullptr;
+
+    Job* job = &s_job_pool.jobs[job_index];
+    job_system.first_injected_job_index = job->next_in_batch;
+    if (job_system.first_injected_job_index == InvalidJobIndex)
+        job_system.last_injected_job_index = InvalidJobIndex;
+    job_system.injected_job_count.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+// Tries every other worker once, starting with a random one, so the thieves don't all target the same victim.
+static Job* try_steal_job(JobSystem& job_system, u32 thief_index)
+{
+    u32 random_state = s_steal_random_state;
+    if (random_state == 0)
+        random_state = ((thief_index + 1) * 0x9E3779B9u) | 1;
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    s_steal_random_state = random_state;
+
+    const u32 first_victim_index = random_state % job_system.worker_count;
+    for (u32 offset = 0; offset < job_system.worker_count; ++offset)
+    {
+        u32 victim_index = first_victim_index + offset;
+        if (victim_index >= job_system.worker_count)
+            victim_index -= job_system.worker_count;
+        if (victim_index == thief_index)
+            continue;
+
+        if (Job* job = job_system.workers[victim_index].deque.steal())
+            return job;
+    }
+    return nullptr;
+}
+
+static Job* try_find_job(JobSystem& job_system, u32 worker_index)
+{
+    if (worker_index != InvalidJobWorkerIndex)
+    {
+        if (Job* job = job_system.workers[worker_index].deque.pop())
+            return job;
+    }
+
+    if (Job* job = try_steal_job(job_system, worker_index))
+    {
+        // There might be more jobs to steal, so let another worker help.
+        if (job_system.sleeping_worker_count.load(std::memory_order_relaxed) > 0)
+            wake_one_worker(job_system);
+        return job;
+    }
+
+    return try_pop_injected_job(job_system);
+}
+
+static bool has_pending_jobs(const JobSystem& job_system)
+{
+    if (job_system.injected_job_count.load(std::memory_order_seq_cst) > 0)
+        return true;
+    for (u32 worker_index = 0; worker_index < job_system.worker_count; ++worker_index)
+    {
+        if (!job_system.workers[worker_index].deque.is_empty())
+            return true;
+    }
+    return false;
+}
+
+static void run_job(Job* job)
+{
+    JobCounter* counter = job->counter;
+    job->function(job->data);
+    release_job(job);
+    if (counter != nullptr)
+        counter->decrement();
+}
+
+static void sleep_until_woken(JobSystem& job_system)
+{
+    const u64 wake_generation = job_system.wake_generation.load(std::memory_order_relaxed);
+    job_system.sleeping_worker_count.fetch_add(1, std::memory_order_seq_cst);
+
+    if (!has_pending_jobs(job_system))
+    {
+        std::unique_lock lock(job_system.sleep_mutex);
+        job_system.sleep_condition.wait(
+            lock,
+            [&job_system, wake_generation]
+            {
+                return job_system.wake_generation.load(std::memory_order_relaxed) != wake_generation ||
+                       job_system.should_stop.load(std::memory_order_relaxed);
+            }
+        );
+    }
+
+    job_system.sleeping_worker_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void run_worker(u32 worker_index, bool should_pin)
+{
+    if (should_pin)
+        set_current_thread_affinity(worker_index);
+    s_current_worker_index = worker_index;
+
+    JobSystem& job_system = get_job_system();
+    u32 idle_spin_count = 0;
+    while (!job_system.should_stop.load(std::memory_order_acquire))
+    {
+        if (Job* job = try_find_job(job_system, worker_index))
+        {
+            run_job(job);
+            idle_spin_count = 0;
+            continue;
+        }
+
+        if (++idle_spin_count < IdleSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        sleep_until_woken(job_system);
+        idle_spin_count = 0;
+    }
+
+    s_current_worker_index = InvalidJobWorkerIndex;
+}
+
+Job* try_allocate_job(JobFunction function, JobCounter* counter)
+{
+    LocalJobCache& cache = s_local_job_cache;
+    if (cache.free_job_count == 0) [[unlikely]]
+    {
+        const u32 first_job_index = pop_free_batch();
+        if (first_job_index == InvalidJobIndex)
+            return nullptr;
+        cache.first_free_job_index = first_job_index;
+        cache.free_job_count = s_job_pool.jobs[first_job_index].batch_job_count;
+    }
+
+    Job* job = &s_job_pool.jobs[cache.first_free_job_index];
+    cache.first_free_job_index = job->next_in_batch;
+    --cache.free_job_count;
+
+    job->function = function;
+    job->counter = counter;
+    if (counter != nullptr)
+        counter->increment();
+    return job;
+}
+
+void* get_job_data(Job* job)
+{
+    return job->data;
+}
+
+void submit_job(Job* job)
+{
+    JobSystem& job_system = get_job_system();
+    const u32 worker_index = s_current_worker_index;
+
+    if (worker_index == InvalidJobWorkerIndex)
+        inject_job(job_system, job);
+    else if (!job_system.workers[worker_index].deque.try_push(job)) [[unlikely]]
+    {
+        run_job(job);
+        return;
+    }
+
+    wake_worker_if_sleeping(job_system);
+}
+
+} // namespace Detail
+
+void initialize_job_system(u32 worker_count)
+{
+    Detail::JobSystem& job_system = Detail::get_job_system();
+    VERIFY_ALWAYS(job_system.worker_count == 0);
+
+    const u32 core_count = get_logical_core_count();
+    if (worker_count == 0)
+        worker_count = core_count;
+
+    Detail::initialize_job_pool();
+
+    MUST_ASSIGN(
+        void* memory,
+        HeapAllocator::try_allocate_from_heap(worker_count * sizeof(Detail::JobWorker), alignof(Detail::JobWorker))
+    );
+    job_system.workers = static_cast<Detail::JobWorker*>(memory);
+    for (u32 worker_index = 0; worker_index < worker_count; ++worker_index)
+        new (&job_system.workers[worker_index]) Detail::JobWorker();
+
+    job_system.worker_count = worker_count;
+    job_system.should_stop.store(false, std::memory_order_relaxed);
+    Detail::s_current_worker_index = 0;
+
+    // Pinning more workers than cores would stack several workers on the same core, so they are left unpinned.
+    const bool should_pin = worker_count <= core_count;
+    for (u32 worker_index = 1; worker_index < worker_count; ++worker_index)
+        job_system.workers[worker_index].thread = std::thread(Detail::run_worker, worker_index, should_pin);
+}
+
+void shutdown_job_system()
+{
+    Detail::JobSystem& job_system = Detail::get_job_system();
+    VERIFY_ALWAYS(Detail::s_current_worker_index == 0);
+
+    {
+        std::scoped_lock lock(job_system.sleep_mutex);
+        job_system.should_stop.store(true, std::memory_order_release);
+    }
+    job_system.sleep_condition.notify_all();
+
+    for (u32 worker_index = 1; worker_index < job_system.worker_count; ++worker_index)
+        job_system.workers[worker_index].thread.join();
+
+    for (u32 worker_index = 0; worker_index < job_system.worker_count; ++worker_index)
+    {
+        VERIFY_ALWAYS(job_system.workers[worker_index].deque.is_empty());
+        job_system.workers[worker_index].~JobWorker();
+    }
+    VERIFY_ALWAYS(job_system.injected_job_count.load(std::memory_order_relaxed) == 0);
+
+    HeapAllocator::release_to_heap(
+        job_system.workers, job_system.worker_count * sizeof(Detail::JobWorker), alignof(Detail::JobWorker)
+    );
+    job_system.workers = nullptr;
+    job_system.worker_count = 0;
+    Detail::s_current_worker_index = InvalidJobWorkerIndex;
+}
+
+u32 get_job_worker_count()
+{
+    return Detail::get_job_system().worker_count;
+}
+
+u32 get_current_job_worker_index()
+{
+    return Detail::s_current_worker_index;
+}
+
+void schedule_job(JobFunction function, void* data, JobCounter* counter)
+{
+    schedule_job([function, data] { function(data); }, counter);
+}
+
+void wait_for_counter(const JobCounter& counter)
+{
+    Detail::JobSystem& job_system = Detail::get_job_system();
+    const u32 worker_index = Detail::s_current_worker_index;
+
+    while (!counter.is_zero())
+    {
+        if (Detail::Job* job = Detail::try_find_job(job_system, worker_index))
+            Detail::run_job(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+} // namespace AT
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Assertions.h"
+#include "AT/CoreTypes.h"
+
+#include <atomic>
+#include <new>
+
+namespace AT
+{
+
+//
+// The job system runs small units of work (jobs) on a fixed pool of worker threads, one per logical core. The thread
+// that initializes the job system is a worker too, so the pool has one thread less than the number of cores, and the
+// other threads are pinned to the remaining cores. Each worker pushes the jobs it schedules to its own work-stealing
+// deque, from which the idle workers steal. The jobs scheduled by threads that are not workers are queued globally.
+//
+// The job system must be initialized before scheduling any job, and shut down once all jobs have completed.
+//
+// Passing a zero worker count creates one worker per logical core.
+AT_API void initialize_job_system(u32 worker_count = 0);
+AT_API void shutdown_job_system();
+
+// Includes the thread that initialized the job system.
+NODISCARD AT_API u32 get_job_worker_count();
+// Returns the index of the calling worker, or InvalidJobWorkerIndex if the calling thread is not a worker.
+NODISCARD AT_API u32 get_current_job_worker_index();
+
+constexpr u32 InvalidJobWorkerIndex = static_cast<u32>(-1);
+
+///
+/// Counts the jobs that haven't completed yet. A job that is scheduled with a counter increments it when it is
+/// scheduled and decrements it when it completes, so a counter can track any number of jobs (see wait_for_counter).
+///
+class JobCounter
+{
+    AT_MAKE_NONCOPYABLE(JobCounter);
+    AT_MAKE_NONMOVABLE(JobCounter);
+
+public:
+    JobCounter() = default;
+
+    NODISCARD ALWAYS_INLINE u32 value() const { return m_value.load(std::memory_order_acquire); }
+    NODISCARD ALWAYS_INLINE bool is_zero() const { return value() == 0; }
+
+    ALWAYS_INLINE void increment(u32 count = 1) { m_value.fetch_add(count, std::memory_order_relaxed); }
+    // The release semantics make the effects of the job visible to the thread that observes the counter reaching zero.
+    ALWAYS_INLINE void decrement() { m_value.fetch_sub(1, std::memory_order_release); }
+
+private:
+    std::atomic<u32> m_value = 0;
+};
+
+using JobFunction = void (*)(void* data);
+
+namespace Detail
+{
+
+// The jobs are 128 bytes long, most of which store the data of the job, so that scheduling a lambda that captures a
+// few values doesn't allocate any memory.
+constexpr usize JobDataByteCount = 96;
+constexpr usize JobDataAlignment = 16;
+
+struct Job;
+
+// Returns nullptr if the job pool is exhausted, in which case the job should be run immediately.
+NODISCARD AT_API Job* try_allocate_job(JobFunction function, JobCounter* counter);
+NODISCARD AT_API void* get_job_data(Job* job);
+AT_API void submit_job(Job* job);
+
+} // namespace Detail
+
+//
+// Schedules the function to be called with the given data on any worker. The data must stay alive until the job
+// completes. If the job pool is exhausted, the function is called before returning.
+//
+AT_API void schedule_job(JobFunction function, void* data, JobCounter* counter = nullptr);
+
+// Schedules a job that calls the callable, which is moved into the job (so it must not be larger than the job data).
+template<typename Callable>
+ALWAYS_INLINE inline void schedule_job(Callable&& callable, JobCounter* counter = nullptr)
+{
+    using CallableType = RemoveCVR<Callable>;
+    static_assert(sizeof(CallableType) <= Detail::JobDataByteCount, "The callable is too large to be stored in a job");
+    static_assert(alignof(CallableType) <= Detail::JobDataAlignment, "The callable is over-aligned");
+
+    const JobFunction trampoline = [](void* data)
+    {
+        CallableType& stored_callable = *static_cast<CallableType*>(data);
+        stored_callable();
+        stored_callable.~CallableType();
+    };
+
+    Detail::Job* job = Detail::try_allocate_job(trampoline, counter);
+    if (!job)
+    {
+        callable();
+        return;
+    }
+
+    new (Detail::get_job_data(job)) CallableType(forward<Callable>(callable));
+    Detail::submit_job(job);
+}
+
+//
+// Runs other jobs on the calling thread until the counter reaches zero, so waiting never blocks a worker (and the
+// jobs that the counter tracks can't be starved by the waiting threads). Can also be called by the threads that are
+// not workers, which only run the jobs that they steal.
+//
+AT_API void wait_for_counter(const JobCounter& counter);
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::get_current_job_worker_index;
+using AT::get_job_worker_count;
+using AT::initialize_job_system;
+using AT::JobCounter;
+using AT::JobFunction;
+using AT::schedule_job;
+using AT::shutdown_job_system;
+using AT::wait_for_counter;
+#endif // AT_INCLUDE_GLOBALLY
@@ -4,15 +4,534 @@
  */
 
 #include "AT/Log.h"
+#include "AT/Allocator.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
 
 namespace AT
 {
 
+namespace Detail
+{
+
+struct LogEntryHeader
+{
+    // Includes the header and the padding that aligns the next entry.
+    u32 byte_count;
+    // The entries written only to skip the end of the ring buffer (when an entry doesn't fit before the end) don't
+    // have a format function.
+    LogEntryFormatFunction format_function;
+};
+
+//
+// A single-producer, single-consumer ring buffer of variable-size entries. The producer is the thread that owns the
+// ring and the consumer is the thread that writes the log (while holding the drain mutex). The positions increase
+// monotonically and an entry is never split across the end of the buffer.
+//
+struct LogRing
+{
+    AT_MAKE_NONCOPYABLE(LogRing);
+    AT_MAKE_NONMOVABLE(LogRing);
+
+    static constexpr usize Capacity = 256 * 1024;
+    static constexpr usize EntryAlignment = 16;
+
+    LogRing() = default;
+
+    alignas(64) u8 buffer[Capacity];
+
+    // Only written by the producer. The pending write position is the end of the reserved (but not yet committed)
+    // entry, and the cached read position avoids loading the read position for each entry.
+    alignas(64) std::atomic<u64> write_position = 0;
+    u64 pending_write_position = 0;
+    u64 cached_read_position = 0;
+
+    // Only written by the consumer, except for the counter of discarded messages.
+    alignas(64) std::atomic<u64> read_position = 0;
+    std::atomic<u64> discarded_message_count = 0;
+    // Set when the producer thread exits. The consumer releases the ring once it is empty.
+    std::atomic<bool> is_abandoned = false;
+};
+
+static_assert(sizeof(LogEntryHeader) <= LogRing::EntryAlignment);
+static_assert(MaxLogEntryPayloadByteCount + LogRing::EntryAlignment <= LogRing::Capacity / 4);
+
+struct ThreadLogState
+{
+    LogRing* ring;
+    // While the thread writes the log, the messages it logs are written directly, so that a message logged by a
+    // formatter (for example, by a failed verification) can't block the writer. The same happens after the thread
+    // released its ring, while its thread-local objects are destroyed.
+    bool is_writing_log;
+    bool has_released_ring;
+    u8* direct_entry_payload;
+    LogEntryFormatFunction direct_entry_format_function;
+};
+
+// Trivially constructible and destructible, so accessing it doesn't go through the thread-local initialization guard.
+static thread_local ThreadLogState s_thread_log_state;
+
+// Marks the ring of the thread as abandoned when the thread exits.
+struct ThreadLogRingOwner
+{
+    ~ThreadLogRingOwner()
+    {
+        s_thread_log_state.ring = nullptr;
+        s_thread_log_state.has_released_ring = true;
+        if (ring != nullptr)
+            ring->is_abandoned.store(true, std::memory_order_release);
+    }
+
+    LogRing* ring = nullptr;
+};
+
+static std::atomic<LogBackpressurePolicy> s_backpressure_policy = LogBackpressurePolicy::Block;
+
+static void write_to_output(const char* characters, usize byte_count)
+{
+    fwrite(characters, 1, byte_count, stdout);
+    fflush(stdout);
+}
+
+//
+// The messages are formatted into a batch buffer, which is written to the output with a single call once all rings
+// are drained (or once it is full). The batch, as well as the read side of all rings, is owned by the thread that
+// holds the drain mutex, which is usually the background writer thread.
+//
+class Logger
+{
+    AT_MAKE_NONCOPYABLE(Logger);
+    AT_MAKE_NONMOVABLE(Logger);
+
+public:
+    static constexpr usize BatchCapacity = 64 * 1024;
+
+    //
+    // While messages are being logged, the writer thread polls the rings periodically, so the logging threads don't
+    // have to wake it up (which requires a system call). After polling without finding any message for a while, the
+    // writer thread waits until the next logged message wakes it up.
+    //
+    static constexpr std::chrono::milliseconds PollInterval = std::chrono::milliseconds(1);
+    static constexpr u32 IdlePollCountBeforeSleeping = 100;
+
+public:
+    Logger() = default;
+
+    NODISCARD LogRing* register_thread_ring();
+
+    // Returns true if any message was written.
+    bool drain_rings_while_holding_drain_mutex();
+
+    ALWAYS_INLINE void wake_writer_thread_if_sleeping()
+    {
+        if (m_is_writer_thread_sleeping.load(std::memory_order_seq_cst))
+        {
+            if (m_is_writer_thread_sleeping.exchange(false, std::memory_order_seq_cst))
+            {
+                // Acquiring the mutex ensures that the writer thread is either waiting or hasn't checked the flag yet.
+                {
+                    std::scoped_lock lock(m_sleep_mutex);
+                }
+                m_wake_condition.notify_one();
+            }
+        }
+    }
+
+    void run_writer_thread();
+
+    // Writes the messages that are already formatted in the batch.
+    void write_batch();
+
+public:
+    std::mutex drain_mutex;
+
+private:
+    void append_entry_to_batch(LogEntryFormatFunction format_function, const u8* payload);
+    NODISCARD bool has_pending_entries();
+
+private:
+    std::mutex m_ring_list_mutex;
+    Vector<LogRing*> m_rings;
+
+    std::atomic<bool> m_is_writer_thread_sleeping = false;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake_condition;
+
+    char m_batch[BatchCapacity];
+    usize m_batch_byte_count = 0;
+};
+
+static Logger* create_logger();
+
+// The payload is the number of discarded messages.
+static void format_discarded_messages_entry(FormatBuilder& builder, const u8* payload)
+{
+    builder.push_string("["sv);
+    builder.push_integer(LogParameter<u64>::decode(payload), IsNegative::No);
+    builder.push_string(" log messages were discarded]"sv);
+}
+
+static Logger& get_logger()
+{
+    // The logger is never destroyed, as messages can be logged by static destructors and by detached threads.
+    static Logger* logger = create_logger();
+    return *logger;
+}
+
+LogRing* Logger::register_thread_ring()
+{
+    MUST_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(sizeof(LogRing), alignof(LogRing)));
+    LogRing* ring = new (memory) LogRing();
+
+    static thread_local ThreadLogRingOwner ring_owner;
+    ring_owner.ring = ring;
+
+    std::scoped_lock lock(m_ring_list_mutex);
+    MUST(m_rings.try_push_back(ring));
+    return ring;
+}
+
+bool Logger::drain_rings_while_holding_drain_mutex()
+{
+    bool has_written_messages = false;
+    std::scoped_lock lock(m_ring_list_mutex);
+
+    for (usize ring_index = 0; ring_index < m_rings.count();)
+    {
+        LogRing* ring = m_rings[ring_index];
+
+        const u64 discarded_message_count = ring->discarded_message_count.exchange(0, std::memory_order_relaxed);
+        if (discarded_message_count > 0)
+        {
+            append_entry_to_batch(
+                format_discarded_messages_entry, reinterpret_cast<const u8*>(&discarded_message_count)
+            );
+            has_written_messages = true;
+        }
+
+        // The abandoned flag is loaded first, so that all the entries written before the thread exited are visible.
+        const bool is_abandoned = ring->is_abandoned.load(std::memory_order_acquire);
+        u64 read_position = ring->read_position.load(std::memory_order_relaxed);
+        const u64 write_position = ring->write_position.load(std::memory_order_acquire);
+
+        while (read_position < write_position)
+        {
+            LogEntryHeader header;
+            std::memcpy(&header, ring->buffer + (read_position & (LogRing::Capacity - 1)), sizeof(header));
+            if (header.format_function != nullptr)
+            {
+                const u8* payload = ring->buffer + (read_position & (LogRing::Capacity - 1)) + LogRing::EntryAlignment;
+                append_entry_to_batch(header.format_function, payload);
+                has_written_messages = true;
+            }
+
+            // The space is released after each entry, so that the blocked producers can continue sooner.
+            read_position += header.byte_count;
+            ring->read_position.store(read_position, std::memory_order_release);
+        }
+
+        if (is_abandoned)
+        {
+            ring->~LogRing();
+            HeapAllocator::release_to_heap(ring, sizeof(LogRing), alignof(LogRing));
+            m_rings[ring_index] = m_rings.last();
+            m_rings.pop_back();
+            continue;
+        }
+
+        ++ring_index;
+    }
+
+    write_batch();
+    return has_written_messages;
+}
+
+void Logger::append_entry_to_batch(LogEntryFormatFunction format_function, const u8* payload)
+{
+    if (m_batch_byte_count == BatchCapacity)
+        write_batch();
+
+    // One byte is always reserved for the newline character.
+    FormatBuilder builder = FormatBuilder(m_batch + m_batch_byte_count, BatchCapacity - m_batch_byte_count - 1);
+    format_function(builder, payload);
+
+    if (builder.is_truncated())
+    {
+        write_batch();
+        builder = FormatBuilder(m_batch, BatchCapacity - 1);
+        format_function(builder, payload);
+
+        // The message doesn't fit in the batch, so it is formatted and written separately.
+        if (builder.is_truncated())
+        {
+            StringBuilder string_builder;
+            FormatBuilder string_format_builder = FormatBuilder(string_builder);
+            format_function(string_format_builder, payload);
+            string_builder.append('\n');
+            write_to_output(string_builder.to_view().characters(), string_builder.byte_count());
+            return;
+        }
+    }
+
+    m_batch_byte_count += builder.byte_count();
+    m_batch[m_batch_byte_count++] = '\n';
+}
+
+void Logger::write_batch()
+{
+    if (m_batch_byte_count == 0)
+        return;
+    write_to_output(m_batch, m_batch_byte_count);
+    m_batch_byte_count = 0;
+}
+
+bool Logger::has_pending_entries()
+{
+    std::scoped_lock lock(m_ring_list_mutex);
+    for (const LogRing* ring : m_rings)
+    {
+        if (ring->read_position.load(std::memory_order_relaxed) != ring->write_position.load(std::memory_order_seq_cst))
+            return true;
+        if (ring->discarded_message_count.load(std::memory_order_relaxed) > 0)
+            return true;
+        if (ring->is_abandoned.load(std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void Logger::run_writer_thread()
+{
+    s_thread_log_state.is_writing_log = true;
+
+    u32 idle_poll_count = 0;
+    while (true)
+    {
+        bool has_written_messages;
+        {
+            std::scoped_lock lock(drain_mutex);
+            has_written_messages = drain_rings_while_holding_drain_mutex();
+        }
+
+        idle_poll_count = has_written_messages ? 0 : idle_poll_count + 1;
+        if (idle_poll_count < IdlePollCountBeforeSleeping)
+        {
+            std::this_thread::sleep_for(PollInterval);
+            continue;
+        }
+
+        // The flag is set before checking the rings one last time, and the producers check the flag after publishing
+        // their entries (both with sequentially consistent operations), so no entry can be missed.
+        m_is_writer_thread_sleeping.store(true, std::memory_order_seq_cst);
+        if (has_pending_entries())
+        {
+            m_is_writer_thread_sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock lock(m_sleep_mutex);
+        m_wake_condition.wait(lock, [this] { return !m_is_writer_thread_sleeping.load(std::memory_order_seq_cst); });
+        idle_poll_count = 0;
+    }
+}
+
+//
+// Drains the rings from the calling thread. If the drain mutex can't be acquired within the timeout (because the
+// thread that holds it was terminated, or is the calling thread), only the standard output is flushed.
+//
+static void flush_log_with_timeout()
+{
+    if (s_thread_log_state.is_writing_log)
+    {
+        fflush(stdout);
+        return;
+    }
+
+    Logger& logger = get_logger();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!logger.drain_mutex.try_lock())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            fflush(stdout);
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    s_thread_log_state.is_writing_log = true;
+    logger.drain_rings_while_holding_drain_mutex();
+    s_thread_log_state.is_writing_log = false;
+    logger.drain_mutex.unlock();
+}
+
+static Logger* create_logger()
+{
+    MUST_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(sizeof(Logger), alignof(Logger)));
+    Logger* logger = new (memory) Logger();
+
+    std::thread([logger] { logger->run_writer_thread(); }).detach();
+    // The writer thread might be terminated before the exit handlers run, so the rings are drained by the exiting
+    // thread itself.
+    std::atexit(flush_log_with_timeout);
+    return logger;
+}
+
+static void write_entry_directly(LogEntryFormatFunction format_function, const u8* payload)
+{
+    StringBuilder string_builder;
+    FormatBuilder builder = FormatBuilder(string_builder);
+    format_function(builder, payload);
+    string_builder.append('\n');
+    write_to_output(string_builder.to_view().characters(), string_builder.byte_count());
+}
+
+NODISCARD static u8* reserve_direct_log_entry(LogEntryFormatFunction format_function)
+{
+    ThreadLogState& state = s_thread_log_state;
+    // Only the threads that write the log (or that log while they exit) use this buffer, so it is never released.
+    if (state.direct_entry_payload == nullptr)
+    {
+        MUST_ASSIGN(void* payload, HeapAllocator::try_allocate_from_heap(MaxLogEntryPayloadByteCount, alignof(u64)));
+        state.direct_entry_payload = static_cast<u8*>(payload);
+    }
+    state.direct_entry_format_function = format_function;
+    return state.direct_entry_payload;
+}
+
+// Waits (or gives up, depending on the policy) until the ring has room for the given number of bytes.
+NODISCARD static bool wait_for_ring_space(LogRing* ring, u64 required_write_position)
+{
+    while (required_write_position - ring->cached_read_position > LogRing::Capacity)
+    {
+        ring->cached_read_position = ring->read_position.load(std::memory_order_acquire);
+        if (required_write_position - ring->cached_read_position <= LogRing::Capacity)
+            break;
+
+        if (s_backpressure_policy.load(std::memory_order_relaxed) == LogBackpressurePolicy::Drop)
+        {
+            ring->discarded_message_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Instead of waiting for the writer thread to poll the rings, the thread writes the pending messages itself.
+        Logger& logger = get_logger();
+        if (logger.drain_mutex.try_lock())
+        {
+            s_thread_log_state.is_writing_log = true;
+            logger.drain_rings_while_holding_drain_mutex();
+            s_thread_log_state.is_writing_log = false;
+            logger.drain_mutex.unlock();
+            continue;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+u8* reserve_log_entry(usize payload_byte_count, LogEntryFormatFunction format_function)
+{
+    ThreadLogState& state = s_thread_log_state;
+    if (state.ring == nullptr || state.is_writing_log) [[unlikely]]
+    {
+        if (state.is_writing_log || state.has_released_ring)
+            return reserve_direct_log_entry(format_function);
+        state.ring = get_logger().register_thread_ring();
+    }
+
+    LogRing* ring = state.ring;
+    const usize entry_byte_count =
+        (LogRing::EntryAlignment + payload_byte_count + LogRing::EntryAlignment - 1) & ~(LogRing::EntryAlignment - 1);
+
+    u64 entry_position = ring->write_position.load(std::memory_order_relaxed);
+    const usize byte_count_until_end = LogRing::Capacity - (entry_position & (LogRing::Capacity - 1));
+    const usize skipped_byte_count = entry_byte_count > byte_count_until_end ? byte_count_until_end : 0;
+
+    if (!wait_for_ring_space(ring, entry_position + skipped_byte_count + entry_byte_count)) [[unlikely]]
+        return nullptr;
+
+    if (skipped_byte_count > 0)
+    {
+        const LogEntryHeader skip_header = { static_cast<u32>(skipped_byte_count), nullptr };
+        std::memcpy(ring->buffer + (entry_position & (LogRing::Capacity - 1)), &skip_header, sizeof(skip_header));
+        entry_position += skipped_byte_count;
+    }
+
+    u8* entry = ring->buffer + (entry_position & (LogRing::Capacity - 1));
+    const LogEntryHeader header = { static_cast<u32>(entry_byte_count), format_function };
+    std::memcpy(entry, &header, sizeof(header));
+    ring->pending_write_position = entry_position + entry_byte_count;
+    return entry + LogRing::EntryAlignment;
+}
+
+void commit_log_entry()
+{
+    ThreadLogState& state = s_thread_log_state;
+    if (state.ring == nullptr || state.is_writing_log) [[unlikely]]
+    {
+        write_entry_directly(state.direct_entry_format_function, state.direct_entry_payload);
+        return;
+    }
+
+    state.ring->write_position.store(state.ring->pending_write_position, std::memory_order_seq_cst);
+    get_logger().wake_writer_thread_if_sleeping();
+}
+
+void format_preformatted_log_entry(FormatBuilder& builder, const u8* payload)
+{
+    builder.push_string(LogParameter<StringView>::decode(payload));
+}
+
+void flush_log_after_failure()
+{
+    flush_log_with_timeout();
+}
+
+} // namespace Detail
+
+void set_log_backpressure_policy(LogBackpressurePolicy policy)
+{
+    Detail::s_backpressure_policy.store(policy, std::memory_order_relaxed);
+}
+
+void flush_log()
+{
+    if (Detail::s_thread_log_state.is_writing_log)
+    {
+        fflush(stdout);
+        return;
+    }
+
+    Detail::Logger& logger = Detail::get_logger();
+    std::scoped_lock lock(logger.drain_mutex);
+    Detail::s_thread_log_state.is_writing_log = true;
+    logger.drain_rings_while_holding_drain_mutex();
+    Detail::s_thread_log_state.is_writing_log = false;
+}
+
 void dbgln(StringView message)
 {
-    const String log_line = format("{}\n"sv, message);
-    printf("%s", log_line.characters());
+    // Messages that are too large are truncated, without splitting a code point.
+    usize byte_count = message.byte_count();
+    if (byte_count > Detail::MaxLogEntryPayloadByteCount - sizeof(usize))
+        byte_count = Detail::MaxLogEntryPayloadByteCount - sizeof(usize);
+
+    u8* payload = Detail::reserve_log_entry(sizeof(usize) + byte_count, Detail::format_preformatted_log_entry);
+    if (payload == nullptr)
+        return;
+
+    FormatBuilder builder = FormatBuilder(reinterpret_cast<char*>(payload + sizeof(usize)), byte_count);
+    builder.push_string(message);
+    const usize written_byte_count = builder.written_byte_count();
+    std::memcpy(payload, &written_byte_count, sizeof(usize));
+    Detail::commit_log_entry();
 }
 
 } // namespace AT
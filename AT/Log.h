@@ -7,20 +7,216 @@
 
 #include "AT/Format.h"
 
+#include <cstring>
+
 namespace AT
 {
 
+//
+// Logging is asynchronous: the logging thread only copies the format string and the parameters into a ring
+// buffer that it owns, and a background thread formats and writes the messages. The messages logged by a thread
+// are written in the order they were logged, but the messages logged by different threads might be reordered.
+//
+
+// What happens when a thread logs a message and its ring buffer is full.
+enum class LogBackpressurePolicy : u8
+{
+    // The thread writes the pending messages itself (or waits for the thread that is writing them) to make room for
+    // the message. This is the default.
+    Block = 0,
+    // The message is discarded. The number of discarded messages is reported once there is room again.
+    Drop = 1,
+};
+
+AT_API void set_log_backpressure_policy(LogBackpressurePolicy policy);
+
+// Blocks until all messages logged before the call (by any thread) are written.
+AT_API void flush_log();
+
 AT_API void dbgln(StringView message);
 
-template<typename... Args>
-inline void dbgln(StringView message, Args&&... args)
+namespace Detail
+{
+
+// Formats the message of a log entry, from the payload that was written when the message was logged.
+using LogEntryFormatFunction = void (*)(FormatBuilder& builder, const u8* payload);
+
+// Larger messages are formatted when they are logged and truncated to this size.
+constexpr usize MaxLogEntryPayloadByteCount = 16 * 1024 - 16;
+
+//
+// Reserves space for an entry in the ring buffer of the calling thread. The entry is not visible to the background
+// thread until it is committed. Returns nullptr if the message is discarded, in which case nothing must be committed.
+//
+NODISCARD AT_API u8* reserve_log_entry(usize payload_byte_count, LogEntryFormatFunction format_function);
+AT_API void commit_log_entry();
+
+// Formats an entry whose payload is a message that was formatted when it was logged.
+AT_API void format_preformatted_log_entry(FormatBuilder& builder, const u8* payload);
+
+// Writes the pending messages when the program is about to terminate, without waiting indefinitely if the logger
+// is in an inconsistent state (for example, if the verification failed on the background thread).
+AT_API void flush_log_after_failure();
+
+//
+// How a log parameter is stored in the payload of a log entry. The entries are packed, so the parameters are
+// always copied to and from the payload byte-wise. The messages that have parameters which are not deferrable
+// are formatted when they are logged.
+//
+template<typename T>
+struct LogParameter
+{
+    static constexpr bool IsDeferrable = IsInteger<T> || IsFloatingPoint<T>;
+    using DecodedType = T;
+
+    NODISCARD ALWAYS_INLINE static usize get_encoded_byte_count(const T&) { return sizeof(T); }
+
+    ALWAYS_INLINE static u8* encode(u8* destination, const T& value)
+    {
+        std::memcpy(destination, &value, sizeof(T));
+        return destination + sizeof(T);
+    }
+
+    NODISCARD ALWAYS_INLINE static T decode(const u8*& source)
+    {
+        T value;
+        std::memcpy(&value, source, sizeof(T));
+        source += sizeof(T);
+        return value;
+    }
+};
+
+// Strings are stored as their byte count followed by their characters, and decoded as views into the payload.
+template<>
+struct LogParameter<StringView>
+{
+    static constexpr bool IsDeferrable = true;
+    using DecodedType = StringView;
+
+    NODISCARD ALWAYS_INLINE static usize get_encoded_byte_count(const StringView& value)
+    {
+        return sizeof(usize) + value.byte_count();
+    }
+
+    ALWAYS_INLINE static u8* encode(u8* destination, const StringView& value)
+    {
+        const usize byte_count = value.byte_count();
+        std::memcpy(destination, &byte_count, sizeof(usize));
+        copy_memory(destination + sizeof(usize), value.characters(), byte_count);
+        return destination + sizeof(usize) + byte_count;
+    }
+
+    NODISCARD ALWAYS_INLINE static StringView decode(const u8*& source)
+    {
+        usize byte_count;
+        std::memcpy(&byte_count, source, sizeof(usize));
+        const char* characters = reinterpret_cast<const char*>(source + sizeof(usize));
+        const StringView value = StringView::from_utf8(characters, byte_count);
+        source += sizeof(usize) + byte_count;
+        return value;
+    }
+};
+
+template<>
+struct LogParameter<String> : public LogParameter<StringView>
+{
+    NODISCARD ALWAYS_INLINE static usize get_encoded_byte_count(const String& value)
+    {
+        return LogParameter<StringView>::get_encoded_byte_count(value.to_view());
+    }
+
+    ALWAYS_INLINE static u8* encode(u8* destination, const String& value)
+    {
+        return LogParameter<StringView>::encode(destination, value.to_view());
+    }
+};
+
+//
+// The payload of a deferred entry is the parsed format string followed by the encoded parameters. The literals of
+// the format string are views into the string literal, which lives for the whole program.
+//
+template<typename... Parameters>
+void format_deferred_log_entry(FormatBuilder& builder, const u8* payload)
+{
+    const auto& format_string = *reinterpret_cast<const FormatString<Parameters...>*>(payload);
+    const u8* encoded_parameters = payload + sizeof(FormatString<Parameters...>);
+
+    const auto push_literal = [&builder](StringView literal)
+    {
+        if (!literal.is_empty())
+            builder.push_string(literal);
+    };
+
+    usize index = 0;
+    (
+        (push_literal(format_string.literal(index)),
+         Formatter<typename LogParameter<Parameters>::DecodedType>::format(
+             builder, format_string.specifier(index), LogParameter<Parameters>::decode(encoded_parameters)
+         ),
+         ++index),
+        ...
+    );
+    push_literal(format_string.literal(index));
+}
+
+template<typename... FormatParameters, typename... Parameters>
+void log_preformatted_message(const FormatString<FormatParameters...>& format_string, const Parameters&... parameters)
+{
+    FormatBuilder counting_builder;
+    format_parameters(counting_builder, format_string, parameters...);
+    usize byte_count = counting_builder.byte_count();
+    if (byte_count > MaxLogEntryPayloadByteCount - sizeof(usize))
+        byte_count = MaxLogEntryPayloadByteCount - sizeof(usize);
+
+    u8* payload = reserve_log_entry(sizeof(usize) + byte_count, format_preformatted_log_entry);
+    if (payload == nullptr)
+        return;
+
+    // The message might be truncated to fewer bytes than reserved, in order to not split a code point.
+    FormatBuilder builder = FormatBuilder(reinterpret_cast<char*>(payload + sizeof(usize)), byte_count);
+    format_parameters(builder, format_string, parameters...);
+    const usize written_byte_count = builder.written_byte_count();
+    std::memcpy(payload, &written_byte_count, sizeof(usize));
+    commit_log_entry();
+}
+
+} // namespace Detail
+
+template<typename... Parameters>
+inline void dbgln(CheckedFormatString<Parameters...> format_string, Parameters&&... parameters)
 {
-    const String formatted_message = format(message, forward<Args>(args)...);
-    dbgln(formatted_message.to_view());
+    if constexpr ((Detail::LogParameter<RemoveCVR<Parameters>>::IsDeferrable && ...))
+    {
+        const usize payload_byte_count =
+            sizeof(format_string) +
+            (Detail::LogParameter<RemoveCVR<Parameters>>::get_encoded_byte_count(parameters) + ... + 0);
+
+        if (payload_byte_count <= Detail::MaxLogEntryPayloadByteCount) [[likely]]
+        {
+            u8* payload = Detail::reserve_log_entry(
+                payload_byte_count, Detail::format_deferred_log_entry<RemoveCVR<Parameters>...>
+            );
+            if (payload == nullptr)
+                return;
+
+            std::memcpy(payload, &format_string, sizeof(format_string));
+            u8* encoded_parameters = payload + sizeof(format_string);
+            ((encoded_parameters =
+                  Detail::LogParameter<RemoveCVR<Parameters>>::encode(encoded_parameters, parameters)),
+             ...);
+            Detail::commit_log_entry();
+            return;
+        }
+    }
+
+    Detail::log_preformatted_message(format_string, parameters...);
 }
 
 } // namespace AT
 
 #if AT_INCLUDE_GLOBALLY
 using AT::dbgln;
+using AT::flush_log;
+using AT::LogBackpressurePolicy;
+using AT::set_log_backpressure_policy;
 #endif // AT_INCLUDE_GLOBALLY
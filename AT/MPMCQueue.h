@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Span.h"
+
+#include <atomic>
+#include <new>
+
+namespace AT
+{
+
+///
+/// Bounded lock-free queue with any number of producer and consumer threads (the queue described by Dmitry Vyukov).
+/// The elements are stored in a ring buffer inside the queue object, so a queue with a large capacity should be
+/// allocated on the heap.
+///
+/// Each cell has a sequence number, which tells the lap of the ring the cell is ready for: a producer can fill the cell
+/// at position P when its sequence is P, and a consumer can empty it when its sequence is P + 1. The threads claim
+/// positions by advancing the shared producer or consumer index with a CAS, so the only contended cache lines are the
+/// two indices and the cells that are accessed at the same time. A batch claims consecutive positions with one CAS.
+///
+template<typename T, usize Capacity>
+class MPMCQueue
+{
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+
+    AT_MAKE_NONCOPYABLE(MPMCQueue);
+    AT_MAKE_NONMOVABLE(MPMCQueue);
+
+public:
+    using ElementType = T;
+
+public:
+    MPMCQueue()
+    {
+        for (usize index = 0; index < Capacity; ++index)
+            m_cells[index].sequence.store(index, std::memory_order_relaxed);
+    }
+
+    ~MPMCQueue()
+    {
+        const usize tail = m_tail.load(std::memory_order_relaxed);
+        for (usize index = m_head.load(std::memory_order_relaxed); index != tail; ++index)
+            cell(index).element()->~T();
+    }
+
+public:
+    // Returns false if the queue is full.
+    template<typename... Args>
+    NODISCARD ALWAYS_INLINE bool try_emplace(Args&&... args)
+    {
+        usize position;
+        if (try_claim_positions(m_tail, 0, 1, position) == 0)
+            return false;
+
+        Cell& claimed_cell = cell(position);
+        new (claimed_cell.element()) T(forward<Args>(args)...);
+        claimed_cell.sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    NODISCARD ALWAYS_INLINE bool try_push(const T& element) { return try_emplace(element); }
+    NODISCARD ALWAYS_INLINE bool try_push(T&& element) { return try_emplace(move(element)); }
+
+    // Moves as many elements as there are consecutive free cells (up to the count of the span) and returns their count.
+    NODISCARD usize try_push_batch(Span<T> elements)
+    {
+        usize position;
+        const usize push_count = try_claim_positions(m_tail, 0, elements.count(), position);
+        for (usize index = 0; index < push_count; ++index)
+        {
+            Cell& claimed_cell = cell(position + index);
+            new (claimed_cell.element()) T(move(elements.unchecked_at(index)));
+            claimed_cell.sequence.store(position + index + 1, std::memory_order_release);
+        }
+        return push_count;
+    }
+
+    // Returns false if the queue is empty.
+    NODISCARD ALWAYS_INLINE bool try_pop(T& out_element)
+    {
+        usize position;
+        if (try_claim_positions(m_head, 1, 1, position) == 0)
+            return false;
+
+        Cell& claimed_cell = cell(position);
+        out_element = move(*claimed_cell.element());
+        claimed_cell.element()->~T();
+        claimed_cell.sequence.store(position + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Moves as many elements as there are consecutive filled cells (up to the count of the span) and returns their
+    // count.
+    NODISCARD usize try_pop_batch(Span<T> out_elements)
+    {
+        usize position;
+        const usize pop_count = try_claim_positions(m_head, 1, out_elements.count(), position);
+        for (usize index = 0; index < pop_count; ++index)
+        {
+            Cell& claimed_cell = cell(position + index);
+            out_elements.unchecked_at(index) = move(*claimed_cell.element());
+            claimed_cell.element()->~T();
+            claimed_cell.sequence.store(position + index + Capacity, std::memory_order_release);
+        }
+        return pop_count;
+    }
+
+    // The count might be outdated by the time it is returned, if other threads are using the queue.
+    NODISCARD ALWAYS_INLINE usize approximate_count() const
+    {
+        const usize head = m_head.load(std::memory_order_acquire);
+        const usize tail = m_tail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    NODISCARD ALWAYS_INLINE static constexpr usize capacity() { return Capacity; }
+
+private:
+    struct Cell
+    {
+        NODISCARD ALWAYS_INLINE T* element() { return reinterpret_cast<T*>(storage); }
+
+        std::atomic<usize> sequence;
+        alignas(T) u8 storage[sizeof(T)];
+    };
+
+    NODISCARD ALWAYS_INLINE Cell& cell(usize position) { return m_cells[position & (Capacity - 1)]; }
+
+    //
+    // Claims up to the maximum count of consecutive positions, starting at the current value of the index, whose cells
+    // are ready (their sequence is the position plus the offset). Returns the number of claimed positions, which is
+    // zero if the first cell is not ready (the queue is full for the producers, or empty for the consumers).
+    //
+    NODISCARD ALWAYS_INLINE usize
+    try_claim_positions(std::atomic<usize>& index, usize sequence_offset, usize maximum_count, usize& out_position)
+    {
+        if (maximum_count == 0)
+            return 0;
+
+        usize position = index.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const usize sequence = cell(position).sequence.load(std::memory_order_acquire);
+            const ssize difference = static_cast<ssize>(sequence - (position + sequence_offset));
+            if (difference < 0)
+                return 0;
+            if (difference > 0)
+            {
+                // Another thread claimed the position since the index was read.
+                position = index.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            usize ready_count = 1;
+            while (ready_count < maximum_count && ready_count < Capacity &&
+                   cell(position + ready_count).sequence.load(std::memory_order_acquire) ==
+                       position + ready_count + sequence_offset)
+                ++ready_count;
+
+            if (index.compare_exchange_weak(
+                    position, position + ready_count, std::memory_order_relaxed, std::memory_order_relaxed
+                ))
+            {
+                out_position = position;
+                return ready_count;
+            }
+        }
+    }
+
+private:
+    alignas(64) std::atomic<usize> m_tail = 0;
+    alignas(64) std::atomic<usize> m_head = 0;
+    alignas(64) Cell m_cells[Capacity];
+};
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::MPMCQueue;
+#endif // AT_INCLUDE_GLOBALLY
@@ -4,30 +4,274 @@
  */
 
 #include "AT/MemoryOperations.h"
+#include "AT/CPUFeatures.h"
+#include "AT/MemoryOperationsKernels.h"
+
+#include <atomic>
+#include <cstring>
 
 namespace AT
 {
 
-void copy_memory(void* destination, const void* source, usize byte_count)
+namespace Detail
+{
+
+#if AT_ARCHITECTURE_X86_64
+
+// SSE2 is part of the x86-64 baseline, so these kernels are always available.
+void copy_memory_sse2(void* destination, const void* source, usize byte_count)
+{
+    copy_memory_kernel<SSE2Registers>(destination, source, byte_count);
+}
+
+void move_memory_sse2(void* destination, const void* source, usize byte_count)
+{
+    move_memory_kernel<SSE2Registers>(destination, source, byte_count);
+}
+
+void set_memory_sse2(void* destination, u8 value, usize byte_count)
+{
+    set_memory_kernel<SSE2Registers>(destination, value, byte_count);
+}
+
+#else
+
+// Portable kernels, that move one machine word per iteration. Used on architectures where
+// no vectorized kernels are implemented.
+static void copy_memory_scalar(void* destination, const void* source, usize byte_count)
 {
-    u8* dst = reinterpret_cast<u8*>(destination);
-    const u8* src = reinterpret_cast<const u8*>(source);
+    u8* dst = static_cast<u8*>(destination);
+    const u8* src = static_cast<const u8*>(source);
+
+    for (; byte_count >= sizeof(uintptr); byte_count -= sizeof(uintptr))
+    {
+        uintptr word;
+        std::memcpy(&word, src, sizeof(uintptr));
+        std::memcpy(dst, &word, sizeof(uintptr));
+        dst += sizeof(uintptr);
+        src += sizeof(uintptr);
+    }
+
     while (byte_count--)
         *dst++ = *src++;
 }
 
-void set_memory(void* destination, u8 value, usize byte_count)
+static void move_memory_scalar(void* destination, const void* source, usize byte_count)
+{
+    u8* dst = static_cast<u8*>(destination);
+    const u8* src = static_cast<const u8*>(source);
+
+    if (reinterpret_cast<uintptr>(dst) - reinterpret_cast<uintptr>(src) >= byte_count)
+    {
+        copy_memory_scalar(destination, source, byte_count);
+        return;
+    }
+
+    // The destination starts inside the source range, so the copy must be done backwards.
+    while (byte_count--)
+        dst[byte_count] = src[byte_count];
+}
+
+static void set_memory_scalar(void* destination, u8 value, usize byte_count)
 {
-    u8* dst = reinterpret_cast<u8*>(destination);
+    u8* dst = static_cast<u8*>(destination);
+    const uintptr pattern = static_cast<uintptr>(0x0101010101010101ull) * value;
+
+    for (; byte_count >= sizeof(uintptr); byte_count -= sizeof(uintptr))
+    {
+        std::memcpy(dst, &pattern, sizeof(uintptr));
+        dst += sizeof(uintptr);
+    }
+
     while (byte_count--)
         *dst++ = value;
 }
 
+#endif // AT_ARCHITECTURE_X86_64
+
+//
+// The kernels are selected only once, the first time any memory operation that exceeds the
+// small threshold is performed. Until then, the dispatch table points to the resolver functions,
+// which select the best kernels that the CPU supports and then forward the call.
+// Multiple threads might race to resolve the table. They all write the same values, and the
+// fields are atomic, so the race is well defined.
+//
+
+static void resolve_copy_memory(void* destination, const void* source, usize byte_count);
+static void resolve_move_memory(void* destination, const void* source, usize byte_count);
+static void resolve_set_memory(void* destination, u8 value, usize byte_count);
+
+struct MemoryOperationsDispatchTable
+{
+    std::atomic<CopyMemoryKernel> copy { resolve_copy_memory };
+    std::atomic<CopyMemoryKernel> move { resolve_move_memory };
+    std::atomic<SetMemoryKernel> set { resolve_set_memory };
+};
+
+static MemoryOperationsDispatchTable s_dispatch_table;
+
+// The kernels are loaded and stored atomically, as threads might resolve the table concurrently. Relaxed ordering is
+// enough, since each kernel is usable on its own, and it compiles to plain loads and stores.
+template<typename Kernel>
+NODISCARD ALWAYS_INLINE static inline Kernel load_kernel(const std::atomic<Kernel>& kernel)
+{
+    return kernel.load(std::memory_order_relaxed);
+}
+
+template<typename Kernel>
+ALWAYS_INLINE static inline void store_kernel(std::atomic<Kernel>& kernel, Kernel value)
+{
+    kernel.store(value, std::memory_order_relaxed);
+}
+
+static void resolve_dispatch_table()
+{
+#if AT_ARCHITECTURE_X86_64
+    const CPUFeatures& cpu_features = get_cpu_features();
+
+    if (cpu_features.has_avx512f)
+    {
+        store_kernel(s_dispatch_table.copy, copy_memory_avx512);
+        store_kernel(s_dispatch_table.move, move_memory_avx512);
+        store_kernel(s_dispatch_table.set, set_memory_avx512);
+    }
+    else if (cpu_features.has_avx2)
+    {
+        store_kernel(s_dispatch_table.copy, copy_memory_avx2);
+        store_kernel(s_dispatch_table.move, move_memory_avx2);
+        store_kernel(s_dispatch_table.set, set_memory_avx2);
+    }
+    else
+    {
+        store_kernel(s_dispatch_table.copy, copy_memory_sse2);
+        store_kernel(s_dispatch_table.move, move_memory_sse2);
+        store_kernel(s_dispatch_table.set, set_memory_sse2);
+    }
+#else
+    store_kernel(s_dispatch_table.copy, copy_memory_scalar);
+    store_kernel(s_dispatch_table.move, move_memory_scalar);
+    store_kernel(s_dispatch_table.set, set_memory_scalar);
+#endif // AT_ARCHITECTURE_X86_64
+}
+
+static void resolve_copy_memory(void* destination, const void* source, usize byte_count)
+{
+    resolve_dispatch_table();
+    load_kernel(s_dispatch_table.copy)(destination, source, byte_count);
+}
+
+static void resolve_move_memory(void* destination, const void* source, usize byte_count)
+{
+    resolve_dispatch_table();
+    load_kernel(s_dispatch_table.move)(destination, source, byte_count);
+}
+
+static void resolve_set_memory(void* destination, u8 value, usize byte_count)
+{
+    resolve_dispatch_table();
+    load_kernel(s_dispatch_table.set)(destination, value, byte_count);
+}
+
+// Resolve the dispatch table when the library is loaded, so that the first memory operation
+// doesn't pay the cost of detecting the CPU features.
+MAYBE_UNUSED static const bool s_is_dispatch_table_resolved_at_startup = (resolve_dispatch_table(), true);
+
+//
+// Small memory operations are the most frequent ones (short strings, single elements), so they
+// are handled inline, without calling through the dispatch table. The first and the last words
+// are both loaded before anything is written, so the ranges are allowed to overlap.
+//
+
+template<typename T>
+ALWAYS_INLINE static inline void move_word_pair(u8* destination, const u8* source, usize byte_count)
+{
+    T head;
+    T tail;
+    std::memcpy(&head, source, sizeof(T));
+    std::memcpy(&tail, source + byte_count - sizeof(T), sizeof(T));
+    std::memcpy(destination, &head, sizeof(T));
+    std::memcpy(destination + byte_count - sizeof(T), &tail, sizeof(T));
+}
+
+ALWAYS_INLINE static inline void move_small(void* destination, const void* source, usize byte_count)
+{
+    u8* dst = static_cast<u8*>(destination);
+    const u8* src = static_cast<const u8*>(source);
+
+    if (byte_count >= sizeof(u64))
+        move_word_pair<u64>(dst, src, byte_count);
+    else if (byte_count >= sizeof(u32))
+        move_word_pair<u32>(dst, src, byte_count);
+    else if (byte_count >= sizeof(u16))
+        move_word_pair<u16>(dst, src, byte_count);
+    else if (byte_count == 1)
+        *dst = *src;
+}
+
+ALWAYS_INLINE static inline void set_small(void* destination, u8 value, usize byte_count)
+{
+    u8* dst = static_cast<u8*>(destination);
+    const u64 pattern = 0x0101010101010101ull * value;
+
+    if (byte_count >= sizeof(u64))
+    {
+        std::memcpy(dst, &pattern, sizeof(u64));
+        std::memcpy(dst + byte_count - sizeof(u64), &pattern, sizeof(u64));
+    }
+    else if (byte_count >= sizeof(u32))
+    {
+        std::memcpy(dst, &pattern, sizeof(u32));
+        std::memcpy(dst + byte_count - sizeof(u32), &pattern, sizeof(u32));
+    }
+    else if (byte_count >= sizeof(u16))
+    {
+        std::memcpy(dst, &pattern, sizeof(u16));
+        std::memcpy(dst + byte_count - sizeof(u16), &pattern, sizeof(u16));
+    }
+    else if (byte_count == 1)
+    {
+        *dst = value;
+    }
+}
+
+} // namespace Detail
+
+void copy_memory(void* destination, const void* source, usize byte_count)
+{
+    if (byte_count <= Detail::SmallMemoryOperationThreshold) [[likely]]
+    {
+        Detail::move_small(destination, source, byte_count);
+        return;
+    }
+
+    Detail::load_kernel(Detail::s_dispatch_table.copy)(destination, source, byte_count);
+}
+
+void move_memory(void* destination, const void* source, usize byte_count)
+{
+    if (byte_count <= Detail::SmallMemoryOperationThreshold) [[likely]]
+    {
+        Detail::move_small(destination, source, byte_count);
+        return;
+    }
+
+    Detail::load_kernel(Detail::s_dispatch_table.move)(destination, source, byte_count);
+}
+
+void set_memory(void* destination, u8 value, usize byte_count)
+{
+    if (byte_count <= Detail::SmallMemoryOperationThreshold) [[likely]]
+    {
+        Detail::set_small(destination, value, byte_count);
+        return;
+    }
+
+    Detail::load_kernel(Detail::s_dispatch_table.set)(destination, value, byte_count);
+}
+
 void zero_memory(void* destination, usize byte_count)
 {
-    u8* dst = reinterpret_cast<u8*>(destination);
-    while (byte_count--)
-        *dst++ = 0;
+    set_memory(destination, 0, byte_count);
 }
 
 } // namespace AT
@@ -10,7 +10,12 @@
 namespace AT
 {
 
+// The source and destination ranges must not overlap. Use move_memory() if they might.
 AT_API void copy_memory(void* destination, const void* source, usize byte_count);
+
+// Same as copy_memory(), except that the source and destination ranges are allowed to overlap.
+AT_API void move_memory(void* destination, const void* source, usize byte_count);
+
 AT_API void set_memory(void* destination, u8 value, usize byte_count);
 AT_API void zero_memory(void* destination, usize byte_count);
 
@@ -18,6 +23,7 @@ AT_API void zero_memory(void* destination, usize byte_count);
 
 #if AT_INCLUDE_GLOBALLY
 using AT::copy_memory;
+using AT::move_memory;
 using AT::set_memory;
 using AT::zero_memory;
 #endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+// NOTE: This translation unit is compiled with the AVX2 code generation flags. The kernels
+// defined here must only be invoked after checking that the CPU supports AVX2.
+
+#include "AT/MemoryOperationsKernels.h"
+
+#if AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+namespace AT::Detail
+{
+
+void copy_memory_avx2(void* destination, const void* source, usize byte_count)
+{
+    copy_memory_kernel<AVX2Registers>(destination, source, byte_count);
+}
+
+void move_memory_avx2(void* destination, const void* source, usize byte_count)
+{
+    move_memory_kernel<AVX2Registers>(destination, source, byte_count);
+}
+
+void set_memory_avx2(void* destination, u8 value, usize byte_count)
+{
+    set_memory_kernel<AVX2Registers>(destination, value, byte_count);
+}
+
+} // namespace AT::Detail
+
+#endif // AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
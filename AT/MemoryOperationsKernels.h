@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+//
+// IMPORTANT: This header is private to the memory operations implementation and should never be
+// included by any other file. The kernels are templated over a register set that wraps the
+// intrinsics of an instruction set extension. Each translation unit that includes this header
+// is compiled with the code generation flags of its instruction set, so everything declared
+// here (except the kernel entry points) must have internal linkage, otherwise the linker might
+// merge the instantiations compiled for different instruction sets.
+//
+
+#include "AT/CoreTypes.h"
+
+#if AT_ARCHITECTURE_X86_64
+    #include <immintrin.h>
+#endif // AT_ARCHITECTURE_X86_64
+
+namespace AT::Detail
+{
+
+// The memory operations that have a byte count less than or equal to this value are handled
+// without going through the dispatch table.
+constexpr usize SmallMemoryOperationThreshold = 16;
+
+// Copies and fills that exceed this byte count (and that don't overlap) use non-temporal stores,
+// as the destination would evict the entire cache anyway.
+constexpr usize NonTemporalThreshold = 4 * 1024 * 1024;
+
+// All kernels expect the byte count to be greater than SmallMemoryOperationThreshold.
+using CopyMemoryKernel = void (*)(void* destination, const void* source, usize byte_count);
+using SetMemoryKernel = void (*)(void* destination, u8 value, usize byte_count);
+
+void copy_memory_sse2(void* destination, const void* source, usize byte_count);
+void move_memory_sse2(void* destination, const void* source, usize byte_count);
+void set_memory_sse2(void* destination, u8 value, usize byte_count);
+
+void copy_memory_avx2(void* destination, const void* source, usize byte_count);
+void move_memory_avx2(void* destination, const void* source, usize byte_count);
+void set_memory_avx2(void* destination, u8 value, usize byte_count);
+
+void copy_memory_avx512(void* destination, const void* source, usize byte_count);
+void move_memory_avx512(void* destination, const void* source, usize byte_count);
+void set_memory_avx512(void* destination, u8 value, usize byte_count);
+
+namespace
+{
+
+//
+// A register set (R) must provide:
+//   - R::Register, R::Width: the vector register type and its size in bytes.
+//   - R::Half: the register set that is half as wide, or void for the narrowest one.
+//   - R::load(), R::store(), R::store_aligned(), R::store_streaming(), R::broadcast(), R::fence().
+//
+// The register sets are only declared when the translation unit is compiled with the code
+// generation flags that enable the corresponding instruction set.
+//
+
+#if AT_ARCHITECTURE_X86_64
+
+struct SSE2Registers
+{
+    using Register = __m128i;
+    using Half = void;
+    static constexpr usize Width = sizeof(Register);
+
+    ALWAYS_INLINE static Register load(const u8* source)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const Register*>(source));
+    }
+    ALWAYS_INLINE static void store(u8* destination, Register value)
+    {
+        _mm_storeu_si128(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static void store_aligned(u8* destination, Register value)
+    {
+        _mm_store_si128(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static void store_streaming(u8* destination, Register value)
+    {
+        _mm_stream_si128(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static Register broadcast(u8 value) { return _mm_set1_epi8(static_cast<char>(value)); }
+    ALWAYS_INLINE static void fence() { _mm_sfence(); }
+};
+
+#endif // AT_ARCHITECTURE_X86_64
+
+#if AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+struct AVX2Registers
+{
+    using Register = __m256i;
+    using Half = SSE2Registers;
+    static constexpr usize Width = sizeof(Register);
+
+    ALWAYS_INLINE static Register load(const u8* source)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const Register*>(source));
+    }
+    ALWAYS_INLINE static void store(u8* destination, Register value)
+    {
+        _mm256_storeu_si256(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static void store_aligned(u8* destination, Register value)
+    {
+        _mm256_store_si256(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static void store_streaming(u8* destination, Register value)
+    {
+        _mm256_stream_si256(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static Register broadcast(u8 value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+    ALWAYS_INLINE static void fence() { _mm_sfence(); }
+};
+
+#endif // AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+#if AT_ARCHITECTURE_X86_64 && defined(__AVX512F__)
+
+struct AVX512Registers
+{
+    using Register = __m512i;
+    using Half = AVX2Registers;
+    static constexpr usize Width = sizeof(Register);
+
+    ALWAYS_INLINE static Register load(const u8* source) { return _mm512_loadu_si512(source); }
+    ALWAYS_INLINE static void store(u8* destination, Register value) { _mm512_storeu_si512(destination, value); }
+    ALWAYS_INLINE static void store_aligned(u8* destination, Register value)
+    {
+        _mm512_store_si512(destination, value);
+    }
+    ALWAYS_INLINE static void store_streaming(u8* destination, Register value)
+    {
+        _mm512_stream_si512(reinterpret_cast<Register*>(destination), value);
+    }
+    ALWAYS_INLINE static Register broadcast(u8 value) { return _mm512_set1_epi8(static_cast<char>(value)); }
+    ALWAYS_INLINE static void fence() { _mm_sfence(); }
+};
+
+#endif // AT_ARCHITECTURE_X86_64 && defined(__AVX512F__)
+
+// Handles byte counts in the range (SmallMemoryOperationThreshold, 2 * R::Width].
+// All loads are performed before any store, so the ranges are allowed to overlap.
+template<typename R>
+ALWAYS_INLINE inline void move_bounded(u8* destination, const u8* source, usize byte_count)
+{
+    if constexpr (!IsVoid<typename R::Half>)
+    {
+        if (byte_count <= R::Width)
+        {
+            move_bounded<typename R::Half>(destination, source, byte_count);
+            return;
+        }
+    }
+
+    const typename R::Register head = R::load(source);
+    const typename R::Register tail = R::load(source + byte_count - R::Width);
+    R::store(destination, head);
+    R::store(destination + byte_count - R::Width, tail);
+}
+
+template<typename R>
+ALWAYS_INLINE inline void set_bounded(u8* destination, u8 value, usize byte_count)
+{
+    if constexpr (!IsVoid<typename R::Half>)
+    {
+        if (byte_count <= R::Width)
+        {
+            set_bounded<typename R::Half>(destination, value, byte_count);
+            return;
+        }
+    }
+
+    const typename R::Register pattern = R::broadcast(value);
+    R::store(destination, pattern);
+    R::store(destination + byte_count - R::Width, pattern);
+}
+
+// Copies from the lowest address towards the highest one. Safe to use when the destination is
+// located before the source, even if the ranges overlap.
+template<typename R, bool UseStreamingStores>
+ALWAYS_INLINE inline void move_forward(u8* destination, const u8* source, usize byte_count)
+{
+    // The first and the last registers are loaded before anything is written, so that overlapping
+    // ranges are handled correctly. They are stored at the very end, covering the unaligned
+    // head and tail of the destination.
+    const typename R::Register head = R::load(source);
+    const typename R::Register tail = R::load(source + byte_count - R::Width);
+
+    // Advance until the destination is aligned to the register width. The skipped bytes are
+    // covered by the head register.
+    const usize skew = R::Width - (reinterpret_cast<uintptr>(destination) & (R::Width - 1));
+    u8* dst = destination + skew;
+    const u8* src = source + skew;
+    usize remaining = byte_count - skew;
+
+    while (remaining > 4 * R::Width)
+    {
+        const typename R::Register r0 = R::load(src + 0 * R::Width);
+        const typename R::Register r1 = R::load(src + 1 * R::Width);
+        const typename R::Register r2 = R::load(src + 2 * R::Width);
+        const typename R::Register r3 = R::load(src + 3 * R::Width);
+
+        if constexpr (UseStreamingStores)
+        {
+            R::store_streaming(dst + 0 * R::Width, r0);
+            R::store_streaming(dst + 1 * R::Width, r1);
+            R::store_streaming(dst + 2 * R::Width, r2);
+            R::store_streaming(dst + 3 * R::Width, r3);
+        }
+        else
+        {
+            R::store_aligned(dst + 0 * R::Width, r0);
+            R::store_aligned(dst + 1 * R::Width, r1);
+            R::store_aligned(dst + 2 * R::Width, r2);
+            R::store_aligned(dst + 3 * R::Width, r3);
+        }
+
+        dst += 4 * R::Width;
+        src += 4 * R::Width;
+        remaining -= 4 * R::Width;
+    }
+
+    while (remaining > R::Width)
+    {
+        R::store_aligned(dst, R::load(src));
+        dst += R::Width;
+        src += R::Width;
+        remaining -= R::Width;
+    }
+
+    if constexpr (UseStreamingStores)
+        R::fence();
+
+    R::store(destination + byte_count - R::Width, tail);
+    R::store(destination, head);
+}
+
+// Copies from the highest address towards the lowest one. Safe to use when the destination is
+// located after the source, even if the ranges overlap.
+template<typename R>
+ALWAYS_INLINE inline void move_backward(u8* destination, const u8* source, usize byte_count)
+{
+    const typename R::Register head = R::load(source);
+    const typename R::Register tail = R::load(source + byte_count - R::Width);
+
+    // Step back until the end of the destination is aligned to the register width. The skipped
+    // bytes are covered by the tail register.
+    u8* const destination_end = destination + byte_count;
+    const usize skew = ((reinterpret_cast<uintptr>(destination_end) - 1) & (R::Width - 1)) + 1;
+    u8* dst_end = destination_end - skew;
+    const u8* src_end = source + byte_count - skew;
+    usize remaining = byte_count - skew;
+
+    while (remaining > 4 * R::Width)
+    {
+        const typename R::Register r0 = R::load(src_end - 1 * R::Width);
+        const typename R::Register r1 = R::load(src_end - 2 * R::Width);
+        const typename R::Register r2 = R::load(src_end - 3 * R::Width);
+        const typename R::Register r3 = R::load(src_end - 4 * R::Width);
+        R::store_aligned(dst_end - 1 * R::Width, r0);
+        R::store_aligned(dst_end - 2 * R::Width, r1);
+        R::store_aligned(dst_end - 3 * R::Width, r2);
+        R::store_aligned(dst_end - 4 * R::Width, r3);
+
+        dst_end -= 4 * R::Width;
+        src_end -= 4 * R::Width;
+        remaining -= 4 * R::Width;
+    }
+
+    while (remaining > R::Width)
+    {
+        R::store_aligned(dst_end - R::Width, R::load(src_end - R::Width));
+        dst_end -= R::Width;
+        src_end -= R::Width;
+        remaining -= R::Width;
+    }
+
+    R::store(destination, head);
+    R::store(destination + byte_count - R::Width, tail);
+}
+
+template<typename R, bool UseStreamingStores>
+ALWAYS_INLINE inline void set_unbounded(u8* destination, u8 value, usize byte_count)
+{
+    const typename R::Register pattern = R::broadcast(value);
+    R::store(destination, pattern);
+
+    const usize skew = R::Width - (reinterpret_cast<uintptr>(destination) & (R::Width - 1));
+    u8* dst = destination + skew;
+    usize remaining = byte_count - skew;
+
+    while (remaining > 4 * R::Width)
+    {
+        if constexpr (UseStreamingStores)
+        {
+            R::store_streaming(dst + 0 * R::Width, pattern);
+            R::store_streaming(dst + 1 * R::Width, pattern);
+            R::store_streaming(dst + 2 * R::Width, pattern);
+            R::store_streaming(dst + 3 * R::Width, pattern);
+        }
+        else
+        {
+            R::store_aligned(dst + 0 * R::Width, pattern);
+            R::store_aligned(dst + 1 * R::Width, pattern);
+            R::store_aligned(dst + 2 * R::Width, pattern);
+            R::store_aligned(dst + 3 * R::Width, pattern);
+        }
+
+        dst += 4 * R::Width;
+        remaining -= 4 * R::Width;
+    }
+
+    while (remaining > R::Width)
+    {
+        R::store_aligned(dst, pattern);
+        dst += R::Width;
+        remaining -= R::Width;
+    }
+
+    if constexpr (UseStreamingStores)
+        R::fence();
+
+    R::store(destination + byte_count - R::Width, pattern);
+}
+
+template<typename R>
+ALWAYS_INLINE inline void copy_memory_kernel(void* destination, const void* source, usize byte_count)
+{
+    u8* dst = static_cast<u8*>(destination);
+    const u8* src = static_cast<const u8*>(source);
+
+    if (byte_count <= 2 * R::Width)
+        move_bounded<R>(dst, src, byte_count);
+    else if (byte_count >= NonTemporalThreshold)
+        move_forward<R, true>(dst, src, byte_count);
+    else
+        move_forward<R, false>(dst, src, byte_count);
+}
+
+template<typename R>
+ALWAYS_INLINE inline void move_memory_kernel(void* destination, const void* source, usize byte_count)
+{
+    u8* dst = static_cast<u8*>(destination);
+    const u8* src = static_cast<const u8*>(source);
+
+    if (byte_count <= 2 * R::Width)
+        move_bounded<R>(dst, src, byte_count);
+    else if (reinterpret_cast<uintptr>(dst) - reinterpret_cast<uintptr>(src) < byte_count)
+        // The destination starts inside the source range, so the copy must be done backwards.
+        move_backward<R>(dst, src, byte_count);
+    else
+        move_forward<R, false>(dst, src, byte_count);
+}
+
+template<typename R>
+ALWAYS_INLINE inline void set_memory_kernel(void* destination, u8 value, usize byte_count)
+{
+    u8* dst = static_cast<u8*>(destination);
+
+    if (byte_count <= 2 * R::Width)
+        set_bounded<R>(dst, value, byte_count);
+    else if (byte_count >= NonTemporalThreshold)
+        set_unbounded<R, true>(dst, value, byte_count);
+    else
+        set_unbounded<R, false>(dst, value, byte_count);
+}
+
+} // namespace
+
+} // namespace AT::Detail
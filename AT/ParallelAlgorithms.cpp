@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/ParallelAlgorithms.h"
+#include "AT/Platform.h"
+
+#include <atomic>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+// The cost of an item is measured by a probe round that takes at least this long, so that the cost of reading the
+// clock is negligible. The measured items are not wasted, as they are part of the work.
+constexpr u64 ParallelProbeRoundNanoseconds = 5'000;
+// Below this estimated time, the cost of waking the workers is not worth paying.
+constexpr u64 ParallelSerialThresholdNanoseconds = 50'000;
+// Claiming a range costs an atomic increment on a shared cache line, which is negligible compared to this.
+constexpr u64 ParallelRangeNanoseconds = 10'000;
+// Each participant should be able to claim a few ranges, so that a slow participant can be compensated for.
+constexpr usize ParallelRangesPerParticipant = 4;
+
+struct ParallelRangeState
+{
+    ParallelRangeFunction function;
+    void* context;
+    usize end;
+    usize range_item_count;
+    alignas(64) std::atomic<usize> next_begin;
+    std::atomic<u32> next_participant_index;
+};
+
+static void run_claimed_ranges(ParallelRangeState& state, u32 participant_index)
+{
+    while (true)
+    {
+        const usize begin = state.next_begin.fetch_add(state.range_item_count, std::memory_order_relaxed);
+        if (begin >= state.end)
+            return;
+
+        const usize end = state.end - begin > state.range_item_count ? begin + state.range_item_count : state.end;
+        state.function(state.context, participant_index, begin, end);
+    }
+}
+
+void run_parallel_range_function(usize count, ParallelRangeFunction function, void* context)
+{
+    if (count == 0)
+        return;
+
+    const u32 worker_count = get_job_worker_count();
+    if (worker_count <= 1 || count == 1)
+    {
+        function(context, 0, 0, count);
+        return;
+    }
+
+    //
+    // The probe rounds double the number of items each time, until a round takes long enough. The first round often
+    // pays one-off costs (such as page faults or cold caches), so it is never used for measuring. The first two rounds
+    // process a single item each, so that at most two expensive items are processed serially.
+    //
+    u64 round_begin_time = get_monotonic_time_in_nanoseconds();
+    u64 round_end_time;
+    usize probed_count = 0;
+    usize round_item_count = 1;
+    u32 round_count = 0;
+    while (true)
+    {
+        const usize round_end = count - probed_count > round_item_count ? probed_count + round_item_count : count;
+        round_item_count = round_end - probed_count;
+        function(context, 0, probed_count, round_end);
+        probed_count = round_end;
+        round_end_time = get_monotonic_time_in_nanoseconds();
+
+        if (probed_count == count)
+            return;
+        if (++round_count >= 2 && round_end_time - round_begin_time >= ParallelProbeRoundNanoseconds)
+            break;
+
+        if (round_count >= 2)
+            round_item_count *= 2;
+        round_begin_time = round_end_time;
+    }
+
+    const usize remaining_count = count - probed_count;
+    const f64 nanoseconds_per_item =
+        static_cast<f64>(round_end_time - round_begin_time) / static_cast<f64>(round_item_count);
+    if (nanoseconds_per_item * static_cast<f64>(remaining_count) < static_cast<f64>(ParallelSerialThresholdNanoseconds))
+    {
+        function(context, 0, probed_count, count);
+        return;
+    }
+
+    // The ranges must take long enough to amortize claiming them, but there must be enough of them to balance the load.
+    const f64 amortized_range_item_count = static_cast<f64>(ParallelRangeNanoseconds) / nanoseconds_per_item;
+    const usize balanced_range_item_count = remaining_count / (worker_count * ParallelRangesPerParticipant);
+    usize range_item_count = amortized_range_item_count < static_cast<f64>(balanced_range_item_count)
+                                 ? static_cast<usize>(amortized_range_item_count)
+                                 : balanced_range_item_count;
+    if (range_item_count == 0)
+        range_item_count = 1;
+
+    const usize range_count = (remaining_count + range_item_count - 1) / range_item_count;
+    const u32 helper_count = range_count - 1 < worker_count - 1 ? static_cast<u32>(range_count - 1) : worker_count - 1;
+
+    ParallelRangeState state;
+    state.function = function;
+    state.context = context;
+    state.end = count;
+    state.range_item_count = range_item_count;
+    state.next_begin.store(probed_count, std::memory_order_relaxed);
+    state.next_participant_index.store(1, std::memory_order_relaxed);
+
+    // The helpers that start after all ranges were claimed return immediately.
+    JobCounter counter;
+    for (u32 helper_index = 0; helper_index < helper_count; ++helper_index)
+    {
+        schedule_job(
+            [&state]
+            {
+                const u32 participant_index = state.next_participant_index.fetch_add(1, std::memory_order_relaxed);
+                run_claimed_ranges(state, participant_index);
+            },
+            &counter
+        );
+    }
+
+    run_claimed_ranges(state, 0);
+    wait_for_counter(counter);
+}
+
+} // namespace Detail
+
+} // namespace AT
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Allocator.h"
+#include "AT/Assertions.h"
+#include "AT/CoreTypes.h"
+#include "AT/JobSystem.h"
+#include "AT/Sort.h"
+#include "AT/Span.h"
+#include "AT/Vector.h"
+
+#include <new>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+// Called with the index of the participating thread (zero for the calling thread, always below the job worker count)
+// and the range of items to process.
+using ParallelRangeFunction = void (*)(void* context, u32 participant_index, usize begin, usize end);
+
+//
+// Runs the function over the items in [0, count), on the calling thread and on the job workers. The calling thread
+// first runs a few items serially, doubling their count each time, in order to measure the cost of an item. If the
+// remaining items are cheap enough, they are run serially as well. Otherwise, they are split into ranges that take
+// long enough to amortize the cost of claiming a range, but that are small enough for the threads to balance the load.
+// The participating threads claim ranges until none is left.
+//
+// If the job system is not initialized, or it only has one worker, all items are run serially.
+//
+AT_API void run_parallel_range_function(usize count, ParallelRangeFunction function, void* context);
+
+template<typename Callable>
+ALWAYS_INLINE inline void run_parallel_ranges(usize count, Callable& callable)
+{
+    const ParallelRangeFunction function = [](void* context, u32 participant_index, usize begin, usize end)
+    {
+        (*static_cast<Callable*>(context))(participant_index, begin, end);
+    };
+    run_parallel_range_function(count, function, &callable);
+}
+
+// The parallel sort splits the elements into chunks of at least this many elements.
+constexpr usize MinimumParallelSortChunkElementCount = 4096;
+
+} // namespace Detail
+
+// Calls the callable with the ranges (begin and end indices) that cover [0, count), possibly in parallel.
+template<typename Callable>
+void parallel_for_range(usize count, Callable&& callable)
+{
+    auto range_callable = [&callable](u32, usize begin, usize end) { callable(begin, end); };
+    Detail::run_parallel_ranges(count, range_callable);
+}
+
+// Calls the callable with each index in [0, count), possibly in parallel.
+template<typename Callable>
+void parallel_for(usize count, Callable&& callable)
+{
+    parallel_for_range(
+        count,
+        [&callable](usize begin, usize end)
+        {
+            for (usize index = begin; index < end; ++index)
+                callable(index);
+        }
+    );
+}
+
+// Calls the callable with (a reference to) each element of the span, possibly in parallel.
+template<typename T, typename Callable>
+void parallel_for(Span<T> span, Callable&& callable)
+{
+    T* elements = span.elements();
+    parallel_for_range(
+        span.count(),
+        [elements, &callable](usize begin, usize end)
+        {
+            for (usize index = begin; index < end; ++index)
+                callable(elements[index]);
+        }
+    );
+}
+
+template<typename T, usize InlineCapacity, typename Callable>
+ALWAYS_INLINE inline void parallel_for(Vector<T, InlineCapacity>& vector, Callable&& callable)
+{
+    parallel_for(vector.span(), forward<Callable>(callable));
+}
+
+// Assigns to each element of the output the result of calling the callable with the corresponding input element.
+template<typename T, typename U, typename Callable>
+void parallel_transform(Span<T> input, Span<U> output, Callable&& callable)
+{
+    VERIFY_ALWAYS(input.count() == output.count());
+    T* input_elements = input.elements();
+    U* output_elements = output.elements();
+    parallel_for_range(
+        input.count(),
+        [input_elements, output_elements, &callable](usize begin, usize end)
+        {
+            for (usize index = begin; index < end; ++index)
+                output_elements[index] = callable(input_elements[index]);
+        }
+    );
+}
+
+template<typename T, usize InputInlineCapacity, typename U, usize OutputInlineCapacity, typename Callable>
+ALWAYS_INLINE inline void parallel_transform(
+    const Vector<T, InputInlineCapacity>& input, Vector<U, OutputInlineCapacity>& output, Callable&& callable
+)
+{
+    parallel_transform(input.span(), output.span(), forward<Callable>(callable));
+}
+
+//
+// Reduces the elements to a single value, possibly in parallel. Each thread folds the elements it processes into its
+// own partial value (starting from the identity) with `reduce(value, element)`, and the partial values are folded
+// with `combine(value, value)`. Both operations must be associative and commutative, as the order in which the
+// elements are folded is not specified.
+//
+template<typename T, typename Value, typename Reduce, typename Combine>
+NODISCARD Value parallel_reduce(Span<T> span, Value identity, Reduce&& reduce, Combine&& combine)
+{
+    const u32 worker_count = get_job_worker_count();
+    const u32 participant_count = worker_count > 0 ? worker_count : 1;
+
+    Vector<Value> partial_values;
+    MUST(partial_values.try_ensure_capacity(participant_count));
+    for (u32 participant_index = 0; participant_index < participant_count; ++participant_index)
+        MUST(partial_values.try_push_back(identity));
+
+    // The partial value is only written once per range, so that the threads don't write to the same cache line
+    // for every element.
+    T* elements = span.elements();
+    auto range_callable = [elements, &identity, &partial_values, &reduce, &combine](u32 participant_index, usize begin,
+                                                                                    usize end)
+    {
+        Value range_value = identity;
+        for (usize index = begin; index < end; ++index)
+            range_value = reduce(move(range_value), elements[index]);
+
+        Value& partial_value = partial_values.unchecked_at(participant_index);
+        partial_value = combine(move(partial_value), move(range_value));
+    };
+    Detail::run_parallel_ranges(span.count(), range_callable);
+
+    Value value = move(identity);
+    for (Value& partial_value : partial_values)
+        value = combine(move(value), move(partial_value));
+    return value;
+}
+
+template<typename T, typename Value, typename Combine>
+NODISCARD ALWAYS_INLINE inline Value parallel_reduce(Span<T> span, Value identity, Combine&& combine)
+{
+    return parallel_reduce(span, move(identity), combine, combine);
+}
+
+template<typename T, usize InlineCapacity, typename Value, typename Reduce, typename Combine>
+NODISCARD ALWAYS_INLINE inline Value
+parallel_reduce(const Vector<T, InlineCapacity>& vector, Value identity, Reduce&& reduce, Combine&& combine)
+{
+    return parallel_reduce(vector.span(), move(identity), forward<Reduce>(reduce), forward<Combine>(combine));
+}
+
+template<typename T, usize InlineCapacity, typename Value, typename Combine>
+NODISCARD ALWAYS_INLINE inline Value
+parallel_reduce(const Vector<T, InlineCapacity>& vector, Value identity, Combine&& combine)
+{
+    return parallel_reduce(vector.span(), move(identity), combine, combine);
+}
+
+//
+// Sorts the elements (in the order given by the less-than comparison) with a stable merge sort. The elements are
+// split into a power of two number of chunks, which are sorted in parallel. The sorted chunks are then merged in
+// pairs, level by level. Each merge is split further (at the points found by binary searching the diagonals of the
+// merge), so that every level is merged by as many parallel segments as there are chunks.
+//
+// A scratch buffer, as large as the span, is allocated from the heap.
+//
+template<typename T, typename Compare>
+void parallel_sort(Span<T> span, Compare&& compare)
+{
+    const usize count = span.count();
+    T* elements = span.elements();
+    if (count <= Detail::MergeSortRunLength)
+    {
+        Detail::insertion_sort(elements, count, compare);
+        return;
+    }
+
+    usize chunk_count = 1;
+    const u32 worker_count = get_job_worker_count();
+    while (chunk_count < 4 * static_cast<usize>(worker_count) &&
+           2 * chunk_count * Detail::MinimumParallelSortChunkElementCount <= count)
+        chunk_count *= 2;
+    const auto get_chunk_begin = [count, chunk_count](usize chunk_index) { return count * chunk_index / chunk_count; };
+
+    // The elements are moved into the buffer, so that the elements of both arrays are constructed and can be
+    // move-assigned by the merges. The span holds the moved-from elements until the first merge overwrites them.
+    MUST_ASSIGN(void* buffer_memory, HeapAllocator::try_allocate_from_heap(count * sizeof(T), alignof(T)));
+    T* buffer = static_cast<T*>(buffer_memory);
+    parallel_for_range(
+        count,
+        [elements, buffer](usize begin, usize end)
+        {
+            for (usize index = begin; index < end; ++index)
+                new (buffer + index) T(move(elements[index]));
+        }
+    );
+
+    parallel_for(
+        chunk_count,
+        [elements, buffer, &get_chunk_begin, &compare](usize chunk_index)
+        {
+            const usize begin = get_chunk_begin(chunk_index);
+            const usize end = get_chunk_begin(chunk_index + 1);
+            Detail::merge_sort(buffer + begin, elements + begin, end - begin, compare);
+        }
+    );
+
+    T* source = buffer;
+    T* destination = elements;
+    for (usize run_chunk_count = 1; run_chunk_count < chunk_count; run_chunk_count *= 2)
+    {
+        parallel_for(
+            chunk_count,
+            [source, destination, run_chunk_count, &get_chunk_begin, &compare](usize segment_index)
+            {
+                const usize pair_chunk_count = 2 * run_chunk_count;
+                const usize first_chunk_index = segment_index - segment_index % pair_chunk_count;
+                const usize pair_begin = get_chunk_begin(first_chunk_index);
+                const usize pair_middle = get_chunk_begin(first_chunk_index + run_chunk_count);
+                const usize pair_end = get_chunk_begin(first_chunk_index + pair_chunk_count);
+
+                const usize segment_index_in_pair = segment_index - first_chunk_index;
+                const usize pair_count = pair_end - pair_begin;
+                const usize diagonal_begin = pair_count * segment_index_in_pair / pair_chunk_count;
+                const usize diagonal_end = pair_count * (segment_index_in_pair + 1) / pair_chunk_count;
+
+                T* left = source + pair_begin;
+                T* right = source + pair_middle;
+                const usize left_count = pair_middle - pair_begin;
+                const usize right_count = pair_end - pair_middle;
+                const usize left_begin =
+                    Detail::find_merge_split(left, left_count, right, right_count, diagonal_begin, compare);
+                const usize left_end =
+                    Detail::find_merge_split(left, left_count, right, right_count, diagonal_end, compare);
+                const usize right_begin = diagonal_begin - left_begin;
+                const usize right_end = diagonal_end - left_end;
+
+                Detail::merge_runs(
+                    left + left_begin, left_end - left_begin, right + right_begin, right_end - right_begin,
+                    destination + pair_begin + diagonal_begin, compare
+                );
+            }
+        );
+
+        T* previous_source = source;
+        source = destination;
+        destination = previous_source;
+    }
+
+    if (source != elements)
+    {
+        parallel_for_range(
+            count,
+            [elements, buffer](usize begin, usize end)
+            {
+                for (usize index = begin; index < end; ++index)
+                    elements[index] = move(buffer[index]);
+            }
+        );
+    }
+
+    for (usize index = 0; index < count; ++index)
+        buffer[index].~T();
+    HeapAllocator::release_to_heap(buffer, count * sizeof(T), alignof(T));
+}
+
+template<typename T>
+ALWAYS_INLINE inline void parallel_sort(Span<T> span)
+{
+    parallel_sort(span, [](const T& a, const T& b) { return a < b; });
+}
+
+template<typename T, usize InlineCapacity, typename Compare>
+ALWAYS_INLINE inline void parallel_sort(Vector<T, InlineCapacity>& vector, Compare&& compare)
+{
+    parallel_sort(vector.span(), forward<Compare>(compare));
+}
+
+template<typename T, usize InlineCapacity>
+ALWAYS_INLINE inline void parallel_sort(Vector<T, InlineCapacity>& vector)
+{
+    parallel_sort(vector.span());
+}
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::parallel_for;
+using AT::parallel_for_range;
+using AT::parallel_reduce;
+using AT::parallel_sort;
+using AT::parallel_transform;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Error.h"
+
+#include <atomic>
+
+namespace AT
+{
+
+//
+// The page sizes are queried only once, the first time they are needed. The huge page size is the size of the pages
+// that the transparent huge page hint requests (2 MiB on x86-64).
+//
+NODISCARD AT_API usize get_page_size();
+NODISCARD AT_API usize get_huge_page_size();
+
+//
+// Reserving a range of virtual memory only claims the addresses, without backing them with physical memory.
+// The pages of a reserved range can't be accessed until they are committed, and committed pages are zero-filled
+// on their first access. Decommitting pages returns their physical memory to the operating system, while keeping the
+// addresses reserved. All addresses and byte counts must be multiples of the page size, except for the byte count
+// of a reservation, which is rounded up to it.
+//
+NODISCARD AT_API ErrorOr<void*> try_reserve_virtual_memory(usize byte_count);
+NODISCARD AT_API ErrorOr<void> try_commit_virtual_memory(void* address, usize byte_count);
+AT_API void decommit_virtual_memory(void* address, usize byte_count);
+// The address and byte count must be the values that were used when reserving the range.
+AT_API void release_virtual_memory(void* address, usize byte_count);
+
+// Asks the operating system to back the range with huge pages, which reduces the TLB misses of large data
+// structures. This is only a hint, which is ignored by the platforms that don't support transparent huge pages.
+AT_API void advise_huge_pages(void* address, usize byte_count);
+
+// Returns the time elapsed since an unspecified point in the past, which never goes backwards.
+NODISCARD AT_API u64 get_monotonic_time_in_nanoseconds();
+
+// Returns the number of logical cores that the process is allowed to run on.
+NODISCARD AT_API u32 get_logical_core_count();
+// Restricts the calling thread to run only on the given logical core (an index below the logical core count).
+AT_API void set_current_thread_affinity(u32 core_index);
+
+//
+// Blocks the calling thread while the word holds the expected value (a futex wait). Comparing the value and starting
+// to wait is atomic with respect to the wake functions, so a wake-up that follows a change of the word can't be lost.
+// The thread might also wake up spuriously, so the callers must check their condition again.
+//
+AT_API void wait_on_address(const std::atomic<u32>& word, u32 expected_value);
+AT_API void wake_one_waiter_on_address(const std::atomic<u32>& word);
+AT_API void wake_all_waiters_on_address(const std::atomic<u32>& word);
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::advise_huge_pages;
+using AT::decommit_virtual_memory;
+using AT::get_huge_page_size;
+using AT::get_logical_core_count;
+using AT::get_monotonic_time_in_nanoseconds;
+using AT::get_page_size;
+using AT::release_virtual_memory;
+using AT::set_current_thread_affinity;
+using AT::try_commit_virtual_memory;
+using AT::try_reserve_virtual_memory;
+using AT::wait_on_address;
+using AT::wake_all_waiters_on_address;
+using AT::wake_one_waiter_on_address;
+#endif // AT_INCLUDE_GLOBALLY
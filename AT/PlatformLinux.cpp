@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Platform.h"
+
+#if AT_PLATFORM_LINUX
+
+    #include <climits>
+    #include <cstdio>
+    #include <linux/futex.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <time.h>
+    #include <unistd.h>
+
+namespace AT
+{
+
+usize get_page_size()
+{
+    static const usize page_size = static_cast<usize>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+static usize query_huge_page_size()
+{
+    // The kernel reports the size of the huge pages that back the transparent huge page mappings.
+    usize huge_page_size = 2 * 1024 * 1024;
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if (file)
+    {
+        unsigned long long value = 0;
+        if (fscanf(file, "%llu", &value) == 1 && value > 0)
+            huge_page_size = static_cast<usize>(value);
+        fclose(file);
+    }
+    return huge_page_size;
+}
+
+usize get_huge_page_size()
+{
+    static const usize huge_page_size = query_huge_page_size();
+    return huge_page_size;
+}
+
+ErrorOr<void*> try_reserve_virtual_memory(usize byte_count)
+{
+    // The reserved pages are not accounted as committed memory until their protection allows accessing them.
+    void* address = mmap(nullptr, byte_count, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (address == MAP_FAILED)
+        return Error::Code::OutOfMemory;
+    return address;
+}
+
+ErrorOr<void> try_commit_virtual_memory(void* address, usize byte_count)
+{
+    if (mprotect(address, byte_count, PROT_READ | PROT_WRITE) != 0)
+        return Error::Code::OutOfMemory;
+    return {};
+}
+
+void decommit_virtual_memory(void* address, usize byte_count)
+{
+    // Discarding the pages releases their physical memory, and the following accesses would observe zero-filled
+    // pages. The protection is removed as well, so that the pages are accounted as reserved only.
+    madvise(address, byte_count, MADV_DONTNEED);
+    mprotect(address, byte_count, PROT_NONE);
+}
+
+void release_virtual_memory(void* address, usize byte_count)
+{
+    munmap(address, byte_count);
+}
+
+void advise_huge_pages(void* address, usize byte_count)
+{
+    #ifdef MADV_HUGEPAGE
+    madvise(address, byte_count, MADV_HUGEPAGE);
+    #else
+    (void)address;
+    (void)byte_count;
+    #endif // MADV_HUGEPAGE
+}
+
+u64 get_monotonic_time_in_nanoseconds()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<u64>(time.tv_sec) * 1'000'000'000 + static_cast<u64>(time.tv_nsec);
+}
+
+//
+// The affinity mask of the process (which might be restricted by the container or by taskset) decides which cores
+// can be used. The core indices map to the allowed cores, in increasing order.
+//
+static cpu_set_t get_process_affinity_mask()
+{
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0)
+    {
+        CPU_ZERO(&mask);
+        CPU_SET(0, &mask);
+    }
+    return mask;
+}
+
+u32 get_logical_core_count()
+{
+    static const u32 core_count = []
+    {
+        const cpu_set_t mask = get_process_affinity_mask();
+        const int count = CPU_COUNT(&mask);
+        return count > 0 ? static_cast<u32>(count) : 1u;
+    }();
+    return core_count;
+}
+
+void set_current_thread_affinity(u32 core_index)
+{
+    static const cpu_set_t process_mask = get_process_affinity_mask();
+
+    u32 allowed_core_index = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &process_mask))
+            continue;
+        if (allowed_core_index++ != core_index)
+            continue;
+
+        cpu_set_t thread_mask;
+        CPU_ZERO(&thread_mask);
+        CPU_SET(cpu, &thread_mask);
+        pthread_setaffinity_np(pthread_self(), sizeof(thread_mask), &thread_mask);
+        return;
+    }
+}
+
+static_assert(sizeof(std::atomic<u32>) == sizeof(u32));
+
+// The words are never shared with other processes, so the private futex operations are used, which are cheaper (the
+// kernel doesn't have to resolve the physical address of the word).
+static u32* get_futex_word(const std::atomic<u32>& word)
+{
+    return const_cast<u32*>(reinterpret_cast<const u32*>(&word));
+}
+
+void wait_on_address(const std::atomic<u32>& word, u32 expected_value)
+{
+    syscall(SYS_futex, get_futex_word(word), FUTEX_WAIT_PRIVATE, expected_value, nullptr, nullptr, 0);
+}
+
+void wake_one_waiter_on_address(const std::atomic<u32>& word)
+{
+    syscall(SYS_futex, get_futex_word(word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+void wake_all_waiters_on_address(const std::atomic<u32>& word)
+{
+    syscall(SYS_futex, get_futex_word(word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace AT
+
+#endif // AT_PLATFORM_LINUX
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Platform.h"
+
+#if AT_PLATFORM_WINDOWS
+
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+
+namespace AT
+{
+
+usize get_page_size()
+{
+    static const usize page_size = []
+    {
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        return static_cast<usize>(system_info.dwPageSize);
+    }();
+    return page_size;
+}
+
+usize get_huge_page_size()
+{
+    static const usize huge_page_size = []
+    {
+        const usize large_page_minimum = static_cast<usize>(GetLargePageMinimum());
+        return large_page_minimum > 0 ? large_page_minimum : static_cast<usize>(2 * 1024 * 1024);
+    }();
+    return huge_page_size;
+}
+
+ErrorOr<void*> try_reserve_virtual_memory(usize byte_count)
+{
+    void* address = VirtualAlloc(nullptr, byte_count, MEM_RESERVE, PAGE_NOACCESS);
+    if (!address)
+        return Error::Code::OutOfMemory;
+    return address;
+}
+
+ErrorOr<void> try_commit_virtual_memory(void* address, usize byte_count)
+{
+    if (!VirtualAlloc(address, byte_count, MEM_COMMIT, PAGE_READWRITE))
+        return Error::Code::OutOfMemory;
+    return {};
+}
+
+void decommit_virtual_memory(void* address, usize byte_count)
+{
+    VirtualFree(address, byte_count, MEM_DECOMMIT);
+}
+
+void release_virtual_memory(void* address, usize)
+{
+    // The whole reservation is released, which requires passing a zero byte count.
+    VirtualFree(address, 0, MEM_RELEASE);
+}
+
+void advise_huge_pages(void*, usize)
+{
+    // The large pages can only be allocated upfront (and require the SeLockMemoryPrivilege privilege), so there are
+    // no transparent huge pages to ask for.
+}
+
+u64 get_monotonic_time_in_nanoseconds()
+{
+    static const u64 frequency = []
+    {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return static_cast<u64>(value.QuadPart);
+    }();
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    const u64 ticks = static_cast<u64>(counter.QuadPart);
+
+    // Splitting the conversion avoids overflowing the multiplication after a few days of uptime.
+    return (ticks / frequency) * 1'000'000'000 + ((ticks % frequency) * 1'000'000'000) / frequency;
+}
+
+u32 get_logical_core_count()
+{
+    static const u32 core_count = []
+    {
+        const DWORD count = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+        return count > 0 ? static_cast<u32>(count) : 1u;
+    }();
+    return core_count;
+}
+
+void set_current_thread_affinity(u32 core_index)
+{
+    // The cores are numbered across the processor groups, each group having at most 64 cores.
+    const WORD group_count = GetActiveProcessorGroupCount();
+    for (WORD group = 0; group < group_count; ++group)
+    {
+        const DWORD group_core_count = GetActiveProcessorCount(group);
+        if (core_index >= group_core_count)
+        {
+            core_index -= group_core_count;
+            continue;
+        }
+
+        GROUP_AFFINITY affinity = {};
+        affinity.Group = group;
+        affinity.Mask = static_cast<KAFFINITY>(1) << core_index;
+        SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr);
+        return;
+    }
+}
+
+// The address functions are exported by the Synchronization library.
+static_assert(sizeof(std::atomic<u32>) == sizeof(u32));
+
+static volatile void* get_wait_address(const std::atomic<u32>& word)
+{
+    return const_cast<std::atomic<u32>*>(&word);
+}
+
+void wait_on_address(const std::atomic<u32>& word, u32 expected_value)
+{
+    WaitOnAddress(get_wait_address(word), &expected_value, sizeof(u32), INFINITE);
+}
+
+void wake_one_waiter_on_address(const std::atomic<u32>& word)
+{
+    WakeByAddressSingle(const_cast<void*>(get_wait_address(word)));
+}
+
+void wake_all_waiters_on_address(const std::atomic<u32>& word)
+{
+    WakeByAddressAll(const_cast<void*>(get_wait_address(word)));
+}
+
+} // namespace AT
+
+#endif // AT_PLATFORM_WINDOWS
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Profiler.h"
+#include "AT/Allocator.h"
+#include "AT/CPUFeatures.h"
+#include "AT/Format.h"
+#include "AT/Log.h"
+#include "AT/Platform.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <new>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+struct ProfilingEvent
+{
+    const char* name;
+    u64 begin_ticks;
+    u64 end_ticks;
+};
+
+struct ProfilingEventChunk
+{
+    static constexpr u32 Capacity = 4096;
+
+    // Only written by the owner thread. The count is published with release semantics, after the events are written.
+    std::atomic<ProfilingEventChunk*> next;
+    std::atomic<u32> event_count;
+    ProfilingEvent events[Capacity];
+};
+
+//
+// The events recorded by a thread. Only the owner thread writes the events, so recording an event doesn't require
+// any synchronization. The events of the previous session are discarded lazily, by the owner thread, when it records
+// the first event of a new session. The chunks are reused by the following sessions.
+//
+struct ThreadProfile
+{
+    u32 thread_index;
+    std::atomic<u32> session_id;
+    std::atomic<bool> is_owned;
+    ProfilingEventChunk* first_chunk;
+    ProfilingEventChunk* current_chunk;
+};
+
+// Marks the profile of the thread as no longer owned when the thread exits. The profile is released by the next
+// session, as its events can still be exported until then.
+struct ThreadProfileOwner
+{
+    ~ThreadProfileOwner()
+    {
+        if (profile != nullptr)
+            profile->is_owned.store(false, std::memory_order_release);
+    }
+
+    ThreadProfile* profile = nullptr;
+};
+
+// Zero means that no session is active. The session identifiers are never reused.
+static std::atomic<u32> s_active_session_id = 0;
+static thread_local ThreadProfile* s_thread_profile;
+
+struct ProfilingSession
+{
+    std::mutex mutex;
+    // The following members are only accessed while holding the mutex.
+    Vector<ThreadProfile*> thread_profiles;
+    u32 last_session_id = 0;
+    u32 next_thread_index = 1;
+    bool is_active = false;
+
+    // The clock calibration points, captured when the session begins and ends.
+    u64 begin_ticks = 0;
+    u64 begin_nanoseconds = 0;
+    u64 end_ticks = 0;
+    u64 end_nanoseconds = 0;
+};
+
+static ProfilingSession& get_profiling_session()
+{
+    static ProfilingSession session;
+    return session;
+}
+
+#if !AT_ARCHITECTURE_X86_64
+u64 read_profiling_clock()
+{
+    return get_monotonic_time_in_nanoseconds();
+}
+#endif // !AT_ARCHITECTURE_X86_64
+
+static ProfilingEventChunk* allocate_event_chunk()
+{
+    MUST_ASSIGN(
+        void* memory, HeapAllocator::try_allocate_from_heap(sizeof(ProfilingEventChunk), alignof(ProfilingEventChunk))
+    );
+    ProfilingEventChunk* chunk = static_cast<ProfilingEventChunk*>(memory);
+    new (&chunk->next) std::atomic<ProfilingEventChunk*>(nullptr);
+    new (&chunk->event_count) std::atomic<u32>(0);
+    return chunk;
+}
+
+static void release_thread_profile(ThreadProfile* profile)
+{
+    ProfilingEventChunk* chunk = profile->first_chunk;
+    while (chunk != nullptr)
+    {
+        ProfilingEventChunk* next_chunk = chunk->next.load(std::memory_order_relaxed);
+        HeapAllocator::release_to_heap(chunk, sizeof(ProfilingEventChunk), alignof(ProfilingEventChunk));
+        chunk = next_chunk;
+    }
+    profile->~ThreadProfile();
+    HeapAllocator::release_to_heap(profile, sizeof(ThreadProfile), alignof(ThreadProfile));
+}
+
+static ThreadProfile* register_thread_profile()
+{
+    MUST_ASSIGN(void* memory, HeapAllocator::try_allocate_from_heap(sizeof(ThreadProfile), alignof(ThreadProfile)));
+    ThreadProfile* profile = new (memory) ThreadProfile();
+    profile->is_owned.store(true, std::memory_order_relaxed);
+    profile->first_chunk = allocate_event_chunk();
+    profile->current_chunk = profile->first_chunk;
+
+    static thread_local ThreadProfileOwner profile_owner;
+    profile_owner.profile = profile;
+
+    ProfilingSession& session = get_profiling_session();
+    std::scoped_lock lock(session.mutex);
+    profile->thread_index = session.next_thread_index++;
+    MUST(session.thread_profiles.try_push_back(profile));
+    return profile;
+}
+
+// Called by the owner thread when it records the first event of a new session.
+static void reset_thread_profile(ThreadProfile* profile, u32 session_id)
+{
+    for (ProfilingEventChunk* chunk = profile->first_chunk; chunk != nullptr;
+         chunk = chunk->next.load(std::memory_order_relaxed))
+        chunk->event_count.store(0, std::memory_order_relaxed);
+
+    profile->current_chunk = profile->first_chunk;
+    profile->session_id.store(session_id, std::memory_order_release);
+}
+
+void record_profiling_event(const char* name, u64 begin_ticks, u64 end_ticks)
+{
+    const u32 session_id = s_active_session_id.load(std::memory_order_relaxed);
+    if (session_id == 0)
+        return;
+
+    ThreadProfile* profile = s_thread_profile;
+    if (profile == nullptr) [[unlikely]]
+    {
+        profile = register_thread_profile();
+        s_thread_profile = profile;
+    }
+    if (profile->session_id.load(std::memory_order_relaxed) != session_id) [[unlikely]]
+        reset_thread_profile(profile, session_id);
+
+    ProfilingEventChunk* chunk = profile->current_chunk;
+    u32 event_count = chunk->event_count.load(std::memory_order_relaxed);
+    if (event_count == ProfilingEventChunk::Capacity) [[unlikely]]
+    {
+        ProfilingEventChunk* next_chunk = chunk->next.load(std::memory_order_relaxed);
+        if (next_chunk == nullptr)
+        {
+            next_chunk = allocate_event_chunk();
+            chunk->next.store(next_chunk, std::memory_order_release);
+        }
+        profile->current_chunk = next_chunk;
+        chunk = next_chunk;
+        event_count = 0;
+    }
+
+    chunk->events[event_count] = { name, begin_ticks, end_ticks };
+    chunk->event_count.store(event_count + 1, std::memory_order_release);
+}
+
+// The names are string literals or function signatures, so only the quotes and the backslashes are escaped.
+static void push_json_string(FormatBuilder& builder, const char* string)
+{
+    builder.push_string("\""sv);
+    for (const char* character = string; *character != 0; ++character)
+    {
+        if (*character == '"' || *character == '\\')
+            builder.push_string("\\"sv);
+        builder.push_string(StringView::from_utf8(character, 1));
+    }
+    builder.push_string("\""sv);
+}
+
+} // namespace Detail
+
+void begin_profiling_session()
+{
+    Detail::ProfilingSession& session = Detail::get_profiling_session();
+    std::scoped_lock lock(session.mutex);
+    VERIFY_ALWAYS(!session.is_active);
+
+#if AT_ARCHITECTURE_X86_64
+    if (!get_cpu_features().has_invariant_tsc)
+        dbgln("The time stamp counter is not invariant, so the profiling timestamps might be inaccurate."sv);
+#endif // AT_ARCHITECTURE_X86_64
+
+    // The profiles of the threads that exited are no longer needed.
+    for (usize index = 0; index < session.thread_profiles.count();)
+    {
+        Detail::ThreadProfile* profile = session.thread_profiles[index];
+        if (!profile->is_owned.load(std::memory_order_acquire))
+        {
+            Detail::release_thread_profile(profile);
+            session.thread_profiles[index] = session.thread_profiles.last();
+            session.thread_profiles.pop_back();
+            continue;
+        }
+        ++index;
+    }
+
+    session.is_active = true;
+    session.begin_nanoseconds = get_monotonic_time_in_nanoseconds();
+    session.begin_ticks = Detail::read_profiling_clock();
+    Detail::s_active_session_id.store(++session.last_session_id, std::memory_order_relaxed);
+}
+
+void end_profiling_session()
+{
+    Detail::ProfilingSession& session = Detail::get_profiling_session();
+    std::scoped_lock lock(session.mutex);
+    VERIFY_ALWAYS(session.is_active);
+
+    Detail::s_active_session_id.store(0, std::memory_order_relaxed);
+    session.end_ticks = Detail::read_profiling_clock();
+    session.end_nanoseconds = get_monotonic_time_in_nanoseconds();
+    session.is_active = false;
+}
+
+void write_profiling_session_as_chrome_trace(StringBuilder& string_builder)
+{
+    Detail::ProfilingSession& session = Detail::get_profiling_session();
+    std::scoped_lock lock(session.mutex);
+
+    // The events recorded by the scopes that end after the session ends are not exported.
+    u64 end_ticks = session.end_ticks;
+    u64 end_nanoseconds = session.end_nanoseconds;
+    if (session.is_active)
+    {
+        end_ticks = Detail::read_profiling_clock();
+        end_nanoseconds = get_monotonic_time_in_nanoseconds();
+    }
+
+    const u64 elapsed_ticks = end_ticks - session.begin_ticks;
+    const u64 elapsed_nanoseconds = end_nanoseconds - session.begin_nanoseconds;
+    const f64 microseconds_per_tick =
+        elapsed_ticks > 0 ? (static_cast<f64>(elapsed_nanoseconds) / 1000.0) / static_cast<f64>(elapsed_ticks) : 0.0;
+
+    FormatBuilder::Specifier microseconds_specifier;
+    microseconds_specifier.type = FormatBuilder::Specifier::Type::Fixed;
+    microseconds_specifier.precision = 3;
+
+    FormatBuilder builder = FormatBuilder(string_builder);
+    builder.push_string("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["sv);
+
+    bool is_first_event = true;
+    const auto begin_event = [&builder, &is_first_event](StringView prefix)
+    {
+        builder.push_string(is_first_event ? "\n"sv : ",\n"sv);
+        builder.push_string(prefix);
+        is_first_event = false;
+    };
+
+    for (const Detail::ThreadProfile* profile : session.thread_profiles)
+    {
+        if (profile->session_id.load(std::memory_order_acquire) != session.last_session_id)
+            continue;
+
+        begin_event("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"sv);
+        builder.push_integer(profile->thread_index, IsNegative::No);
+        builder.push_string(",\"args\":{\"name\":\"Thread "sv);
+        builder.push_integer(profile->thread_index, IsNegative::No);
+        builder.push_string("\"}}"sv);
+
+        for (const Detail::ProfilingEventChunk* chunk = profile->first_chunk; chunk != nullptr;
+             chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            const u32 event_count = chunk->event_count.load(std::memory_order_acquire);
+            for (u32 event_index = 0; event_index < event_count; ++event_index)
+            {
+                const Detail::ProfilingEvent& event = chunk->events[event_index];
+                if (event.end_ticks > end_ticks)
+                    continue;
+
+                // The scopes that began before the session are clamped to its beginning.
+                u64 begin_ticks = event.begin_ticks;
+                if (begin_ticks < session.begin_ticks)
+                    begin_ticks = session.begin_ticks;
+                const f64 timestamp = static_cast<f64>(begin_ticks - session.begin_ticks) * microseconds_per_tick;
+                const f64 duration = static_cast<f64>(event.end_ticks - begin_ticks) * microseconds_per_tick;
+
+                begin_event("{\"name\":"sv);
+                Detail::push_json_string(builder, event.name);
+                builder.push_string(",\"ph\":\"X\",\"pid\":1,\"tid\":"sv);
+                builder.push_integer(profile->thread_index, IsNegative::No);
+                builder.push_string(",\"ts\":"sv);
+                builder.push_floating_point(timestamp, microseconds_specifier);
+                builder.push_string(",\"dur\":"sv);
+                builder.push_floating_point(duration, microseconds_specifier);
+                builder.push_string("}"sv);
+            }
+        }
+    }
+
+    builder.push_string("\n]}\n"sv);
+}
+
+ErrorOr<void> write_profiling_session_as_chrome_trace(StringView file_path)
+{
+    StringBuilder builder;
+    write_profiling_session_as_chrome_trace(builder);
+
+    // The path is copied in order to be null-terminated.
+    const String null_terminated_file_path = String(file_path);
+    FILE* file = fopen(null_terminated_file_path.characters(), "wb");
+    if (file == nullptr)
+        return Error::Code::FileOperationFailed;
+
+    const StringView trace = builder.to_view();
+    const usize written_byte_count = fwrite(trace.characters(), 1, trace.byte_count(), file);
+    const bool is_closed = fclose(file) == 0;
+    if (written_byte_count != trace.byte_count() || !is_closed)
+        return Error::Code::FileOperationFailed;
+    return {};
+}
+
+} // namespace AT
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Error.h"
+#include "AT/StringBuilder.h"
+
+#if AT_ARCHITECTURE_X86_64 && AT_COMPILER_MSVC
+extern "C" unsigned __int64 __rdtsc();
+    #pragma intrinsic(__rdtsc)
+#endif // AT_ARCHITECTURE_X86_64 && AT_COMPILER_MSVC
+
+//
+// The profiling instrumentation is only compiled when AT_ENABLE_PROFILING is set (by the ENABLE_PROFILING CMake
+// option). Otherwise, the profiling macros expand to nothing.
+//
+#ifndef AT_ENABLE_PROFILING
+    #define AT_ENABLE_PROFILING 0
+#endif // AT_ENABLE_PROFILING
+
+namespace AT
+{
+
+//
+// The events are only recorded while a profiling session is active. Beginning a session discards the events of
+// the previous one. The recorded events can be exported (after the session ends) in the Chrome trace event format,
+// which can be opened in Perfetto or in chrome://tracing.
+//
+AT_API void begin_profiling_session();
+AT_API void end_profiling_session();
+
+AT_API void write_profiling_session_as_chrome_trace(StringBuilder& builder);
+NODISCARD AT_API ErrorOr<void> write_profiling_session_as_chrome_trace(StringView file_path);
+
+namespace Detail
+{
+
+//
+// The timestamps are read from the time stamp counter, which is invariant (ticking at a constant rate, regardless of
+// the power state of the core) on all x86-64 processors from the last decade. The counter is converted to time
+// by measuring its rate against the monotonic system clock over the whole session.
+//
+#if AT_ARCHITECTURE_X86_64
+NODISCARD ALWAYS_INLINE inline u64 read_profiling_clock()
+{
+    #if AT_COMPILER_MSVC
+    return __rdtsc();
+    #else
+    return __builtin_ia32_rdtsc();
+    #endif // AT_COMPILER_MSVC
+}
+#else
+// Returns the monotonic system clock, in nanoseconds.
+NODISCARD AT_API u64 read_profiling_clock();
+#endif // AT_ARCHITECTURE_X86_64
+
+// The name must be a string that lives for the whole program (such as a string literal).
+AT_API void record_profiling_event(const char* name, u64 begin_ticks, u64 end_ticks);
+
+} // namespace Detail
+
+///
+/// Records the time between its construction and its destruction as a profiling event.
+/// Use the AT_PROFILE_SCOPE and AT_PROFILE_FUNCTION macros, which can be disabled at compile time.
+///
+class ProfilingScope
+{
+    AT_MAKE_NONCOPYABLE(ProfilingScope);
+    AT_MAKE_NONMOVABLE(ProfilingScope);
+
+public:
+    ALWAYS_INLINE explicit ProfilingScope(const char* name)
+        : m_name(name)
+        , m_begin_ticks(Detail::read_profiling_clock())
+    {
+    }
+
+    ALWAYS_INLINE ~ProfilingScope()
+    {
+        Detail::record_profiling_event(m_name, m_begin_ticks, Detail::read_profiling_clock());
+    }
+
+private:
+    const char* m_name;
+    u64 m_begin_ticks;
+};
+
+} // namespace AT
+
+#if AT_ENABLE_PROFILING
+    ///
+    /// Profiles the rest of the current scope. The name must be a string literal.
+    ///
+    #define AT_PROFILE_SCOPE(name) const ::AT::ProfilingScope CONCATENATE(at_profiling_scope_, __LINE__)(name)
+    #define AT_PROFILE_FUNCTION()  AT_PROFILE_SCOPE(AT_FUNCTION)
+#else
+    #define AT_PROFILE_SCOPE(name)
+    #define AT_PROFILE_FUNCTION()
+#endif // AT_ENABLE_PROFILING
+
+#if AT_INCLUDE_GLOBALLY
+using AT::begin_profiling_session;
+using AT::end_profiling_session;
+using AT::ProfilingScope;
+using AT::write_profiling_session_as_chrome_trace;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Span.h"
+
+#include <atomic>
+#include <new>
+
+namespace AT
+{
+
+///
+/// Bounded lock-free queue with a single producer thread and a single consumer thread. The elements are stored in
+/// a ring buffer inside the queue object, so a queue with a large capacity should be allocated on the heap.
+///
+/// The producer index and the consumer index live on separate cache lines. Each side also keeps a private copy of the
+/// index of the other side, which is only refreshed when the ring looks full (or empty), so most operations don't
+/// read the cache line written by the other thread.
+///
+template<typename T, usize Capacity>
+class SPSCQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+
+    AT_MAKE_NONCOPYABLE(SPSCQueue);
+    AT_MAKE_NONMOVABLE(SPSCQueue);
+
+public:
+    using ElementType = T;
+
+public:
+    SPSCQueue() = default;
+
+    ~SPSCQueue()
+    {
+        const usize tail = m_tail.load(std::memory_order_relaxed);
+        for (usize index = m_head.load(std::memory_order_relaxed); index != tail; ++index)
+            slot(index)->~T();
+    }
+
+public:
+    // Can only be called by the producer thread. Returns false if the queue is full.
+    template<typename... Args>
+    NODISCARD ALWAYS_INLINE bool try_emplace(Args&&... args)
+    {
+        const usize tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_producer_cached_head == Capacity)
+        {
+            m_producer_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_producer_cached_head == Capacity)
+                return false;
+        }
+
+        new (slot(tail)) T(forward<Args>(args)...);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    NODISCARD ALWAYS_INLINE bool try_push(const T& element) { return try_emplace(element); }
+    NODISCARD ALWAYS_INLINE bool try_push(T&& element) { return try_emplace(move(element)); }
+
+    // Can only be called by the producer thread. Moves as many elements as fit and returns their count.
+    NODISCARD usize try_push_batch(Span<T> elements)
+    {
+        const usize tail = m_tail.load(std::memory_order_relaxed);
+        if (Capacity - (tail - m_producer_cached_head) < elements.count())
+            m_producer_cached_head = m_head.load(std::memory_order_acquire);
+
+        const usize free_count = Capacity - (tail - m_producer_cached_head);
+        const usize push_count = elements.count() < free_count ? elements.count() : free_count;
+        for (usize index = 0; index < push_count; ++index)
+            new (slot(tail + index)) T(move(elements.unchecked_at(index)));
+
+        if (push_count > 0)
+            m_tail.store(tail + push_count, std::memory_order_release);
+        return push_count;
+    }
+
+    // Can only be called by the consumer thread. Returns false if the queue is empty.
+    NODISCARD ALWAYS_INLINE bool try_pop(T& out_element)
+    {
+        const usize head = m_head.load(std::memory_order_relaxed);
+        if (head == m_consumer_cached_tail)
+        {
+            m_consumer_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_consumer_cached_tail)
+                return false;
+        }
+
+        T* element = slot(head);
+        out_element = move(*element);
+        element->~T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Can only be called by the consumer thread. Moves as many elements as are available (up to the count of the
+    // destination span) and returns their count.
+    NODISCARD usize try_pop_batch(Span<T> out_elements)
+    {
+        const usize head = m_head.load(std::memory_order_relaxed);
+        if (m_consumer_cached_tail - head < out_elements.count())
+            m_consumer_cached_tail = m_tail.load(std::memory_order_acquire);
+
+        const usize available_count = m_consumer_cached_tail - head;
+        const usize pop_count = out_elements.count() < available_count ? out_elements.count() : available_count;
+        for (usize index = 0; index < pop_count; ++index)
+        {
+            T* element = slot(head + index);
+            out_elements.unchecked_at(index) = move(*element);
+            element->~T();
+        }
+
+        if (pop_count > 0)
+            m_head.store(head + pop_count, std::memory_order_release);
+        return pop_count;
+    }
+
+    // The count might be outdated by the time it is returned, if the other thread is using the queue.
+    NODISCARD ALWAYS_INLINE usize approximate_count() const
+    {
+        const usize head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    NODISCARD ALWAYS_INLINE static constexpr usize capacity() { return Capacity; }
+
+private:
+    NODISCARD ALWAYS_INLINE T* slot(usize index)
+    {
+        return reinterpret_cast<T*>(m_storage) + (index & (Capacity - 1));
+    }
+
+private:
+    // The indices increase forever (they are reduced modulo the capacity when accessing the storage).
+    alignas(64) std::atomic<usize> m_head = 0;
+    usize m_consumer_cached_tail = 0;
+
+    alignas(64) std::atomic<usize> m_tail = 0;
+    usize m_producer_cached_head = 0;
+
+    alignas(64) alignas(T) u8 m_storage[Capacity * sizeof(T)];
+};
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::SPSCQueue;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,803 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Allocator.h"
+#include "AT/Assertions.h"
+#include "AT/BitOperations.h"
+#include "AT/CoreTypes.h"
+#include "AT/MemoryOperations.h"
+#include "AT/Span.h"
+#include "AT/Vector.h"
+
+#include <new>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+// Below this count, the ranges are sorted with an insertion sort.
+constexpr usize InsertionSortThreshold = 24;
+// Above this count, the pivot is the median of three medians of three (Tukey's ninther).
+constexpr usize NintherThreshold = 128;
+// The number of element moves after which the partial insertion sort gives up.
+constexpr usize PartialInsertionSortMoveLimit = 8;
+// The branchless partitioning classifies the elements in blocks of this many elements.
+constexpr usize PartitionBlockSize = 64;
+// The merge sort starts by insertion sorting runs of this many elements.
+constexpr usize MergeSortRunLength = 32;
+// Below this count, the radix sort falls back to an insertion sort.
+constexpr usize RadixSortThreshold = 64;
+
+template<typename T>
+ALWAYS_INLINE inline void swap_elements(T& a, T& b)
+{
+    T temporary = move(a);
+    a = move(b);
+    b = move(temporary);
+}
+
+template<typename T, typename Compare>
+void insertion_sort(T* elements, usize count, Compare& compare)
+{
+    for (usize index = 1; index < count; ++index)
+    {
+        if (!compare(elements[index], elements[index - 1]))
+            continue;
+
+        T element = move(elements[index]);
+        usize slot_index = index;
+        do
+        {
+            elements[slot_index] = move(elements[slot_index - 1]);
+            --slot_index;
+        } while (slot_index > 0 && compare(element, elements[slot_index - 1]));
+        elements[slot_index] = move(element);
+    }
+}
+
+// The element before the range must not be greater than any element of the range, so it stops the shifting.
+template<typename T, typename Compare>
+void unguarded_insertion_sort(T* begin, T* end, Compare& compare)
+{
+    if (begin == end)
+        return;
+
+    for (T* current = begin + 1; current < end; ++current)
+    {
+        if (!compare(*current, *(current - 1)))
+            continue;
+
+        T element = move(*current);
+        T* slot = current;
+        do
+        {
+            *slot = move(*(slot - 1));
+            --slot;
+        } while (compare(element, *(slot - 1)));
+        *slot = move(element);
+    }
+}
+
+// Returns false (leaving the range partially sorted) if sorting the range requires too many moves.
+template<typename T, typename Compare>
+NODISCARD bool partial_insertion_sort(T* begin, T* end, Compare& compare)
+{
+    if (begin == end)
+        return true;
+
+    usize move_count = 0;
+    for (T* current = begin + 1; current < end; ++current)
+    {
+        if (!compare(*current, *(current - 1)))
+            continue;
+
+        T element = move(*current);
+        T* slot = current;
+        do
+        {
+            *slot = move(*(slot - 1));
+            --slot;
+        } while (slot != begin && compare(element, *(slot - 1)));
+        *slot = move(element);
+
+        move_count += static_cast<usize>(current - slot);
+        if (move_count > PartialInsertionSortMoveLimit)
+            return false;
+    }
+    return true;
+}
+
+template<typename T, typename Compare>
+void sift_down(T* elements, usize index, usize count, Compare& compare)
+{
+    T element = move(elements[index]);
+    while (true)
+    {
+        usize child_index = 2 * index + 1;
+        if (child_index >= count)
+            break;
+        if (child_index + 1 < count && compare(elements[child_index], elements[child_index + 1]))
+            ++child_index;
+        if (!compare(element, elements[child_index]))
+            break;
+
+        elements[index] = move(elements[child_index]);
+        index = child_index;
+    }
+    elements[index] = move(element);
+}
+
+template<typename T, typename Compare>
+void heap_sort(T* elements, usize count, Compare& compare)
+{
+    for (usize index = count / 2; index > 0; --index)
+        sift_down(elements, index - 1, count, compare);
+    for (usize end = count - 1; end > 0; --end)
+    {
+        swap_elements(elements[0], elements[end]);
+        sift_down(elements, 0, end, compare);
+    }
+}
+
+template<typename T, typename Compare>
+ALWAYS_INLINE inline void sort_two(T* a, T* b, Compare& compare)
+{
+    if (compare(*b, *a))
+        swap_elements(*a, *b);
+}
+
+template<typename T, typename Compare>
+ALWAYS_INLINE inline void sort_three(T* a, T* b, T* c, Compare& compare)
+{
+    sort_two(a, b, compare);
+    sort_two(b, c, compare);
+    sort_two(a, b, compare);
+}
+
+template<typename T>
+struct PartitionResult
+{
+    T* pivot;
+    // True if no element had to be moved, which hints that the range might already be sorted.
+    bool was_already_partitioned;
+};
+
+//
+// Partitions the range around its first element (the pivot), placing the elements that are equal to the pivot on
+// the right side. Returns the final position of the pivot. The element before the range (if any) must not be greater
+// than the pivot, and the last element of the range must not be less than it, so the scans need no bounds checks.
+//
+template<typename T, typename Compare>
+NODISCARD PartitionResult<T> partition_right(T* begin, T* end, Compare& compare)
+{
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    while (compare(*++first, pivot))
+        ;
+    if (first - 1 == begin)
+    {
+        while (first < last && !compare(*--last, pivot))
+            ;
+    }
+    else
+    {
+        while (!compare(*--last, pivot))
+            ;
+    }
+
+    const bool was_already_partitioned = first >= last;
+    while (first < last)
+    {
+        swap_elements(*first, *last);
+        while (compare(*++first, pivot))
+            ;
+        while (!compare(*--last, pivot))
+            ;
+    }
+
+    T* pivot_position = first - 1;
+    *begin = move(*pivot_position);
+    *pivot_position = move(pivot);
+    return { pivot_position, was_already_partitioned };
+}
+
+//
+// Moves the misplaced elements at the given offsets from the left base to the misplaced elements at the given offsets
+// from the right base, and the other way around. The elements are rotated through a single temporary, which takes
+// fewer moves than swapping them in pairs.
+//
+template<typename T>
+ALWAYS_INLINE inline void
+swap_partition_offsets(T* left_base, T* right_base, const u8* left_offsets, const u8* right_offsets, usize count)
+{
+    if (count == 0)
+        return;
+
+    T* left = left_base + left_offsets[0];
+    T* right = right_base - right_offsets[0];
+    T temporary = move(*left);
+    *left = move(*right);
+    for (usize index = 1; index < count; ++index)
+    {
+        left = left_base + left_offsets[index];
+        *right = move(*left);
+        right = right_base - right_offsets[index];
+        *left = move(*right);
+    }
+    *right = move(temporary);
+}
+
+//
+// Same as partition_right, but the comparisons don't decide any branch: the elements are classified in blocks, by
+// writing the offset of every element and advancing the write position by the result of its comparison. The
+// misplaced elements are then swapped in bulk. This removes the branch mispredictions on random inputs (see Edelkamp
+// and Weiß, "BlockQuicksort: Avoiding Branch Mispredictions in Quicksort").
+//
+template<typename T, typename Compare>
+NODISCARD PartitionResult<T> partition_right_branchless(T* begin, T* end, Compare& compare)
+{
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    while (compare(*++first, pivot))
+        ;
+    if (first - 1 == begin)
+    {
+        while (first < last && !compare(*--last, pivot))
+            ;
+    }
+    else
+    {
+        while (!compare(*--last, pivot))
+            ;
+    }
+
+    const bool was_already_partitioned = first >= last;
+    if (!was_already_partitioned)
+    {
+        swap_elements(*first, *last);
+        ++first;
+
+        alignas(64) u8 left_offsets[PartitionBlockSize];
+        alignas(64) u8 right_offsets[PartitionBlockSize];
+        T* left_base = first;
+        T* right_base = last;
+        usize left_count = 0;
+        usize right_count = 0;
+        usize left_start = 0;
+        usize right_start = 0;
+
+        while (first < last)
+        {
+            // Only the sides that have no pending misplaced elements are classified. When both sides are
+            // classified, the unknown elements are split evenly between them.
+            const usize unknown_count = static_cast<usize>(last - first);
+            const usize left_split = left_count == 0 ? (right_count == 0 ? unknown_count / 2 : unknown_count) : 0;
+            const usize right_split = right_count == 0 ? unknown_count - left_split : 0;
+
+            const usize left_block_count = left_split < PartitionBlockSize ? left_split : PartitionBlockSize;
+            for (usize index = 0; index < left_block_count; ++index)
+            {
+                left_offsets[left_count] = static_cast<u8>(index);
+                left_count += !compare(*first, pivot);
+                ++first;
+            }
+
+            const usize right_block_count = right_split < PartitionBlockSize ? right_split : PartitionBlockSize;
+            for (usize index = 0; index < right_block_count;)
+            {
+                right_offsets[right_count] = static_cast<u8>(++index);
+                right_count += compare(*--last, pivot);
+            }
+
+            const usize swap_count = left_count < right_count ? left_count : right_count;
+            swap_partition_offsets(
+                left_base, right_base, left_offsets + left_start, right_offsets + right_start, swap_count
+            );
+            left_count -= swap_count;
+            right_count -= swap_count;
+            left_start += swap_count;
+            right_start += swap_count;
+
+            if (left_count == 0)
+            {
+                left_start = 0;
+                left_base = first;
+            }
+            if (right_count == 0)
+            {
+                right_start = 0;
+                right_base = last;
+            }
+        }
+
+        // At most one side has misplaced elements left, which are moved next to the boundary.
+        if (left_count > 0)
+        {
+            while (left_count > 0)
+            {
+                --left_count;
+                swap_elements(*(left_base + left_offsets[left_start + left_count]), *--last);
+            }
+            first = last;
+        }
+        if (right_count > 0)
+        {
+            while (right_count > 0)
+            {
+                --right_count;
+                swap_elements(*(right_base - right_offsets[right_start + right_count]), *first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    T* pivot_position = first - 1;
+    *begin = move(*pivot_position);
+    *pivot_position = move(pivot);
+    return { pivot_position, was_already_partitioned };
+}
+
+//
+// Partitions the range around its first element, placing the elements that are equal to the pivot on the left side.
+// Only used when the pivot is equal to the element before the range, in which case no element of the range is less
+// than the pivot, and all the elements on the left side are equal to it (so they don't have to be sorted anymore).
+//
+template<typename T, typename Compare>
+NODISCARD T* partition_left(T* begin, T* end, Compare& compare)
+{
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    while (compare(pivot, *--last))
+        ;
+    if (last + 1 == end)
+    {
+        while (first < last && !compare(pivot, *++first))
+            ;
+    }
+    else
+    {
+        while (!compare(pivot, *++first))
+            ;
+    }
+
+    while (first < last)
+    {
+        swap_elements(*first, *last);
+        while (compare(pivot, *--last))
+            ;
+        while (!compare(pivot, *++first))
+            ;
+    }
+
+    T* pivot_position = last;
+    *begin = move(*pivot_position);
+    *pivot_position = move(pivot);
+    return pivot_position;
+}
+
+//
+// The pattern-defeating quicksort described by Orson Peters. A quicksort that recognizes the patterns which make
+// the quicksort degrade: the ranges of equal elements are partitioned once (see partition_left), the already sorted
+// ranges are detected by a bounded insertion sort after a partition that moved nothing, and the unbalanced partitions
+// shuffle a few elements to break the pattern that caused them. After too many unbalanced partitions, the range is
+// sorted with a heap sort, which bounds the worst case to O(n log n).
+//
+template<bool IsBranchless, typename T, typename Compare>
+void pattern_defeating_quicksort(T* begin, T* end, Compare& compare, u32 bad_partition_budget, bool is_leftmost)
+{
+    while (true)
+    {
+        const usize count = static_cast<usize>(end - begin);
+        if (count < InsertionSortThreshold)
+        {
+            if (is_leftmost)
+                insertion_sort(begin, count, compare);
+            else
+                unguarded_insertion_sort(begin, end, compare);
+            return;
+        }
+
+        // The pivot is moved to the first position.
+        const usize half_count = count / 2;
+        if (count > NintherThreshold)
+        {
+            sort_three(begin, begin + half_count, end - 1, compare);
+            sort_three(begin + 1, begin + (half_count - 1), end - 2, compare);
+            sort_three(begin + 2, begin + (half_count + 1), end - 3, compare);
+            sort_three(begin + (half_count - 1), begin + half_count, begin + (half_count + 1), compare);
+            swap_elements(*begin, *(begin + half_count));
+        }
+        else
+        {
+            sort_three(begin + half_count, begin, end - 1, compare);
+        }
+
+        // The element before the range is a pivot of an earlier partition, so it is not greater than any element of
+        // the range. If it is equal to the new pivot, the range has many equal elements.
+        if (!is_leftmost && !compare(*(begin - 1), *begin))
+        {
+            begin = partition_left(begin, end, compare) + 1;
+            continue;
+        }
+
+        const PartitionResult<T> partition_result =
+            IsBranchless ? partition_right_branchless(begin, end, compare) : partition_right(begin, end, compare);
+        T* pivot = partition_result.pivot;
+
+        const usize left_count = static_cast<usize>(pivot - begin);
+        const usize right_count = static_cast<usize>(end - (pivot + 1));
+        const bool is_highly_unbalanced = left_count < count / 8 || right_count < count / 8;
+
+        if (is_highly_unbalanced)
+        {
+            if (--bad_partition_budget == 0)
+            {
+                heap_sort(begin, count, compare);
+                return;
+            }
+
+            if (left_count >= InsertionSortThreshold)
+            {
+                swap_elements(*begin, *(begin + left_count / 4));
+                swap_elements(*(pivot - 1), *(pivot - left_count / 4));
+                if (left_count > NintherThreshold)
+                {
+                    swap_elements(*(begin + 1), *(begin + (left_count / 4 + 1)));
+                    swap_elements(*(begin + 2), *(begin + (left_count / 4 + 2)));
+                    swap_elements(*(pivot - 2), *(pivot - (left_count / 4 + 1)));
+                    swap_elements(*(pivot - 3), *(pivot - (left_count / 4 + 2)));
+                }
+            }
+            if (right_count >= InsertionSortThreshold)
+            {
+                swap_elements(*(pivot + 1), *(pivot + (1 + right_count / 4)));
+                swap_elements(*(end - 1), *(end - right_count / 4));
+                if (right_count > NintherThreshold)
+                {
+                    swap_elements(*(pivot + 2), *(pivot + (2 + right_count / 4)));
+                    swap_elements(*(pivot + 3), *(pivot + (3 + right_count / 4)));
+                    swap_elements(*(end - 2), *(end - (1 + right_count / 4)));
+                    swap_elements(*(end - 3), *(end - (2 + right_count / 4)));
+                }
+            }
+        }
+        else if (partition_result.was_already_partitioned && partial_insertion_sort(begin, pivot, compare) &&
+                 partial_insertion_sort(pivot + 1, end, compare))
+        {
+            return;
+        }
+
+        // Recursing into the left side and looping on the right side bounds the recursion depth.
+        pattern_defeating_quicksort<IsBranchless>(begin, pivot, compare, bad_partition_budget, is_leftmost);
+        begin = pivot + 1;
+        is_leftmost = false;
+    }
+}
+
+// The merge is stable: the elements of the left run come before the equal elements of the right run.
+template<typename T, typename Compare>
+void merge_runs(T* left, usize left_count, T* right, usize right_count, T* destination, Compare& compare)
+{
+    T* left_end = left + left_count;
+    T* right_end = right + right_count;
+
+    // The runs of an already sorted range don't interleave, so they are only concatenated.
+    const bool are_runs_ordered = left_count == 0 || right_count == 0 || !compare(*right, *(left_end - 1));
+    while (!are_runs_ordered && left != left_end && right != right_end)
+    {
+        if (compare(*right, *left))
+            *destination++ = move(*right++);
+        else
+            *destination++ = move(*left++);
+    }
+    while (left != left_end)
+        *destination++ = move(*left++);
+    while (right != right_end)
+        *destination++ = move(*right++);
+}
+
+// Returns how many of the first `diagonal` elements of the stable merge of the two runs come from the left run.
+template<typename T, typename Compare>
+NODISCARD usize
+find_merge_split(const T* left, usize left_count, const T* right, usize right_count, usize diagonal, Compare& compare)
+{
+    usize low = diagonal > right_count ? diagonal - right_count : 0;
+    usize high = diagonal < left_count ? diagonal : left_count;
+    while (low < high)
+    {
+        const usize middle = low + (high - low) / 2;
+        if (compare(right[diagonal - middle - 1], left[middle]))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+// Sorts the elements, using the buffer (which holds the same number of constructed elements) as scratch space.
+template<typename T, typename Compare>
+void merge_sort(T* elements, T* buffer, usize count, Compare& compare)
+{
+    for (usize begin = 0; begin < count; begin += MergeSortRunLength)
+    {
+        const usize run_count = count - begin < MergeSortRunLength ? count - begin : MergeSortRunLength;
+        insertion_sort(elements + begin, run_count, compare);
+    }
+
+    T* source = elements;
+    T* destination = buffer;
+    for (usize run_count = MergeSortRunLength; run_count < count; run_count *= 2)
+    {
+        for (usize begin = 0; begin < count; begin += 2 * run_count)
+        {
+            const usize middle = count - begin > run_count ? begin + run_count : count;
+            const usize end = count - middle > run_count ? middle + run_count : count;
+            merge_runs(source + begin, middle - begin, source + middle, end - middle, destination + begin, compare);
+        }
+
+        T* previous_source = source;
+        source = destination;
+        destination = previous_source;
+    }
+
+    if (source != elements)
+    {
+        for (usize index = 0; index < count; ++index)
+            elements[index] = move(source[index]);
+    }
+}
+
+// The type of the payloads of the radix sort that only sorts keys.
+struct NoRadixSortPayload
+{
+};
+
+template<typename Key, typename Payload>
+void radix_sort(Key* keys, Payload* payloads, usize count)
+{
+    static_assert(IsSame<Key, u32> || IsSame<Key, u64>, "The radix sort only supports u32 and u64 keys");
+    static_assert(IsTriviallyCopyable<Payload>, "The radix sort only supports trivially copyable payloads");
+    constexpr bool HasPayloads = !IsSame<Payload, NoRadixSortPayload>;
+    constexpr usize DigitCount = sizeof(Key);
+
+    if (count < RadixSortThreshold)
+    {
+        for (usize index = 1; index < count; ++index)
+        {
+            const Key key = keys[index];
+            Payload payload;
+            if constexpr (HasPayloads)
+                payload = payloads[index];
+
+            usize slot_index = index;
+            while (slot_index > 0 && key < keys[slot_index - 1])
+            {
+                keys[slot_index] = keys[slot_index - 1];
+                if constexpr (HasPayloads)
+                    payloads[slot_index] = payloads[slot_index - 1];
+                --slot_index;
+            }
+            keys[slot_index] = key;
+            if constexpr (HasPayloads)
+                payloads[slot_index] = payload;
+        }
+        return;
+    }
+
+    // The histograms of all digits are computed by a single pass over the keys.
+    usize histograms[DigitCount][256] = {};
+    for (usize index = 0; index < count; ++index)
+    {
+        const Key key = keys[index];
+        for (usize digit_index = 0; digit_index < DigitCount; ++digit_index)
+            ++histograms[digit_index][(key >> (8 * digit_index)) & 0xFF];
+    }
+
+    MUST_ASSIGN(void* key_buffer_memory, HeapAllocator::try_allocate_from_heap(count * sizeof(Key), alignof(Key)));
+    Key* source_keys = keys;
+    Key* destination_keys = static_cast<Key*>(key_buffer_memory);
+
+    Payload* source_payloads = payloads;
+    Payload* destination_payloads = nullptr;
+    if constexpr (HasPayloads)
+    {
+        MUST_ASSIGN(
+            void* payload_buffer_memory,
+            HeapAllocator::try_allocate_from_heap(count * sizeof(Payload), alignof(Payload))
+        );
+        destination_payloads = static_cast<Payload*>(payload_buffer_memory);
+    }
+
+    for (usize digit_index = 0; digit_index < DigitCount; ++digit_index)
+    {
+        // A digit that is the same for all keys doesn't change the order, so its pass is skipped.
+        usize* histogram = histograms[digit_index];
+        const u32 shift = static_cast<u32>(8 * digit_index);
+        if (histogram[(source_keys[0] >> shift) & 0xFF] == count)
+            continue;
+
+        usize offsets[256];
+        usize offset = 0;
+        for (usize digit = 0; digit < 256; ++digit)
+        {
+            offsets[digit] = offset;
+            offset += histogram[digit];
+        }
+
+        for (usize index = 0; index < count; ++index)
+        {
+            const Key key = source_keys[index];
+            const usize destination_index = offsets[(key >> shift) & 0xFF]++;
+            destination_keys[destination_index] = key;
+            if constexpr (HasPayloads)
+                destination_payloads[destination_index] = source_payloads[index];
+        }
+
+        Key* previous_source_keys = source_keys;
+        source_keys = destination_keys;
+        destination_keys = previous_source_keys;
+        if constexpr (HasPayloads)
+        {
+            Payload* previous_source_payloads = source_payloads;
+            source_payloads = destination_payloads;
+            destination_payloads = previous_source_payloads;
+        }
+    }
+
+    // After an odd number of passes, the sorted elements are in the buffers.
+    Key* key_buffer = static_cast<Key*>(key_buffer_memory);
+    if (source_keys != keys)
+    {
+        copy_memory(keys, source_keys, count * sizeof(Key));
+        if constexpr (HasPayloads)
+            copy_memory(payloads, source_payloads, count * sizeof(Payload));
+    }
+
+    HeapAllocator::release_to_heap(key_buffer, count * sizeof(Key), alignof(Key));
+    if constexpr (HasPayloads)
+    {
+        Payload* payload_buffer = source_payloads != payloads ? source_payloads : destination_payloads;
+        HeapAllocator::release_to_heap(payload_buffer, count * sizeof(Payload), alignof(Payload));
+    }
+}
+
+} // namespace Detail
+
+//
+// Sorts the elements in the order given by the less-than comparison, with the pattern-defeating quicksort. The sort is
+// not stable, doesn't allocate memory and runs in O(n log n) time in the worst case. The sorted and reverse sorted
+// ranges, and the ranges with few distinct elements, are sorted in close to linear time. The trivially copyable
+// elements are partitioned without branching on the comparisons.
+//
+template<typename T, typename Compare>
+void sort(Span<T> span, Compare&& compare)
+{
+    const usize count = span.count();
+    if (count < 2)
+        return;
+
+    T* elements = span.elements();
+    const u32 bad_partition_budget = 63 - count_leading_zeroes(static_cast<u64>(count));
+    Detail::pattern_defeating_quicksort<IsTriviallyCopyable<T>>(
+        elements, elements + count, compare, bad_partition_budget, true
+    );
+}
+
+template<typename T>
+ALWAYS_INLINE inline void sort(Span<T> span)
+{
+    sort(span, [](const T& a, const T& b) { return a < b; });
+}
+
+template<typename T, usize InlineCapacity, typename Compare>
+ALWAYS_INLINE inline void sort(Vector<T, InlineCapacity>& vector, Compare&& compare)
+{
+    sort(vector.span(), forward<Compare>(compare));
+}
+
+template<typename T, usize InlineCapacity>
+ALWAYS_INLINE inline void sort(Vector<T, InlineCapacity>& vector)
+{
+    sort(vector.span());
+}
+
+//
+// Sorts the elements in the order given by the less-than comparison, keeping the equal elements in their original
+// order, with a merge sort. A scratch buffer, as large as the span, is allocated from the heap.
+//
+template<typename T, typename Compare>
+void stable_sort(Span<T> span, Compare&& compare)
+{
+    const usize count = span.count();
+    T* elements = span.elements();
+    if (count <= Detail::MergeSortRunLength)
+    {
+        Detail::insertion_sort(elements, count, compare);
+        return;
+    }
+
+    MUST_ASSIGN(void* buffer_memory, HeapAllocator::try_allocate_from_heap(count * sizeof(T), alignof(T)));
+    T* buffer = static_cast<T*>(buffer_memory);
+
+    if constexpr (IsTriviallyCopyable<T>)
+    {
+        // The elements of the buffer don't have to be constructed in order to be assigned.
+        Detail::merge_sort(elements, buffer, count, compare);
+    }
+    else
+    {
+        // The elements are moved into the buffer, so that the elements of both arrays are constructed and can be
+        // move-assigned by the merges.
+        for (usize index = 0; index < count; ++index)
+            new (buffer + index) T(move(elements[index]));
+        Detail::merge_sort(buffer, elements, count, compare);
+        for (usize index = 0; index < count; ++index)
+        {
+            elements[index] = move(buffer[index]);
+            buffer[index].~T();
+        }
+    }
+
+    HeapAllocator::release_to_heap(buffer, count * sizeof(T), alignof(T));
+}
+
+template<typename T>
+ALWAYS_INLINE inline void stable_sort(Span<T> span)
+{
+    stable_sort(span, [](const T& a, const T& b) { return a < b; });
+}
+
+template<typename T, usize InlineCapacity, typename Compare>
+ALWAYS_INLINE inline void stable_sort(Vector<T, InlineCapacity>& vector, Compare&& compare)
+{
+    stable_sort(vector.span(), forward<Compare>(compare));
+}
+
+template<typename T, usize InlineCapacity>
+ALWAYS_INLINE inline void stable_sort(Vector<T, InlineCapacity>& vector)
+{
+    stable_sort(vector.span());
+}
+
+//
+// Sorts the keys in increasing order with a least significant digit radix sort, which processes one byte of the keys
+// per pass and skips the bytes that are the same for all keys. The sort is stable and runs in linear time. Scratch
+// buffers, as large as the spans, are allocated from the heap.
+//
+// The keys are unsigned integers. The signed integers and the floating point numbers can be sorted by mapping them to
+// unsigned keys that have the same order.
+//
+template<typename Key>
+ALWAYS_INLINE inline void radix_sort(Span<Key> keys)
+{
+    Detail::radix_sort<Key, Detail::NoRadixSortPayload>(keys.elements(), nullptr, keys.count());
+}
+
+// Sorts the keys, and reorders the payloads (the satellite data of the keys) the same way.
+template<typename Key, typename Payload>
+ALWAYS_INLINE inline void radix_sort(Span<Key> keys, Span<Payload> payloads)
+{
+    VERIFY_ALWAYS(keys.count() == payloads.count());
+    Detail::radix_sort<Key, Payload>(keys.elements(), payloads.elements(), keys.count());
+}
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::radix_sort;
+using AT::sort;
+using AT::stable_sort;
+#endif // AT_INCLUDE_GLOBALLY
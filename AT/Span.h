@@ -7,6 +7,7 @@
 
 #include "AT/Assertions.h"
 #include "AT/CoreTypes.h"
+#include "AT/TypeTraits.h"
 
 namespace AT
 {
@@ -62,6 +63,11 @@ public:
     NODISCARD ALWAYS_INLINE T& operator[](usize index) { return at(index); }
     NODISCARD ALWAYS_INLINE const T& operator[](usize index) const { return at(index); }
 
+    // Doesn't check the index, regardless of the checking level. Only meant for the loops that already proved their
+    // indices to be in bounds.
+    NODISCARD ALWAYS_INLINE T& unchecked_at(usize index) { return m_elements[index]; }
+    NODISCARD ALWAYS_INLINE const T& unchecked_at(usize index) const { return m_elements[index]; }
+
 public:
     NODISCARD ALWAYS_INLINE T* elements() { return m_elements; }
     NODISCARD ALWAYS_INLINE const T* elements() const { return m_elements; }
@@ -95,6 +101,17 @@ private:
     usize m_count;
 };
 
+// The spans are hashed by their contents, not by their address.
+template<typename T>
+struct TypeTraits<Span<T>>
+{
+    NODISCARD ALWAYS_INLINE static u64 get_hash(const Span<T>& span)
+    {
+        static_assert(IsTriviallyHashable<RemoveConst<T>>, "Only spans of trivially hashable types can be hashed");
+        return hash_bytes(span.elements(), span.byte_count());
+    }
+};
+
 } // namespace AT
 
 #if AT_INCLUDE_GLOBALLY
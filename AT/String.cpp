@@ -6,45 +6,46 @@
 #include "AT/String.h"
 #include "AT/MemoryOperations.h"
 
+#include <atomic>
+
 namespace AT
 {
 
+struct String::HeapHeader
+{
+    Allocator* allocator;
+    // Only used by shared buffers. Non-atomic shared buffers only use relaxed loads and stores.
+    std::atomic<usize> reference_count;
+};
+
+String String::create_shared(StringView view, StringSharing sharing, Allocator* allocator)
+{
+    String string;
+    string.initialize_from(view.characters(), view.byte_count() + 1, allocator, sharing);
+    return string;
+}
+
 String::String(const String& other)
-    : m_byte_count(other.m_byte_count)
 {
-    if (other.is_stored_inline())
-    {
-        copy_memory(m_inline_characters, other.m_inline_characters, m_byte_count);
-    }
-    else
-    {
-        MUST_ASSIGN(m_heap_characters, allocate_memory(m_byte_count));
-        copy_memory(m_heap_characters, other.m_heap_characters, m_byte_count);
-    }
+    copy_from(other);
 }
 
 String::String(String&& other) noexcept
-    : m_byte_count(other.m_byte_count)
-    , m_heap_characters(other.m_heap_characters)
 {
-    other.m_heap_characters = nullptr;
-    other.m_byte_count = 1;
+    // The ownership of the heap buffer (or the reference to the shared buffer) is transferred.
+    copy_memory(m_inline_characters, other.m_inline_characters, InlineCapacity);
+    other.m_inline_characters[0] = 0;
+    other.set_inline_byte_count(1);
 }
 
 String::String(StringView view)
-    : m_byte_count(view.byte_count() + 1)
+    : String(view, nullptr)
 {
-    if (is_stored_inline())
-    {
-        copy_memory(m_inline_characters, view.characters(), view.byte_count());
-        m_inline_characters[m_byte_count - 1] = 0;
-    }
-    else
-    {
-        MUST_ASSIGN(m_heap_characters, allocate_memory(m_byte_count));
-        copy_memory(m_heap_characters, view.characters(), view.byte_count());
-        m_heap_characters[m_byte_count - 1] = 0;
-    }
+}
+
+String::String(StringView view, Allocator* allocator)
+{
+    initialize_from(view.characters(), view.byte_count() + 1, allocator, StringSharing::None);
 }
 
 String& String::operator=(const String& other)
@@ -52,47 +53,18 @@ String& String::operator=(const String& other)
     if (this == &other)
         return *this;
 
-    char* destination_buffer;
-    const char* source_buffer;
-
-    if (is_stored_inline())
+    if (is_stored_on_heap() && other.is_stored_on_heap() && m_heap.sharing == StringSharing::None &&
+        other.m_heap.sharing == StringSharing::None && m_heap.byte_count == other.m_heap.byte_count)
     {
-        if (other.is_stored_inline())
-        {
-            destination_buffer = m_inline_characters;
-            source_buffer = other.m_inline_characters;
-        }
-        else
-        {
-            MUST_ASSIGN(m_heap_characters, allocate_memory(other.m_byte_count));
-            destination_buffer = m_heap_characters;
-            source_buffer = other.m_heap_characters;
-        }
-    }
-    else
-    {
-        if (other.is_stored_inline())
-        {
-            MUST(release_memory(m_heap_characters, m_byte_count));
-            destination_buffer = m_inline_characters;
-            source_buffer = other.m_inline_characters;
-        }
-        else
-        {
-            if (m_byte_count != other.m_byte_count)
-            {
-                MUST(release_memory(m_heap_characters, m_byte_count));
-                MUST_ASSIGN(m_heap_characters, allocate_memory(other.m_byte_count));
-            }
-
-            destination_buffer = m_heap_characters;
-            source_buffer = other.m_heap_characters;
-        }
+        // The current heap buffer has the exact required size, so it is reused.
+        copy_memory(m_heap.characters, other.m_heap.characters, m_heap.byte_count);
+        return *this;
     }
 
-    m_byte_count = other.m_byte_count;
-    copy_memory(destination_buffer, source_buffer, m_byte_count);
-
+    // NOTE: If both strings reference the same shared buffer, the reference count is incremented
+    // by copy_from() before it is decremented, so the buffer is never released prematurely.
+    String previous = move(*this);
+    copy_from(other);
     return *this;
 }
 
@@ -101,101 +73,207 @@ String& String::operator=(String&& other) noexcept
     if (this == &other)
         return *this;
 
-    if (is_stored_on_heap())
-        MUST(release_memory(m_heap_characters, m_byte_count));
-
-    m_byte_count = other.m_byte_count;
-    m_heap_characters = other.m_heap_characters;
+    release_heap_buffer_if_any();
 
-    other.m_heap_characters = nullptr;
-    other.m_byte_count = 1;
+    copy_memory(m_inline_characters, other.m_inline_characters, InlineCapacity);
+    other.m_inline_characters[0] = 0;
+    other.set_inline_byte_count(1);
 
     return *this;
 }
 
 String& String::operator=(StringView view)
 {
-    char* destination_buffer;
     const usize source_byte_count = view.byte_count() + 1;
 
-    if (is_stored_inline())
+    if (is_stored_on_heap() && m_heap.sharing == StringSharing::None && m_heap.byte_count == source_byte_count)
     {
-        if (source_byte_count <= InlineCapacity)
-        {
-            destination_buffer = m_inline_characters;
-        }
-        else
-        {
-            MUST_ASSIGN(m_heap_characters, allocate_memory(source_byte_count));
-            destination_buffer = m_heap_characters;
-        }
+        // The current heap buffer has the exact required size, so it is reused.
+        copy_memory(m_heap.characters, view.characters(), view.byte_count());
+        m_heap.characters[source_byte_count - 1] = 0;
+        return *this;
     }
-    else
+
+    if (is_stored_inline())
     {
+        // NOTE: The view might point into the inline storage (in which case it always fits inline), so the
+        // characters are moved instead of copied. There is no heap buffer to release.
         if (source_byte_count <= InlineCapacity)
         {
-            MUST(release_memory(m_heap_characters, m_byte_count));
-            destination_buffer = m_inline_characters;
+            move_memory(m_inline_characters, view.characters(), view.byte_count());
+            m_inline_characters[source_byte_count - 1] = 0;
+            set_inline_byte_count(source_byte_count);
+            return *this;
         }
-        else
-        {
-            if (m_byte_count != source_byte_count)
-            {
-                MUST(release_memory(m_heap_characters, m_byte_count));
-                MUST_ASSIGN(m_heap_characters, allocate_memory(source_byte_count));
-            }
 
-            destination_buffer = m_heap_characters;
-        }
+        initialize_from(view.characters(), source_byte_count, nullptr, StringSharing::None);
+        return *this;
     }
 
-    m_byte_count = source_byte_count;
-    copy_memory(destination_buffer, view.characters(), view.byte_count());
-    destination_buffer[m_byte_count - 1] = 0;
+    // The new buffer is acquired from the same allocator as the current one, and it is shared in the same way.
+    // NOTE: The view might point into the current heap buffer, so it is released only after the copy is made.
+    String previous = move(*this);
+    initialize_from(view.characters(), source_byte_count, previous.allocator(), previous.sharing());
 
     return *this;
 }
 
 String::~String()
 {
-    if (is_stored_on_heap())
-        MUST(release_memory(m_heap_characters, m_byte_count));
+    release_heap_buffer_if_any();
 }
 
-void String::set_internal_heap_buffer(char* heap_characters, usize byte_count)
+Allocator* String::allocator() const
 {
-    VERIFY(byte_count > InlineCapacity);
-
-    if (is_stored_on_heap())
-        MUST(release_memory(m_heap_characters, m_byte_count));
-
-    m_heap_characters = heap_characters;
-    m_byte_count = byte_count;
+    if (is_stored_inline())
+        return nullptr;
+    return get_heap_header(m_heap.characters)->allocator;
 }
 
 void String::set_internal_inline_buffer(const char* inline_characters, usize byte_count)
 {
-    VERIFY(byte_count <= InlineCapacity);
-    if (is_stored_on_heap())
-        MUST(release_memory(m_heap_characters, m_byte_count));
+    VERIFY(byte_count > 0 && byte_count <= InlineCapacity);
+    release_heap_buffer_if_any();
 
     copy_memory(m_inline_characters, inline_characters, byte_count);
-    m_byte_count = byte_count;
+    set_inline_byte_count(byte_count);
 }
 
-ErrorOr<char*> String::allocate_memory(usize byte_count)
+char* String::replace_with_uninitialized(usize byte_count)
 {
-    void* memory = ::operator new(byte_count);
-    if (!memory)
-        return Error::Code::OutOfMemory;
+    release_heap_buffer_if_any();
 
-    return reinterpret_cast<char*>(memory);
+    char* characters;
+    if (byte_count + 1 <= InlineCapacity)
+    {
+        characters = m_inline_characters;
+        set_inline_byte_count(byte_count + 1);
+    }
+    else
+    {
+        MUST_ASSIGN(characters, allocate_memory(byte_count + 1, nullptr));
+        set_heap_buffer(characters, byte_count + 1, StringSharing::None);
+    }
+
+    characters[byte_count] = 0;
+    return characters;
+}
+
+// NOTE: The byte count includes the null-termination byte, which is not read from the source characters.
+void String::initialize_from(const char* characters, usize byte_count, Allocator* allocator, StringSharing sharing)
+{
+    if (byte_count <= InlineCapacity)
+    {
+        copy_memory(m_inline_characters, characters, byte_count - 1);
+        m_inline_characters[byte_count - 1] = 0;
+        set_inline_byte_count(byte_count);
+    }
+    else
+    {
+        MUST_ASSIGN(char* heap_characters, allocate_memory(byte_count, allocator));
+        copy_memory(heap_characters, characters, byte_count - 1);
+        heap_characters[byte_count - 1] = 0;
+        set_heap_buffer(heap_characters, byte_count, sharing);
+    }
+}
+
+void String::copy_from(const String& other)
+{
+    if (other.is_stored_inline())
+    {
+        // Copying the entire storage also copies the tag, so the byte count doesn't have to be computed.
+        copy_memory(m_inline_characters, other.m_inline_characters, InlineCapacity);
+        return;
+    }
+
+    switch (other.m_heap.sharing)
+    {
+        case StringSharing::None:
+            initialize_from(other.m_heap.characters, other.m_heap.byte_count, other.allocator(), StringSharing::None);
+            break;
+
+        case StringSharing::NonAtomic:
+        {
+            std::atomic<usize>& reference_count = get_heap_header(other.m_heap.characters)->reference_count;
+            reference_count.store(reference_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            copy_memory(m_inline_characters, other.m_inline_characters, InlineCapacity);
+            break;
+        }
+
+        case StringSharing::Atomic:
+            get_heap_header(other.m_heap.characters)->reference_count.fetch_add(1, std::memory_order_relaxed);
+            copy_memory(m_inline_characters, other.m_inline_characters, InlineCapacity);
+            break;
+    }
+}
+
+void String::release_heap_buffer_if_any()
+{
+    if (is_stored_inline())
+        return;
+
+    switch (m_heap.sharing)
+    {
+        case StringSharing::None:
+            break;
+
+        case StringSharing::NonAtomic:
+        {
+            std::atomic<usize>& reference_count = get_heap_header(m_heap.characters)->reference_count;
+            const usize new_reference_count = reference_count.load(std::memory_order_relaxed) - 1;
+            reference_count.store(new_reference_count, std::memory_order_relaxed);
+            if (new_reference_count > 0)
+                return;
+            break;
+        }
+
+        case StringSharing::Atomic:
+        {
+            // The release-acquire pair ensures that all accesses to the buffer made through other strings
+            // happen before the buffer is released.
+            std::atomic<usize>& reference_count = get_heap_header(m_heap.characters)->reference_count;
+            if (reference_count.fetch_sub(1, std::memory_order_acq_rel) > 1)
+                return;
+            break;
+        }
+    }
+
+    MUST(release_memory(m_heap.characters, m_heap.byte_count));
+}
+
+void String::detach_shared_buffer()
+{
+    // The buffer can be mutated in place if no other string references it.
+    const usize reference_count = get_heap_header(m_heap.characters)->reference_count.load(std::memory_order_acquire);
+    if (reference_count == 1)
+        return;
+
+    String previous = move(*this);
+    initialize_from(previous.m_heap.characters, previous.m_heap.byte_count, previous.allocator(), previous.sharing());
+}
+
+ErrorOr<char*> String::allocate_memory(usize byte_count, Allocator* allocator)
+{
+    TRY_ASSIGN(void* memory, try_allocate_from(allocator, sizeof(HeapHeader) + byte_count, alignof(HeapHeader)));
+
+    HeapHeader* header = new (memory) HeapHeader();
+    header->allocator = allocator;
+    header->reference_count.store(1, std::memory_order_relaxed);
+    return reinterpret_cast<char*>(header + 1);
 }
 
 ErrorOr<void> String::release_memory(char* characters, usize byte_count)
 {
-    ::operator delete(characters, byte_count);
+    HeapHeader* header = get_heap_header(characters);
+    Allocator* allocator = header->allocator;
+    header->~HeapHeader();
+    release_to(allocator, header, sizeof(HeapHeader) + byte_count, alignof(HeapHeader));
     return {};
 }
 
+String::HeapHeader* String::get_heap_header(char* characters)
+{
+    return reinterpret_cast<HeapHeader*>(characters) - 1;
+}
+
 } // namespace AT
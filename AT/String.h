@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "AT/Allocator.h"
 #include "AT/CoreTypes.h"
 #include "AT/Error.h"
 #include "AT/StringView.h"
@@ -12,28 +13,57 @@
 namespace AT
 {
 
+//
+// Describes whether the heap buffer of a string is owned by a single string or shared between
+// all of its copies. Shared buffers are immutable: copying the string only increments a reference
+// count, while requesting mutable access to the characters first copies them to a private buffer.
+//
+enum class StringSharing : u8
+{
+    // The heap buffer is owned by a single string, and copies are deep.
+    None = 0,
+    // The heap buffer is shared, but the strings that reference it must be used from a single thread.
+    NonAtomic,
+    // The heap buffer is shared and the strings that reference it can be used from multiple threads.
+    Atomic,
+};
+
 //
 // Container that stored a UTF-8 encoded, null-terminated string.
 // Depending on the size and the platform, the string might be stored inline. In
 // this case, no memory allocation is performed. Otherwise, the memory is dynamically
-// allocated from the heap.
+// allocated from the allocator that was specified when the string was created, or from
+// the global heap if no allocator was specified. The copies of a string use the same
+// allocator as the original one.
+//
+// By default, each string owns its heap buffer. Strings created with create_shared() share their
+// heap buffer with all their copies instead (see StringSharing).
 //
 class String
 {
 public:
+    // The total size of the string object. All of it is used to store the characters inline.
+    static constexpr usize StorageSize = 3 * sizeof(char*);
+
     // The number of bytes, including the null-termination byte, that can be stored inline.
-    static constexpr usize InlineCapacity = sizeof(char*);
+    static constexpr usize InlineCapacity = StorageSize;
+
+public:
+    // Strings that fit in the inline storage are never shared, as copying them is already cheap.
+    NODISCARD AT_API static String
+    create_shared(StringView view, StringSharing sharing = StringSharing::Atomic, Allocator* allocator = nullptr);
 
 public:
     ALWAYS_INLINE String()
-        : m_byte_count(1)
     {
-        m_heap_characters = nullptr;
+        m_inline_characters[0] = 0;
+        set_inline_byte_count(1);
     }
 
     AT_API String(const String& other);
     AT_API String(String&& other) noexcept;
     AT_API String(StringView view);
+    AT_API String(StringView view, Allocator* allocator);
 
     AT_API String& operator=(const String& other);
     AT_API String& operator=(String&& other) noexcept;
@@ -42,54 +72,136 @@ public:
     AT_API ~String();
 
 public:
-    NODISCARD ALWAYS_INLINE StringView to_view() const { return StringView::from_utf8(characters(), m_byte_count - 1); }
+    NODISCARD ALWAYS_INLINE StringView to_view() const { return StringView::from_utf8(characters(), byte_count() - 1); }
 
-    NODISCARD ALWAYS_INLINE const char* characters() const { return reinterpret_cast<const char*>(bytes()); }
-    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_byte_count; }
+    NODISCARD ALWAYS_INLINE const char* characters() const
+    {
+        return is_stored_inline() ? m_inline_characters : m_heap.characters;
+    }
 
-    NODISCARD ALWAYS_INLINE ReadonlyBytes bytes() const
+    NODISCARD ALWAYS_INLINE usize byte_count() const
     {
-        return is_stored_on_heap() ? reinterpret_cast<ReadonlyBytes>(m_heap_characters)
-                                   : reinterpret_cast<ReadonlyBytes>(m_inline_characters);
+        return is_stored_inline() ? InlineCapacity - get_tag() : m_heap.byte_count;
     }
 
+    NODISCARD ALWAYS_INLINE ReadonlyBytes bytes() const { return reinterpret_cast<ReadonlyBytes>(characters()); }
+
+    // If the heap buffer is shared with other strings, it is first copied to a private buffer.
     NODISCARD ALWAYS_INLINE ReadWriteBytes bytes()
     {
-        return is_stored_on_heap() ? reinterpret_cast<ReadWriteBytes>(m_heap_characters)
-                                   : reinterpret_cast<ReadWriteBytes>(m_inline_characters);
+        if (is_stored_inline())
+            return reinterpret_cast<ReadWriteBytes>(m_inline_characters);
+
+        if (m_heap.sharing != StringSharing::None)
+            detach_shared_buffer();
+        return reinterpret_cast<ReadWriteBytes>(m_heap.characters);
     }
 
-    NODISCARD ALWAYS_INLINE bool is_stored_inline() const { return (m_byte_count <= InlineCapacity); }
-    NODISCARD ALWAYS_INLINE bool is_stored_on_heap() const { return (m_byte_count > InlineCapacity); }
+    NODISCARD ALWAYS_INLINE bool is_stored_inline() const { return get_tag() != HeapTag; }
+    NODISCARD ALWAYS_INLINE bool is_stored_on_heap() const { return get_tag() == HeapTag; }
 
-public:
-    // IMPORTANT: Sets the string characters pointer to the specified value. This function is
-    // dangerous to use and should only be limited to low-level operations.
-    // No null-termination character will be inserted.
-    // After this call, the lifetime of the provided memory is managed ENTIRELY by the string.
-    AT_DANGEROUS AT_API void set_internal_heap_buffer(char* heap_characters, usize byte_count);
+    NODISCARD ALWAYS_INLINE StringSharing sharing() const
+    {
+        return is_stored_on_heap() ? m_heap.sharing : StringSharing::None;
+    }
+
+    NODISCARD ALWAYS_INLINE bool operator==(const String& other) const { return to_view() == other.to_view(); }
+    NODISCARD ALWAYS_INLINE bool operator==(StringView other) const { return to_view() == other; }
+    NODISCARD ALWAYS_INLINE bool operator!=(const String& other) const { return to_view() != other.to_view(); }
+    NODISCARD ALWAYS_INLINE bool operator!=(StringView other) const { return to_view() != other; }
+
+    // Returns nullptr if the string is stored inline or if the heap buffer was allocated from the global heap.
+    NODISCARD AT_API Allocator* allocator() const;
 
+public:
     // IMPORTANT: Copies the characters from the provided string to the inline buffer.
     // No null-termination character will be inserted.
     // The lifetime of the passed buffer will not be altered in any way.
     AT_DANGEROUS AT_API void set_internal_inline_buffer(const char* inline_characters, usize byte_count);
 
+    // IMPORTANT: Replaces the content of the string with the given number of uninitialized characters, followed
+    // by a null-termination character, and returns a pointer to them. All characters must be written before the
+    // string is used in any other way. The new buffer is owned by this string only and allocated from the global heap.
+    AT_DANGEROUS NODISCARD AT_API char* replace_with_uninitialized(usize byte_count);
+
 private:
-    NODISCARD static ErrorOr<char*> allocate_memory(usize byte_count);
+    // The heap buffers are prefixed by a header that stores the allocator they were acquired from
+    // and, for shared buffers, the reference count.
+    struct HeapHeader;
+
+    struct HeapStorage
+    {
+        char* characters;
+        usize byte_count;
+        StringSharing sharing;
+        u8 padding[sizeof(usize) - 2];
+        // Overlaps the last byte of the inline storage.
+        u8 tag;
+    };
+
+    static_assert(sizeof(HeapStorage) == StorageSize);
+
+    //
+    // The last byte of the storage is a tag that describes how the string is stored:
+    //   - For inline strings it stores (InlineCapacity - byte_count). When the inline storage is full,
+    //     the tag is zero and thus it also acts as the null-termination byte.
+    //   - For heap strings it stores HeapTag, a value that an inline string can never have.
+    //
+    static constexpr u8 HeapTag = 0xFF;
+    static_assert(InlineCapacity < HeapTag);
+
+    NODISCARD ALWAYS_INLINE u8 get_tag() const { return static_cast<u8>(m_inline_characters[InlineCapacity - 1]); }
+
+    ALWAYS_INLINE void set_inline_byte_count(usize byte_count)
+    {
+        m_inline_characters[InlineCapacity - 1] = static_cast<char>(InlineCapacity - byte_count);
+    }
+
+    ALWAYS_INLINE void set_heap_buffer(char* characters, usize byte_count, StringSharing sharing)
+    {
+        m_heap.characters = characters;
+        m_heap.byte_count = byte_count;
+        m_heap.sharing = sharing;
+        m_heap.tag = HeapTag;
+    }
+
+    void initialize_from(const char* characters, usize byte_count, Allocator* allocator, StringSharing sharing);
+    void copy_from(const String& other);
+    void release_heap_buffer_if_any();
+    AT_API void detach_shared_buffer();
+
+    NODISCARD static ErrorOr<char*> allocate_memory(usize byte_count, Allocator* allocator);
+    NODISCARD static HeapHeader* get_heap_header(char* characters);
     static ErrorOr<void> release_memory(char* characters, usize byte_count);
 
 private:
     union
     {
-        char* m_heap_characters;
+        HeapStorage m_heap;
         char m_inline_characters[InlineCapacity];
     };
+};
 
-    usize m_byte_count;
+static_assert(sizeof(String) == String::StorageSize);
+
+// The string doesn't store any pointers to itself, so it can be relocated by copying its bytes.
+template<>
+inline constexpr bool IsTriviallyRelocatable<String> = true;
+
+// The hash of a string is the hash of its view, so that maps keyed by strings can be searched using views.
+template<>
+struct TypeTraits<String>
+{
+    NODISCARD ALWAYS_INLINE static u64 get_hash(const String& string)
+    {
+        return TypeTraits<StringView>::get_hash(string.to_view());
+    }
+    NODISCARD ALWAYS_INLINE static u64 get_hash(StringView view) { return TypeTraits<StringView>::get_hash(view); }
 };
 
 } // namespace AT
 
 #if AT_INCLUDE_GLOBALLY
 using AT::String;
+using AT::StringSharing;
 #endif // AT_INCLUDE_GLOBALLY
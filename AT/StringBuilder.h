@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/Allocator.h"
+#include "AT/CoreTypes.h"
+#include "AT/Error.h"
+#include "AT/String.h"
+#include "AT/StringView.h"
+#include "AT/Vector.h"
+
+namespace AT
+{
+
+//
+// Builds a string from multiple pieces, without reallocating the buffer for each piece.
+// The first InlineCapacity bytes are stored inside the builder, so building short strings (such as labels)
+// on the stack doesn't allocate any memory. The built characters are not null-terminated.
+//
+class StringBuilder
+{
+public:
+    static constexpr usize InlineCapacity = 256;
+
+public:
+    StringBuilder() = default;
+
+    ALWAYS_INLINE explicit StringBuilder(Allocator* allocator)
+        : m_buffer(allocator)
+    {
+    }
+
+public:
+    ALWAYS_INLINE ErrorOr<void> try_append(StringView string)
+    {
+        TRY(m_buffer.try_append({ string.characters(), string.byte_count() }));
+        return {};
+    }
+
+    ALWAYS_INLINE ErrorOr<void> try_append(char character)
+    {
+        TRY(m_buffer.try_push_back(character));
+        return {};
+    }
+
+    ALWAYS_INLINE void append(StringView string) { MUST(try_append(string)); }
+    ALWAYS_INLINE void append(char character) { MUST(try_append(character)); }
+
+    // Makes sure that the given number of bytes can be appended without reallocating.
+    ALWAYS_INLINE ErrorOr<void> try_ensure_available(usize byte_count)
+    {
+        TRY(m_buffer.try_ensure_capacity(m_buffer.count() + byte_count));
+        return {};
+    }
+
+    ALWAYS_INLINE void clear() { m_buffer.clear(); }
+
+public:
+    NODISCARD ALWAYS_INLINE StringView to_view() const
+    {
+        return StringView::from_utf8(m_buffer.elements(), m_buffer.count());
+    }
+
+    // The string buffer is allocated with the exact required size.
+    NODISCARD ALWAYS_INLINE String to_string(Allocator* allocator = nullptr) const
+    {
+        return String(to_view(), allocator);
+    }
+
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_buffer.count(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_buffer.count() == 0; }
+
+private:
+    SmallVector<char, InlineCapacity> m_buffer;
+};
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::StringBuilder;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/StringSearch.h"
+#include "AT/CPUFeatures.h"
+#include "AT/StringSearchKernels.h"
+
+#include <atomic>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+#if AT_ARCHITECTURE_X86_64
+
+// SSE2 is part of the x86-64 baseline, so these kernels are always available.
+usize find_byte_sse2(const u8* bytes, usize byte_count, u8 value)
+{
+    return find_byte_kernel<SSE2SearchRegisters>(bytes, byte_count, value);
+}
+
+usize find_any_byte_of_sse2(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count)
+{
+    return find_any_byte_of_kernel<SSE2SearchRegisters>(bytes, byte_count, set, set_byte_count);
+}
+
+usize find_byte_sequence_sse2(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count)
+{
+    return find_byte_sequence_kernel<SSE2SearchRegisters>(bytes, byte_count, needle, needle_byte_count);
+}
+
+AT_NO_SANITIZE_ADDRESS usize get_null_terminated_length_sse2(const u8* characters)
+{
+    return get_null_terminated_length_kernel<SSE2SearchRegisters>(characters);
+}
+
+#endif // AT_ARCHITECTURE_X86_64
+
+// Portable kernels. Used for the small ranges and on architectures where no vectorized kernels are implemented.
+static usize find_byte_scalar(const u8* bytes, usize byte_count, u8 value)
+{
+    for (usize offset = 0; offset < byte_count; ++offset)
+    {
+        if (bytes[offset] == value)
+            return offset;
+    }
+    return InvalidSize;
+}
+
+static usize find_any_byte_of_scalar(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count)
+{
+    // One bit for each possible byte value.
+    u64 set_table[4] = {};
+    for (usize index = 0; index < set_byte_count; ++index)
+        set_table[set[index] >> 6] |= static_cast<u64>(1) << (set[index] & 63);
+
+    for (usize offset = 0; offset < byte_count; ++offset)
+    {
+        if (set_table[bytes[offset] >> 6] & (static_cast<u64>(1) << (bytes[offset] & 63)))
+            return offset;
+    }
+    return InvalidSize;
+}
+
+// The needle must have at least two bytes.
+static usize find_byte_sequence_scalar(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count)
+{
+    const usize candidate_count = byte_count - needle_byte_count + 1;
+    for (usize offset = 0; offset < candidate_count; ++offset)
+    {
+        if (bytes[offset] == needle[0] && std::memcmp(bytes + offset + 1, needle + 1, needle_byte_count - 1) == 0)
+            return offset;
+    }
+    return InvalidSize;
+}
+
+#if !AT_ARCHITECTURE_X86_64
+static usize get_null_terminated_length_scalar(const u8* characters)
+{
+    const u8* current = characters;
+    while (*current != 0)
+        ++current;
+    return static_cast<usize>(current - characters);
+}
+#endif // !AT_ARCHITECTURE_X86_64
+
+//
+// The kernels are selected in the same way as the memory operations kernels: the dispatch table initially
+// points to the resolver functions, which select the best kernels that the CPU supports and then forward
+// the call. The table is resolved when the library is loaded, but searches performed by static initializers
+// of other translation units might run before that.
+//
+
+static usize resolve_find_byte(const u8* bytes, usize byte_count, u8 value);
+static usize resolve_find_any_byte_of(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count);
+static usize resolve_find_byte_sequence(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count);
+static usize resolve_get_null_terminated_length(const u8* characters);
+
+struct StringSearchDispatchTable
+{
+    std::atomic<FindByteKernel> find_byte { resolve_find_byte };
+    std::atomic<FindAnyByteOfKernel> find_any_byte_of { resolve_find_any_byte_of };
+    std::atomic<FindByteSequenceKernel> find_byte_sequence { resolve_find_byte_sequence };
+    std::atomic<GetNullTerminatedLengthKernel> get_null_terminated_length { resolve_get_null_terminated_length };
+};
+
+static StringSearchDispatchTable s_dispatch_table;
+
+// Relaxed atomic accesses to the kernels, for the same reasons as in MemoryOperations.cpp.
+template<typename Kernel>
+NODISCARD ALWAYS_INLINE static inline Kernel load_kernel(const std::atomic<Kernel>& kernel)
+{
+    return kernel.load(std::memory_order_relaxed);
+}
+
+template<typename Kernel>
+ALWAYS_INLINE static inline void store_kernel(std::atomic<Kernel>& kernel, Kernel value)
+{
+    kernel.store(value, std::memory_order_relaxed);
+}
+
+static void resolve_dispatch_table()
+{
+#if AT_ARCHITECTURE_X86_64
+    if (get_cpu_features().has_avx2)
+    {
+        store_kernel(s_dispatch_table.find_byte, find_byte_avx2);
+        store_kernel(s_dispatch_table.find_any_byte_of, find_any_byte_of_avx2);
+        store_kernel(s_dispatch_table.find_byte_sequence, find_byte_sequence_avx2);
+        store_kernel(s_dispatch_table.get_null_terminated_length, get_null_terminated_length_avx2);
+    }
+    else
+    {
+        store_kernel(s_dispatch_table.find_byte, find_byte_sse2);
+        store_kernel(s_dispatch_table.find_any_byte_of, find_any_byte_of_sse2);
+        store_kernel(s_dispatch_table.find_byte_sequence, find_byte_sequence_sse2);
+        store_kernel(s_dispatch_table.get_null_terminated_length, get_null_terminated_length_sse2);
+    }
+#else
+    store_kernel(s_dispatch_table.find_byte, find_byte_scalar);
+    store_kernel(s_dispatch_table.find_any_byte_of, find_any_byte_of_scalar);
+    store_kernel(s_dispatch_table.find_byte_sequence, find_byte_sequence_scalar);
+    store_kernel(s_dispatch_table.get_null_terminated_length, get_null_terminated_length_scalar);
+#endif // AT_ARCHITECTURE_X86_64
+}
+
+static usize resolve_find_byte(const u8* bytes, usize byte_count, u8 value)
+{
+    resolve_dispatch_table();
+    return load_kernel(s_dispatch_table.find_byte)(bytes, byte_count, value);
+}
+
+static usize resolve_find_any_byte_of(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count)
+{
+    resolve_dispatch_table();
+    return load_kernel(s_dispatch_table.find_any_byte_of)(bytes, byte_count, set, set_byte_count);
+}
+
+static usize resolve_find_byte_sequence(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count)
+{
+    resolve_dispatch_table();
+    return load_kernel(s_dispatch_table.find_byte_sequence)(bytes, byte_count, needle, needle_byte_count);
+}
+
+static usize resolve_get_null_terminated_length(const u8* characters)
+{
+    resolve_dispatch_table();
+    return load_kernel(s_dispatch_table.get_null_terminated_length)(characters);
+}
+
+MAYBE_UNUSED static const bool s_is_dispatch_table_resolved_at_startup = (resolve_dispatch_table(), true);
+
+} // namespace Detail
+
+usize find_byte(const char* bytes, usize byte_count, char value)
+{
+    const u8* bytes_u8 = reinterpret_cast<const u8*>(bytes);
+    if (byte_count < Detail::SmallSearchThreshold)
+        return Detail::find_byte_scalar(bytes_u8, byte_count, static_cast<u8>(value));
+    return Detail::load_kernel(Detail::s_dispatch_table.find_byte)(bytes_u8, byte_count, static_cast<u8>(value));
+}
+
+usize find_any_byte_of(const char* bytes, usize byte_count, const char* set, usize set_byte_count)
+{
+    if (set_byte_count == 0)
+        return InvalidSize;
+    if (set_byte_count == 1)
+        return find_byte(bytes, byte_count, set[0]);
+
+    const u8* bytes_u8 = reinterpret_cast<const u8*>(bytes);
+    const u8* set_u8 = reinterpret_cast<const u8*>(set);
+    if (byte_count < Detail::SmallSearchThreshold || set_byte_count > Detail::MaxVectorizedSetByteCount)
+        return Detail::find_any_byte_of_scalar(bytes_u8, byte_count, set_u8, set_byte_count);
+    return Detail::load_kernel(Detail::s_dispatch_table.find_any_byte_of)(bytes_u8, byte_count, set_u8, set_byte_count);
+}
+
+usize find_byte_sequence(const char* bytes, usize byte_count, const char* needle, usize needle_byte_count)
+{
+    if (needle_byte_count == 0)
+        return 0;
+    if (needle_byte_count > byte_count)
+        return InvalidSize;
+    if (needle_byte_count == 1)
+        return find_byte(bytes, byte_count, needle[0]);
+
+    const u8* bytes_u8 = reinterpret_cast<const u8*>(bytes);
+    const u8* needle_u8 = reinterpret_cast<const u8*>(needle);
+    if (byte_count - needle_byte_count + 1 < Detail::SmallSearchThreshold)
+        return Detail::find_byte_sequence_scalar(bytes_u8, byte_count, needle_u8, needle_byte_count);
+    return Detail::load_kernel(Detail::s_dispatch_table.find_byte_sequence)(
+        bytes_u8, byte_count, needle_u8, needle_byte_count
+    );
+}
+
+usize get_null_terminated_length(const char* characters)
+{
+    const u8* characters_u8 = reinterpret_cast<const u8*>(characters);
+    return Detail::load_kernel(Detail::s_dispatch_table.get_null_terminated_length)(characters_u8);
+}
+
+} // namespace AT
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+
+namespace AT
+{
+
+//
+// Byte search primitives, similar to memchr() and strlen(). The searches are vectorized using SSE2 or AVX2,
+// selected at runtime based on the CPU features. All functions return the offset (in bytes) of the first match,
+// or InvalidSize if no match is found.
+//
+
+NODISCARD AT_API usize find_byte(const char* bytes, usize byte_count, char value);
+
+// Finds the first byte that is equal to any of the bytes in the set.
+NODISCARD AT_API usize find_any_byte_of(const char* bytes, usize byte_count, const char* set, usize set_byte_count);
+
+// Finds the first occurrence of the needle. An empty needle is found at offset zero.
+NODISCARD AT_API usize
+find_byte_sequence(const char* bytes, usize byte_count, const char* needle, usize needle_byte_count);
+
+// Returns the number of bytes before the null-terminator. The scan reads aligned blocks, so it might read
+// some bytes past the null-terminator, but never past the end of the memory page that contains it.
+NODISCARD AT_API usize get_null_terminated_length(const char* characters);
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::find_any_byte_of;
+using AT::find_byte;
+using AT::find_byte_sequence;
+using AT::get_null_terminated_length;
+#endif // AT_INCLUDE_GLOBALLY
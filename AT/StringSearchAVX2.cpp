@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+// NOTE: This translation unit is compiled with the AVX2 code generation flags. The kernels
+// defined here must only be invoked after checking that the CPU supports AVX2.
+
+#include "AT/StringSearchKernels.h"
+
+#if AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+namespace AT::Detail
+{
+
+usize find_byte_avx2(const u8* bytes, usize byte_count, u8 value)
+{
+    return find_byte_kernel<AVX2SearchRegisters>(bytes, byte_count, value);
+}
+
+usize find_any_byte_of_avx2(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count)
+{
+    return find_any_byte_of_kernel<AVX2SearchRegisters>(bytes, byte_count, set, set_byte_count);
+}
+
+usize find_byte_sequence_avx2(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count)
+{
+    return find_byte_sequence_kernel<AVX2SearchRegisters>(bytes, byte_count, needle, needle_byte_count);
+}
+
+AT_NO_SANITIZE_ADDRESS usize get_null_terminated_length_avx2(const u8* characters)
+{
+    return get_null_terminated_length_kernel<AVX2SearchRegisters>(characters);
+}
+
+} // namespace AT::Detail
+
+#endif // AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+//
+// IMPORTANT: This header is private to the string search implementation and should never be included by any
+// other file. Just like the memory operations kernels, the search kernels are templated over a register set
+// and each translation unit that includes this header is compiled with the code generation flags of its
+// instruction set, so everything declared here (except the kernel entry points) must have internal linkage.
+//
+
+#include "AT/BitOperations.h"
+#include "AT/CoreTypes.h"
+
+#include <cstring>
+
+#if AT_ARCHITECTURE_X86_64
+    #include <immintrin.h>
+#endif // AT_ARCHITECTURE_X86_64
+
+namespace AT::Detail
+{
+
+// The searches in ranges that have a byte count less than this value are handled without going through
+// the dispatch table.
+constexpr usize SmallSearchThreshold = 16;
+
+// The maximum number of bytes in the set for which find_any_byte_of() uses the vectorized kernels. Each byte
+// in the set costs one comparison per block, so larger sets are faster to check using a lookup table.
+constexpr usize MaxVectorizedSetByteCount = 8;
+
+// All kernels expect the byte count (or the number of candidate positions, for the byte sequence search)
+// to be greater than or equal to SmallSearchThreshold.
+using FindByteKernel = usize (*)(const u8* bytes, usize byte_count, u8 value);
+using FindAnyByteOfKernel = usize (*)(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count);
+using FindByteSequenceKernel =
+    usize (*)(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count);
+using GetNullTerminatedLengthKernel = usize (*)(const u8* characters);
+
+usize find_byte_sse2(const u8* bytes, usize byte_count, u8 value);
+usize find_any_byte_of_sse2(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count);
+usize find_byte_sequence_sse2(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count);
+usize get_null_terminated_length_sse2(const u8* characters);
+
+usize find_byte_avx2(const u8* bytes, usize byte_count, u8 value);
+usize find_any_byte_of_avx2(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count);
+usize find_byte_sequence_avx2(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count);
+usize get_null_terminated_length_avx2(const u8* characters);
+
+namespace
+{
+
+//
+// A register set (R) must provide:
+//   - R::Register, R::Width: the vector register type and its size in bytes.
+//   - R::Half: the register set that is half as wide, or void for the narrowest one.
+//   - R::load(), R::load_aligned(), R::broadcast(), R::compare_equal(), R::bitwise_or(), R::bitwise_and().
+//   - R::get_mask(): a bit mask with the most significant bit of each byte in the register.
+//
+
+#if AT_ARCHITECTURE_X86_64
+
+struct SSE2SearchRegisters
+{
+    using Register = __m128i;
+    using Half = void;
+    static constexpr usize Width = sizeof(Register);
+
+    ALWAYS_INLINE static Register load(const u8* source)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const Register*>(source));
+    }
+    ALWAYS_INLINE static Register load_aligned(const u8* source)
+    {
+        return _mm_load_si128(reinterpret_cast<const Register*>(source));
+    }
+    ALWAYS_INLINE static Register broadcast(u8 value) { return _mm_set1_epi8(static_cast<char>(value)); }
+    ALWAYS_INLINE static Register compare_equal(Register lhs, Register rhs) { return _mm_cmpeq_epi8(lhs, rhs); }
+    ALWAYS_INLINE static Register bitwise_or(Register lhs, Register rhs) { return _mm_or_si128(lhs, rhs); }
+    ALWAYS_INLINE static Register bitwise_and(Register lhs, Register rhs) { return _mm_and_si128(lhs, rhs); }
+    ALWAYS_INLINE static u32 get_mask(Register value) { return static_cast<u32>(_mm_movemask_epi8(value)); }
+};
+
+#endif // AT_ARCHITECTURE_X86_64
+
+#if AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+struct AVX2SearchRegisters
+{
+    using Register = __m256i;
+    using Half = SSE2SearchRegisters;
+    static constexpr usize Width = sizeof(Register);
+
+    ALWAYS_INLINE static Register load(const u8* source)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const Register*>(source));
+    }
+    ALWAYS_INLINE static Register load_aligned(const u8* source)
+    {
+        return _mm256_load_si256(reinterpret_cast<const Register*>(source));
+    }
+    ALWAYS_INLINE static Register broadcast(u8 value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+    ALWAYS_INLINE static Register compare_equal(Register lhs, Register rhs) { return _mm256_cmpeq_epi8(lhs, rhs); }
+    ALWAYS_INLINE static Register bitwise_or(Register lhs, Register rhs) { return _mm256_or_si256(lhs, rhs); }
+    ALWAYS_INLINE static Register bitwise_and(Register lhs, Register rhs) { return _mm256_and_si256(lhs, rhs); }
+    ALWAYS_INLINE static u32 get_mask(Register value) { return static_cast<u32>(_mm256_movemask_epi8(value)); }
+};
+
+#endif // AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+// Returns the offset of the first block byte that is marked by the matcher. The matcher receives a pointer to
+// a block of R::Width bytes and returns a register that has the matching bytes set to 0xFF.
+template<typename R, typename Matcher>
+ALWAYS_INLINE inline usize find_first_match(const u8* bytes, usize byte_count, Matcher matcher)
+{
+    usize offset = 0;
+
+    // Four blocks are checked per iteration, with a single branch, as most blocks don't contain any match.
+    for (; offset + 4 * R::Width <= byte_count; offset += 4 * R::Width)
+    {
+        const typename R::Register m0 = matcher(bytes + offset + 0 * R::Width);
+        const typename R::Register m1 = matcher(bytes + offset + 1 * R::Width);
+        const typename R::Register m2 = matcher(bytes + offset + 2 * R::Width);
+        const typename R::Register m3 = matcher(bytes + offset + 3 * R::Width);
+        if (R::get_mask(R::bitwise_or(R::bitwise_or(m0, m1), R::bitwise_or(m2, m3))) == 0) [[likely]]
+            continue;
+
+        if (const u32 mask = R::get_mask(m0))
+            return offset + count_trailing_zeroes(mask);
+        if (const u32 mask = R::get_mask(m1))
+            return offset + 1 * R::Width + count_trailing_zeroes(mask);
+        if (const u32 mask = R::get_mask(m2))
+            return offset + 2 * R::Width + count_trailing_zeroes(mask);
+        return offset + 3 * R::Width + count_trailing_zeroes(R::get_mask(m3));
+    }
+
+    for (; offset + R::Width <= byte_count; offset += R::Width)
+    {
+        if (const u32 mask = R::get_mask(matcher(bytes + offset)))
+            return offset + count_trailing_zeroes(mask);
+    }
+
+    if (offset < byte_count)
+    {
+        // The last block ends at the end of the range and overlaps the previous one, so the bytes that
+        // were already checked are discarded from the mask.
+        const usize last_block_offset = byte_count - R::Width;
+        const u32 mask = R::get_mask(matcher(bytes + last_block_offset)) >> (offset - last_block_offset);
+        if (mask != 0)
+            return offset + count_trailing_zeroes(mask);
+    }
+
+    return InvalidSize;
+}
+
+template<typename R>
+ALWAYS_INLINE inline usize find_byte_kernel(const u8* bytes, usize byte_count, u8 value)
+{
+    if constexpr (!IsVoid<typename R::Half>)
+    {
+        if (byte_count < R::Width)
+            return find_byte_kernel<typename R::Half>(bytes, byte_count, value);
+    }
+
+    const typename R::Register pattern = R::broadcast(value);
+    return find_first_match<R>(
+        bytes,
+        byte_count,
+        [pattern](const u8* block) { return R::compare_equal(R::load(block), pattern); }
+    );
+}
+
+template<typename R>
+ALWAYS_INLINE inline usize
+find_any_byte_of_kernel(const u8* bytes, usize byte_count, const u8* set, usize set_byte_count)
+{
+    if constexpr (!IsVoid<typename R::Half>)
+    {
+        if (byte_count < R::Width)
+            return find_any_byte_of_kernel<typename R::Half>(bytes, byte_count, set, set_byte_count);
+    }
+
+    typename R::Register patterns[MaxVectorizedSetByteCount];
+    for (usize index = 0; index < set_byte_count; ++index)
+        patterns[index] = R::broadcast(set[index]);
+
+    return find_first_match<R>(
+        bytes,
+        byte_count,
+        [&patterns, set_byte_count](const u8* block)
+        {
+            const typename R::Register block_bytes = R::load(block);
+            typename R::Register matches = R::compare_equal(block_bytes, patterns[0]);
+            for (usize index = 1; index < set_byte_count; ++index)
+                matches = R::bitwise_or(matches, R::compare_equal(block_bytes, patterns[index]));
+            return matches;
+        }
+    );
+}
+
+//
+// The byte sequence search compares the first and the last byte of the needle against the corresponding bytes
+// of each candidate position, for a whole block of candidates at once. Only the candidates that match both
+// bytes are verified, which filters out almost all of them even when the first byte of the needle is common.
+// The needle must have at least two bytes.
+//
+template<typename R>
+ALWAYS_INLINE inline usize
+find_byte_sequence_kernel(const u8* bytes, usize byte_count, const u8* needle, usize needle_byte_count)
+{
+    const usize candidate_count = byte_count - needle_byte_count + 1;
+    if constexpr (!IsVoid<typename R::Half>)
+    {
+        if (candidate_count < R::Width)
+            return find_byte_sequence_kernel<typename R::Half>(bytes, byte_count, needle, needle_byte_count);
+    }
+
+    const typename R::Register first_pattern = R::broadcast(needle[0]);
+    const typename R::Register last_pattern = R::broadcast(needle[needle_byte_count - 1]);
+    const usize last_byte_offset = needle_byte_count - 1;
+
+    // Verifies the candidates from the mask, in order, and returns the offset of the first actual match.
+    const auto verify_candidates = [&](usize offset, u32 mask) -> usize
+    {
+        for (; mask != 0; mask &= mask - 1)
+        {
+            const usize candidate_offset = offset + count_trailing_zeroes(mask);
+            if (std::memcmp(bytes + candidate_offset + 1, needle + 1, needle_byte_count - 2) == 0)
+                return candidate_offset;
+        }
+        return InvalidSize;
+    };
+
+    const auto get_candidates = [&](usize offset) -> u32
+    {
+        const typename R::Register first_matches = R::compare_equal(R::load(bytes + offset), first_pattern);
+        const typename R::Register last_matches =
+            R::compare_equal(R::load(bytes + offset + last_byte_offset), last_pattern);
+        return R::get_mask(R::bitwise_and(first_matches, last_matches));
+    };
+
+    usize offset = 0;
+    for (; offset + R::Width <= candidate_count; offset += R::Width)
+    {
+        if (const u32 mask = get_candidates(offset))
+        {
+            const usize match_offset = verify_candidates(offset, mask);
+            if (match_offset != InvalidSize)
+                return match_offset;
+        }
+    }
+
+    if (offset < candidate_count)
+    {
+        const usize last_block_offset = candidate_count - R::Width;
+        const u32 mask = get_candidates(last_block_offset) >> (offset - last_block_offset);
+        return verify_candidates(offset, mask);
+    }
+
+    return InvalidSize;
+}
+
+//
+// The null-terminator scan only performs aligned loads. An aligned block never crosses a page boundary, so if
+// it contains at least one byte of the string it can be read entirely, even though some of its bytes might be
+// located before the start or after the end of the string. Reading those bytes is benign, but the address
+// sanitizer would report it, so the instrumentation is disabled for this kernel.
+//
+template<typename R>
+AT_NO_SANITIZE_ADDRESS ALWAYS_INLINE inline usize get_null_terminated_length_kernel(const u8* characters)
+{
+    const typename R::Register zero = R::broadcast(0);
+    const usize misalignment = reinterpret_cast<uintptr>(characters) & (R::Width - 1);
+    const u8* block = characters - misalignment;
+
+    // The bytes located before the start of the string are discarded from the mask.
+    const u32 first_mask = R::get_mask(R::compare_equal(R::load_aligned(block), zero)) >> misalignment;
+    if (first_mask != 0)
+        return count_trailing_zeroes(first_mask);
+
+    while (true)
+    {
+        block += R::Width;
+        if (const u32 mask = R::get_mask(R::compare_equal(R::load_aligned(block), zero)))
+            return static_cast<usize>(block - characters) + count_trailing_zeroes(mask);
+    }
+}
+
+} // namespace
+
+} // namespace AT::Detail
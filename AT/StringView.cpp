@@ -4,8 +4,19 @@
  */
 
 #include "AT/StringView.h"
+#include "AT/UTF8.h"
 
 namespace AT
 {
 
+bool StringView::is_valid_utf8() const
+{
+    return AT::is_valid_utf8(m_characters, m_byte_count);
+}
+
+usize StringView::count_code_points() const
+{
+    return count_utf8_code_points(m_characters, m_byte_count);
+}
+
 } // namespace AT
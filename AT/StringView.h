@@ -7,11 +7,165 @@
 
 #include "AT/Assertions.h"
 #include "AT/CoreTypes.h"
+#include "AT/StringSearch.h"
+#include "AT/TypeTraits.h"
 #include <cstring>
 
 namespace AT
 {
 
+//
+// Iterates over the code points of a UTF-8 encoded string. ASCII characters take a fast path. Invalid sequences never
+// cause reads outside of the string and decode to U+FFFD, once per maximal subpart (the longest prefix of a valid
+// sequence, or a single byte if it can't start one), as recommended by the Unicode standard. So the byte that breaks
+// a sequence is never consumed by it, and it starts the next code point.
+//
+class UTF8CodePointIterator
+{
+public:
+    ALWAYS_INLINE UTF8CodePointIterator(const char* current, const char* end)
+        : m_current(reinterpret_cast<const u8*>(current))
+        , m_end(reinterpret_cast<const u8*>(end))
+    {
+    }
+
+    NODISCARD ALWAYS_INLINE u32 operator*() const
+    {
+        if (m_current[0] < 0x80) [[likely]]
+            return m_current[0];
+        return decode_multibyte_sequence().code_point;
+    }
+
+    ALWAYS_INLINE UTF8CodePointIterator& operator++()
+    {
+        m_current += get_sequence_byte_count();
+        return *this;
+    }
+
+    NODISCARD ALWAYS_INLINE bool operator==(const UTF8CodePointIterator& other) const
+    {
+        return m_current == other.m_current;
+    }
+
+    NODISCARD ALWAYS_INLINE bool operator!=(const UTF8CodePointIterator& other) const
+    {
+        return m_current != other.m_current;
+    }
+
+    // The number of bytes that encode the current code point (or the maximal subpart of an invalid sequence).
+    NODISCARD ALWAYS_INLINE usize get_sequence_byte_count() const
+    {
+        if (m_current[0] < 0x80) [[likely]]
+            return 1;
+        return decode_multibyte_sequence().byte_count;
+    }
+
+public:
+    static constexpr u32 ReplacementCodePoint = 0xFFFD;
+
+private:
+    struct DecodedSequence
+    {
+        u32 code_point;
+        usize byte_count;
+    };
+
+    NODISCARD DecodedSequence decode_multibyte_sequence() const
+    {
+        const u8 lead_byte = m_current[0];
+
+        // The valid range of the second byte depends on the lead byte, which excludes the overlong encodings, the
+        // surrogates and the code points above U+10FFFF. The following bytes are always in the [0x80, 0xBF] range.
+        usize byte_count;
+        u32 code_point;
+        u8 second_byte_minimum = 0x80;
+        u8 second_byte_maximum = 0xBF;
+        if (lead_byte >= 0xC2 && lead_byte <= 0xDF)
+        {
+            byte_count = 2;
+            code_point = lead_byte & 0x1F;
+        }
+        else if (lead_byte >= 0xE0 && lead_byte <= 0xEF)
+        {
+            byte_count = 3;
+            code_point = lead_byte & 0x0F;
+            if (lead_byte == 0xE0)
+                second_byte_minimum = 0xA0;
+            else if (lead_byte == 0xED)
+                second_byte_maximum = 0x9F;
+        }
+        else if (lead_byte >= 0xF0 && lead_byte <= 0xF4)
+        {
+            byte_count = 4;
+            code_point = lead_byte & 0x07;
+            if (lead_byte == 0xF0)
+                second_byte_minimum = 0x90;
+            else if (lead_byte == 0xF4)
+                second_byte_maximum = 0x8F;
+        }
+        else
+        {
+            // A continuation byte, or a lead byte that never appears in valid UTF-8.
+            return { ReplacementCodePoint, 1 };
+        }
+
+        const usize remaining_byte_count = static_cast<usize>(m_end - m_current);
+        for (usize index = 1; index < byte_count; ++index)
+        {
+            if (index == remaining_byte_count)
+                return { ReplacementCodePoint, index };
+
+            const u8 byte = m_current[index];
+            const u8 minimum = (index == 1) ? second_byte_minimum : 0x80;
+            const u8 maximum = (index == 1) ? second_byte_maximum : 0xBF;
+            if (byte < minimum || byte > maximum)
+                return { ReplacementCodePoint, index };
+
+            code_point = (code_point << 6) | (byte & 0x3F);
+        }
+
+        return { code_point, byte_count };
+    }
+
+private:
+    const u8* m_current;
+    const u8* m_end;
+};
+
+class UTF8CodePointView
+{
+public:
+    ALWAYS_INLINE UTF8CodePointView(const char* characters, usize byte_count)
+        : m_characters(characters)
+        , m_byte_count(byte_count)
+    {
+    }
+
+    NODISCARD ALWAYS_INLINE UTF8CodePointIterator begin() const
+    {
+        return UTF8CodePointIterator(m_characters, m_characters + m_byte_count);
+    }
+
+    NODISCARD ALWAYS_INLINE UTF8CodePointIterator end() const
+    {
+        return UTF8CodePointIterator(m_characters + m_byte_count, m_characters + m_byte_count);
+    }
+
+private:
+    const char* m_characters;
+    usize m_byte_count;
+};
+
+enum class SplitBehavior : u8
+{
+    // Adjacent delimiters, as well as delimiters at the start or at the end, produce empty pieces.
+    KeepEmpty = 0,
+    SkipEmpty = 1,
+};
+
+template<typename DelimiterType>
+class StringSplitView;
+
 //
 // A view towards a sequence of immutable UTF-8 encoded characters.
 // The viewed string is not null-terminated.
@@ -25,7 +179,8 @@ public:
         StringView utf8_view;
         utf8_view.m_characters = characters;
         utf8_view.m_byte_count = byte_count;
-        // TODO: Check that the provided string is valid UTF-8?
+        // NOTE: The characters are not validated here, as most views are created from trusted strings.
+        // Views created from untrusted data should be checked using is_valid_utf8().
         return utf8_view;
     }
 
@@ -33,8 +188,7 @@ public:
     {
         StringView utf8_view;
         utf8_view.m_characters = characters;
-        // TODO: Don't use strlen()!
-        utf8_view.m_byte_count = strlen(characters);
+        utf8_view.m_byte_count = get_null_terminated_length(characters);
         return utf8_view;
     }
 
@@ -76,25 +230,240 @@ public:
         return m_characters[offset_in_bytes];
     }
 
+    // Don't check the offsets, regardless of the checking level. Only meant for the code that already proved the
+    // offsets to be in bounds.
+    NODISCARD ALWAYS_INLINE StringView unchecked_substring(usize offset_in_bytes, usize count_in_bytes) const
+    {
+        StringView substring;
+        substring.m_characters = m_characters + offset_in_bytes;
+        substring.m_byte_count = count_in_bytes;
+        return substring;
+    }
+
+    NODISCARD ALWAYS_INLINE const char& unchecked_at_offset_in_bytes(usize offset_in_bytes) const
+    {
+        return m_characters[offset_in_bytes];
+    }
+
 public:
-    NODISCARD ALWAYS_INLINE const char* characters() const { return m_characters; }
-    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_byte_count; }
-    NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_byte_count == 0); }
+    NODISCARD ALWAYS_INLINE constexpr const char* characters() const { return m_characters; }
+    NODISCARD ALWAYS_INLINE constexpr usize byte_count() const { return m_byte_count; }
+    NODISCARD ALWAYS_INLINE constexpr bool is_empty() const { return (m_byte_count == 0); }
     NODISCARD ALWAYS_INLINE ReadonlyBytes bytes() const
     {
         return reinterpret_cast<ReadonlyBytes>(m_characters);
     }
 
+public:
+    // The search functions return the offset (in bytes) of the first match, or InvalidSize if there is no match.
+    // See StringSearch.h for the kernels that perform the actual search.
+    NODISCARD ALWAYS_INLINE usize find(char character) const
+    {
+        return find_byte(m_characters, m_byte_count, character);
+    }
+
+    NODISCARD ALWAYS_INLINE usize find(StringView needle) const
+    {
+        return find_byte_sequence(m_characters, m_byte_count, needle.m_characters, needle.m_byte_count);
+    }
+
+    // Finds the first byte that is equal to any of the bytes in the set. The set must only contain ASCII characters.
+    NODISCARD ALWAYS_INLINE usize find_any_of(StringView set) const
+    {
+        return find_any_byte_of(m_characters, m_byte_count, set.m_characters, set.m_byte_count);
+    }
+
+    NODISCARD ALWAYS_INLINE bool contains(char character) const { return find(character) != InvalidSize; }
+    NODISCARD ALWAYS_INLINE bool contains(StringView needle) const { return find(needle) != InvalidSize; }
+
+    NODISCARD ALWAYS_INLINE bool starts_with(StringView prefix) const
+    {
+        if (prefix.m_byte_count > m_byte_count)
+            return false;
+        return (prefix.m_byte_count == 0 || std::memcmp(m_characters, prefix.m_characters, prefix.m_byte_count) == 0);
+    }
+
+    NODISCARD ALWAYS_INLINE bool ends_with(StringView suffix) const
+    {
+        if (suffix.m_byte_count > m_byte_count)
+            return false;
+        const char* suffix_begin = m_characters + m_byte_count - suffix.m_byte_count;
+        return (suffix.m_byte_count == 0 || std::memcmp(suffix_begin, suffix.m_characters, suffix.m_byte_count) == 0);
+    }
+
+    // The pieces are produced lazily, while iterating, so splitting doesn't allocate any memory.
+    NODISCARD ALWAYS_INLINE StringSplitView<char>
+    split(char delimiter, SplitBehavior split_behavior = SplitBehavior::KeepEmpty) const;
+
+    // The delimiter must not be empty.
+    NODISCARD ALWAYS_INLINE StringSplitView<StringView>
+    split(StringView delimiter, SplitBehavior split_behavior = SplitBehavior::KeepEmpty) const;
+
+public:
+    // Uses vectorized kernels, selected at runtime based on the CPU features.
+    NODISCARD AT_API bool is_valid_utf8() const;
+
+    // The view must be valid UTF-8.
+    NODISCARD AT_API usize count_code_points() const;
+
+    NODISCARD ALWAYS_INLINE UTF8CodePointView code_points() const { return { m_characters, m_byte_count }; }
+
+public:
+    NODISCARD ALWAYS_INLINE bool operator==(StringView other) const
+    {
+        if (m_byte_count != other.m_byte_count)
+            return false;
+        return (m_byte_count == 0 || std::memcmp(m_characters, other.m_characters, m_byte_count) == 0);
+    }
+
+    NODISCARD ALWAYS_INLINE bool operator!=(StringView other) const { return !(*this == other); }
+
 private:
     const char* m_characters;
     usize m_byte_count;
 };
 
+//
+// Iterates over the pieces of a string that are separated by a delimiter, which is either a single character
+// or a string. The next delimiter is only searched for when the iterator is advanced.
+//
+template<typename DelimiterType>
+class StringSplitIterator
+{
+public:
+    ALWAYS_INLINE StringSplitIterator(StringView string, DelimiterType delimiter, SplitBehavior split_behavior)
+        : m_remaining(string)
+        , m_delimiter(delimiter)
+        , m_split_behavior(split_behavior)
+    {
+        advance();
+    }
+
+    // Creates the end iterator.
+    ALWAYS_INLINE StringSplitIterator()
+        : m_delimiter()
+        , m_is_end(true)
+    {
+    }
+
+    NODISCARD ALWAYS_INLINE StringView operator*() const { return m_current; }
+
+    ALWAYS_INLINE StringSplitIterator& operator++()
+    {
+        advance();
+        return *this;
+    }
+
+    // Iterators over the same string are equal if they point to the same piece.
+    NODISCARD ALWAYS_INLINE bool operator==(const StringSplitIterator& other) const
+    {
+        if (m_is_end || other.m_is_end)
+            return m_is_end == other.m_is_end;
+        return m_current.characters() == other.m_current.characters();
+    }
+
+    NODISCARD ALWAYS_INLINE bool operator!=(const StringSplitIterator& other) const { return !(*this == other); }
+
+private:
+    ALWAYS_INLINE void advance()
+    {
+        do
+        {
+            if (!m_has_remaining)
+            {
+                m_is_end = true;
+                return;
+            }
+
+            const usize delimiter_offset = m_remaining.find(m_delimiter);
+            if (delimiter_offset == InvalidSize)
+            {
+                // The last piece doesn't end with a delimiter.
+                m_current = m_remaining;
+                m_has_remaining = false;
+            }
+            else
+            {
+                const usize piece_end_offset = delimiter_offset + get_delimiter_byte_count();
+                // The delimiter was found in the remaining view, so both pieces are in bounds.
+                m_current = m_remaining.unchecked_substring(0, delimiter_offset);
+                m_remaining = m_remaining.unchecked_substring(
+                    piece_end_offset, m_remaining.byte_count() - piece_end_offset
+                );
+            }
+        } while (m_split_behavior == SplitBehavior::SkipEmpty && m_current.is_empty());
+    }
+
+    NODISCARD ALWAYS_INLINE usize get_delimiter_byte_count() const
+    {
+        if constexpr (IsSame<DelimiterType, char>)
+            return 1;
+        else
+            return m_delimiter.byte_count();
+    }
+
+private:
+    StringView m_remaining;
+    StringView m_current;
+    DelimiterType m_delimiter;
+    SplitBehavior m_split_behavior = SplitBehavior::KeepEmpty;
+    bool m_has_remaining = true;
+    bool m_is_end = false;
+};
+
+template<typename DelimiterType>
+class StringSplitView
+{
+public:
+    ALWAYS_INLINE StringSplitView(StringView string, DelimiterType delimiter, SplitBehavior split_behavior)
+        : m_string(string)
+        , m_delimiter(delimiter)
+        , m_split_behavior(split_behavior)
+    {
+    }
+
+    NODISCARD ALWAYS_INLINE StringSplitIterator<DelimiterType> begin() const
+    {
+        return StringSplitIterator<DelimiterType>(m_string, m_delimiter, m_split_behavior);
+    }
+
+    NODISCARD ALWAYS_INLINE StringSplitIterator<DelimiterType> end() const { return {}; }
+
+private:
+    StringView m_string;
+    DelimiterType m_delimiter;
+    SplitBehavior m_split_behavior;
+};
+
+ALWAYS_INLINE inline StringSplitView<char> StringView::split(char delimiter, SplitBehavior split_behavior) const
+{
+    return StringSplitView<char>(*this, delimiter, split_behavior);
+}
+
+ALWAYS_INLINE inline StringSplitView<StringView>
+StringView::split(StringView delimiter, SplitBehavior split_behavior) const
+{
+    VERIFY_ALWAYS(!delimiter.is_empty());
+    return StringSplitView<StringView>(*this, delimiter, split_behavior);
+}
+
+template<>
+struct TypeTraits<StringView>
+{
+    NODISCARD ALWAYS_INLINE static u64 get_hash(StringView view)
+    {
+        return hash_bytes(view.characters(), view.byte_count());
+    }
+};
+
 } // namespace AT
 
 #if AT_COMPILER_CLANG
     #pragma clang diagnostic push
     #pragma clang diagnostic ignored "-Wuser-defined-literals"
+#elif AT_COMPILER_GCC
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wliteral-suffix"
 #elif AT_COMPILER_MSVC
     #pragma warning(push)
     #pragma warning(disable : 4455)
@@ -107,11 +476,18 @@ NODISCARD constexpr AT::StringView operator""sv(const char* characters, usize by
 }
 
 #if AT_COMPILER_CLANG
-    #pragma clang pop
+    #pragma clang diagnostic pop
+#elif AT_COMPILER_GCC
+    #pragma GCC diagnostic pop
 #elif AT_COMPILER_MSVC
     #pragma warning(pop)
 #endif // Compilers.
 
 #if AT_INCLUDE_GLOBALLY
+using AT::SplitBehavior;
+using AT::StringSplitIterator;
+using AT::StringSplitView;
 using AT::StringView;
+using AT::UTF8CodePointIterator;
+using AT::UTF8CodePointView;
 #endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Format.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+//
+// Compares the floating-point formatting against std::to_chars, whose output is exact. The shortest notations are
+// checked for random bit patterns of f64 and f32, and the fixed and scientific notations with a precision for random
+// f64 bit patterns and random precisions. The edge cases (zeroes, subnormals, the powers of two and their neighbours,
+// the extremes and the non-finite values) are checked as well. NaN is always formatted as "nan", regardless of its
+// sign, while std::to_chars formats the sign.
+//
+
+namespace AT
+{
+
+namespace Tests
+{
+
+using Type = FormatBuilder::Specifier::Type;
+
+constexpr usize DefaultRandomValueCount = 200'000;
+constexpr u32 MaximumRandomPrecision = 40;
+constexpr usize MaximumReportedMismatchCount = 16;
+
+// Large enough for the fixed notation of the largest f64 with the maximum precision.
+constexpr usize BufferByteCount = 2048;
+
+static usize s_check_count = 0;
+static usize s_mismatch_count = 0;
+
+// SplitMix64, with a fixed seed so that the failures are reproducible.
+static u64 s_random_state = 0x9E3779B97F4A7C15;
+
+NODISCARD static u64 next_random()
+{
+    u64 value = (s_random_state += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+template<typename T>
+NODISCARD static T from_bits(u64 bits)
+{
+    using BitsType = std::conditional_t<sizeof(T) == sizeof(u32), u32, u64>;
+    const BitsType narrow_bits = static_cast<BitsType>(bits);
+    T value;
+    std::memcpy(&value, &narrow_bits, sizeof(value));
+    return value;
+}
+
+template<typename T>
+NODISCARD static StringView format_expected(char* buffer, T value, Type type, u32 precision)
+{
+    if (std::isnan(value))
+        return "nan"sv;
+
+    char* const buffer_end = buffer + BufferByteCount;
+    std::to_chars_result result;
+    if (type == Type::Default)
+        result = std::to_chars(buffer, buffer_end, value);
+    else if (precision == FormatBuilder::Specifier::NoPrecision)
+        result = std::to_chars(buffer, buffer_end, value,
+                               type == Type::Fixed ? std::chars_format::fixed : std::chars_format::scientific);
+    else
+        result = std::to_chars(buffer, buffer_end, value,
+                               type == Type::Fixed ? std::chars_format::fixed : std::chars_format::scientific,
+                               static_cast<int>(precision));
+
+    return StringView::from_utf8(buffer, static_cast<usize>(result.ptr - buffer));
+}
+
+template<typename T>
+static void check(T value, Type type, u32 precision = FormatBuilder::Specifier::NoPrecision)
+{
+    char expected_buffer[BufferByteCount];
+    char buffer[BufferByteCount];
+
+    FormatBuilder::Specifier specifier;
+    specifier.type = type;
+    specifier.precision = precision;
+    FormatBuilder builder = FormatBuilder(buffer, BufferByteCount);
+    builder.push_floating_point(value, specifier);
+
+    const StringView expected = format_expected(expected_buffer, value, type, precision);
+    const StringView formatted = StringView::from_utf8(buffer, builder.written_byte_count());
+    ++s_check_count;
+    if (formatted == expected)
+        return;
+
+    if (s_mismatch_count++ < MaximumReportedMismatchCount)
+    {
+        const char* notation = (type == Type::Fixed) ? "fixed" : (type == Type::Scientific) ? "scientific" : "shortest";
+        std::printf("Mismatch (%s, %s, precision %d) for %a: expected '%.*s', formatted '%.*s'.\n",
+                    sizeof(T) == sizeof(f32) ? "f32" : "f64", notation,
+                    precision == FormatBuilder::Specifier::NoPrecision ? -1 : static_cast<int>(precision),
+                    static_cast<f64>(value), static_cast<int>(expected.byte_count()), expected.characters(),
+                    static_cast<int>(formatted.byte_count()), formatted.characters());
+    }
+}
+
+template<typename T>
+static void check_shortest_notations(T value)
+{
+    check(value, Type::Default);
+    check(value, Type::Fixed);
+    check(value, Type::Scientific);
+}
+
+static void check_precision_notations(f64 value, u32 precision)
+{
+    check(value, Type::Fixed, precision);
+    check(value, Type::Scientific, precision);
+}
+
+static void check_edge_cases()
+{
+    // The powers of two and their neighbours, which cover every exponent and both boundaries of each binade.
+    for (u64 exponent = 0; exponent <= 0x7FF; ++exponent)
+    {
+        const u64 bits = exponent << 52;
+        for (const u64 neighbour_bits : { bits, bits + 1, bits - 1 })
+        {
+            check_shortest_notations(from_bits<f64>(neighbour_bits));
+            check_shortest_notations(from_bits<f64>(neighbour_bits | (u64(1) << 63)));
+        }
+    }
+    for (u64 exponent = 0; exponent <= 0xFF; ++exponent)
+    {
+        const u64 bits = exponent << 23;
+        for (const u64 neighbour_bits : { bits, bits + 1, bits - 1 })
+        {
+            check_shortest_notations(from_bits<f32>(neighbour_bits));
+            check_shortest_notations(from_bits<f32>(neighbour_bits | (u64(1) << 31)));
+        }
+    }
+
+    // The smallest subnormals.
+    for (u64 bits = 0; bits < 1024; ++bits)
+    {
+        check_shortest_notations(from_bits<f64>(bits));
+        check_shortest_notations(from_bits<f32>(bits));
+    }
+
+    const f64 values[] = {
+        0.0,
+        -0.0,
+        1.0,
+        0.1,
+        0.5,
+        2.5,
+        1e23,
+        9007199254740993.0,
+        std::numeric_limits<f64>::denorm_min(),
+        std::numeric_limits<f64>::min(),
+        std::numeric_limits<f64>::max(),
+        std::numeric_limits<f64>::infinity(),
+        -std::numeric_limits<f64>::infinity(),
+        std::numeric_limits<f64>::quiet_NaN(),
+    };
+    for (const f64 value : values)
+    {
+        check_shortest_notations(value);
+        check_shortest_notations(static_cast<f32>(value));
+        for (u32 precision = 0; precision <= MaximumRandomPrecision; ++precision)
+            check_precision_notations(value, precision);
+    }
+
+    // The full precision, which writes every digit of the smallest subnormal and of the largest number.
+    check_precision_notations(std::numeric_limits<f64>::denorm_min(), MaxFloatingPointFractionDigitCount);
+    check_precision_notations(std::numeric_limits<f64>::max(), MaxFloatingPointFractionDigitCount);
+}
+
+static void check_random_values(usize value_count)
+{
+    for (usize index = 0; index < value_count; ++index)
+    {
+        const u64 bits = next_random();
+        check_shortest_notations(from_bits<f64>(bits));
+        check_shortest_notations(from_bits<f32>(bits));
+
+        // Random bit patterns are mostly huge or tiny, so values of ordinary magnitudes are checked as well.
+        const u32 precision = static_cast<u32>(next_random() % (MaximumRandomPrecision + 1));
+        const f64 ordinary_value = static_cast<f64>(static_cast<i64>(next_random())) / static_cast<f64>(u64(1) << 40);
+        check_precision_notations(from_bits<f64>(bits), precision);
+        check_precision_notations(ordinary_value, precision);
+    }
+}
+
+} // namespace Tests
+
+} // namespace AT
+
+int main(int argument_count, char** arguments)
+{
+    // The number of random values can be raised from the command line, for a more thorough run.
+    const AT::usize random_value_count =
+        (argument_count > 1) ? std::strtoull(arguments[1], nullptr, 10) : AT::Tests::DefaultRandomValueCount;
+
+    AT::Tests::check_edge_cases();
+    AT::Tests::check_random_values(random_value_count);
+
+    std::printf("%zu checks, %zu mismatches.\n", AT::Tests::s_check_count, AT::Tests::s_mismatch_count);
+    return (AT::Tests::s_mismatch_count == 0) ? 0 : 1;
+}
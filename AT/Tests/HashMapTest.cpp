@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/HashMap.h"
+
+#include <cstdio>
+#include <utility>
+
+//
+// Checks the lookups of HashMap: the values are found after the table grows and after removals, and the lookups of
+// a const map only give const access to its entries.
+//
+
+namespace AT
+{
+
+namespace Tests
+{
+
+constexpr u32 KeyCount = 10'000;
+
+static usize s_failure_count = 0;
+
+using MapType = HashMap<u32, u32>;
+
+static_assert(IsSame<decltype(std::declval<MapType&>().find_entry(0u)), MapType::Entry*>);
+static_assert(IsSame<decltype(std::declval<const MapType&>().find_entry(0u)), const MapType::Entry*>);
+static_assert(IsSame<decltype(std::declval<MapType&>().find(0u)), u32*>);
+static_assert(IsSame<decltype(std::declval<const MapType&>().find(0u)), const u32*>);
+
+static void check(bool condition, const char* description, u32 key)
+{
+    if (condition)
+        return;
+
+    ++s_failure_count;
+    std::printf("Failure (%s) for key %u.\n", description, key);
+}
+
+static void check_lookups()
+{
+    MapType map;
+    for (u32 key = 0; key < KeyCount; ++key)
+        MUST(map.try_set(key, key * 3));
+
+    // Remove every other key, so that the lookups have to probe past the deleted slots.
+    for (u32 key = 0; key < KeyCount; key += 2)
+        check(map.remove(key), "remove an existing key", key);
+
+    const MapType& const_map = map;
+    for (u32 key = 0; key < KeyCount; ++key)
+    {
+        const u32* value = const_map.find(key);
+        if (key % 2 == 0)
+        {
+            check(value == nullptr, "find a removed key", key);
+            continue;
+        }
+
+        check(value != nullptr && *value == key * 3, "find a present key", key);
+        const MapType::Entry* entry = const_map.find_entry(key);
+        check(entry != nullptr && entry->key == key, "find the entry of a present key", key);
+    }
+
+    check(map.count() == KeyCount / 2, "count after the removals", KeyCount);
+}
+
+} // namespace Tests
+
+} // namespace AT
+
+int main()
+{
+    AT::Tests::check_lookups();
+
+    std::printf("%zu failures.\n", AT::Tests::s_failure_count);
+    return (AT::Tests::s_failure_count == 0) ? 0 : 1;
+}
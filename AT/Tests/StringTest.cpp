@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/String.h"
+
+#include <cstdio>
+
+//
+// Checks the assignment of a view into the string itself (a substring of its own characters), for strings that are
+// stored inline, on the heap and in a shared heap buffer. The view overlaps the storage that is being overwritten.
+//
+
+namespace AT
+{
+
+namespace Tests
+{
+
+static usize s_failure_count = 0;
+
+static void check(const String& string, StringView expected, const char* description)
+{
+    if (string.to_view() == expected && string.characters()[string.byte_count() - 1] == 0)
+        return;
+
+    ++s_failure_count;
+    std::printf("Failure (%s): expected '%.*s', got '%.*s' (%zu bytes).\n", description,
+                static_cast<int>(expected.byte_count()), expected.characters(),
+                static_cast<int>(string.byte_count() - 1), string.characters(), string.byte_count() - 1);
+}
+
+static void check_inline_self_view()
+{
+    String prefix = "hello world"sv;
+    prefix = prefix.to_view().substring(0, 5);
+    check(prefix, "hello"sv, "inline string, assigned its prefix");
+
+    String suffix = "hello world"sv;
+    suffix = suffix.to_view().substring(6, 5);
+    check(suffix, "world"sv, "inline string, assigned its suffix");
+
+    String whole = "hello world"sv;
+    whole = whole.to_view();
+    check(whole, "hello world"sv, "inline string, assigned itself");
+}
+
+static void check_heap_self_view()
+{
+    constexpr StringView Characters = "The quick brown fox jumps over the lazy dog, twice over."sv;
+
+    String prefix = Characters;
+    prefix = prefix.to_view().substring(0, 5);
+    check(prefix, "The q"sv, "heap string, assigned an inline prefix");
+
+    String long_prefix = Characters;
+    long_prefix = long_prefix.to_view().substring(0, 43);
+    check(long_prefix, "The quick brown fox jumps over the lazy dog"sv, "heap string, assigned a heap prefix");
+
+    String suffix = Characters;
+    suffix = suffix.to_view().substring(4, Characters.byte_count() - 4);
+    check(suffix, "quick brown fox jumps over the lazy dog, twice over."sv, "heap string, assigned a heap suffix");
+
+    String shared = String::create_shared(Characters);
+    const String other_reference = shared;
+    shared = shared.to_view().substring(10, 33);
+    check(shared, "brown fox jumps over the lazy dog"sv, "shared string, assigned a heap substring");
+    check(other_reference, Characters, "shared string, the other reference");
+}
+
+} // namespace Tests
+
+} // namespace AT
+
+int main()
+{
+    AT::Tests::check_inline_self_view();
+    AT::Tests::check_heap_self_view();
+
+    std::printf("%zu failures.\n", AT::Tests::s_failure_count);
+    return (AT::Tests::s_failure_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/UTF8.h"
+
+#include <cstdio>
+
+//
+// Checks the code point iteration of StringView. Invalid sequences must decode to U+FFFD once per maximal subpart,
+// without consuming the byte that breaks the sequence. Random byte strings are checked as well: the decoded code
+// points are always valid scalar values, and the valid strings decode exactly as transcode_utf8_to_utf32() does.
+//
+
+namespace AT
+{
+
+namespace Tests
+{
+
+constexpr usize RandomStringCount = 20'000;
+constexpr usize MaximumRandomStringByteCount = 32;
+
+static usize s_failure_count = 0;
+
+static void report_failure(StringView string, const char* description)
+{
+    ++s_failure_count;
+    std::printf("Failure (%s) for:", description);
+    for (usize offset = 0; offset < string.byte_count(); ++offset)
+        std::printf(" %02X", static_cast<u8>(string.characters()[offset]));
+    std::printf("\n");
+}
+
+static void
+check_code_points(StringView string, const u32* expected_code_points, usize expected_count, const char* description)
+{
+    usize index = 0;
+    for (const u32 code_point : string.code_points())
+    {
+        if (index >= expected_count || code_point != expected_code_points[index])
+        {
+            report_failure(string, description);
+            return;
+        }
+        ++index;
+    }
+
+    if (index != expected_count)
+        report_failure(string, description);
+}
+
+template<usize ExpectedCount>
+static void
+check_code_points(StringView string, const u32 (&expected_code_points)[ExpectedCount], const char* description)
+{
+    check_code_points(string, expected_code_points, ExpectedCount, description);
+}
+
+static void check_known_sequences()
+{
+    constexpr u32 R = UTF8CodePointIterator::ReplacementCodePoint;
+
+    const u32 valid[] = { 'a', 0xE9, 0x20AC, 0x1D11E, 0x10FFFF, 'z' };
+    check_code_points("a\xC3\xA9\xE2\x82\xAC\xF0\x9D\x84\x9E\xF4\x8F\xBF\xBFz"sv, valid, "valid sequences");
+
+    const u32 mixed[] = { 'a', R, '(', R, R, 'z' };
+    check_code_points("a\xC3(\xFF\xE4\xB8z"sv, mixed, "broken sequences between ASCII characters");
+
+    const u32 overlong[] = { R, R, R, R, R, R, R, R, R, R };
+    check_code_points("\xC0\x80\xC1\xBF\xE0\x80\x80\xF0\x80\x80"sv, overlong, "overlong encodings");
+
+    const u32 surrogate[] = { R, R, R, 0xD7FF, 0xE000 };
+    check_code_points("\xED\xA0\x80\xED\x9F\xBF\xEE\x80\x80"sv, surrogate, "surrogates");
+
+    const u32 too_large[] = { R, R, R, R, R, R };
+    check_code_points("\xF4\x90\x80\x80\xF5\x80"sv, too_large, "code points above U+10FFFF");
+
+    const u32 truncated[] = { 'a', R, R, R };
+    check_code_points("a\xF0\x9F\x98\xE2\x82\xC3"sv, truncated, "truncated sequences");
+
+    const u32 lone_continuation[] = { R, R, 'b' };
+    // The literal is split, as "\xBFb" would be parsed as a single hexadecimal escape sequence.
+    check_code_points("\x80\xBF" "b"sv, lone_continuation, "continuation bytes without a lead byte");
+}
+
+static void check_random_strings()
+{
+    // Bytes that are likely to form valid sequences, broken sequences and boundary cases.
+    constexpr u8 Alphabet[] = { 0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC2,
+                                0xDF, 0xE0, 0xE1, 0xED, 0xEF, 0xF0, 0xF3, 0xF4, 0xF5, 0xFF };
+    constexpr usize AlphabetSize = sizeof(Alphabet);
+
+    u64 random_state = 0x2545F4914F6CDD1D;
+    char bytes[MaximumRandomStringByteCount];
+    u32 decoded[MaximumRandomStringByteCount];
+    u32 expected[MaximumRandomStringByteCount];
+
+    for (usize string_index = 0; string_index < RandomStringCount; ++string_index)
+    {
+        // xorshift64, with a fixed seed so that the failures are reproducible.
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+
+        const usize byte_count = random_state % (MaximumRandomStringByteCount + 1);
+        u64 byte_state = random_state;
+        for (usize index = 0; index < byte_count; ++index)
+        {
+            byte_state = byte_state * 6364136223846793005 + 1442695040888963407;
+            bytes[index] = static_cast<char>(Alphabet[(byte_state >> 33) % AlphabetSize]);
+        }
+
+        const StringView string = StringView::from_utf8(bytes, byte_count);
+        const bool is_valid = string.is_valid_utf8();
+
+        usize code_point_count = 0;
+        bool has_failed = false;
+        for (const u32 code_point : string.code_points())
+        {
+            const bool is_scalar_value = code_point <= 0x10FFFF && (code_point < 0xD800 || code_point > 0xDFFF);
+            if (!is_scalar_value)
+                has_failed = true;
+            decoded[code_point_count++] = code_point;
+        }
+
+        if (is_valid)
+        {
+            MUST_ASSIGN(const usize expected_count, transcode_utf8_to_utf32(string, Span<u32>(expected, byte_count)));
+            if (expected_count != code_point_count)
+                has_failed = true;
+            for (usize index = 0; index < expected_count && !has_failed; ++index)
+                has_failed = (decoded[index] != expected[index]);
+        }
+
+        if (has_failed)
+            report_failure(string, "random string");
+    }
+}
+
+} // namespace Tests
+
+} // namespace AT
+
+int main()
+{
+    AT::Tests::check_known_sequences();
+    AT::Tests::check_random_strings();
+
+    std::printf("%zu failures.\n", AT::Tests::s_failure_count);
+    return (AT::Tests::s_failure_count == 0) ? 0 : 1;
+}
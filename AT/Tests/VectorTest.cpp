@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/Vector.h"
+
+#include <cstdio>
+
+//
+// Checks that resizing a vector value-initializes the new elements: trivially default constructible elements are
+// zeroed, while the elements with default member initializers are constructed (even if they are trivially copyable).
+//
+
+namespace AT
+{
+
+namespace Tests
+{
+
+static usize s_failure_count = 0;
+
+struct InitializedU32
+{
+    u32 value = 7;
+};
+
+static_assert(IsTriviallyCopyable<InitializedU32>);
+static_assert(!IsTriviallyDefaultConstructible<InitializedU32>);
+
+NODISCARD static u32 get_value(u32 element) { return element; }
+NODISCARD static u32 get_value(InitializedU32 element) { return element.value; }
+
+template<typename T>
+static void check_resize(u32 expected_value, const char* description)
+{
+    Vector<T> vector;
+    MUST(vector.try_resize(3));
+    MUST(vector.try_resize(1));
+    MUST(vector.try_resize(40));
+
+    for (usize index = 0; index < vector.count(); ++index)
+    {
+        const u32 value = get_value(vector[index]);
+        if (value == expected_value)
+            continue;
+
+        ++s_failure_count;
+        std::printf("Failure (%s): element %zu is %u instead of %u.\n", description, index, value, expected_value);
+        return;
+    }
+}
+
+} // namespace Tests
+
+} // namespace AT
+
+int main()
+{
+    AT::Tests::check_resize<AT::u32>(0, "u32");
+    AT::Tests::check_resize<AT::Tests::InitializedU32>(7, "default member initializer");
+
+    std::printf("%zu failures.\n", AT::Tests::s_failure_count);
+    return (AT::Tests::s_failure_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Hash.h"
+
+#include <cstring>
+
+namespace AT
+{
+
+namespace Detail
+{
+
+template<typename T>
+static constexpr bool IsDependentFalse = false;
+
+} // namespace Detail
+
+///
+/// A type is trivially hashable if its hash can be computed from the bytes of its object representation,
+/// which implies that equal values have identical bytes. Spans of such types are hashed in bulk.
+///
+template<typename T>
+inline constexpr bool IsTriviallyHashable = std::is_integral_v<T> || std::is_enum_v<T> || IsPointer<T>;
+
+//
+// Describes how the instances of a type are hashed. The hash containers use it by default.
+// Integers, enumerations, floating point numbers and pointers are supported out of the box. Any other type
+// must specialize this structure, a good starting point for composite types being hash_combine().
+//
+template<typename T>
+struct TypeTraits
+{
+    NODISCARD ALWAYS_INLINE static u64 get_hash(const T& value)
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            return hash_integer(static_cast<u64>(value));
+        }
+        else if constexpr (IsPointer<T>)
+        {
+            return hash_integer(static_cast<u64>(reinterpret_cast<uintptr>(value)));
+        }
+        else if constexpr (IsFloatingPoint<T>)
+        {
+            // Positive and negative zero compare equal, so they must have the same hash.
+            if (value == 0)
+                return hash_integer(0);
+
+            using BitsType = std::conditional_t<sizeof(T) == sizeof(u32), u32, u64>;
+            BitsType bits;
+            std::memcpy(&bits, &value, sizeof(T));
+            return hash_integer(bits);
+        }
+        else
+        {
+            static_assert(Detail::IsDependentFalse<T>, "TypeTraits<T>::get_hash must be specialized for this type");
+            return 0;
+        }
+    }
+};
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::IsTriviallyHashable;
+using AT::TypeTraits;
+#endif // AT_INCLUDE_GLOBALLY
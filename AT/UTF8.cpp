@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include "AT/UTF8.h"
+#include "AT/CPUFeatures.h"
+
+#include <cstring>
+
+#if AT_ARCHITECTURE_X86_64
+    #include <emmintrin.h>
+#endif // AT_ARCHITECTURE_X86_64
+
+namespace AT
+{
+
+namespace Detail
+{
+
+#if AT_ARCHITECTURE_X86_64
+// Implemented in UTF8AVX2.cpp, which is compiled with AVX2 code generation enabled.
+bool is_valid_utf8_avx2(const u8* bytes, usize byte_count);
+#endif // AT_ARCHITECTURE_X86_64
+
+} // namespace Detail
+
+// Decodes a single code point and returns the number of bytes it occupies, or zero if the sequence is invalid.
+// The lead byte must not be ASCII.
+NODISCARD ALWAYS_INLINE static inline usize
+decode_multibyte_sequence(const u8* bytes, usize remaining_byte_count, u32& out)
+{
+    const u8 lead_byte = bytes[0];
+
+    // The lower bound of the second byte rejects the overlong encodings, while the upper bound rejects
+    // the surrogates (for 0xED) and the code points above U+10FFFF (for 0xF4).
+    usize byte_count;
+    u8 second_byte_min = 0x80;
+    u8 second_byte_max = 0xBF;
+
+    if (lead_byte >= 0xC2 && lead_byte <= 0xDF)
+    {
+        byte_count = 2;
+        out = lead_byte & 0x1F;
+    }
+    else if (lead_byte >= 0xE0 && lead_byte <= 0xEF)
+    {
+        byte_count = 3;
+        out = lead_byte & 0x0F;
+        if (lead_byte == 0xE0)
+            second_byte_min = 0xA0;
+        else if (lead_byte == 0xED)
+            second_byte_max = 0x9F;
+    }
+    else if (lead_byte >= 0xF0 && lead_byte <= 0xF4)
+    {
+        byte_count = 4;
+        out = lead_byte & 0x07;
+        if (lead_byte == 0xF0)
+            second_byte_min = 0x90;
+        else if (lead_byte == 0xF4)
+            second_byte_max = 0x8F;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (byte_count > remaining_byte_count)
+        return 0;
+    if (bytes[1] < second_byte_min || bytes[1] > second_byte_max)
+        return 0;
+
+    out = (out << 6) | (bytes[1] & 0x3F);
+    for (usize index = 2; index < byte_count; ++index)
+    {
+        if ((bytes[index] & 0xC0) != 0x80)
+            return 0;
+        out = (out << 6) | (bytes[index] & 0x3F);
+    }
+
+    return byte_count;
+}
+
+// Returns the number of leading bytes that are ASCII.
+NODISCARD ALWAYS_INLINE static inline usize skip_ascii(const u8* bytes, usize byte_count)
+{
+    usize offset = 0;
+
+#if AT_ARCHITECTURE_X86_64
+    for (; offset + 16 <= byte_count; offset += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+        if (_mm_movemask_epi8(block) != 0)
+            break;
+    }
+#else
+    for (; offset + sizeof(u64) <= byte_count; offset += sizeof(u64))
+    {
+        u64 word;
+        std::memcpy(&word, bytes + offset, sizeof(u64));
+        if ((word & 0x8080808080808080ull) != 0)
+            break;
+    }
+#endif // AT_ARCHITECTURE_X86_64
+
+    while (offset < byte_count && bytes[offset] < 0x80)
+        ++offset;
+    return offset;
+}
+
+static bool is_valid_utf8_scalar(const u8* bytes, usize byte_count)
+{
+    usize offset = 0;
+    while (offset < byte_count)
+    {
+        offset += skip_ascii(bytes + offset, byte_count - offset);
+        if (offset == byte_count)
+            break;
+
+        u32 code_point;
+        const usize sequence_byte_count = decode_multibyte_sequence(bytes + offset, byte_count - offset, code_point);
+        if (sequence_byte_count == 0)
+            return false;
+        offset += sequence_byte_count;
+    }
+
+    return true;
+}
+
+bool is_valid_utf8(const char* characters, usize byte_count)
+{
+    using ValidationKernel = bool (*)(const u8*, usize);
+
+    static const ValidationKernel s_kernel = []() -> ValidationKernel
+    {
+#if AT_ARCHITECTURE_X86_64
+        if (get_cpu_features().has_avx2)
+            return Detail::is_valid_utf8_avx2;
+#endif // AT_ARCHITECTURE_X86_64
+        return is_valid_utf8_scalar;
+    }();
+
+    return s_kernel(reinterpret_cast<const u8*>(characters), byte_count);
+}
+
+usize count_utf8_code_points(const char* characters, usize byte_count)
+{
+    // Each code point has exactly one byte that is not a continuation byte (10xxxxxx), and the continuation bytes are
+    // the only ones that are less than -64 when interpreted as signed integers.
+    const i8* bytes = reinterpret_cast<const i8*>(characters);
+    usize code_point_count = 0;
+    usize offset = 0;
+
+#if AT_ARCHITECTURE_X86_64
+    const __m128i continuation_threshold = _mm_set1_epi8(-65);
+    while (offset + 16 <= byte_count)
+    {
+        // The per-byte counters are summed before they can overflow.
+        const usize iteration_count = (byte_count - offset) / 16 < 255 ? (byte_count - offset) / 16 : 255;
+        __m128i counters = _mm_setzero_si128();
+        for (usize iteration = 0; iteration < iteration_count; ++iteration, offset += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+            // The comparison result is -1 for the bytes that start a code point.
+            counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(block, continuation_threshold));
+        }
+
+        const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        code_point_count += static_cast<usize>(_mm_cvtsi128_si32(sums));
+        code_point_count += static_cast<usize>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums)));
+    }
+#endif // AT_ARCHITECTURE_X86_64
+
+    for (; offset < byte_count; ++offset)
+        code_point_count += (bytes[offset] > -65);
+    return code_point_count;
+}
+
+ErrorOr<usize> transcode_utf8_to_utf32(StringView string, Span<u32> destination)
+{
+    const u8* bytes = reinterpret_cast<const u8*>(string.characters());
+    const usize byte_count = string.byte_count();
+    u32* output = destination.elements();
+    const usize output_capacity = destination.count();
+
+    usize offset = 0;
+    usize output_count = 0;
+
+    while (offset < byte_count)
+    {
+#if AT_ARCHITECTURE_X86_64
+        // Blocks of ASCII characters are widened directly, without decoding.
+        if (offset + 16 <= byte_count && output_count + 16 <= output_capacity)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+            if (_mm_movemask_epi8(block) == 0)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i low_words = _mm_unpacklo_epi8(block, zero);
+                const __m128i high_words = _mm_unpackhi_epi8(block, zero);
+
+                __m128i* output_block = reinterpret_cast<__m128i*>(output + output_count);
+                _mm_storeu_si128(output_block + 0, _mm_unpacklo_epi16(low_words, zero));
+                _mm_storeu_si128(output_block + 1, _mm_unpackhi_epi16(low_words, zero));
+                _mm_storeu_si128(output_block + 2, _mm_unpacklo_epi16(high_words, zero));
+                _mm_storeu_si128(output_block + 3, _mm_unpackhi_epi16(high_words, zero));
+
+                offset += 16;
+                output_count += 16;
+                continue;
+            }
+        }
+#endif // AT_ARCHITECTURE_X86_64
+
+        if (output_count == output_capacity)
+            return Error::Code::BufferTooSmall;
+
+        if (bytes[offset] < 0x80)
+        {
+            output[output_count++] = bytes[offset++];
+            continue;
+        }
+
+        u32 code_point;
+        const usize sequence_byte_count = decode_multibyte_sequence(bytes + offset, byte_count - offset, code_point);
+        if (sequence_byte_count == 0)
+            return Error::Code::InvalidEncoding;
+
+        output[output_count++] = code_point;
+        offset += sequence_byte_count;
+    }
+
+    return output_count;
+}
+
+} // namespace AT
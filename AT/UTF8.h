@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include "AT/CoreTypes.h"
+#include "AT/Error.h"
+#include "AT/Span.h"
+#include "AT/StringView.h"
+
+namespace AT
+{
+
+//
+// Bulk UTF-8 operations. They process the input in blocks, using vector instructions when available, and
+// are intended for large amounts of text. For iterating over the code points see UTF8CodePointIterator.
+//
+
+// Checks that the bytes are valid UTF-8, according to the Unicode standard: no overlong encodings, no surrogates
+// and no code points above U+10FFFF. The check is vectorized using AVX2, when the CPU supports it.
+NODISCARD AT_API bool is_valid_utf8(const char* characters, usize byte_count);
+
+// The characters must be valid UTF-8.
+NODISCARD AT_API usize count_utf8_code_points(const char* characters, usize byte_count);
+
+// Decodes the UTF-8 string into the provided buffer and returns the number of code points written.
+// The string is validated while decoding. If it is not valid UTF-8, Error::Code::InvalidEncoding is returned.
+// If the buffer can't store all code points, Error::Code::BufferTooSmall is returned. A buffer that has at least
+// as many elements as the string has bytes is always large enough.
+NODISCARD AT_API ErrorOr<usize> transcode_utf8_to_utf32(StringView string, Span<u32> destination);
+
+} // namespace AT
+
+#if AT_INCLUDE_GLOBALLY
+using AT::count_utf8_code_points;
+using AT::is_valid_utf8;
+using AT::transcode_utf8_to_utf32;
+#endif // AT_INCLUDE_GLOBALLY
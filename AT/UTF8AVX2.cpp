@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2023 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+// NOTE: This translation unit is compiled with the AVX2 code generation flags. The kernels
+// defined here must only be invoked after checking that the CPU supports AVX2.
+
+#include "AT/CoreTypes.h"
+
+#if AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
+
+    #include <cstring>
+    #include <immintrin.h>
+
+namespace AT::Detail
+{
+
+//
+// UTF-8 validation using the lookup algorithm of John Keiser and Daniel Lemire ("Validating UTF-8 In Less Than
+// One Instruction Per Byte"). Almost all errors can be detected by looking at two consecutive bytes: the high
+// nibble of the first byte, its low nibble and the high nibble of the second byte each index a table of error
+// classes, and a pair of bytes is invalid if all three lookups share an error class. The only errors that require
+// more context are the missing and the unexpected continuation bytes of three and four byte sequences, which are
+// detected by checking the bytes two and three positions back.
+//
+
+// The error classes, with the pairs of bytes that belong to them.
+static constexpr u8 TooShort = 1 << 0;         // 11______ 0_______ or 11______ 11______
+static constexpr u8 TooLong = 1 << 1;          // 0_______ 10______
+static constexpr u8 Overlong3 = 1 << 2;        // 11100000 100_____
+static constexpr u8 TooLarge = 1 << 3;         // 11110100 1001____, 11110100 101_____, 11110101 ________, ...
+static constexpr u8 Surrogate = 1 << 4;        // 11101101 101_____
+static constexpr u8 Overlong2 = 1 << 5;        // 1100000_ 10______
+static constexpr u8 TwoContinuations = 1 << 7; // 10______ 10______
+
+// These two classes never overlap, as their first bytes differ, so they share the same bit.
+static constexpr u8 TooLarge1000 = 1 << 6; // 11110101 1000____, ...
+static constexpr u8 Overlong4 = 1 << 6;    // 11110000 1000____
+
+// The classes for which the low nibble of the first byte doesn't matter.
+static constexpr u8 Carry = TooShort | TooLong | TwoContinuations;
+
+ALWAYS_INLINE static inline __m256i make_table(
+    u8 x0, u8 x1, u8 x2, u8 x3, u8 x4, u8 x5, u8 x6, u8 x7,
+    u8 x8, u8 x9, u8 x10, u8 x11, u8 x12, u8 x13, u8 x14, u8 x15
+)
+{
+    // The byte shuffle instruction operates on each 128-bit lane independently, so the table is duplicated.
+    return _mm256_setr_epi8(
+        x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15,
+        x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15
+    );
+}
+
+// Returns the input shifted by the given number of bytes, with the last bytes of the previous input shifted in.
+template<int N>
+ALWAYS_INLINE static inline __m256i get_previous_bytes(__m256i input, __m256i previous_input)
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous_input, input, 0x21), 16 - N);
+}
+
+ALWAYS_INLINE static inline __m256i get_high_nibbles(__m256i input)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+}
+
+class UTF8Validator
+{
+public:
+    ALWAYS_INLINE UTF8Validator()
+        : m_error(_mm256_setzero_si256())
+        , m_previous_input(_mm256_setzero_si256())
+        , m_previous_incomplete(_mm256_setzero_si256())
+        , m_first_high_nibble_table(make_table(
+              // 0_______ ________
+              TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+              // 10______ ________
+              TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+              // 1100____ ________
+              TooShort | Overlong2,
+              // 1101____ ________
+              TooShort,
+              // 1110____ ________
+              TooShort | Overlong3 | Surrogate,
+              // 1111____ ________
+              TooShort | TooLarge | TooLarge1000 | Overlong4
+          ))
+        , m_first_low_nibble_table(make_table(
+              // ____0000 ________
+              Carry | Overlong3 | Overlong2 | Overlong4,
+              // ____0001 ________
+              Carry | Overlong2,
+              // ____001_ ________
+              Carry, Carry,
+              // ____0100 ________
+              Carry | TooLarge,
+              // ____0101 ________ to ____1100 ________
+              Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+              Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+              Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+              // ____1101 ________
+              Carry | TooLarge | TooLarge1000 | Surrogate,
+              // ____111_ ________
+              Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000
+          ))
+        , m_second_high_nibble_table(make_table(
+              // ________ 0_______
+              TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+              // ________ 1000____
+              TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+              // ________ 1001____
+              TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+              // ________ 101_____
+              TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+              TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+              // ________ 11______
+              TooShort, TooShort, TooShort, TooShort
+          ))
+    {
+    }
+
+    ALWAYS_INLINE void check_block(__m256i input)
+    {
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            // An ASCII block is only invalid if the previous block ends with an incomplete sequence.
+            m_error = _mm256_or_si256(m_error, m_previous_incomplete);
+            m_previous_incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            m_error = _mm256_or_si256(m_error, check_multibyte_sequences(input));
+            m_previous_incomplete = get_incomplete_sequences(input);
+        }
+
+        m_previous_input = input;
+    }
+
+    NODISCARD ALWAYS_INLINE bool has_error() const { return !_mm256_testz_si256(m_error, m_error); }
+
+private:
+    NODISCARD ALWAYS_INLINE __m256i check_multibyte_sequences(__m256i input) const
+    {
+        const __m256i previous_1 = get_previous_bytes<1>(input, m_previous_input);
+        const __m256i first_high_nibble_errors =
+            _mm256_shuffle_epi8(m_first_high_nibble_table, get_high_nibbles(previous_1));
+        const __m256i first_low_nibble_errors =
+            _mm256_shuffle_epi8(m_first_low_nibble_table, _mm256_and_si256(previous_1, _mm256_set1_epi8(0x0F)));
+        const __m256i second_high_nibble_errors =
+            _mm256_shuffle_epi8(m_second_high_nibble_table, get_high_nibbles(input));
+        const __m256i special_cases = _mm256_and_si256(
+            _mm256_and_si256(first_high_nibble_errors, first_low_nibble_errors),
+            second_high_nibble_errors
+        );
+
+        // The bytes that follow a three or four byte lead byte, at the distance of two or three bytes, must be
+        // continuation bytes. Those are exactly the positions that have the TwoContinuations bit set in the
+        // special cases, so XOR-ing the two masks cancels the expected continuations out.
+        const __m256i previous_2 = get_previous_bytes<2>(input, m_previous_input);
+        const __m256i previous_3 = get_previous_bytes<3>(input, m_previous_input);
+        const __m256i is_third_byte = _mm256_subs_epu8(previous_2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        const __m256i is_fourth_byte = _mm256_subs_epu8(previous_3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        const __m256i must_be_continuation = _mm256_and_si256(
+            _mm256_or_si256(is_third_byte, is_fourth_byte),
+            _mm256_set1_epi8(static_cast<char>(0x80))
+        );
+
+        return _mm256_xor_si256(must_be_continuation, special_cases);
+    }
+
+    // Returns a non-zero value if the last three bytes of the input start a sequence that doesn't fit in them.
+    NODISCARD ALWAYS_INLINE static __m256i get_incomplete_sequences(__m256i input)
+    {
+        const __m256i maximum_values = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1)
+        );
+        return _mm256_subs_epu8(input, maximum_values);
+    }
+
+private:
+    __m256i m_error;
+    __m256i m_previous_input;
+    __m256i m_previous_incomplete;
+
+    __m256i m_first_high_nibble_table;
+    __m256i m_first_low_nibble_table;
+    __m256i m_second_high_nibble_table;
+};
+
+bool is_valid_utf8_avx2(const u8* bytes, usize byte_count)
+{
+    UTF8Validator validator;
+    usize offset = 0;
+
+    for (; offset + 64 <= byte_count; offset += 64)
+    {
+        const __m256i first_half = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + offset));
+        const __m256i second_half = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + offset + 32));
+        validator.check_block(first_half);
+        validator.check_block(second_half);
+    }
+
+    for (; offset + 32 <= byte_count; offset += 32)
+        validator.check_block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + offset)));
+
+    // The remaining bytes are padded with zeroes (ASCII), so that a sequence that is truncated by the end of the
+    // input is reported as an error. If there are no remaining bytes, an empty block is checked for the same reason.
+    alignas(32) u8 last_block[32] = {};
+    if (offset < byte_count)
+        std::memcpy(last_block, bytes + offset, byte_count - offset);
+    validator.check_block(_mm256_load_si256(reinterpret_cast<const __m256i*>(last_block)));
+
+    return !validator.has_error();
+}
+
+} // namespace AT::Detail
+
+#endif // AT_ARCHITECTURE_X86_64 && defined(__AVX2__)
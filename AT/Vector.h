@@ -5,22 +5,57 @@
 
 #pragma once
 
+#include "AT/Allocator.h"
 #include "AT/Assertions.h"
 #include "AT/CoreTypes.h"
 #include "AT/Error.h"
+#include "AT/MemoryOperations.h"
 #include "AT/Span.h"
 
 namespace AT
 {
 
+namespace Detail
+{
+
+template<typename T, usize InlineCapacity>
+struct VectorInlineStorage
+{
+    NODISCARD ALWAYS_INLINE T* inline_elements() { return reinterpret_cast<T*>(m_inline_storage); }
+
+    alignas(T) u8 m_inline_storage[InlineCapacity * sizeof(T)];
+};
+
+// Vectors without inline capacity don't pay any storage cost, due to the empty base optimization.
+template<typename T>
+struct VectorInlineStorage<T, 0>
+{
+    NODISCARD ALWAYS_INLINE T* inline_elements() { return nullptr; }
+};
+
+} // namespace Detail
+
 ///
 /// Dynamic collection of elements that are stored contiguously in memory.
 /// The type of elements stored in this container must provide the ability
 /// to be moved in memory, as this operation is performed every time the
 /// vector grows, shrinks or the elements are shifted.
+/// If the type is trivially relocatable (see IsTriviallyRelocatable) these
+/// operations are performed in bulk, by copying the memory of the elements.
 ///
-template<typename T>
-class Vector
+/// The memory is acquired from the allocator the vector was created with, or
+/// from the global heap if no allocator was specified. The copies of a vector
+/// use the same allocator as the original one.
+///
+/// The first InlineCapacity elements are stored inside the vector object, so
+/// no memory is allocated until the vector grows beyond that count.
+///
+/// A vector that has its own VirtualMemoryAllocator grows in place, by
+/// committing more pages of the reserved address space, so its elements are
+/// never moved (and the references to them are never invalidated).
+///
+template<typename T, usize InlineCapacity = 0>
+class Vector : private Detail::VectorInlineStorage<T, InlineCapacity>
 {
 public:
     using Iterator = T*;
@@ -29,28 +64,47 @@ public:
     using ReverseConstIterator = const T*;
 
 public:
-    ALWAYS_INLINE static ErrorOr<Vector<T>> try_create_with_initial_capacity(usize initial_capacity)
+    ALWAYS_INLINE static ErrorOr<Vector>
+    try_create_with_initial_capacity(usize initial_capacity, Allocator* allocator = nullptr)
     {
-        Vector<T> vector;
-        vector.m_count = 0;
-        vector.m_capacity = initial_capacity;
-        TRY_ASSIGN(vector.m_elements, try_allocate_memory(initial_capacity));
+        Vector vector = Vector(allocator);
+        if (initial_capacity > vector.m_capacity)
+            TRY(vector.try_reallocate_to_fixed(initial_capacity));
         return vector;
     }
 
 public:
     ALWAYS_INLINE Vector()
-        : m_elements(nullptr)
-        , m_capacity(0)
+        : m_elements(this->inline_elements())
+        , m_capacity(InlineCapacity)
+        , m_count(0)
+        , m_allocator(nullptr)
+    {
+    }
+
+    ALWAYS_INLINE explicit Vector(Allocator* allocator)
+        : m_elements(this->inline_elements())
+        , m_capacity(InlineCapacity)
         , m_count(0)
+        , m_allocator(allocator)
     {
     }
 
     ALWAYS_INLINE Vector(const Vector& other)
         : m_count(other.m_count)
+        , m_allocator(other.m_allocator)
     {
-        m_capacity = m_count;
-        MUST_ASSIGN(m_elements, try_allocate_memory(m_capacity));
+        if (m_count <= InlineCapacity)
+        {
+            m_elements = this->inline_elements();
+            m_capacity = InlineCapacity;
+        }
+        else
+        {
+            m_capacity = m_count;
+            MUST_ASSIGN(m_elements, try_allocate_memory(m_capacity));
+        }
+
         copy_elements(m_elements, other.m_elements, m_count);
     }
 
@@ -58,10 +112,16 @@ public:
         : m_elements(other.m_elements)
         , m_capacity(other.m_capacity)
         , m_count(other.m_count)
+        , m_allocator(other.m_allocator)
     {
-        other.m_elements = nullptr;
-        other.m_capacity = 0;
-        other.m_count = 0;
+        if (other.is_using_inline_storage())
+        {
+            // The elements stored inline can't be stolen, so they are relocated instead.
+            m_elements = this->inline_elements();
+            move_elements(m_elements, other.m_elements, m_count);
+        }
+
+        other.reset_to_inline_storage();
     }
 
     ALWAYS_INLINE Vector& operator=(const Vector& other)
@@ -95,11 +155,16 @@ public:
         m_elements = other.m_elements;
         m_capacity = other.m_capacity;
         m_count = other.m_count;
+        m_allocator = other.m_allocator;
 
-        other.m_elements = nullptr;
-        other.m_capacity = 0;
-        other.m_count = 0;
+        if (other.is_using_inline_storage())
+        {
+            // The elements stored inline can't be stolen, so they are relocated instead.
+            m_elements = this->inline_elements();
+            move_elements(m_elements, other.m_elements, m_count);
+        }
 
+        other.reset_to_inline_storage();
         return *this;
     }
 
@@ -125,6 +190,11 @@ public:
     NODISCARD ALWAYS_INLINE T& operator[](usize index) { return at(index); }
     NODISCARD ALWAYS_INLINE const T& operator[](usize index) const { return at(index); }
 
+    // Doesn't check the index, regardless of the checking level. Only meant for the loops that already proved their
+    // indices to be in bounds.
+    NODISCARD ALWAYS_INLINE T& unchecked_at(usize index) { return m_elements[index]; }
+    NODISCARD ALWAYS_INLINE const T& unchecked_at(usize index) const { return m_elements[index]; }
+
     NODISCARD ALWAYS_INLINE T& first() { return at(0); }
     NODISCARD ALWAYS_INLINE const T& first() const { return at(0); }
 
@@ -146,14 +216,20 @@ public:
         VERIFY(next_index <= m_count);
 
         // Delete the elements located in the range.
-        for (usize index = index_to_remove_from; index < next_index; ++index)
-            m_elements[index].~T();
+        destroy_elements(m_elements + index_to_remove_from, range_count);
 
         // Shift the remaining elements into the deleted range.
-        for (usize index = next_index; index < m_count; ++index)
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            move_memory(m_elements + index_to_remove_from, m_elements + next_index, (m_count - next_index) * sizeof(T));
+        }
+        else
         {
-            new (m_elements + index - range_count) T(move(m_elements[index]));
-            m_elements[index].~T();
+            for (usize index = next_index; index < m_count; ++index)
+            {
+                new (m_elements + index - range_count) T(move(m_elements[index]));
+                m_elements[index].~T();
+            }
         }
 
         m_count -= range_count;
@@ -183,8 +259,10 @@ public:
 
     ALWAYS_INLINE ErrorOr<void> try_insert_range(usize slot_index, Span<const T> range)
     {
+        VERIFY(slot_index <= m_count);
+
         // Ensure that the vector can store the new element count.
-        try_reallocate_if_required(m_count + range.count());
+        TRY(try_reallocate_if_required(m_count + range.count()));
 
         if (slot_index < m_count)
         {
@@ -193,16 +271,18 @@ public:
         }
 
         // Insert the elements, by copying them to the newly created slots.
-        for (usize index = 0; index < range.count(); ++index)
-            new (m_elements + slot_index + index) T(range[index]);
+        copy_elements(m_elements + slot_index, range.elements(), range.count());
+        m_count += range.count();
 
         return {};
     }
 
     ALWAYS_INLINE ErrorOr<void> try_insert_range_move(usize slot_index, Span<T> range)
     {
+        VERIFY(slot_index <= m_count);
+
         // Ensure that the vector can store the new element count.
-        try_reallocate_if_required(m_count + range.count());
+        TRY(try_reallocate_if_required(m_count + range.count()));
 
         if (slot_index < m_count)
         {
@@ -210,13 +290,24 @@ public:
             unsafe_shift_elements_right(slot_index, range.count());
         }
 
-        // Insert the elements, by copying them to the newly created slots.
-        for (usize index = 0; index < range.count(); ++index)
-            new (m_elements + slot_index + index) T(move(range[index]));
+        // Insert the elements, by moving them to the newly created slots.
+        if constexpr (IsTriviallyCopyable<T>)
+        {
+            copy_memory(m_elements + slot_index, range.elements(), range.byte_count());
+        }
+        else
+        {
+            for (usize index = 0; index < range.count(); ++index)
+                new (m_elements + slot_index + index) T(move(range[index]));
+        }
 
+        m_count += range.count();
         return {};
     }
 
+    /// Wrapper around Vector::try_insert_range(), that inserts the range at the end of the vector.
+    ALWAYS_INLINE ErrorOr<void> try_append(Span<const T> range) { return try_insert_range(m_count, range); }
+
     ALWAYS_INLINE ErrorOr<T&> try_insert(usize slot_index, const T& element)
     {
         TRY(try_insert_range(slot_index, { &element, 1 }));
@@ -232,8 +323,7 @@ public:
 public:
     ALWAYS_INLINE void clear()
     {
-        for (usize index = 0; index < m_count; ++index)
-            m_elements[index].~T();
+        destroy_elements(m_elements, m_count);
         m_count = 0;
     }
 
@@ -241,8 +331,40 @@ public:
     {
         clear();
         MUST(try_release_memory(m_elements, m_capacity));
-        m_elements = nullptr;
-        m_capacity = 0;
+        reset_to_inline_storage();
+    }
+
+    // If the new count is greater than the current one, the new elements are value-initialized. For trivially
+    // default constructible elements that means zero-initialized, which is done in bulk.
+    ALWAYS_INLINE ErrorOr<void> try_resize(usize new_count)
+    {
+        if (new_count <= m_count)
+        {
+            pop_back(m_count - new_count);
+            return {};
+        }
+
+        TRY(try_reallocate_if_required(new_count));
+
+        if constexpr (IsTriviallyDefaultConstructible<T>)
+        {
+            zero_memory(m_elements + m_count, (new_count - m_count) * sizeof(T));
+        }
+        else
+        {
+            for (usize index = m_count; index < new_count; ++index)
+                new (m_elements + index) T();
+        }
+
+        m_count = new_count;
+        return {};
+    }
+
+    // Makes sure that the vector can store the given number of elements without reallocating.
+    ALWAYS_INLINE ErrorOr<void> try_ensure_capacity(usize required_capacity)
+    {
+        TRY(try_reallocate_if_required(required_capacity));
+        return {};
     }
 
     ALWAYS_INLINE ErrorOr<void> try_shrink_to_fit()
@@ -261,8 +383,7 @@ public:
     ALWAYS_INLINE void pop_back(usize count)
     {
         VERIFY(m_count >= count);
-        for (usize index = m_count - count; index < m_count; ++index)
-            m_elements[index].~T();
+        destroy_elements(m_elements + m_count - count, count);
         m_count -= count;
     }
 
@@ -283,6 +404,20 @@ public:
     NODISCARD ALWAYS_INLINE usize available() { return m_capacity - m_count; }
     NODISCARD ALWAYS_INLINE usize element_size() const { return sizeof(T); }
 
+    NODISCARD ALWAYS_INLINE Span<T> span() { return { m_elements, m_count }; }
+    NODISCARD ALWAYS_INLINE Span<const T> span() const { return { m_elements, m_count }; }
+
+    NODISCARD ALWAYS_INLINE bool is_using_inline_storage() const
+    {
+        if constexpr (InlineCapacity > 0)
+            return m_elements == reinterpret_cast<const T*>(this->m_inline_storage);
+        else
+            return false;
+    }
+
+    // Returns nullptr if the vector allocates from the global heap.
+    NODISCARD ALWAYS_INLINE Allocator* allocator() const { return m_allocator; }
+
     NODISCARD ALWAYS_INLINE ReadWriteBytes bytes() { return reinterpret_cast<ReadWriteBytes>(m_elements); }
     NODISCARD ALWAYS_INLINE ReadonlyBytes bytes() const { return reinterpret_cast<ReadonlyBytes>(m_elements); }
     NODISCARD ALWAYS_INLINE usize byte_count() const { return m_count * sizeof(T); }
@@ -305,44 +440,81 @@ public:
 
 public:
     // IMPORTANT: This function causes a memory leak if not used correctly. Only intended for
-    // low-level operations.
+    // low-level operations. The elements must be released using the allocator of the vector.
+    // The elements can't be leaked while they are stored inline.
     AT_DANGEROUS NODISCARD ALWAYS_INLINE T* leak_elements()
     {
+        VERIFY_ALWAYS(!is_using_inline_storage());
         T* elements = m_elements;
-        m_elements = nullptr;
-        m_capacity = 0;
-        m_count = 0;
+        reset_to_inline_storage();
         return elements;
     }
 
 private:
-    NODISCARD ALWAYS_INLINE static ErrorOr<T*> try_allocate_memory(usize capacity)
+    NODISCARD ALWAYS_INLINE ErrorOr<T*> try_allocate_memory(usize capacity)
     {
-        void* memory_block = ::operator new(capacity * sizeof(T));
-        if (!memory_block)
-            return Error::Code::OutOfMemory;
-
+        TRY_ASSIGN(void* memory_block, try_allocate_from(m_allocator, capacity * sizeof(T), alignof(T)));
         return reinterpret_cast<T*>(memory_block);
     }
 
-    ALWAYS_INLINE static ErrorOr<void> try_release_memory(T* elements, usize capacity)
+    ALWAYS_INLINE ErrorOr<void> try_release_memory(T* elements, usize capacity)
     {
-        ::operator delete(elements, capacity * sizeof(T));
+        if constexpr (InlineCapacity > 0)
+        {
+            // The inline storage is not owned by the allocator.
+            if (elements == this->inline_elements())
+                return {};
+        }
+
+        release_to(m_allocator, elements, capacity * sizeof(T), alignof(T));
         return {};
     }
 
+    // NOTE: The elements must be destroyed and the memory released before calling this function.
+    ALWAYS_INLINE void reset_to_inline_storage()
+    {
+        m_elements = this->inline_elements();
+        m_capacity = InlineCapacity;
+        m_count = 0;
+    }
+
     ALWAYS_INLINE static void copy_elements(T* destination, const T* source, usize count)
     {
-        for (usize index = 0; index < count; ++index)
-            new (destination + index) T(source[index]);
+        if constexpr (IsTriviallyCopyable<T>)
+        {
+            copy_memory(destination, source, count * sizeof(T));
+        }
+        else
+        {
+            for (usize index = 0; index < count; ++index)
+                new (destination + index) T(source[index]);
+        }
     }
 
+    // Relocates the elements to a memory block that doesn't overlap the source. After this call,
+    // the source memory block contains no alive elements.
     ALWAYS_INLINE static void move_elements(T* destination, T* source, usize count)
     {
-        for (usize index = 0; index < count; ++index)
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            copy_memory(destination, source, count * sizeof(T));
+        }
+        else
+        {
+            for (usize index = 0; index < count; ++index)
+            {
+                new (destination + index) T(move(source[index]));
+                source[index].~T();
+            }
+        }
+    }
+
+    ALWAYS_INLINE static void destroy_elements(T* elements, usize count)
+    {
+        if constexpr (!IsTriviallyDestructible<T>)
         {
-            new (destination + index) T(move(source[index]));
-            source[index].~T();
+            for (usize index = 0; index < count; ++index)
+                elements[index].~T();
         }
     }
 
@@ -361,9 +533,33 @@ private:
 private:
     ALWAYS_INLINE ErrorOr<void> try_reallocate_to_fixed(usize new_capacity)
     {
-        VERIFY(new_capacity >= m_count);
+        VERIFY_ALWAYS(new_capacity >= m_count);
+
+        T* new_elements;
+        if (new_capacity <= InlineCapacity)
+        {
+            // The elements fit in the inline storage, so no memory has to be allocated.
+            if (is_using_inline_storage())
+                return {};
+
+            new_elements = this->inline_elements();
+            new_capacity = InlineCapacity;
+        }
+        else
+        {
+            // Some allocators (such as the virtual memory allocator) can resize the block without moving it.
+            if (m_allocator && m_capacity > InlineCapacity &&
+                m_allocator->try_resize_in_place(
+                    m_elements, m_capacity * sizeof(T), new_capacity * sizeof(T), alignof(T)
+                ))
+            {
+                m_capacity = new_capacity;
+                return {};
+            }
+
+            TRY_ASSIGN(new_elements, try_allocate_memory(new_capacity));
+        }
 
-        TRY_ASSIGN(T * new_elements, try_allocate_memory(new_capacity));
         move_elements(new_elements, m_elements, m_count);
         TRY(try_release_memory(m_elements, m_capacity));
 
@@ -393,11 +589,18 @@ private:
         VERIFY(offset < m_count);
         VERIFY(m_capacity >= m_count + count);
 
-        for (usize index = 1; index <= m_count - offset; ++index)
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            move_memory(m_elements + offset + count, m_elements + offset, (m_count - offset) * sizeof(T));
+        }
+        else
         {
-            const usize source_index = m_count - index;
-            new (m_elements + source_index + count) T(move(m_elements[source_index]));
-            m_elements[source_index].~T();
+            for (usize index = 1; index <= m_count - offset; ++index)
+            {
+                const usize source_index = m_count - index;
+                new (m_elements + source_index + count) T(move(m_elements[source_index]));
+                m_elements[source_index].~T();
+            }
         }
     }
 
@@ -405,10 +608,24 @@ private:
     T* m_elements;
     usize m_capacity;
     usize m_count;
+    Allocator* m_allocator;
 };
 
+///
+/// Vector that stores up to InlineCapacity elements without allocating any memory.
+/// Intended for collections that are usually small, such as child lists or scratch buffers.
+///
+template<typename T, usize InlineCapacity>
+using SmallVector = Vector<T, InlineCapacity>;
+
+// The vector doesn't store any pointers to itself, so it can be relocated by copying its bytes.
+// This doesn't hold for vectors with inline capacity, as they point to their own inline storage.
+template<typename T>
+inline constexpr bool IsTriviallyRelocatable<Vector<T, 0>> = true;
+
 } // namespace AT
 
 #if AT_INCLUDE_GLOBALLY
+using AT::SmallVector;
 using AT::Vector;
 #endif // AT_INCLUDE_GLOBALLY